@@ -10,7 +10,7 @@
 from libc.stdio cimport FILE
 from libcpp cimport bool
 from cpython.ref cimport PyObject
-from libc.stdint cimport int32_t, uint32_t
+from libc.stdint cimport int32_t, uint32_t, uint64_t
 from pyboolector import BoolectorException
 
 #include "pyboolector_enums.pxd"
@@ -105,6 +105,14 @@ cdef extern from "boolector.h":
                                    int32_t sat_limit) \
       except +raise_py_error
 
+    void boolector_sat_parallel (Btor * btor,
+                                 BoolectorNode ** assumptions,
+                                 uint32_t * sizes,
+                                 uint32_t nsets,
+                                 uint32_t nthreads,
+                                 int32_t * results) \
+      except +raise_py_error
+
     int32_t boolector_simplify (Btor * btor) \
       except +raise_py_error
 
@@ -496,6 +504,17 @@ cdef extern from "boolector.h":
     void boolector_free_bv_assignment (Btor * btor, const char * assignment) \
       except +raise_py_error
 
+    uint64_t boolector_bv_assignment_u64 (Btor * btor, BoolectorNode * node) \
+      except +raise_py_error
+
+    void boolector_bv_assignment_words (Btor * btor, BoolectorNode * node,
+                                        uint64_t * words, uint32_t nwords) \
+      except +raise_py_error
+
+    void boolector_bv_assignments (Btor * btor, BoolectorNode ** nodes,
+                                   uint32_t n, uint64_t * values) \
+      except +raise_py_error
+
     void boolector_array_assignment (Btor * btor,
                                      BoolectorNode * n_array,
                                      char *** indices,
@@ -592,6 +611,9 @@ cdef extern from "boolector.h":
     void boolector_dump_aiger_binary (Btor * btor, FILE * file, bool merge_roots) \
       except +raise_py_error
 
+    void boolector_dump_binary (Btor * btor, FILE * file) \
+      except +raise_py_error
+
     const char * boolector_copyright (Btor * btor) \
       except +raise_py_error
 
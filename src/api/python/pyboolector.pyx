@@ -1224,7 +1224,7 @@ cdef class Boolector:
 
             Dump input formula to output file.
 
-            :param format: A file format identifier string (use 'btor' for BTOR_, 'smt2' for `SMT-LIB v2`_, 'aig' for binary AIGER (QF_BV only), and 'aag' for ASCII AIGER (QF_BV only)).
+            :param format: A file format identifier string (use 'btor' for BTOR_, 'smt2' for `SMT-LIB v2`_, 'aig' for binary AIGER (QF_BV only), 'aag' for ASCII AIGER (QF_BV only), and 'bin' for Boolector's binary format).
             :type format: str
             :param outile: Output file name (default: stdout).
             :type format: str.
@@ -1251,6 +1251,8 @@ cdef class Boolector:
             btorapi.boolector_dump_aiger_binary(self._c_btor, c_file, True)
         elif format.lower() == "aag":
             btorapi.boolector_dump_aiger_ascii(self._c_btor, c_file, True)
+        elif format.lower() == "bin":
+            btorapi.boolector_dump_binary(self._c_btor, c_file)
         else:
             raise BoolectorException("Invalid dump format '{}'".format(format))
         if outfile is not None:
@@ -17,12 +17,14 @@
 #include "btorexit.h"
 #include "btorexp.h"
 #include "btormodel.h"
+#include "btorparallel.h"
 #include "btorparse.h"
 #include "btorprintmodel.h"
 #include "btorsat.h"
 #include "btorsort.h"
 #include "btortrapi.h"
 #include "dumper/btordumpaig.h"
+#include "dumper/btordumpbin.h"
 #include "dumper/btordumpbtor.h"
 #include "dumper/btordumpsmt.h"
 #include "preprocess/btorpreprocess.h"
@@ -31,6 +33,7 @@
 
 /*------------------------------------------------------------------------*/
 
+#include <inttypes.h>
 #include <limits.h>
 #include <stdio.h>
 #include <string.h>
@@ -235,6 +238,31 @@ boolector_var_mark_bool (Btor *btor, BoolectorNode *node)
 #endif
 }
 
+BoolectorNode *
+boolector_const_bv (Btor *btor, const BtorBitVector *bits)
+{
+  BtorNode *res;
+  BoolectorNode *bres;
+  char *str;
+
+  BTOR_ABORT_ARG_NULL (btor);
+  BTOR_ABORT_ARG_NULL (bits);
+  if (btor->apitrace)
+  {
+    /* trace as 'const' to keep API traces replayable */
+    str  = btor_bv_to_char (btor->mm, bits);
+    bres = boolector_const (btor, str);
+    btor_mem_freestr (btor->mm, str);
+    return bres;
+  }
+  res = btor_exp_bv_const (btor, bits);
+  btor_node_inc_ext_ref_counter (btor, res);
+#ifndef NDEBUG
+  BTOR_CHKCLONE_RES_PTR (res, const_bv, bits);
+#endif
+  return BTOR_EXPORT_BOOLECTOR_NODE (res);
+}
+
 void
 boolector_add_output (Btor *btor, BoolectorNode *node)
 {
@@ -425,6 +453,7 @@ boolector_push (Btor *btor, uint32_t level)
   {
     BTOR_PUSH_STACK (btor->assertions_trail,
                      BTOR_COUNT_STACK (btor->assertions));
+    btor_push_scope (btor);
   }
   btor->num_push_pop++;
 }
@@ -447,7 +476,10 @@ boolector_pop (Btor *btor, uint32_t level)
   BtorNode *cur;
 
   for (i = 0, pos = 0; i < level; i++)
+  {
     pos = BTOR_POP_STACK (btor->assertions_trail);
+    btor_pop_scope (btor);
+  }
 
   while (BTOR_COUNT_STACK (btor->assertions) > pos)
   {
@@ -662,6 +694,80 @@ boolector_limited_sat (Btor *btor, int32_t lod_limit, int32_t sat_limit)
   return res;
 }
 
+void
+boolector_sat_parallel (Btor *btor,
+                        BoolectorNode **assumptions,
+                        uint32_t *sizes,
+                        uint32_t nsets,
+                        uint32_t nthreads,
+                        int32_t *results)
+{
+  uint32_t i, j, k;
+  BtorNode *exp;
+  BtorSolverResult *res;
+
+  BTOR_ABORT_ARG_NULL (btor);
+  BTOR_ABORT (!btor_opt_get (btor, BTOR_OPT_INCREMENTAL),
+              "incremental usage has not been enabled");
+  BTOR_ABORT (nsets && !sizes, "'sizes' must not be NULL if 'nsets' > 0");
+  BTOR_ABORT (nsets && !results, "'results' must not be NULL if 'nsets' > 0");
+  BTOR_TRAPI_PRINT ("%s %p %u %u ", __FUNCTION__ + 10, btor, nsets, nthreads);
+  for (i = 0, k = 0; i < nsets; i++)
+  {
+    BTOR_TRAPI_PRINT ("%u ", sizes[i]);
+    BTOR_ABORT (sizes[i] && !assumptions,
+                "'assumptions' must not be NULL if 'sizes[%u]' > 0",
+                i);
+    for (j = 0; j < sizes[i]; j++, k++)
+    {
+      exp = BTOR_IMPORT_BOOLECTOR_NODE (assumptions[k]);
+      BTOR_ABORT_ARG_NULL (exp);
+      BTOR_TRAPI_PRINT (BTOR_TRAPI_NODE_FMT, BTOR_TRAPI_NODE_ID (exp));
+    }
+  }
+  BTOR_TRAPI_PRINT ("\n");
+  for (i = 0; i < k; i++)
+  {
+    exp = BTOR_IMPORT_BOOLECTOR_NODE (assumptions[i]);
+    BTOR_ABORT_REFS_NOT_POS (exp);
+    BTOR_ABORT_BTOR_MISMATCH (btor, exp);
+    BTOR_ABORT_IS_NOT_BV (exp);
+    BTOR_ABORT (!btor_sort_is_bool (btor, btor_node_real_addr (exp)->sort_id),
+                "'assumptions[%u]' must have bit-width one",
+                i);
+    BTOR_ABORT (btor_node_real_addr (exp)->parameterized,
+                "assumption must not be parameterized");
+  }
+
+  BTOR_NEWN (btor->mm, res, nsets);
+  btor_check_sat_parallel (btor,
+                           BTOR_IMPORT_BOOLECTOR_NODE_ARRAY (assumptions),
+                           sizes,
+                           nsets,
+                           nthreads,
+                           res);
+  for (i = 0; i < nsets; i++) results[i] = res[i];
+  BTOR_DELETEN (btor->mm, res, nsets);
+#ifndef NDEBUG
+  if (btor->clone)
+  {
+    int32_t *cresults;
+    BoolectorNode **cassumptions;
+    BTOR_NEWN (btor->mm, cresults, nsets);
+    BTOR_NEWN (btor->mm, cassumptions, k);
+    for (i = 0; i < k; i++)
+      cassumptions[i] =
+          BTOR_CLONED_EXP (BTOR_IMPORT_BOOLECTOR_NODE (assumptions[i]));
+    boolector_sat_parallel (
+        btor->clone, cassumptions, sizes, nsets, nthreads, cresults);
+    for (i = 0; i < nsets; i++) assert (cresults[i] == results[i]);
+    BTOR_DELETEN (btor->mm, cassumptions, k);
+    BTOR_DELETEN (btor->mm, cresults, nsets);
+    btor_chkclone (btor, btor->clone);
+  }
+#endif
+}
+
 /*------------------------------------------------------------------------*/
 
 int32_t
@@ -4083,6 +4189,143 @@ boolector_free_bv_assignment (Btor *btor, const char *assignment)
 #endif
 }
 
+uint64_t
+boolector_bv_assignment_u64 (Btor *btor, BoolectorNode *node)
+{
+  uint64_t res;
+  BtorNode *exp;
+
+  exp = BTOR_IMPORT_BOOLECTOR_NODE (node);
+  BTOR_ABORT_ARG_NULL (btor);
+  BTOR_ABORT (btor->last_sat_result != BTOR_RESULT_SAT
+                  || !btor->valid_assignments,
+              "cannot retrieve model if input formula is not SAT");
+  BTOR_ABORT (!btor_opt_get (btor, BTOR_OPT_MODEL_GEN),
+              "model generation has not been enabled");
+  BTOR_ABORT (btor->quantifiers->count,
+              "models are currently not supported with quantifiers");
+  BTOR_ABORT_ARG_NULL (exp);
+  BTOR_TRAPI_UNFUN (exp);
+  BTOR_ABORT_REFS_NOT_POS (exp);
+  BTOR_ABORT_BTOR_MISMATCH (btor, exp);
+  BTOR_ABORT_IS_NOT_BV (exp);
+  BTOR_ABORT (btor_node_bv_get_width (btor, exp) > 64,
+              "bit-width of 'exp' must not be > 64");
+  res = btor_bv_to_uint64 (btor_model_get_bv (btor, exp));
+  BTOR_TRAPI_RETURN ("%" PRIu64, res);
+#ifndef NDEBUG
+  if (btor->clone)
+  {
+    uint64_t cloneres =
+        boolector_bv_assignment_u64 (btor->clone, BTOR_CLONED_EXP (exp));
+    (void) cloneres;
+    assert (cloneres == res);
+    btor_chkclone (btor, btor->clone);
+  }
+#endif
+  return res;
+}
+
+void
+boolector_bv_assignment_words (Btor *btor,
+                               BoolectorNode *node,
+                               uint64_t *words,
+                               uint32_t nwords)
+{
+  BtorNode *exp;
+
+  exp = BTOR_IMPORT_BOOLECTOR_NODE (node);
+  BTOR_ABORT_ARG_NULL (btor);
+  BTOR_ABORT (btor->last_sat_result != BTOR_RESULT_SAT
+                  || !btor->valid_assignments,
+              "cannot retrieve model if input formula is not SAT");
+  BTOR_ABORT (!btor_opt_get (btor, BTOR_OPT_MODEL_GEN),
+              "model generation has not been enabled");
+  BTOR_ABORT (btor->quantifiers->count,
+              "models are currently not supported with quantifiers");
+  BTOR_ABORT_ARG_NULL (exp);
+  BTOR_TRAPI_UNFUN_EXT (exp, "%u", nwords);
+  BTOR_ABORT_ARG_NULL (words);
+  BTOR_ABORT_REFS_NOT_POS (exp);
+  BTOR_ABORT_BTOR_MISMATCH (btor, exp);
+  BTOR_ABORT_IS_NOT_BV (exp);
+  BTOR_ABORT ((btor_node_bv_get_width (btor, exp) + 63) / 64 > nwords,
+              "'nwords' must not be < number of 64 bit words of 'exp'");
+  btor_bv_to_uint64_words (btor_model_get_bv (btor, exp), words, nwords);
+#ifndef NDEBUG
+  if (btor->clone)
+  {
+    uint32_t i;
+    uint64_t *cwords;
+    BTOR_NEWN (btor->mm, cwords, nwords);
+    boolector_bv_assignment_words (
+        btor->clone, BTOR_CLONED_EXP (exp), cwords, nwords);
+    for (i = 0; i < nwords; i++) assert (cwords[i] == words[i]);
+    BTOR_DELETEN (btor->mm, cwords, nwords);
+    btor_chkclone (btor, btor->clone);
+  }
+#endif
+}
+
+void
+boolector_bv_assignments (Btor *btor,
+                          BoolectorNode **nodes,
+                          uint32_t n,
+                          uint64_t *values)
+{
+  uint32_t i;
+  BtorNode *exp;
+
+  BTOR_ABORT_ARG_NULL (btor);
+  BTOR_ABORT (btor->last_sat_result != BTOR_RESULT_SAT
+                  || !btor->valid_assignments,
+              "cannot retrieve model if input formula is not SAT");
+  BTOR_ABORT (!btor_opt_get (btor, BTOR_OPT_MODEL_GEN),
+              "model generation has not been enabled");
+  BTOR_ABORT (btor->quantifiers->count,
+              "models are currently not supported with quantifiers");
+  BTOR_ABORT (n && !nodes, "'nodes' must not be NULL if 'n' > 0");
+  BTOR_ABORT (n && !values, "'values' must not be NULL if 'n' > 0");
+  BTOR_TRAPI_PRINT ("%s %p %u ", __FUNCTION__ + 10, btor, n);
+  for (i = 0; i < n; i++)
+  {
+    exp = BTOR_IMPORT_BOOLECTOR_NODE (nodes[i]);
+    BTOR_ABORT_ARG_NULL (exp);
+    BTOR_TRAPI_PRINT (BTOR_TRAPI_NODE_FMT, BTOR_TRAPI_NODE_ID (exp));
+  }
+  BTOR_TRAPI_PRINT ("\n");
+  for (i = 0; i < n; i++)
+  {
+    exp = BTOR_IMPORT_BOOLECTOR_NODE (nodes[i]);
+    BTOR_ABORT_REFS_NOT_POS (exp);
+    BTOR_ABORT_BTOR_MISMATCH (btor, exp);
+    BTOR_ABORT_IS_NOT_BV (exp);
+    BTOR_ABORT (btor_node_bv_get_width (btor, exp) > 64,
+                "bit-width of 'nodes[%u]' must not be > 64",
+                i);
+    values[i] = btor_bv_to_uint64 (btor_model_get_bv (btor, exp));
+  }
+#ifndef NDEBUG
+  if (btor->clone)
+  {
+    uint64_t *cvalues;
+    BoolectorNode **cnodes;
+    if (n)
+    {
+      BTOR_NEWN (btor->mm, cnodes, n);
+      BTOR_NEWN (btor->mm, cvalues, n);
+      for (i = 0; i < n; i++)
+        cnodes[i] = BTOR_CLONED_EXP (BTOR_IMPORT_BOOLECTOR_NODE (nodes[i]));
+      boolector_bv_assignments (btor->clone, cnodes, n, cvalues);
+      for (i = 0; i < n; i++) assert (cvalues[i] == values[i]);
+      BTOR_DELETEN (btor->mm, cnodes, n);
+      BTOR_DELETEN (btor->mm, cvalues, n);
+    }
+    btor_chkclone (btor, btor->clone);
+  }
+#endif
+}
+
 static void
 generate_fun_model_str (
     Btor *btor, BtorNode *exp, char ***args, char ***values, uint32_t *size)
@@ -4107,7 +4350,7 @@ generate_fun_model_str (
   exp = btor_simplify_exp (btor, exp);
   assert (btor_node_is_fun (exp));
 
-  model = btor_model_get_fun_aux (btor, btor->bv_model, btor->fun_model, exp);
+  model = btor_model_get_fun (btor, exp);
 
   if ((btor_node_is_lambda (exp) && btor_node_fun_get_arity (btor, exp) > 1)
       || !btor->fun_model || !model)
@@ -4919,6 +5162,18 @@ boolector_dump_aiger_binary (Btor *btor, FILE *file, bool merge_roots)
 #endif
 }
 
+void
+boolector_dump_binary (Btor *btor, FILE *file)
+{
+  BTOR_TRAPI ("");
+  BTOR_ABORT_ARG_NULL (btor);
+  BTOR_ABORT_ARG_NULL (file);
+  BTOR_WARN (btor->assumptions->count > 0,
+             "dumping in incremental mode only captures the current state "
+             "of the input formula without assumptions");
+  btor_dumpbin_dump (btor, file);
+}
+
 /*------------------------------------------------------------------------*/
 
 const char *
@@ -365,6 +365,48 @@ int32_t boolector_limited_sat (Btor *btor,
                                int32_t lod_limit,
                                int32_t sat_limit);
 
+/*!
+  Check ``nsets`` sets of assumptions against the current input formula
+  concurrently on up to ``nthreads`` threads.
+
+  Set ``i`` consists of the next ``sizes[i]`` expressions in ``assumptions``,
+  i.e., the assumptions of all sets are stored consecutively.  Its result is
+  stored into ``results[i]``.  Assumptions made via boolector_assume before
+  calling this function are added to every set.
+
+  The input formula is simplified and bit-blasted only once, and all threads
+  share the resulting AIGs.  Each thread only holds its own SAT solver, hence
+  checking the sets on N threads requires memory for roughly one formula and
+  N SAT solvers instead of N clones.  If the input formula contains
+  functions or quantifiers, or if Boolector was built without pthreads, the
+  sets are checked sequentially via boolector_sat.
+
+  Incremental usage must be enabled via boolector_set_opt.  Models and failed
+  assumptions of the individual sets are out of scope: the SAT solvers of the
+  threads are discarded after checking their sets, and the instance itself
+  has no model or failed assumptions afterwards.  Call boolector_sat with the
+  assumptions of a set to obtain them.
+
+  :param btor: Boolector instance.
+  :param assumptions: Array of ``sizes[0] + ... + sizes[nsets - 1]``
+                      assumptions (bit-vector expressions of bit-width one).
+  :param sizes: Array of size ``nsets`` with the number of assumptions per
+                set.
+  :param nsets: Number of sets.
+  :param nthreads: Maximum number of threads.
+  :param results: Array of size ``nsets`` for the results (BOOLECTOR_SAT or
+                  BOOLECTOR_UNSAT).
+
+  .. seealso::
+    boolector_sat, boolector_assume
+*/
+void boolector_sat_parallel (Btor *btor,
+                             BoolectorNode **assumptions,
+                             uint32_t *sizes,
+                             uint32_t nsets,
+                             uint32_t nthreads,
+                             int32_t *results);
+
 /*------------------------------------------------------------------------*/
 
 /*!
@@ -2056,6 +2098,63 @@ const char *boolector_bv_assignment (Btor *btor, BoolectorNode *node);
 */
 void boolector_free_bv_assignment (Btor *btor, const char *assignment);
 
+/*!
+  Get the assignment of a bit-vector expression of bit-width at most 64 as
+  unsigned integer if boolector_sat has returned BOOLECTOR_SAT and model
+  generation has been enabled.
+
+  In contrast to boolector_bv_assignment, no assignment string is created,
+  and the result does not depend on option ``BTOR_OPT_OUTPUT_NUMBER_FORMAT``.
+
+  :param btor: Boolector instance.
+  :param node: Bit-vector expression of bit-width at most 64.
+  :return: A satisfying assignment to ``node`` as unsigned integer.
+
+  .. seealso::
+    boolector_bv_assignment, boolector_bv_assignments
+*/
+uint64_t boolector_bv_assignment_u64 (Btor *btor, BoolectorNode *node);
+
+/*!
+  Write the assignment of a bit-vector expression of arbitrary bit-width into
+  the given buffer of ``nwords`` 64 bit words, least significant word first,
+  if boolector_sat has returned BOOLECTOR_SAT and model generation has been
+  enabled.  Words beyond the bit-width of ``node`` are set to zero.
+
+  :param btor: Boolector instance.
+  :param node: Bit-vector expression.
+  :param words: Buffer of size ``nwords``.
+  :param nwords: Size of ``words``, must be at least the bit-width of ``node``
+                 divided by 64 (rounded up).
+
+  .. seealso::
+    boolector_bv_assignment_u64
+*/
+void boolector_bv_assignment_words (Btor *btor,
+                                    BoolectorNode *node,
+                                    uint64_t *words,
+                                    uint32_t nwords);
+
+/*!
+  Get the assignments of ``n`` bit-vector expressions of bit-width at most 64
+  as unsigned integers if boolector_sat has returned BOOLECTOR_SAT and model
+  generation has been enabled.  The assignment of ``nodes[i]`` is stored into
+  ``values[i]``.  This is equivalent to calling boolector_bv_assignment_u64
+  for every node, but checks the solver state only once.
+
+  :param btor: Boolector instance.
+  :param nodes: Array of bit-vector expressions of bit-width at most 64.
+  :param n: Number of expressions in ``nodes``.
+  :param values: Array of size ``n`` for the assignments.
+
+  .. seealso::
+    boolector_bv_assignment_u64
+*/
+void boolector_bv_assignments (Btor *btor,
+                               BoolectorNode **nodes,
+                               uint32_t n,
+                               uint64_t *values);
+
 /*!
   Generate a model for an array expression.
 
@@ -2500,6 +2599,24 @@ void boolector_dump_aiger_ascii (Btor *btor, FILE *file, bool merge_roots);
 */
 void boolector_dump_aiger_binary (Btor *btor, FILE *file, bool merge_roots);
 
+/*!
+  Dumps formula to file in Boolector's binary format.
+
+  The binary format is not meant to be read by other tools but allows to
+  load large formulas considerably faster than any of the text formats.
+  It is recognized by boolector_parse.
+
+  The dump includes all inputs of the formula.  If called after
+  boolector_simplify, it captures the simplified formula together with the
+  substitutions of inputs that were eliminated.  Loading such a dump skips
+  the expensive preprocessing while models are still available for all
+  inputs of the original formula.
+
+  :param btor: Boolector instance
+  :param file: Output file.
+*/
+void boolector_dump_binary (Btor *btor, FILE *file);
+
 /*------------------------------------------------------------------------*/
 
 /*!
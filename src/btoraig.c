@@ -12,6 +12,7 @@
 #include "btorcore.h"
 #include "btorsat.h"
 #include "utils/btoraigmap.h"
+#include "utils/btorhashint.h"
 #include "utils/btorhashptr.h"
 #include "utils/btorutil.h"
 
@@ -45,6 +46,8 @@
 
 #define BTOR_FIND_AND_AIG_CONTRADICTION_LIMIT 8
 
+#define BTOR_AIG_GC_MIN_IDS (1 << 16)
+
 /*------------------------------------------------------------------------*/
 
 //#define BTOR_EXTRACT_TOP_LEVEL_MULTI_OR
@@ -105,7 +108,10 @@ release_cnf_id_aig_mgr (BtorAIGMgr *amgr, BtorAIG *aig)
   assert (aig->cnf_id > 0);
   assert ((size_t) aig->cnf_id < BTOR_SIZE_STACK (amgr->cnfid2aig));
   assert (amgr->cnfid2aig.start[aig->cnf_id] == aig->id);
-  if (amgr->smgr->have_restore) return;
+  /* Solvers without melt support (e.g., with have_restore) can not eliminate
+   * the index, hence we keep it for reuse.  It is counted as garbage as soon
+   * as the AIG is deleted. */
+  if (!btor_sat_mgr_has_melt_support (amgr->smgr)) return;
   amgr->cnfid2aig.start[aig->cnf_id] = 0;
   btor_sat_mgr_release_cnf_id (amgr->smgr, aig->cnf_id);
   aig->cnf_id = 0;
@@ -117,7 +123,11 @@ delete_aig_node (BtorAIGMgr *amgr, BtorAIG *aig)
   assert (!BTOR_IS_INVERTED_AIG (aig));
   assert (amgr);
   if (btor_aig_is_const (aig)) return;
-  if (aig->cnf_id) release_cnf_id_aig_mgr (amgr, aig);
+  if (aig->cnf_id)
+  {
+    release_cnf_id_aig_mgr (amgr, aig);
+    amgr->num_dead_cnf_ids++;
+  }
   amgr->id2aig.start[aig->id] = 0;
   if (aig->is_var)
   {
@@ -893,6 +903,9 @@ btor_aig_mgr_clone (Btor *btor, BtorAIGMgr *amgr)
   res->num_cnf_vars     = amgr->num_cnf_vars;
   res->num_cnf_clauses  = amgr->num_cnf_clauses;
   res->num_cnf_literals = amgr->num_cnf_literals;
+  res->num_dead_cnf_ids = amgr->num_dead_cnf_ids;
+  res->num_cnf_gcs      = amgr->num_cnf_gcs;
+  res->num_aig_id_gcs   = amgr->num_aig_id_gcs;
   clone_aigs (amgr, res);
   return res;
 }
@@ -912,6 +925,192 @@ btor_aig_mgr_delete (BtorAIGMgr *amgr)
   BTOR_DELETE (mm, amgr);
 }
 
+void
+btor_aig_mgr_push_scope (BtorAIGMgr *amgr)
+{
+  assert (amgr);
+  btor_sat_push_scope (amgr->smgr);
+}
+
+void
+btor_aig_mgr_pop_scope (BtorAIGMgr *amgr)
+{
+  assert (amgr);
+  btor_sat_pop_scope (amgr->smgr);
+}
+
+bool
+btor_aig_mgr_release_popped_scopes (BtorAIGMgr *amgr)
+{
+  assert (amgr);
+
+  int32_t guard, cnf_id, id;
+  uint32_t reset;
+  BtorAIG *aig;
+  BtorSATMgr *smgr;
+
+  smgr = amgr->smgr;
+  if (BTOR_EMPTY_STACK (smgr->popped)) return false;
+
+  guard = btor_sat_disable_popped_scopes (smgr);
+  if (!guard) return false;
+
+  /* The Tseitin encodings of all AIGs with a CNF index greater than the
+   * smallest activation literal of the popped scopes have been disabled.
+   * Solvers that can not melt these indices keep them as garbage, which is
+   * collected in btor_aig_mgr_collect_garbage.  Indices of deleted AIGs have
+   * already been counted as garbage, and indices reset by an earlier call
+   * are not mapped anymore, hence only the indices reset below are counted. */
+  reset = 0;
+  for (cnf_id = guard + 1;
+       (size_t) cnf_id < BTOR_SIZE_STACK (amgr->cnfid2aig);
+       cnf_id++)
+  {
+    id = amgr->cnfid2aig.start[cnf_id];
+    if (!id) continue;
+    amgr->cnfid2aig.start[cnf_id] = 0;
+    aig = btor_aig_get_by_id (amgr, id);
+    /* CNF indices of deleted AIGs are not released without melt support */
+    if (!aig) continue;
+    assert (aig->cnf_id == cnf_id);
+    btor_sat_mgr_release_cnf_id (smgr, cnf_id);
+    aig->cnf_id = 0;
+    reset++;
+  }
+  amgr->num_dead_cnf_ids += reset;
+  BTOR_MSG (amgr->btor->msg,
+            2,
+            "reset CNF indices of %u AIGs encoded in popped scopes",
+            reset);
+  return reset > 0;
+}
+
+/* Start over with a fresh SAT solver if the majority of all CNF indices is
+ * garbage the SAT solver can not release. */
+static bool
+collect_cnf_garbage (BtorAIGMgr *amgr)
+{
+  assert (amgr);
+
+  int32_t cnf_id, id;
+  BtorAIG *aig;
+  BtorMemMgr *mm;
+  BtorSATMgr *smgr;
+
+  mm   = amgr->btor->mm;
+  smgr = amgr->smgr;
+  if (!btor_sat_is_initialized (smgr)) return false;
+  if (btor_sat_mgr_has_melt_support (smgr)) return false;
+  if (amgr->num_dead_cnf_ids <= smgr->maxvar / 2) return false;
+
+  BTOR_MSG (amgr->btor->msg,
+            1,
+            "reset %s to collect %d of %d CNF indices",
+            smgr->name,
+            amgr->num_dead_cnf_ids,
+            smgr->maxvar);
+  btor_sat_reset (smgr);
+  btor_sat_enable_solver (smgr);
+  btor_sat_init (smgr);
+
+  for (cnf_id = 1; (size_t) cnf_id < BTOR_SIZE_STACK (amgr->cnfid2aig);
+       cnf_id++)
+  {
+    id = amgr->cnfid2aig.start[cnf_id];
+    if (!id) continue;
+    aig = btor_aig_get_by_id (amgr, id);
+    if (!aig) continue;
+    assert (aig->cnf_id == cnf_id);
+    aig->cnf_id = 0;
+  }
+  BTOR_RELEASE_STACK (amgr->cnfid2aig);
+  BTOR_INIT_STACK (mm, amgr->cnfid2aig);
+  amgr->num_dead_cnf_ids = 0;
+  amgr->num_cnf_gcs++;
+  return true;
+}
+
+/* Renumber all AIGs consecutively (in their original order, which keeps the
+ * ids of children below the id of their parent) if the majority of all ids
+ * belongs to deleted AIGs. */
+static void
+compact_aig_ids (BtorAIGMgr *amgr)
+{
+  assert (amgr);
+
+  int32_t *map, id, new_id, child;
+  uint32_t i, hash;
+  size_t count, live, size;
+  BtorAIG *aig;
+  BtorMemMgr *mm;
+
+  mm    = amgr->btor->mm;
+  count = BTOR_COUNT_STACK (amgr->id2aig);
+  live  = 2 + amgr->cur_num_aigs + amgr->cur_num_aig_vars;
+  assert (live <= count);
+  if (count - live < BTOR_AIG_GC_MIN_IDS || count - live <= live) return;
+
+  BTOR_NEWN (mm, map, count);
+  map[0] = 0;
+  map[1] = 1;
+  BTOR_CLRN (amgr->table.chains, amgr->table.size);
+  for (id = 2, new_id = 2; (size_t) id < count; id++)
+  {
+    aig = amgr->id2aig.start[id];
+    if (!aig)
+    {
+      map[id] = 0;
+      continue;
+    }
+    map[id] = new_id;
+    aig->id = new_id;
+    if (btor_aig_is_and (aig))
+    {
+      for (i = 0; i < 2; i++)
+      {
+        child = aig->children[i];
+        assert (map[abs (child)]);
+        aig->children[i] = child < 0 ? -map[-child] : map[child];
+      }
+      hash                     = compute_aig_hash (aig, amgr->table.size);
+      aig->next                = amgr->table.chains[hash];
+      amgr->table.chains[hash] = new_id;
+    }
+    amgr->id2aig.start[new_id++] = aig;
+  }
+  assert ((size_t) new_id == live);
+
+  /* CNF indices of deleted AIGs are not released without melt support */
+  for (i = 1; i < BTOR_SIZE_STACK (amgr->cnfid2aig); i++)
+    amgr->cnfid2aig.start[i] = map[amgr->cnfid2aig.start[i]];
+  BTOR_DELETEN (mm, map, count);
+
+  size = BTOR_SIZE_STACK (amgr->id2aig);
+  BTOR_REALLOC (mm, amgr->id2aig.start, size, live);
+  amgr->id2aig.top = amgr->id2aig.start + live;
+  amgr->id2aig.end = amgr->id2aig.start + live;
+
+  BTOR_MSG (amgr->btor->msg,
+            1,
+            "compacted AIG ids, %zu of %zu ids in use, %.1f MB reclaimed",
+            live,
+            count,
+            (size - live) * sizeof (BtorAIG *) / (double) (1 << 20));
+  amgr->num_aig_id_gcs++;
+}
+
+bool
+btor_aig_mgr_collect_garbage (BtorAIGMgr *amgr)
+{
+  assert (amgr);
+
+  bool res;
+
+  res = collect_cnf_garbage (amgr);
+  compact_aig_ids (amgr);
+  return res;
+}
+
 static bool
 is_xor_aig (BtorAIGMgr *amgr, BtorAIG *aig, BtorAIGPtrStack *leafs)
 {
@@ -1319,6 +1518,164 @@ btor_aig_to_sat_tseitin (BtorAIGMgr *amgr, BtorAIG *start)
   BTOR_RELEASE_STACK (marked);
 }
 
+static int32_t
+get_mapped_cnf_id (BtorIntHashTable *cnf_ids, BtorAIG *aig)
+{
+  BtorHashTableData *d;
+
+  assert (!btor_aig_is_const (aig));
+  d = btor_hashint_map_get (cnf_ids, BTOR_REAL_ADDR_AIG (aig)->id);
+  assert (d);
+  assert (d->as_int > 0);
+  return BTOR_IS_INVERTED_AIG (aig) ? -d->as_int : d->as_int;
+}
+
+int32_t
+btor_aig_to_sat_tseitin_map (BtorAIGMgr *amgr,
+                             BtorSATMgr *smgr,
+                             BtorIntHashTable *cnf_ids,
+                             BtorAIG *start)
+{
+  assert (amgr);
+  assert (smgr);
+  assert (smgr != amgr->smgr);
+  assert (cnf_ids);
+
+  BtorAIGPtrStack stack, leafs;
+  BtorHashTableData *d;
+  int32_t x, y, a, b, c;
+  bool isxor, isite;
+  BtorAIG *root, **p;
+  BtorMemMgr *mm;
+
+  if (start == BTOR_AIG_TRUE) return smgr->true_lit;
+  if (start == BTOR_AIG_FALSE) return -smgr->true_lit;
+
+  /* 'amgr' is shared, allocate from the memory manager of 'smgr' */
+  mm = smgr->btor->mm;
+  BTOR_INIT_STACK (mm, stack);
+  BTOR_INIT_STACK (mm, leafs);
+
+  BTOR_PUSH_STACK (stack, BTOR_REAL_ADDR_AIG (start));
+  while (!BTOR_EMPTY_STACK (stack))
+  {
+    root = BTOR_POP_STACK (stack);
+    d    = btor_hashint_map_get (cnf_ids, root->id);
+
+    /* a CNF id of 0 marks AIGs whose children are not yet encoded */
+    if (d && d->as_int) continue;
+
+    if (btor_aig_is_var (root))
+    {
+      btor_hashint_map_add (cnf_ids, root->id)->as_int =
+          btor_sat_mgr_next_cnf_id (smgr);
+      continue;
+    }
+
+    assert (btor_aig_is_and (root));
+    assert (BTOR_EMPTY_STACK (leafs));
+
+    if ((isxor = is_xor_aig (amgr, root, &leafs)))
+      isite = 0;
+    else
+      isite = is_ite_aig (amgr, root, &leafs);
+
+    if (!isxor && !isite)
+    {
+      BTOR_PUSH_STACK (leafs, btor_aig_get_left_child (amgr, root));
+      BTOR_PUSH_STACK (leafs, btor_aig_get_right_child (amgr, root));
+    }
+
+    if (!d)
+    {
+      btor_hashint_map_add (cnf_ids, root->id)->as_int = 0;
+      BTOR_PUSH_STACK (stack, root);
+      for (p = leafs.start; p < leafs.top; p++)
+        BTOR_PUSH_STACK (stack, BTOR_REAL_ADDR_AIG (*p));
+    }
+    else
+    {
+      x = btor_sat_mgr_next_cnf_id (smgr);
+
+      if (isxor)
+      {
+        assert (BTOR_COUNT_STACK (leafs) == 2);
+        a = get_mapped_cnf_id (cnf_ids, leafs.start[0]);
+        b = get_mapped_cnf_id (cnf_ids, leafs.start[1]);
+
+        btor_sat_add (smgr, -x);
+        btor_sat_add (smgr, a);
+        btor_sat_add (smgr, -b);
+        btor_sat_add (smgr, 0);
+
+        btor_sat_add (smgr, -x);
+        btor_sat_add (smgr, -a);
+        btor_sat_add (smgr, b);
+        btor_sat_add (smgr, 0);
+
+        btor_sat_add (smgr, x);
+        btor_sat_add (smgr, -a);
+        btor_sat_add (smgr, -b);
+        btor_sat_add (smgr, 0);
+
+        btor_sat_add (smgr, x);
+        btor_sat_add (smgr, a);
+        btor_sat_add (smgr, b);
+        btor_sat_add (smgr, 0);
+      }
+      else if (isite)
+      {
+        assert (BTOR_COUNT_STACK (leafs) == 3);
+        a = get_mapped_cnf_id (cnf_ids, leafs.start[0]);  // else
+        b = get_mapped_cnf_id (cnf_ids, leafs.start[1]);  // then
+        c = get_mapped_cnf_id (cnf_ids, leafs.start[2]);  // cond
+
+        btor_sat_add (smgr, -x);
+        btor_sat_add (smgr, -c);
+        btor_sat_add (smgr, b);
+        btor_sat_add (smgr, 0);
+
+        btor_sat_add (smgr, -x);
+        btor_sat_add (smgr, c);
+        btor_sat_add (smgr, a);
+        btor_sat_add (smgr, 0);
+
+        btor_sat_add (smgr, x);
+        btor_sat_add (smgr, -c);
+        btor_sat_add (smgr, -b);
+        btor_sat_add (smgr, 0);
+
+        btor_sat_add (smgr, x);
+        btor_sat_add (smgr, c);
+        btor_sat_add (smgr, -a);
+        btor_sat_add (smgr, 0);
+      }
+      else
+      {
+        for (p = leafs.start; p < leafs.top; p++)
+          btor_sat_add (smgr, -get_mapped_cnf_id (cnf_ids, *p));
+        btor_sat_add (smgr, x);
+        btor_sat_add (smgr, 0);
+
+        for (p = leafs.start; p < leafs.top; p++)
+        {
+          y = get_mapped_cnf_id (cnf_ids, *p);
+          btor_sat_add (smgr, -x);
+          btor_sat_add (smgr, y);
+          btor_sat_add (smgr, 0);
+        }
+      }
+      /* no AIGs have been added to 'cnf_ids' since 'd' was retrieved */
+      d->as_int = x;
+    }
+    BTOR_RESET_STACK (leafs);
+  }
+  BTOR_RELEASE_STACK (stack);
+  BTOR_RELEASE_STACK (leafs);
+
+  return get_mapped_cnf_id (cnf_ids, start);
+}
+
 static void
 aig_to_sat_tseitin (BtorAIGMgr *amgr, BtorAIG *aig)
 {
@@ -12,6 +12,7 @@
 #include "btoropt.h"
 #include "btorsat.h"
 #include "btortypes.h"
+#include "utils/btorhashint.h"
 #include "utils/btorhashptr.h"
 #include "utils/btormem.h"
 #include "utils/btorstack.h"
@@ -59,12 +60,17 @@ struct BtorAIGMgr
   uint_least64_t cur_num_aigs;     /* current number of ANDs */
   uint_least64_t cur_num_aig_vars; /* current number of AIG variables */
 
+  int32_t num_dead_cnf_ids; /* CNF indices of deleted AIGs and AIGs encoded
+                               in popped scopes only */
+
   /* statistics */
   uint_least64_t max_num_aigs;
   uint_least64_t max_num_aig_vars;
   uint_least64_t num_cnf_vars;
   uint_least64_t num_cnf_clauses;
   uint_least64_t num_cnf_literals;
+  uint_least64_t num_cnf_gcs;
+  uint_least64_t num_aig_id_gcs;
 };
 
 typedef struct BtorAIGMgr BtorAIGMgr;
@@ -167,6 +173,29 @@ BtorAIGMgr *btor_aig_mgr_new (Btor *btor);
 BtorAIGMgr *btor_aig_mgr_clone (Btor *btor, BtorAIGMgr *amgr);
 void btor_aig_mgr_delete (BtorAIGMgr *amgr);
 
+/* Opens a new scope of the SAT solver (see btor_sat_push_scope). */
+void btor_aig_mgr_push_scope (BtorAIGMgr *amgr);
+
+/* Closes the current scope of the SAT solver (see btor_sat_pop_scope). */
+void btor_aig_mgr_pop_scope (BtorAIGMgr *amgr);
+
+/* Disables the clauses of all scopes popped since the last call and resets
+ * the CNF indices of all AIGs encoded within.  Returns true if any CNF index
+ * has been reset.  Note that the caller is responsible for encoding AIGs
+ * that are still in use again.
+ */
+bool btor_aig_mgr_release_popped_scopes (BtorAIGMgr *amgr);
+
+/* Collects garbage of long-lived incremental instances.  If the SAT solver
+ * can not release the CNF indices of deleted AIGs and popped scopes (no melt
+ * support) and these make up the majority of all indices, the SAT solver is
+ * reset and reinitialized and all CNF indices are reset.  Returns true in this
+ * case, the caller is responsible for encoding AIGs that are still in use
+ * again.  Further, AIG ids are compacted if the majority of all ids belongs
+ * to deleted AIGs, hence AIG ids must not be held across calls.
+ */
+bool btor_aig_mgr_collect_garbage (BtorAIGMgr *amgr);
+
 BtorSATMgr *btor_aig_get_sat_mgr (const BtorAIGMgr *amgr);
 
 /* Variable representing 1 bit. */
@@ -214,6 +243,17 @@ void btor_aig_add_toplevel_to_sat (BtorAIGMgr *, BtorAIG *);
  */
 void btor_aig_to_sat_tseitin (BtorAIGMgr *amgr, BtorAIG *aig);
 
+/* Translates AIG into the SAT instance of SAT manager 'smgr' (which is not
+ * the SAT manager of 'amgr') in both phases, where 'cnf_ids' maps AIG ids to
+ * the CNF ids of 'smgr'.  In contrast to 'btor_aig_to_sat_tseitin', the AIGs
+ * are not modified, hence 'amgr' may be shared by several threads encoding
+ * into different SAT managers.  Returns the literal of 'aig'.
+ */
+int32_t btor_aig_to_sat_tseitin_map (BtorAIGMgr *amgr,
+                                     BtorSATMgr *smgr,
+                                     BtorIntHashTable *cnf_ids,
+                                     BtorAIG *aig);
+
 /* Gets current assignment of AIG aig (in the SAT case).
  */
 int32_t btor_aig_get_assignment (BtorAIGMgr *amgr, BtorAIG *aig);
@@ -12,6 +12,7 @@
 #include "btorcore.h"
 #include "utils/btorutil.h"
 
+#include <ctype.h>
 #include <limits.h>
 
 #ifdef BTOR_USE_GMP
@@ -65,6 +66,15 @@ set_rem_bits_to_zero (BtorBitVector *bv)
   if (bv->width != BTOR_BV_TYPE_BW * bv->len)
     bv->bits[0] &= BTOR_MASK_REM_BITS (bv);
 }
+
+static uint32_t
+hex_digit_value (char c)
+{
+  if (c >= '0' && c <= '9') return c - '0';
+  if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+  assert (c >= 'A' && c <= 'F');
+  return c - 'A' + 10;
+}
 #endif
 
 #ifndef NDEBUG
@@ -346,34 +356,12 @@ btor_bv_constd (BtorMemMgr *mm, const char *str, uint32_t bw)
   res->width = bw;
   mpz_init_set_str (res->val, str, 10);
 #else
-  bool is_neg, is_min_val;
+  bool is_neg;
   BtorBitVector *tmp;
-  char *bits;
-  uint32_t size_bits;
-
-  is_min_val = false;
-  is_neg     = (str[0] == '-');
-  bits       = btor_util_dec_to_bin_str (mm, is_neg ? str + 1 : str);
-  size_bits  = strlen (bits);
-  if (is_neg)
-  {
-    is_min_val = (bits[0] == '1');
-    for (size_t i = 1; is_min_val && i < size_bits; i++)
-      is_min_val = (bits[i] == '0');
-  }
-  assert (((is_neg && !is_min_val) || size_bits <= bw)
-          && (!is_neg || is_min_val || size_bits + 1 <= bw));
 
-  res = btor_bv_char_to_bv (mm, bits);
-  btor_mem_freestr (mm, bits);
-  assert (res->width == size_bits);
-  /* zero-extend to bw */
-  if (size_bits < bw)
-  {
-    tmp = btor_bv_uext (mm, res, bw - size_bits);
-    btor_bv_free (mm, res);
-    res = tmp;
-  }
+  is_neg = (str[0] == '-');
+  res    = btor_bv_dec_to_bv (mm, is_neg ? str + 1 : str, bw);
+  assert (res);
   if (is_neg)
   {
     tmp = btor_bv_neg (mm, res);
@@ -396,22 +384,76 @@ btor_bv_consth (BtorMemMgr *mm, const char *str, uint32_t bw)
   res->width = bw;
   mpz_init_set_str (res->val, str, 16);
 #else
-  BtorBitVector *tmp;
-  char *bits;
-  uint32_t size_bits;
-
-  bits      = btor_util_hex_to_bin_str (mm, str);
-  size_bits = strlen (bits);
-  assert (size_bits <= bw);
-  res = btor_bv_char_to_bv (mm, bits);
-  btor_mem_freestr (mm, bits);
-  assert (res->width == size_bits);
-  /* zero-extend to bw */
-  if (size_bits < bw)
-  {
-    tmp = btor_bv_uext (mm, res, bw - size_bits);
+  uint32_t pos, digit;
+  const char *p;
+
+  /* 'BTOR_BV_TYPE_BW' is a multiple of 4, hence every hexadecimal digit
+   * goes into a single chunk */
+  res = btor_bv_new (mm, bw);
+  for (p = str + strlen (str), pos = 0; p > str; pos += 4)
+  {
+    digit = hex_digit_value (*--p);
+    if (pos / BTOR_BV_TYPE_BW >= res->len)
+    {
+      assert (!digit);
+      continue;
+    }
+    res->bits[res->len - 1 - pos / BTOR_BV_TYPE_BW] |= (BTOR_BV_TYPE) digit
+                                                       << (pos % BTOR_BV_TYPE_BW);
+  }
+  assert (rem_bits_zero_dbg (res));
+#endif
+  return res;
+}
+
+BtorBitVector *
+btor_bv_dec_to_bv (BtorMemMgr *mm, const char *str, uint32_t bw)
+{
+  assert (mm);
+  assert (str);
+  assert (bw > 0);
+
+  BtorBitVector *res;
+
+#ifdef BTOR_USE_GMP
+  BTOR_NEW (mm, res);
+  res->width = bw;
+  mpz_init_set_str (res->val, str, 10);
+  if (mpz_sizeinbase (res->val, 2) > bw)
+  {
     btor_bv_free (mm, res);
-    res = tmp;
+    return 0;
+  }
+#else
+  int64_t i;
+  uint32_t n, mul, add;
+  uint64_t x, carry;
+  const char *p;
+
+  res = btor_bv_new (mm, bw);
+  for (p = str; *p;)
+  {
+    /* process up to 9 digits at once (10^9 < 2^32) */
+    for (n = 0, mul = 1, add = 0; n < 9 && *p; n++, p++)
+    {
+      assert (isdigit ((unsigned char) *p));
+      mul *= 10;
+      add = add * 10 + (*p - '0');
+    }
+    carry = add;
+    for (i = res->len - 1; i >= 0; i--)
+    {
+      x            = (uint64_t) res->bits[i] * mul + carry;
+      res->bits[i] = (BTOR_BV_TYPE) x;
+      carry        = x >> BTOR_BV_TYPE_BW;
+    }
+    if (carry
+        || (bw % BTOR_BV_TYPE_BW
+            && res->bits[0] >> (bw % BTOR_BV_TYPE_BW)))
+    {
+      btor_bv_free (mm, res);
+      return 0;
+    }
   }
 #endif
   return res;
@@ -833,6 +875,32 @@ btor_bv_to_uint64 (const BtorBitVector *bv)
   return res;
 }
 
+void
+btor_bv_to_uint64_words (const BtorBitVector *bv,
+                         uint64_t *words,
+                         uint32_t nwords)
+{
+  assert (bv);
+  assert (words);
+  assert (nwords >= (bv->width + 63) / 64);
+
+  uint32_t i;
+
+#ifdef BTOR_USE_GMP
+  size_t count;
+  mpz_export (words, &count, -1, sizeof (uint64_t), 0, 0, bv->val);
+  i = count;
+#else
+  uint32_t j;
+  for (i = 0, j = bv->len; j > 0; i++)
+  {
+    words[i] = bv->bits[--j];
+    if (j > 0) words[i] |= ((uint64_t) bv->bits[--j]) << BTOR_BV_TYPE_BW;
+  }
+#endif
+  for (; i < nwords; i++) words[i] = 0;
+}
+
 /*------------------------------------------------------------------------*/
 
 uint32_t
@@ -69,6 +69,10 @@ BtorBitVector *btor_bv_constd (BtorMemMgr *mm, const char *str, uint32_t bw);
 /* Create bit-vector of given bit-width from given hexadecimal string. */
 BtorBitVector *btor_bv_consth (BtorMemMgr *mm, const char *str, uint32_t bw);
 
+/* Create bit-vector of given bit-width from given unsigned decimal string.
+ * Returns 0 if the value does not fit into 'bw' bits. */
+BtorBitVector *btor_bv_dec_to_bv (BtorMemMgr *mm, const char *str, uint32_t bw);
+
 /* Get AIG vector assignment of given node as bit-vector. */
 BtorBitVector *btor_bv_get_assignment (BtorMemMgr *mm, BtorNode *exp);
 
@@ -115,6 +119,12 @@ char *btor_bv_to_dec_char (BtorMemMgr *mm, const BtorBitVector *bv);
 /* Convert given bit-vector to an unsigned 64 bit integer. */
 uint64_t btor_bv_to_uint64 (const BtorBitVector *bv);
 
+/* Convert given bit-vector to 'nwords' unsigned 64 bit words, least
+ * significant word first.  Words beyond the width of 'bv' are set to zero. */
+void btor_bv_to_uint64_words (const BtorBitVector *bv,
+                              uint64_t *words,
+                              uint32_t nwords);
+
 /*------------------------------------------------------------------------*/
 
 /* Get the bit-width of given bit-vector. */
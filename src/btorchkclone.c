@@ -202,6 +202,9 @@ chkclone_state (Btor *btor, Btor *clone)
   BTOR_CHKCLONE_STATE (vis_idx);
   BTOR_CHKCLONE_STATE (inconsistent);
   BTOR_CHKCLONE_STATE (found_constraint_false);
+  BTOR_CHKCLONE_STATE (lazy_model);
+  BTOR_CHKCLONE_STATE (synthesized_unencoded);
+  BTOR_CHKCLONE_STATE (simplified);
   BTOR_CHKCLONE_STATE (external_refs);
   BTOR_CHKCLONE_STATE (btor_sat_btor_called);
   BTOR_CHKCLONE_STATE (last_sat_result);
@@ -246,11 +249,13 @@ chkclone_stats (Btor *btor, Btor *clone)
   BTOR_CHKCLONE_STATS (muls_normalized);
   BTOR_CHKCLONE_STATS (muls_normalized);
   BTOR_CHKCLONE_STATS (ackermann_constraints);
+  BTOR_CHKCLONE_STATS (simplifications_skipped);
   BTOR_CHKCLONE_STATS (bv_uc_props);
   BTOR_CHKCLONE_STATS (fun_uc_props);
   BTOR_CHKCLONE_STATS (lambdas_merged);
   BTOR_CHKCLONE_STATS (expressions);
   BTOR_CHKCLONE_STATS (clone_calls);
+  BTOR_CHKCLONE_STATS (parallel_checks);
   BTOR_CHKCLONE_STATS (node_bytes_alloc);
   BTOR_CHKCLONE_STATS (beta_reduce_calls);
 
@@ -549,7 +554,6 @@ btor_chkclone_exp (Btor *btor,
   else if (real_exp->rho)
     chkclone_node_ptr_hash_table (real_exp->rho, real_cexp->rho, 0);
 
-  BTOR_CHKCLONE_EXPPTRID (next);
   BTOR_CHKCLONE_EXPPTRID (simplified);
   BTOR_CHKCLONE_EXPPTRID (first_parent);
   BTOR_CHKCLONE_EXPPTRID (last_parent);
@@ -732,12 +736,28 @@ chkclone_node_id_table (Btor *btor, Btor *clone)
 
 /*------------------------------------------------------------------------*/
 
-/* Note: no need to check next pointers here as we catch all of them when
- *	 traversing through nodes id table. */
 static inline void
-chkclone_node_unique_table (Btor *btor, Btor *clone)
+chkclone_node_unique_table_slots (BtorNodeUniqueTableSlot *bslots,
+                                  BtorNodeUniqueTableSlot *cslots,
+                                  uint32_t size)
 {
   uint32_t i;
+
+  for (i = 0; i < size; i++)
+  {
+    if (!bslots[i].exp)
+    {
+      assert (!cslots[i].exp);
+      continue;
+    }
+    assert (bslots[i].hash == cslots[i].hash);
+    BTOR_CHKCLONE_EXPID (bslots[i].exp, cslots[i].exp);
+  }
+}
+
+static inline void
+chkclone_node_unique_table (Btor *btor, Btor *clone)
+{
   BtorNodeUniqueTable *btable, *ctable;
 
   btable = &btor->nodes_unique_table;
@@ -745,16 +765,14 @@ chkclone_node_unique_table (Btor *btor, Btor *clone)
   assert (btable != ctable);
   assert (btable->size == ctable->size);
   assert (btable->num_elements == ctable->num_elements);
-
-  for (i = 0; i < btable->size; i++)
-  {
-    if (!btable->chains[i])
-    {
-      assert (!ctable->chains[i]);
-      continue;
-    }
-    BTOR_CHKCLONE_EXPID (btable->chains[i], ctable->chains[i]);
-  }
+  assert (btable->old_size == ctable->old_size);
+  assert (btable->old_start == ctable->old_start);
+  assert (btable->old_pos == ctable->old_pos);
+
+  chkclone_node_unique_table_slots (btable->slots, ctable->slots, btable->size);
+  if (btable->old_slots)
+    chkclone_node_unique_table_slots (
+        btable->old_slots, ctable->old_slots, btable->old_size);
 }
 
 /*------------------------------------------------------------------------*/
@@ -1084,6 +1102,9 @@ chkclone_slv (Btor *btor, Btor *clone)
     BTOR_CHKCLONE_SLV_STATS (slv, cslv, function_congruence_conflicts);
     BTOR_CHKCLONE_SLV_STATS (slv, cslv, beta_reduction_conflicts);
     BTOR_CHKCLONE_SLV_STATS (slv, cslv, extensionality_lemmas);
+    BTOR_CHKCLONE_SLV_STATS (slv, cslv, update_axioms);
+    BTOR_CHKCLONE_SLV_STATS (slv, cslv, reused_lemmas);
+    BTOR_CHKCLONE_SLV_STATS (slv, cslv, deferred_lemmas);
     BTOR_CHKCLONE_SLV_STATS (slv, cslv, lemmas_size_sum);
     BTOR_CHKCLONE_SLV_STATS (slv, cslv, dp_failed_vars);
     BTOR_CHKCLONE_SLV_STATS (slv, cslv, dp_assumed_vars);
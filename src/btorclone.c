@@ -83,21 +83,6 @@ btor_clone_key_as_bv_tuple (BtorMemMgr *mm, const void *map, const void *t)
   return btor_bv_copy_tuple (mm, (BtorBitVectorTuple *) t);
 }
 
-void *
-btor_clone_key_as_rw_cache_tuple (BtorMemMgr *mm,
-                                  const void *map,
-                                  const void *t)
-{
-  assert (mm);
-  assert (t);
-  (void) map;
-
-  BtorRwCacheTuple *res;
-  BTOR_CNEW (mm, res);
-  memcpy (res, t, sizeof (BtorRwCacheTuple));
-  return res;
-}
-
 void
 btor_clone_data_as_node_ptr (BtorMemMgr *mm,
                              const void *map,
@@ -220,20 +205,10 @@ btor_clone_data_as_int_htable (BtorMemMgr *mm,
 
   table = (BtorIntHashTable *) data->as_ptr;
 
-  res = btor_hashint_table_new (mm);
-
-  BTOR_DELETEN (mm, res->keys, res->size);
-  BTOR_DELETEN (mm, res->hop_info, res->size);
-
-  res->size  = table->size;
-  res->count = table->count;
-  BTOR_CNEWN (mm, res->keys, res->size);
-  BTOR_CNEWN (mm, res->hop_info, res->size);
-  if (table->data) BTOR_CNEWN (mm, res->data, res->size);
-
-  memcpy (res->keys, table->keys, table->size);
-  memcpy (res->hop_info, table->hop_info, table->size);
-  if (table->data) memcpy (res->data, table->data, table->size);
+  if (table->data)
+    res = btor_hashint_map_clone (mm, table, 0, 0);
+  else
+    res = btor_hashint_table_clone (mm, table);
 
   cloned_data->as_ptr = res;
 }
@@ -533,9 +508,6 @@ clone_exp (Btor *clone,
   else if (exp->av)
     res->av = exp_layer_only ? 0 : btor_aigvec_clone (exp->av, clone->avmgr);
 
-  assert (!exp->next || !btor_node_is_invalid (exp->next));
-  BTOR_PUSH_STACK_IF (exp->next, *nodes, &res->next);
-
   assert (!btor_node_is_simplified (exp) || !btor_node_is_invalid (exp->simplified));
   if (clone_simplified || btor_node_is_proxy (exp))
   {
@@ -615,8 +587,6 @@ clone_exp (Btor *clone,
                         &((BtorBinderNode *) res)->body);
   }
 
-  btor_nodemap_map (exp_map, exp, res);
-
   return res;
 }
 
@@ -696,7 +666,7 @@ clone_nodes_id_table (Btor *btor,
 
   if (BTOR_SIZE_STACK (*id_table))
   {
-    BTOR_NEWN (mm, res->start, BTOR_SIZE_STACK (*id_table));
+    BTOR_CNEWN (mm, res->start, BTOR_SIZE_STACK (*id_table));
     res->top      = res->start + BTOR_COUNT_STACK (*id_table);
     res->end      = res->start + BTOR_SIZE_STACK (*id_table);
     res->start[0] = 0;
@@ -765,6 +735,26 @@ clone_nodes_id_table (Btor *btor,
   BTOR_RELEASE_STACK (static_rhos);
 }
 
+static BtorNodeUniqueTableSlot *
+clone_nodes_unique_table_slots (BtorMemMgr *mm,
+                                BtorNodeUniqueTableSlot *slots,
+                                uint32_t size,
+                                BtorNodeMap *exp_map)
+{
+  uint32_t i;
+  BtorNodeUniqueTableSlot *res;
+
+  BTOR_CNEWN (mm, res, size);
+  for (i = 0; i < size; i++)
+  {
+    if (!slots[i].exp) continue;
+    res[i].hash = slots[i].hash;
+    res[i].exp  = btor_nodemap_mapped (exp_map, slots[i].exp);
+    assert (res[i].exp);
+  }
+  return res;
+}
+
 static void
 clone_nodes_unique_table (Btor *btor, Btor *clone, BtorNodeMap *exp_map)
 {
@@ -772,7 +762,6 @@ clone_nodes_unique_table (Btor *btor, Btor *clone, BtorNodeMap *exp_map)
   assert (clone);
   assert (exp_map);
 
-  uint32_t i;
   BtorNodeUniqueTable *table, *res;
   BtorMemMgr *mm;
 
@@ -780,16 +769,12 @@ clone_nodes_unique_table (Btor *btor, Btor *clone, BtorNodeMap *exp_map)
   table = &btor->nodes_unique_table;
   res   = &clone->nodes_unique_table;
 
-  BTOR_CNEWN (mm, res->chains, table->size);
-  res->size         = table->size;
-  res->num_elements = table->num_elements;
-
-  for (i = 0; i < table->size; i++)
-  {
-    if (!table->chains[i]) continue;
-    res->chains[i] = btor_nodemap_mapped (exp_map, table->chains[i]);
-    assert (res->chains[i]);
-  }
+  *res = *table;
+  res->slots =
+      clone_nodes_unique_table_slots (mm, table->slots, table->size, exp_map);
+  if (table->old_slots)
+    res->old_slots = clone_nodes_unique_table_slots (
+        mm, table->old_slots, table->old_size, exp_map);
 }
 
 #define MEM_INT_HASH_TABLE(table)                                 \
@@ -802,10 +787,8 @@ clone_nodes_unique_table (Btor *btor, Btor *clone, BtorNodeMap *exp_map)
                  + (table)->size * sizeof (BtorHashTableData) \
            : 0)
 
-#define MEM_PTR_HASH_TABLE(table)                                             \
-  ((table) ? sizeof (*(table)) + (table)->size * sizeof (BtorPtrHashBucket *) \
-                 + (table)->count * sizeof (BtorPtrHashBucket)                \
-           : 0)
+#define MEM_PTR_HASH_TABLE(table) \
+  ((table) ? btor_hashptr_table_size (table) : 0)
 
 #define CHKCLONE_MEM_INT_HASH_TABLE(table, clone)                      \
   do                                                                   \
@@ -860,6 +843,23 @@ clone_nodes_unique_table (Btor *btor, Btor *clone, BtorNodeMap *exp_map)
 
 #define MEM_BITVEC(bv) ((bv) ? btor_bv_size (bv) : 0)
 
+/* Set the message prefix of 'clone' to the prefix of 'btor' followed by
+ * ">clone". */
+static void
+set_clone_msg_prefix (Btor *btor, Btor *clone)
+{
+  size_t len;
+  char *prefix;
+  const char *btor_prefix;
+
+  btor_prefix = btor->msg->prefix ? btor->msg->prefix : "";
+  len         = strlen (btor_prefix) + strlen (">clone") + 1;
+  BTOR_NEWN (clone->mm, prefix, len);
+  sprintf (prefix, "%s>clone", btor_prefix);
+  btor_set_msg_prefix (clone, prefix);
+  BTOR_DELETEN (clone->mm, prefix, len);
+}
+
 static Btor *
 clone_aux_btor (Btor *btor,
                 BtorNodeMap **exp_map,
@@ -874,8 +874,7 @@ clone_aux_btor (Btor *btor,
   BtorNodeMap *emap = 0;
   BtorMemMgr *mm;
   double start, delta;
-  uint32_t i, len;
-  char *prefix, *clone_prefix;
+  uint32_t i;
   BtorNode *exp, *cloned_exp;
   BtorPtrHashTableIterator pit;
   BtorNodePtrStack rhos;
@@ -951,17 +950,9 @@ clone_aux_btor (Btor *btor,
   clone->msg = btor_msg_new (clone);
   assert ((allocated += sizeof (BtorMsg)) == clone->mm->allocated);
 
-  /* set msg prefix for clone */
-  clone_prefix = "clone";
-  len          = btor->msg->prefix ? strlen (btor->msg->prefix) : 0;
-  len += strlen (clone_prefix) + 1;
-#ifndef NDEBUG
-  allocated += len + 1;
-#endif
-  BTOR_NEWN (clone->mm, prefix, len + 1);
-  sprintf (prefix, "%s>%s", btor->msg->prefix, clone_prefix);
-  btor_set_msg_prefix (clone, prefix);
-  BTOR_DELETEN (clone->mm, prefix, len + 1);
+  set_clone_msg_prefix (btor, clone);
+  assert ((allocated += strlen (clone->msg->prefix) + 1)
+          == clone->mm->allocated);
 
   if (exp_layer_only)
   {
@@ -1036,7 +1027,9 @@ clone_aux_btor (Btor *btor,
           /* unique table chain */
           + amgr->table.size * sizeof (int32_t)
           + BTOR_SIZE_STACK (amgr->id2aig) * sizeof (BtorAIG *)
-          + BTOR_SIZE_STACK (amgr->cnfid2aig) * sizeof (int32_t);
+          + BTOR_SIZE_STACK (amgr->cnfid2aig) * sizeof (int32_t)
+          + BTOR_SIZE_STACK (amgr->smgr->scopes) * sizeof (int32_t)
+          + BTOR_SIZE_STACK (amgr->smgr->popped) * sizeof (int32_t);
 #ifdef BTOR_USE_LINGELING
       assert (strcmp (amgr->smgr->name, "Lingeling") == 0
               || strcmp (amgr->smgr->name, "DIMACS Printer") == 0);
@@ -1078,9 +1071,11 @@ clone_aux_btor (Btor *btor,
   assert (allocated == clone->mm->allocated);
 #endif
 
-  emap = btor_nodemap_new (clone);
-  assert ((allocated += sizeof (*emap) + MEM_PTR_HASH_TABLE (emap->table))
-          == clone->mm->allocated);
+  /* Node ids are preserved, hence nodes are mapped via the id table of the
+   * clone rather than a (huge) hash table that owns references to all nodes
+   * of both instances. */
+  emap = btor_nodemap_new_by_id (clone, clone);
+  assert ((allocated += sizeof (*emap)) == clone->mm->allocated);
 
   BTOR_INIT_STACK (btor->mm, rhos);
   BTORLOG_TIMESTAMP (delta);
@@ -1111,10 +1106,7 @@ clone_aux_btor (Btor *btor,
     if (btor_node_is_lambda (cur) && btor_node_lambda_get_static_rho (cur))
       allocated += MEM_PTR_HASH_TABLE (btor_node_lambda_get_static_rho (cur));
   }
-  /* Note: hash table is initialized with size 1 */
-  allocated += (emap->table->size - 1) * sizeof (BtorPtrHashBucket *)
-               + emap->table->count * sizeof (BtorPtrHashBucket)
-               + BTOR_SIZE_STACK (btor->nodes_id_table) * sizeof (BtorNode *);
+  allocated += BTOR_SIZE_STACK (btor->nodes_id_table) * sizeof (BtorNode *);
   assert (allocated == clone->mm->allocated);
 #endif
 
@@ -1126,7 +1118,9 @@ clone_aux_btor (Btor *btor,
   BTORLOG (2,
            "  clone nodes unique table: %.3f s",
            (btor_util_time_stamp () - delta));
-  assert ((allocated += btor->nodes_unique_table.size * sizeof (BtorNode *))
+  assert ((allocated += (btor->nodes_unique_table.size
+                         + btor->nodes_unique_table.old_size)
+                        * sizeof (BtorNodeUniqueTableSlot))
           == clone->mm->allocated);
 
   clone->symbols = btor_hashptr_table_clone (mm,
@@ -1226,6 +1220,22 @@ clone_aux_btor (Btor *btor,
            BTOR_SIZE_STACK (btor->assertions_trail) * sizeof (uint32_t))
           == clone->mm->allocated);
 
+  btor_clone_node_ptr_stack (
+      mm, &btor->scope_constraints, &clone->scope_constraints, emap, false);
+  assert ((allocated +=
+           BTOR_SIZE_STACK (btor->scope_constraints) * sizeof (BtorNode *))
+          == clone->mm->allocated);
+
+  BTOR_INIT_STACK (clone->mm, clone->scope_constraints_trail);
+  for (i = 0; i < BTOR_COUNT_STACK (btor->scope_constraints_trail); i++)
+    BTOR_PUSH_STACK (clone->scope_constraints_trail,
+                     BTOR_PEEK_STACK (btor->scope_constraints_trail, i));
+  BTOR_ADJUST_STACK (btor->scope_constraints_trail,
+                     clone->scope_constraints_trail);
+  assert ((allocated +=
+           BTOR_SIZE_STACK (btor->scope_constraints_trail) * sizeof (uint32_t))
+          == clone->mm->allocated);
+
   if (btor->bv_model)
   {
     clone->bv_model = btor_model_clone_bv (clone, btor->bv_model, false);
@@ -1365,14 +1375,24 @@ clone_aux_btor (Btor *btor,
   assert (allocated == clone->mm->allocated);
 #endif
   BTOR_NEW (mm, clone->rw_cache);
-  clone->rw_cache->btor  = clone;
-  clone->rw_cache->cache = btor_hashptr_table_clone (
-      mm, btor->rw_cache->cache, btor_clone_key_as_rw_cache_tuple, 0, 0, 0);
+  memcpy (clone->rw_cache, btor->rw_cache, sizeof (BtorRwCache));
+  clone->rw_cache->btor = clone;
+  BTOR_NEWN (mm, clone->rw_cache->cache, btor->rw_cache->size);
+  memcpy (clone->rw_cache->cache,
+          btor->rw_cache->cache,
+          btor->rw_cache->size * sizeof (BtorRwCacheTuple));
+  /* node ids are preserved, hence the structural hashes are still valid */
+  BTOR_INIT_STACK (mm, clone->rw_cache->hashes);
+  if (BTOR_SIZE_STACK (btor->rw_cache->hashes))
+  {
+    BTOR_FIT_STACK (clone->rw_cache->hashes,
+                    BTOR_SIZE_STACK (btor->rw_cache->hashes) - 1);
+    memcpy (clone->rw_cache->hashes.start,
+            btor->rw_cache->hashes.start,
+            BTOR_SIZE_STACK (btor->rw_cache->hashes) * sizeof (uint64_t));
+  }
 #ifndef NDEBUG
-  CHKCLONE_MEM_PTR_HASH_TABLE (btor->rw_cache->cache, clone->rw_cache->cache);
-  allocated += sizeof (*btor->rw_cache);
-  allocated += btor->rw_cache->cache->count * sizeof (BtorRwCacheTuple);
-  allocated += MEM_PTR_HASH_TABLE (btor->rw_cache->cache);
+  allocated += btor_rw_cache_size (btor->rw_cache);
 #endif
 
   /* move synthesized constraints to unsynthesized if we only clone the exp
@@ -1482,9 +1502,9 @@ clone_aux_btor (Btor *btor,
       {
         assert (BTOR_PEEK_STACK (cslv->moves, i));
         m = BTOR_PEEK_STACK (cslv->moves, i);
-        assert (MEM_PTR_HASH_TABLE (m->cans)
-                == MEM_PTR_HASH_TABLE (BTOR_PEEK_STACK (cslv->moves, i)->cans));
-        allocated += MEM_PTR_HASH_TABLE (m->cans);
+        assert (MEM_INT_HASH_MAP (m->cans)
+                == MEM_INT_HASH_MAP (BTOR_PEEK_STACK (cslv->moves, i)->cans));
+        allocated += MEM_INT_HASH_MAP (m->cans);
         btor_iter_hashint_init (&iit, m->cans);
         while (btor_iter_hashint_has_next (&iit))
           allocated +=
@@ -1495,7 +1515,7 @@ clone_aux_btor (Btor *btor,
       {
         assert (slv->max_cans);
         assert (slv->max_cans->count == cslv->max_cans->count);
-        allocated += MEM_PTR_HASH_TABLE (cslv->max_cans);
+        allocated += MEM_INT_HASH_MAP (cslv->max_cans);
         btor_iter_hashint_init (&iit, cslv->max_cans);
         while (btor_iter_hashint_has_next (&iit))
           allocated +=
@@ -1510,8 +1530,8 @@ clone_aux_btor (Btor *btor,
       CHKCLONE_MEM_INT_HASH_MAP (slv->roots, cslv->roots);
       CHKCLONE_MEM_INT_HASH_MAP (slv->score, cslv->score);
 
-      allocated += sizeof (BtorPropSolver) + MEM_PTR_HASH_TABLE (cslv->roots)
-                   + MEM_PTR_HASH_TABLE (cslv->score);
+      allocated += sizeof (BtorPropSolver) + MEM_INT_HASH_MAP (cslv->roots)
+                   + MEM_INT_HASH_MAP (cslv->score);
     }
     else if (clone->slv->kind == BTOR_AIGPROP_SOLVER_KIND)
     {
@@ -1521,13 +1541,13 @@ clone_aux_btor (Btor *btor,
       if (slv->aprop)
       {
         assert (cslv->aprop);
-        CHKCLONE_MEM_PTR_HASH_TABLE (slv->aprop->roots, cslv->aprop->roots);
-        CHKCLONE_MEM_PTR_HASH_TABLE (slv->aprop->score, cslv->aprop->score);
-        CHKCLONE_MEM_PTR_HASH_TABLE (slv->aprop->model, cslv->aprop->model);
+        CHKCLONE_MEM_INT_HASH_MAP (slv->aprop->roots, cslv->aprop->roots);
+        CHKCLONE_MEM_INT_HASH_MAP (slv->aprop->score, cslv->aprop->score);
+        CHKCLONE_MEM_INT_HASH_MAP (slv->aprop->model, cslv->aprop->model);
         allocated += sizeof (BtorAIGProp)
-                     + MEM_PTR_HASH_TABLE (cslv->aprop->roots)
-                     + MEM_PTR_HASH_TABLE (cslv->aprop->score)
-                     + MEM_PTR_HASH_TABLE (cslv->aprop->model);
+                     + MEM_INT_HASH_MAP (cslv->aprop->roots)
+                     + MEM_INT_HASH_MAP (cslv->aprop->score)
+                     + MEM_INT_HASH_MAP (cslv->aprop->model);
       }
 
       allocated += sizeof (BtorAIGPropSolver);
@@ -1544,9 +1564,17 @@ clone_aux_btor (Btor *btor,
   clone->close_apitrace = 0;
 
   if (exp_map)
-    *exp_map = emap;
-  else
-    btor_nodemap_delete (emap);
+  {
+    *exp_map = btor_nodemap_new (clone);
+    for (i = 1; i < BTOR_COUNT_STACK (btor->nodes_id_table); i++)
+    {
+      if (!(exp = BTOR_PEEK_STACK (btor->nodes_id_table, i))) continue;
+      cloned_exp = BTOR_PEEK_STACK (clone->nodes_id_table, i);
+      assert (cloned_exp);
+      btor_nodemap_map (*exp_map, exp, cloned_exp);
+    }
+  }
+  btor_nodemap_delete (emap);
 
 #ifndef NDEBUG
   /* flag sanity checks */
@@ -1862,10 +1890,14 @@ btor_clone_recursively_rebuild_exp (Btor *btor,
         case BTOR_FORALL_NODE:
           cur_clone = btor_exp_forall (clone, e[0], e[1]);
           break;
+        case BTOR_UPDATE_NODE:
+          cur_clone = btor_exp_update (clone, e[0], e[1], e[2]);
+          break;
         default:
-          assert (btor_node_is_bv_cond (cur));
+          assert (btor_node_is_cond (cur));
           cur_clone = btor_exp_cond (clone, e[0], e[1], e[2]);
       }
+      if (cur->is_array) btor_node_real_addr (cur_clone)->is_array = 1;
       btor_nodemap_map (exp_map, cur, cur_clone);
       btor_node_release (clone, cur_clone);
     }
@@ -1878,3 +1910,52 @@ btor_clone_recursively_rebuild_exp (Btor *btor,
   btor_opt_set (clone, BTOR_OPT_REWRITE_LEVEL, rwl);
   return btor_node_copy (clone, btor_nodemap_mapped (exp_map, exp));
 }
+
+Btor *
+btor_clone_cone (Btor *btor,
+                 BtorNode **roots,
+                 uint32_t nroots,
+                 BtorNodeMap **exp_map)
+{
+  assert (btor);
+  assert (!nroots || roots);
+  assert (exp_map);
+
+  uint32_t i;
+  double start;
+  Btor *clone;
+  BtorNode *simp, *cloned_exp;
+  BtorNodeMap *emap;
+
+  BTORLOG (2, "start cloning cone of %u roots of btor %p ...", nroots, btor);
+  start = btor_util_time_stamp ();
+  btor->stats.clone_calls += 1;
+
+  clone = btor_new ();
+  btor_opt_delete_opts (clone);
+  btor_opt_clone_opts (btor, clone);
+  /* release references still held by the caller on deletion */
+  btor_opt_set (clone, BTOR_OPT_AUTO_CLEANUP, 1);
+  btor_opt_set (clone, BTOR_OPT_AUTO_CLEANUP_INTERNAL, 1);
+
+  set_clone_msg_prefix (btor, clone);
+
+  /* Rebuild without rewriting, the cone has already been rewritten in
+   * 'btor'.  Simplified roots are mapped to the clone of their
+   * simplification. */
+  emap = btor_nodemap_new (clone);
+  for (i = 0; i < nroots; i++)
+  {
+    simp       = btor_node_get_simplified (btor, roots[i]);
+    cloned_exp =
+        btor_clone_recursively_rebuild_exp (btor, clone, simp, emap, 0);
+    if (!btor_nodemap_mapped (emap, roots[i]))
+      btor_nodemap_map (emap, roots[i], cloned_exp);
+    btor_node_release (clone, cloned_exp);
+  }
+  *exp_map = emap;
+
+  btor->time.cloning += btor_util_time_stamp () - start;
+  BTORLOG (2, "cloning total: %.3f s", btor->time.cloning);
+  return clone;
+}
@@ -22,6 +22,18 @@ Btor *btor_clone_exp_layer (Btor *btor,
 /* Clone the expression layer and no btor->slv */
 Btor *btor_clone_formula (Btor *btor);
 
+/* Clone the cone of influence of the 'nroots' expressions 'roots' of an
+ * existing boolector instance into a new boolector instance with the same
+ * options.  Only the expressions below the roots (and the sorts and symbols
+ * they require) are cloned, the roots are not asserted in the clone.  The
+ * returned 'exp_map' maps the roots and all expressions in their cone to
+ * their clones and has to be deleted before the clone.
+ */
+Btor *btor_clone_cone (Btor *btor,
+                       BtorNode **roots,
+                       uint32_t nroots,
+                       BtorNodeMap **exp_map);
+
 /* Rebuild 'exp' (and all expressions below) of an existing boolector instance
  * 'btor' in an existing boolector instance 'clone' with rewrite level
  * 'rewrite_level'. 'exp_map' must contain all previously cloned expressions.
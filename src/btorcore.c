@@ -53,6 +53,24 @@
     BTOR_DELETEN (mm, (table).chains, (table).size); \
   } while (0)
 
+#define BTOR_INIT_NODE_UNIQUE_TABLE(mm, table) \
+  do                                           \
+  {                                            \
+    assert (mm);                               \
+    BTOR_CLR (&(table));                       \
+    (table).size = 1;                          \
+    BTOR_CNEW (mm, (table).slots);             \
+  } while (0)
+
+#define BTOR_RELEASE_NODE_UNIQUE_TABLE(mm, table)             \
+  do                                                          \
+  {                                                           \
+    assert (mm);                                              \
+    BTOR_DELETEN (mm, (table).slots, (table).size);           \
+    if ((table).old_slots)                                    \
+      BTOR_DELETEN (mm, (table).old_slots, (table).old_size); \
+  } while (0)
+
 #define BTOR_INIT_SORT_UNIQUE_TABLE(mm, table) \
   do                                           \
   {                                            \
@@ -392,13 +410,11 @@ number_of_ops (Btor *btor)
   return result;
 }
 
-#ifdef BTOR_TIME_STATISTICS
 static double
 percent (double a, double b)
 {
   return b ? 100.0 * a / b : 0.0;
 }
-#endif
 
 void
 btor_print_stats (Btor *btor)
@@ -488,6 +504,10 @@ btor_print_stats (Btor *btor)
             1,
             "%5d extracted skeleton constraints",
             btor->stats.skeleton_constraints);
+  BTOR_MSG (btor->msg,
+            1,
+            "%5d simplifications skipped",
+            btor->stats.simplifications_skipped);
   BTOR_MSG (
       btor->msg, 1, "%5d and normalizations", btor->stats.ands_normalized);
   BTOR_MSG (
@@ -506,20 +526,39 @@ btor_print_stats (Btor *btor)
   BTOR_MSG (
       btor->msg, 1, "%5lld beta reductions", btor->stats.beta_reduce_calls);
   BTOR_MSG (btor->msg, 1, "%5lld clone calls", btor->stats.clone_calls);
+  BTOR_MSG (
+      btor->msg, 1, "%5lld parallel checks", btor->stats.parallel_checks);
 
   BTOR_MSG (btor->msg, 1, "");
   BTOR_MSG (btor->msg, 1, "rewrite rule cache");
   BTOR_MSG (btor->msg, 1, "  %lld cached (add) ", btor->rw_cache->num_add);
   BTOR_MSG (btor->msg, 1, "  %lld cached (get)", btor->rw_cache->num_get);
+  BTOR_MSG (btor->msg,
+            1,
+            "  %lld hits (%.1f %%)",
+            btor->rw_cache->num_hits,
+            percent (btor->rw_cache->num_hits, btor->rw_cache->num_get));
+  BTOR_MSG (btor->msg,
+            1,
+            "  %lld misses",
+            btor->rw_cache->num_get - btor->rw_cache->num_hits);
   BTOR_MSG (btor->msg, 1, "  %lld updated", btor->rw_cache->num_update);
   BTOR_MSG (btor->msg, 1, "  %lld removed (gc)", btor->rw_cache->num_remove);
+  BTOR_MSG (btor->msg, 1, "  %lld evicted", btor->rw_cache->num_evict);
+  if (btor_opt_get (btor, BTOR_OPT_RW_CACHE_SHARED))
+  {
+    BTOR_MSG (btor->msg,
+              1,
+              "  %lld shared hits (%.1f %%)",
+              btor->rw_cache->num_shared_hits,
+              percent (btor->rw_cache->num_shared_hits,
+                       btor->rw_cache->num_shared_get));
+  }
   BTOR_MSG (btor->msg,
             1,
-            "  %.2f MB cache",
-            (btor->rw_cache->cache->count * sizeof (BtorRwCacheTuple)
-             + btor->rw_cache->cache->count * sizeof (BtorPtrHashBucket)
-             + btor->rw_cache->cache->size * sizeof (BtorPtrHashBucket *))
-                / (double) (1 << 20));
+            "  %.2f MB cache (%u entries)",
+            btor_rw_cache_size (btor->rw_cache) / (double) (1 << 20),
+            btor->rw_cache->count);
 
 #ifndef NDEBUG
   BtorPtrHashTableIterator it;
@@ -568,6 +607,14 @@ btor_print_stats (Btor *btor)
             1,
             "  %7lld CNF literals",
             btor->avmgr ? btor->avmgr->amgr->num_cnf_literals : 0);
+  BTOR_MSG (btor->msg,
+            1,
+            "  %7lld CNF garbage collections",
+            btor->avmgr ? btor->avmgr->amgr->num_cnf_gcs : 0);
+  BTOR_MSG (btor->msg,
+            1,
+            "  %7lld AIG id compactions",
+            btor->avmgr ? btor->avmgr->amgr->num_aig_id_gcs : 0);
 
   if (btor->slv) btor->slv->api.print_stats (btor->slv);
 
@@ -680,7 +727,7 @@ btor_new (void)
   btor->msg = btor_msg_new (btor);
   btor_set_msg_prefix (btor, "btor");
 
-  BTOR_INIT_UNIQUE_TABLE (mm, btor->nodes_unique_table);
+  BTOR_INIT_NODE_UNIQUE_TABLE (mm, btor->nodes_unique_table);
   BTOR_INIT_SORT_UNIQUE_TABLE (mm, btor->sorts_unique_table);
   BTOR_INIT_STACK (btor->mm, btor->nodes_id_table);
   BTOR_PUSH_STACK (btor->nodes_id_table, 0);
@@ -766,6 +813,8 @@ btor_new (void)
   BTOR_INIT_STACK (mm, btor->assertions);
   BTOR_INIT_STACK (mm, btor->assertions_trail);
   btor->assertions_cache = btor_hashint_table_new (mm);
+  BTOR_INIT_STACK (mm, btor->scope_constraints);
+  BTOR_INIT_STACK (mm, btor->scope_constraints_trail);
 
 #ifndef NDEBUG
   btor->stats.rw_rules_applied = btor_hashptr_table_new (
@@ -943,6 +992,11 @@ btor_delete (Btor *btor)
   BTOR_RELEASE_STACK (btor->assertions_trail);
   btor_hashint_table_delete (btor->assertions_cache);
 
+  for (i = 0; i < BTOR_COUNT_STACK (btor->scope_constraints); i++)
+    btor_node_release (btor, BTOR_PEEK_STACK (btor->scope_constraints, i));
+  BTOR_RELEASE_STACK (btor->scope_constraints);
+  BTOR_RELEASE_STACK (btor->scope_constraints_trail);
+
   btor_model_delete (btor);
   btor_node_release (btor, btor->true_exp);
 
@@ -1020,7 +1074,7 @@ btor_delete (Btor *btor)
   }
   assert (getenv ("BTORLEAK") || getenv ("BTORLEAKEXP") || !node_leak);
 #endif
-  BTOR_RELEASE_UNIQUE_TABLE (mm, btor->nodes_unique_table);
+  BTOR_RELEASE_NODE_UNIQUE_TABLE (mm, btor->nodes_unique_table);
   BTOR_RELEASE_STACK (btor->nodes_id_table);
 
   assert (getenv ("BTORLEAK") || getenv ("BTORLEAKSORT")
@@ -1138,6 +1192,10 @@ btor_process_unsynthesized_constraints (Btor *btor)
       btor_aig_release (amgr, aig);
       (void) btor_hashptr_table_add (sc, cur);
       btor_hashptr_table_remove (uc, cur, 0, 0);
+      /* clauses are guarded by the current scope, remember constraint to
+       * synthesize it again when the scope is popped */
+      if (!BTOR_EMPTY_STACK (btor->scope_constraints_trail))
+        BTOR_PUSH_STACK (btor->scope_constraints, btor_node_copy (btor, cur));
 
       btor->stats.constraints.synthesized++;
       report_constraint_stats (btor, false);
@@ -1721,6 +1779,7 @@ add_constraint (Btor *btor, BtorNode *exp)
   mark = btor_hashint_table_new (mm);
 
   if (btor->valid_assignments) btor_reset_incremental_usage (btor);
+  btor->simplified = false;
 
   if (!btor_node_is_inverted (exp) && btor_node_is_bv_and (exp))
   {
@@ -1827,6 +1886,52 @@ exp_to_cnf_lit (Btor *btor, BtorNode *exp)
   return res;
 }
 
+void
+btor_push_scope (Btor *btor)
+{
+  assert (btor);
+  assert (btor_opt_get (btor, BTOR_OPT_INCREMENTAL));
+
+  BTOR_PUSH_STACK (btor->scope_constraints_trail,
+                   BTOR_COUNT_STACK (btor->scope_constraints));
+  btor_aig_mgr_push_scope (btor_get_aig_mgr (btor));
+}
+
+void
+btor_pop_scope (Btor *btor)
+{
+  assert (btor);
+  assert (btor_opt_get (btor, BTOR_OPT_INCREMENTAL));
+  assert (!BTOR_EMPTY_STACK (btor->scope_constraints_trail));
+
+  uint32_t pos;
+  BtorNode *cur;
+  BtorPtrHashTable *uc, *sc;
+
+  uc  = btor->unsynthesized_constraints;
+  sc  = btor->synthesized_constraints;
+  pos = BTOR_POP_STACK (btor->scope_constraints_trail);
+
+  btor_aig_mgr_pop_scope (btor_get_aig_mgr (btor));
+
+  /* The clauses of constraints synthesized within the popped scope are
+   * disabled now, but these constraints (e.g., lemmas) still hold and have
+   * to be synthesized again. */
+  while (BTOR_COUNT_STACK (btor->scope_constraints) > pos)
+  {
+    cur = BTOR_POP_STACK (btor->scope_constraints);
+    if (btor_hashptr_table_get (sc, cur))
+    {
+      btor_hashptr_table_remove (sc, cur, 0, 0);
+      if (btor_hashptr_table_get (uc, cur))
+        btor_node_release (btor, cur);
+      else
+        btor_hashptr_table_add (uc, cur);
+    }
+    btor_node_release (btor, cur);
+  }
+}
+
 void
 btor_assume_exp (Btor *btor, BtorNode *exp)
 {
@@ -2870,6 +2975,95 @@ update_sat_assignments (Btor * btor)
 }
 #endif
 
+/* Disable the clauses of all scopes popped since the last call and collect
+ * CNF and AIG garbage. */
+static void
+collect_garbage (Btor *btor)
+{
+  assert (btor);
+
+  bool reset;
+  BtorPtrHashTableIterator it;
+  BtorNode *cur;
+  BtorAIGMgr *amgr;
+
+  amgr  = btor_get_aig_mgr (btor);
+  reset = btor_aig_mgr_release_popped_scopes (amgr);
+
+  if (btor_aig_mgr_collect_garbage (amgr))
+  {
+    /* the SAT solver has been reset, synthesize all constraints again */
+    btor_iter_hashptr_init (&it, btor->synthesized_constraints);
+    while (btor_iter_hashptr_has_next (&it))
+    {
+      cur = btor_iter_hashptr_next (&it);
+      if (btor_hashptr_table_get (btor->unsynthesized_constraints, cur))
+        btor_node_release (btor, cur);
+      else
+        btor_hashptr_table_add (btor->unsynthesized_constraints, cur);
+    }
+    btor_hashptr_table_delete (btor->synthesized_constraints);
+    btor->synthesized_constraints =
+        btor_hashptr_table_new (btor->mm,
+                                (BtorHashPtr) btor_node_hash_by_id,
+                                (BtorCmpPtr) btor_node_compare_by_id);
+    reset = true;
+  }
+
+  if (reset) btor_synthesized_to_sat (btor);
+}
+
+/* The assignment of a synthesized node is derived from the encodings of its
+ * AIGs (e.g., for arguments of applies that are not in the cone of any
+ * constraint), hence AIGs that have been reset or synthesized while the SAT
+ * solver was not initialized have to be encoded.  Only nodes reachable from
+ * constraints, assumptions and assertions of open scopes are encoded, the
+ * assignment of any other synthesized node is evaluated on demand if its
+ * AIGs are not encoded.  AIG variables of bv skeleton inputs are an
+ * exception, these are consistently assigned to false until they are encoded
+ * again. */
+void
+btor_synthesized_to_sat (Btor *btor)
+{
+  assert (btor);
+
+  uint32_t i;
+  BtorNode *cur;
+  BtorNodePtrStack visit;
+  BtorPtrHashTableIterator it;
+  BtorIntHashTable *mark;
+
+  if (!btor_sat_is_initialized (btor_get_sat_mgr (btor))) return;
+
+  mark = btor_hashint_table_new (btor->mm);
+  BTOR_INIT_STACK (btor->mm, visit);
+  btor_iter_hashptr_init (&it, btor->synthesized_constraints);
+  btor_iter_hashptr_queue (&it, btor->unsynthesized_constraints);
+  btor_iter_hashptr_queue (&it, btor->assumptions);
+  while (btor_iter_hashptr_has_next (&it))
+    BTOR_PUSH_STACK (visit, btor_iter_hashptr_next (&it));
+  for (i = 0; i < BTOR_COUNT_STACK (btor->assertions); i++)
+    BTOR_PUSH_STACK (visit, BTOR_PEEK_STACK (btor->assertions, i));
+
+  while (!BTOR_EMPTY_STACK (visit))
+  {
+    cur = btor_node_real_addr (
+        btor_node_get_simplified (btor, BTOR_POP_STACK (visit)));
+    if (cur->parameterized || btor_hashint_table_contains (mark, cur->id))
+      continue;
+    btor_hashint_table_add (mark, cur->id);
+    for (i = 0; i < cur->arity; i++) BTOR_PUSH_STACK (visit, cur->e[i]);
+    if (!btor_node_is_synth (cur)) continue;
+    if (btor_node_is_bv_var (cur) || btor_node_is_apply (cur)
+        || btor_node_is_fun_eq (cur))
+      continue;
+    btor_aigvec_to_sat_tseitin (btor->avmgr, cur->av);
+  }
+
+  BTOR_RELEASE_STACK (visit);
+  btor_hashint_table_delete (mark);
+}
+
 int32_t
 btor_check_sat (Btor *btor, int32_t lod_limit, int32_t sat_limit)
 {
@@ -2890,6 +3084,8 @@ btor_check_sat (Btor *btor, int32_t lod_limit, int32_t sat_limit)
 
   if (btor->valid_assignments == 1) btor_reset_incremental_usage (btor);
 
+  collect_garbage (btor);
+
   /* 'btor->assertions' contains all assertions that were asserted in context
    * levels > 0 (boolector_push). We assume all these assertions on every
    * btor_check_sat call since these assumptions are valid until the
@@ -49,11 +49,29 @@
 
 /*------------------------------------------------------------------------*/
 
+/* Open addressing table (linear probing, deletion by backward shifting)
+ * with the full hash of each node stored inline as fingerprint.  On enlarge,
+ * the previous slots are kept as 'old_slots' and moved to the new table in
+ * small chunks on each insertion instead of rehashing all nodes at once. */
+
+struct BtorNodeUniqueTableSlot
+{
+  uint32_t hash;
+  BtorNode *exp; /* 0 if slot is empty */
+};
+
+typedef struct BtorNodeUniqueTableSlot BtorNodeUniqueTableSlot;
+
 struct BtorNodeUniqueTable
 {
-  uint32_t size;
-  uint32_t num_elements;
-  BtorNode **chains;
+  uint32_t size;         /* number of slots, always a power of 2 */
+  uint32_t num_elements; /* number of nodes in slots and old_slots */
+  BtorNodeUniqueTableSlot *slots;
+  /* incremental resizing */
+  uint32_t old_size;  /* number of old slots, 0 if not resizing */
+  uint32_t old_start; /* first old slot to move (start of a cluster) */
+  uint32_t old_pos;   /* number of old slots moved so far */
+  BtorNodeUniqueTableSlot *old_slots;
 };
 
 typedef struct BtorNodeUniqueTable BtorNodeUniqueTable;
@@ -129,6 +147,10 @@ struct Btor
 
   bool inconsistent;
   bool found_constraint_false;
+  bool lazy_model; /* model values are generated on demand */
+  /* nodes have been synthesized while the SAT solver was not initialized */
+  bool synthesized_unencoded;
+  bool simplified; /* no new constraints since the last simplification */
 
   uint32_t external_refs;        /* external references (library mode) */
   uint32_t btor_sat_btor_called; /* how often is btor_check_sat been called */
@@ -154,6 +176,11 @@ struct Btor
   BtorIntHashTable *assertions_cache;
   /* saves the number of assertions on each push */
   BtorUIntStack assertions_trail;
+  /* constraints synthesized in context levels > 0, their clauses are
+   * disabled when the context level is popped */
+  BtorNodePtrStack scope_constraints;
+  /* saves the number of scope constraints on each push */
+  BtorUIntStack scope_constraints_trail;
   /* Number of push/pop calls (used for unique symbol prefixes) */
   uint32_t num_push_pop;
 
@@ -191,6 +218,8 @@ struct Btor
     uint32_t ands_normalized;       /* number of and chains normalizations */
     uint32_t muls_normalized;       /* number of mul chains normalizations */
     uint32_t ackermann_constraints;
+    uint32_t simplifications_skipped; /* simplify calls without new
+                                         constraints */
     uint_least64_t prop_apply_lambda; /* number of static props over lambdas */
     uint_least64_t prop_apply_update; /* number of static props over updates */
     uint32_t bv_uc_props;
@@ -201,6 +230,7 @@ struct Btor
     BtorConstraintStats oldconstraints;
     uint_least64_t expressions;
     uint_least64_t clone_calls;
+    uint_least64_t parallel_checks; /* number of parallel sat calls */
     size_t node_bytes_alloc;
     uint_least64_t beta_reduce_calls;
     uint_least64_t betap_reduce_calls;
@@ -272,6 +302,15 @@ void btor_assert_exp (Btor *btor, BtorNode *exp);
 /* Adds assumption. */
 void btor_assume_exp (Btor *btor, BtorNode *exp);
 
+/* Opens a new context level (see boolector_push). */
+void btor_push_scope (Btor *btor);
+
+/* Closes the current context level (see boolector_pop).  The clauses added to
+ * the SAT solver within are disabled and the CNF encodings of the AIGs
+ * encoded within are released on the next call to btor_check_sat, where
+ * constraints synthesized within are synthesized again. */
+void btor_pop_scope (Btor *btor);
+
 /* Determines if expression has been previously assumed. */
 bool btor_is_assumption_exp (Btor *btor, BtorNode *exp);
 
@@ -355,6 +394,7 @@ BtorNode *btor_substitute_nodes_node_map (Btor *btor,
 void btor_reset_incremental_usage (Btor *btor);
 void btor_add_again_assumptions (Btor *btor);
 void btor_process_unsynthesized_constraints (Btor *btor);
+void btor_synthesized_to_sat (Btor *btor);
 void btor_insert_unsynthesized_constraint (Btor *btor, BtorNode *constraint);
 void btor_set_simplified_exp (Btor *btor, BtorNode *exp, BtorNode *simplified);
 void btor_delete_varsubst_constraints (Btor *btor);
@@ -15,6 +15,7 @@
 #include <limits.h>
 #include "btorlog.h"
 #include "utils/btorhashptr.h"
+#include "utils/btornodeiter.h"
 #include "utils/btorutil.h"
 
 /*------------------------------------------------------------------------*/
@@ -51,20 +52,24 @@ btor_dbg_check_lambdas_static_rho_proxy_free (const Btor *btor)
 bool
 btor_dbg_check_unique_table_children_proxy_free (const Btor *btor)
 {
-  uint32_t i, j;
+  uint32_t j;
   BtorNode *cur;
+  BtorNodeIterator it;
 
-  for (i = 0; i < btor->nodes_unique_table.size; i++)
-    for (cur = btor->nodes_unique_table.chains[i]; cur; cur = cur->next)
-      for (j = 0; j < cur->arity; j++)
-        if (btor_node_is_proxy (cur->e[j]))
-        {
-          BTORLOG (1,
-                   "found proxy node in unique table: %s (parent: %s)",
-                   btor_util_node2string (cur->e[j]),
-                   btor_util_node2string (cur));
-          return false;
-        }
+  btor_iter_unique_table_init (&it, btor);
+  while (btor_iter_unique_table_has_next (&it))
+  {
+    cur = btor_iter_unique_table_next (&it);
+    for (j = 0; j < cur->arity; j++)
+      if (btor_node_is_proxy (cur->e[j]))
+      {
+        BTORLOG (1,
+                 "found proxy node in unique table: %s (parent: %s)",
+                 btor_util_node2string (cur->e[j]),
+                 btor_util_node2string (cur));
+        return false;
+      }
+  }
   return true;
 }
 
@@ -109,20 +114,21 @@ btor_dbg_check_hash_table_simp_free (BtorPtrHashTable *table)
 bool
 btor_dbg_check_unique_table_rebuild (const Btor *btor)
 {
-  uint32_t i;
   BtorNode *cur;
+  BtorNodeIterator it;
 
-  for (i = 0; i < btor->nodes_unique_table.size; i++)
-    for (cur = btor->nodes_unique_table.chains[i]; cur; cur = cur->next)
+  btor_iter_unique_table_init (&it, btor);
+  while (btor_iter_unique_table_has_next (&it))
+  {
+    cur = btor_iter_unique_table_next (&it);
+    if (cur->rebuild)
     {
-      if (cur->rebuild)
-      {
-        BTORLOG (1,
-                 "found node with rebuild flag enabled: %s",
-                 btor_util_node2string (cur));
-        return false;
-      }
+      BTORLOG (1,
+               "found node with rebuild flag enabled: %s",
+               btor_util_node2string (cur));
+      return false;
     }
+  }
   return true;
 }
 
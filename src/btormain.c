@@ -74,6 +74,7 @@ enum BtorMainOption
   BTORMAIN_OPT_DUMP_BTOR2,
 #endif
   BTORMAIN_OPT_DUMP_SMT,
+  BTORMAIN_OPT_DUMP_BIN,
   BTORMAIN_OPT_DUMP_AAG,
   BTORMAIN_OPT_DUMP_AIG,
   BTORMAIN_OPT_DUMP_AIGER_MERGE,
@@ -346,6 +347,18 @@ btormain_init_opts (BtorMainApp *app)
                      false,
                      BTOR_ARG_EXPECT_NONE,
                      "dump formula in SMT-LIB v2 format");
+  btormain_init_opt (app,
+                     BTORMAIN_OPT_DUMP_BIN,
+                     true,
+                     true,
+                     "dump-bin",
+                     "dbi",
+                     0,
+                     0,
+                     1,
+                     false,
+                     BTOR_ARG_EXPECT_NONE,
+                     "dump formula in binary format");
   btormain_init_opt (app,
                      BTORMAIN_OPT_DUMP_AAG,
                      true,
@@ -1217,6 +1230,10 @@ boolector_main (int32_t argc, char **argv)
 
         case BTORMAIN_OPT_DUMP_AIGER_MERGE: dump_merge = true; break;
 
+        case BTORMAIN_OPT_DUMP_BIN:
+          dump = BTOR_OUTPUT_FORMAT_BINARY;
+          goto SET_OUTPUT_FORMAT;
+
         default:
           /* get rid of compiler warnings, should be unreachable */
           assert (bmopt == BTORMAIN_OPT_NUM_OPTS);
@@ -1526,6 +1543,10 @@ boolector_main (int32_t argc, char **argv)
         if (g_verbosity) btormain_msg ("dumping in ascii AIGER format");
         boolector_dump_aiger_ascii (btor, g_app->outfile, dump_merge);
         break;
+      case BTOR_OUTPUT_FORMAT_BINARY:
+        if (g_verbosity) btormain_msg ("dumping in binary format");
+        boolector_dump_binary (btor, g_app->outfile);
+        break;
       default:
         assert (dump == BTOR_OUTPUT_FORMAT_AIGER_BINARY);
         if (g_verbosity) btormain_msg ("dumping in binary AIGER format");
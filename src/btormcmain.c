@@ -13,6 +13,7 @@
 #include "boolectormc.h"
 #include "btor2parser.h"
 #include "btormc.h"
+#include "parser/btoraiger.h"
 #include "utils/btorhashint.h"
 #include "utils/btormem.h"
 #include "utils/btoroptparse.h"
@@ -144,6 +145,8 @@ print_help (FILE *out, BtorMC *mc)
 
   fprintf (out, "usage: btormc [<option>...][<input>]\n");
   fprintf (out, "\n");
+  fprintf (out, "where <input> is a BTOR2 or an AIGER (ASCII or binary) file\n");
+  fprintf (out, "\n");
   fprintf (out, "where <option> is one of the following:\n");
   fprintf (out, "\n");
 
@@ -227,6 +230,7 @@ parse (BtorMC *mc, FILE *infile, const char *infile_name, bool checkall)
   verb    = btor_mc_get_opt (mc, BTOR_MC_OPT_VERBOSITY);
   res     = BTOR_MC_SUCC_EXIT;
   bfr     = btor2parser_new ();
+  btor    = mc->btor;
   nodemap = 0;
   sortmap = 0;
 
@@ -246,7 +250,6 @@ parse (BtorMC *mc, FILE *infile, const char *infile_name, bool checkall)
 
   sortmap = btor_hashint_map_new (mc->mm);
   nodemap = btor_hashint_map_new (mc->mm);
-  btor    = mc->btor;
 
   lit = btor2parser_iter_init (bfr);
   while ((l = btor2parser_iter_next (&lit)))
@@ -750,6 +753,48 @@ DONE:
   return res;
 }
 
+static int32_t
+parse_aiger (BtorMC *mc, FILE *infile, const char *infile_name, bool checkall)
+{
+  assert (mc);
+  assert (infile);
+  assert (infile_name);
+
+  int32_t res;
+  uint32_t verb;
+  char *err;
+
+  verb = btor_mc_get_opt (mc, BTOR_MC_OPT_VERBOSITY);
+  res  = BTOR_MC_SUCC_EXIT;
+
+  if (verb) msg ("parsing AIGER input file...");
+
+  if ((err = btor_parseaiger_mc (mc, infile, infile_name, checkall)))
+  {
+    res = error ("parse error in %s", err);
+    btor_mem_freestr (mc->mm, err);
+  }
+  else if (verb)
+    msg ("finished parsing");
+
+  return res;
+}
+
+/* AIGER files start with 'aag' or 'aig', BTOR2 lines with an id or ';'. */
+static bool
+is_aiger (FILE *infile, const char *infile_name)
+{
+  int32_t ch;
+
+  if (btor_util_file_has_suffix (infile_name, ".aig")
+      || btor_util_file_has_suffix (infile_name, ".aag"))
+    return true;
+  ch = getc (infile);
+  if (ch == EOF) return false;
+  ungetc (ch, infile);
+  return ch == 'a';
+}
+
 int32_t
 main (int32_t argc, char **argv)
 {
@@ -932,7 +977,10 @@ main (int32_t argc, char **argv)
 
   /* parse and execute ================================================ */
 
-  res = parse (mc, infile, infile_name, checkall);
+  if (is_aiger (infile, infile_name))
+    res = parse_aiger (mc, infile, infile_name, checkall);
+  else
+    res = parse (mc, infile, infile_name, checkall);
 
   if (res == BTOR_MC_SUCC_EXIT)
   {
@@ -463,6 +463,14 @@ btor_model_get_fun (Btor *btor, BtorNode *exp)
 {
   assert (btor);
   assert (exp);
+
+  /* The model of a function also contains the values of all applies on it,
+   * which are only known after evaluating the whole formula. */
+  if (btor->lazy_model)
+  {
+    btor->lazy_model = false;
+    btor_model_generate (btor, btor->bv_model, btor->fun_model, false);
+  }
   return btor_model_get_fun_aux (btor, btor->bv_model, btor->fun_model, exp);
 }
 
@@ -1443,4 +1451,5 @@ btor_model_delete (Btor *btor)
   assert (btor);
   btor_model_delete_bv (btor, &btor->bv_model);
   delete_fun_model (btor, &btor->fun_model);
+  btor->lazy_model = false;
 }
@@ -30,11 +30,14 @@
 
 /*------------------------------------------------------------------------*/
 
-#define BTOR_UNIQUE_TABLE_LIMIT 30
+#define BTOR_UNIQUE_TABLE_LIMIT 31
 
-#define BTOR_FULL_UNIQUE_TABLE(table)   \
-  ((table).num_elements >= (table).size \
-   && btor_util_log_2 ((table).size) < BTOR_UNIQUE_TABLE_LIMIT)
+/* Maximum load factor of the node unique table is 3/4. */
+#define BTOR_FULL_UNIQUE_TABLE(table) \
+  (4 * ((uint64_t) (table).num_elements + 1) > 3 * (uint64_t) (table).size)
+
+/* Number of old slots moved per insertion while resizing the unique table. */
+#define BTOR_UNIQUE_TABLE_MIGRATE 32
 
 /*------------------------------------------------------------------------*/
 
@@ -426,11 +429,9 @@ hash_binder_exp (Btor *btor,
 
 /* Computes hash value of expresssion by children ids */
 static uint32_t
-compute_hash_exp (Btor *btor, BtorNode *exp, uint32_t table_size)
+compute_hash_exp (Btor *btor, BtorNode *exp)
 {
   assert (exp);
-  assert (table_size > 0);
-  assert (btor_util_is_power_of_2 (table_size));
   assert (btor_node_is_regular (exp));
   assert (!btor_node_is_bv_var (exp));
   assert (!btor_node_is_uf (exp));
@@ -454,7 +455,6 @@ compute_hash_exp (Btor *btor, BtorNode *exp, uint32_t table_size)
                            btor_node_bv_slice_get_lower (exp));
   else
     hash = hash_bv_exp (btor, exp->kind, exp->arity, exp->e);
-  hash &= table_size - 1;
   return hash;
 }
 
@@ -487,39 +487,105 @@ setup_node_and_add_to_id_table (Btor *btor, void *ptr)
   if (btor_node_is_apply (exp)) exp->apply_below = 1;
 }
 
-/* Enlarges unique table and rehashes expressions. */
+/* Returns the position of the first slot to probe for 'hash' in 'slots',
+ * which are either the current or the old slots of the unique table.  Old
+ * slots that were already moved to the new table are empty and skipped by
+ * starting at the first old slot that has not been moved yet. */
+static inline uint32_t
+home_nodes_unique_table (BtorNodeUniqueTable *table,
+                         BtorNodeUniqueTableSlot *slots,
+                         uint32_t hash)
+{
+  uint32_t mask, pos;
+
+  if (slots == table->slots) return hash & (table->size - 1);
+
+  assert (slots == table->old_slots);
+  mask = table->old_size - 1;
+  pos  = hash & mask;
+  if (((pos - table->old_start) & mask) < table->old_pos)
+    pos = (table->old_start + table->old_pos) & mask;
+  return pos;
+}
+
+/* Moves at most 'n' old slots to the new table. */
 static void
-enlarge_nodes_unique_table (Btor *btor)
+migrate_nodes_unique_table (Btor *btor, uint32_t n)
 {
   assert (btor);
 
-  BtorMemMgr *mm;
-  uint32_t size, new_size, i;
-  uint32_t hash;
-  BtorNode *cur, *temp, **new_chains;
+  uint32_t mask, pos;
+  BtorNodeUniqueTable *table;
+  BtorNodeUniqueTableSlot *slot;
+
+  table = &btor->nodes_unique_table;
+  if (!table->old_slots) return;
 
-  mm       = btor->mm;
-  size     = btor->nodes_unique_table.size;
-  new_size = size ? 2 * size : 1;
-  BTOR_CNEWN (mm, new_chains, new_size);
-  for (i = 0; i < size; i++)
+  mask = table->size - 1;
+  for (; n > 0 && table->old_pos < table->old_size; n--, table->old_pos++)
   {
-    cur = btor->nodes_unique_table.chains[i];
-    while (cur)
-    {
-      assert (btor_node_is_regular (cur));
-      assert (!btor_node_is_bv_var (cur));
-      assert (!btor_node_is_uf (cur));
-      temp             = cur->next;
-      hash             = compute_hash_exp (btor, cur, new_size);
-      cur->next        = new_chains[hash];
-      new_chains[hash] = cur;
-      cur              = temp;
-    }
+    slot = table->old_slots
+           + ((table->old_start + table->old_pos) & (table->old_size - 1));
+    if (!slot->exp) continue;
+    assert (btor_node_is_regular (slot->exp));
+    for (pos = slot->hash & mask; table->slots[pos].exp; pos = (pos + 1) & mask)
+      ;
+    table->slots[pos] = *slot;
+    slot->exp         = 0;
+  }
+
+  if (table->old_pos == table->old_size)
+  {
+    BTOR_DELETEN (btor->mm, table->old_slots, table->old_size);
+    table->old_slots = 0;
+    table->old_size  = 0;
+    table->old_start = 0;
+    table->old_pos   = 0;
   }
-  BTOR_DELETEN (mm, btor->nodes_unique_table.chains, size);
-  btor->nodes_unique_table.size   = new_size;
-  btor->nodes_unique_table.chains = new_chains;
+}
+
+/* Doubles the size of the unique table.  Expressions are moved to the new
+ * slots incrementally (cf. migrate_nodes_unique_table). */
+static void
+enlarge_nodes_unique_table (Btor *btor)
+{
+  assert (btor);
+
+  uint32_t i;
+  BtorNodeUniqueTable *table;
+
+  table = &btor->nodes_unique_table;
+  BTOR_ABORT (btor_util_log_2 (table->size) >= BTOR_UNIQUE_TABLE_LIMIT,
+              "unique table overflow");
+
+  /* finish pending resize first */
+  migrate_nodes_unique_table (btor, table->old_size);
+  assert (!table->old_slots);
+
+  /* Start moving slots at the beginning of a cluster, i.e., after an empty
+   * slot, such that no probe sequence wraps around into moved slots. */
+  for (i = 0; table->slots[i].exp; i++)
+    ;
+  table->old_slots = table->slots;
+  table->old_size  = table->size;
+  table->old_start = (i + 1) & (table->size - 1);
+  table->old_pos   = 0;
+  table->size *= 2;
+  BTOR_CNEWN (btor->mm, table->slots, table->size);
+}
+
+static void
+add_to_nodes_unique_table_exp (Btor *btor, BtorNode *exp)
+{
+  assert (btor);
+  assert (exp);
+  assert (btor_node_is_regular (exp));
+  assert (!exp->unique);
+
+  assert (btor->nodes_unique_table.num_elements < INT32_MAX);
+  btor->nodes_unique_table.num_elements++;
+  exp->unique = 1;
+  migrate_nodes_unique_table (btor, BTOR_UNIQUE_TABLE_MIGRATE);
 }
 
 static void
@@ -528,35 +594,48 @@ remove_from_nodes_unique_table_exp (Btor *btor, BtorNode *exp)
   assert (exp);
   assert (btor_node_is_regular (exp));
 
-  uint32_t hash;
-  BtorNode *cur, *prev;
+  uint32_t hash, mask, i, j, k;
+  BtorNodeUniqueTable *table;
+  BtorNodeUniqueTableSlot *slots;
 
   if (!exp->unique) return;
 
   assert (btor);
   assert (btor->nodes_unique_table.num_elements > 0);
 
-  hash = compute_hash_exp (btor, exp, btor->nodes_unique_table.size);
-  prev = 0;
-  cur  = btor->nodes_unique_table.chains[hash];
+  table = &btor->nodes_unique_table;
+  hash  = compute_hash_exp (btor, exp);
+  slots = table->slots;
+  mask  = table->size - 1;
+  i     = home_nodes_unique_table (table, slots, hash);
+  while (slots[i].exp != exp)
+  {
+    if (!slots[i].exp)
+    {
+      assert (slots == table->slots);
+      assert (table->old_slots);
+      slots = table->old_slots;
+      mask  = table->old_size - 1;
+      i     = home_nodes_unique_table (table, slots, hash);
+      continue;
+    }
+    i = (i + 1) & mask;
+  }
 
-  while (cur != exp)
+  /* Fill the gap with subsequent slots of the same cluster that would not be
+   * reachable otherwise. */
+  for (j = (i + 1) & mask; slots[j].exp; j = (j + 1) & mask)
   {
-    assert (cur);
-    assert (btor_node_is_regular (cur));
-    prev = cur;
-    cur  = cur->next;
+    k = home_nodes_unique_table (table, slots, slots[j].hash);
+    if (((j - k) & mask) < ((j - i) & mask)) continue;
+    slots[i] = slots[j];
+    i        = j;
   }
-  assert (cur);
-  if (!prev)
-    btor->nodes_unique_table.chains[hash] = cur->next;
-  else
-    prev->next = cur->next;
+  slots[i].exp = 0;
 
-  btor->nodes_unique_table.num_elements--;
+  table->num_elements--;
 
   exp->unique = 0; /* NOTE: this is not debugging code ! */
-  exp->next   = 0;
 }
 
 static void
@@ -1115,6 +1194,9 @@ btor_node_set_symbol (Btor *btor, BtorNode *exp, const char *symbol)
     b = btor_hashptr_table_add (btor->node2symbol, exp);
 
   b->data.as_str = sym;
+
+  /* structural hashes of variables depend on their symbol */
+  if (btor_node_is_bv_var (exp)) btor_rw_cache_reset_hashes (btor->rw_cache);
 }
 
 BtorNode *
@@ -1488,6 +1570,67 @@ sort_bv_exp (Btor *btor, BtorNodeKind kind, BtorNode *e[])
 
 /*------------------------------------------------------------------------*/
 
+/* Probe sequence for the unique table.  The current slots are probed
+ * first, then the old slots if the table is resized incrementally.  On a
+ * miss, the first empty slot of the current slots is returned for insertion.
+ * Note that removing expressions from the unique table may move other slots,
+ * hence returned slots must not be kept across calls that release nodes. */
+typedef struct BtorNodeUniqueTableProbe
+{
+  BtorNodeUniqueTable *table;
+  BtorNodeUniqueTableSlot *slots;
+  BtorNodeUniqueTableSlot *empty;
+  uint32_t hash, mask, pos;
+} BtorNodeUniqueTableProbe;
+
+static inline void
+init_probe_unique_table (BtorNodeUniqueTableProbe *probe,
+                         Btor *btor,
+                         uint32_t hash)
+{
+  probe->table = &btor->nodes_unique_table;
+  probe->slots = probe->table->slots;
+  probe->empty = 0;
+  probe->hash  = hash;
+  probe->mask  = probe->table->size - 1;
+  probe->pos   = hash & probe->mask;
+}
+
+/* Returns the next slot with matching hash, 0 if there is none. */
+static inline BtorNodeUniqueTableSlot *
+next_probe_unique_table (BtorNodeUniqueTableProbe *probe)
+{
+  BtorNodeUniqueTableSlot *slot;
+
+  for (;;)
+  {
+    slot       = probe->slots + probe->pos;
+    probe->pos = (probe->pos + 1) & probe->mask;
+    if (!slot->exp)
+    {
+      if (probe->empty) return 0;
+      probe->empty = slot;
+      if (!probe->table->old_slots) return 0;
+      probe->slots = probe->table->old_slots;
+      probe->mask  = probe->table->old_size - 1;
+      probe->pos =
+          home_nodes_unique_table (probe->table, probe->slots, probe->hash);
+      continue;
+    }
+    assert (btor_node_is_regular (slot->exp));
+    if (slot->hash == probe->hash) return slot;
+  }
+}
+
+static inline BtorNode **
+miss_probe_unique_table (BtorNodeUniqueTableProbe *probe)
+{
+  assert (probe->empty);
+  assert (!probe->empty->exp);
+  probe->empty->hash = probe->hash;
+  return &probe->empty->exp;
+}
+
 /* Search for constant expression in hash table. Returns 0 if not found. */
 static BtorNode **
 find_const_exp (Btor *btor, BtorBitVector *bits)
@@ -1495,27 +1638,20 @@ find_const_exp (Btor *btor, BtorBitVector *bits)
   assert (btor);
   assert (bits);
 
-  BtorNode *cur, **result;
-  uint32_t hash;
+  BtorNode *cur;
+  BtorNodeUniqueTableSlot *slot;
+  BtorNodeUniqueTableProbe probe;
 
-  hash = btor_bv_hash (bits);
-  hash &= btor->nodes_unique_table.size - 1;
-  result = btor->nodes_unique_table.chains + hash;
-  cur    = *result;
-  while (cur)
+  init_probe_unique_table (&probe, btor, btor_bv_hash (bits));
+  while ((slot = next_probe_unique_table (&probe)))
   {
-    assert (btor_node_is_regular (cur));
+    cur = slot->exp;
     if (btor_node_is_bv_const (cur)
         && btor_node_bv_get_width (btor, cur) == btor_bv_get_width (bits)
         && !btor_bv_compare (btor_node_bv_const_get_bits (cur), bits))
-      break;
-    else
-    {
-      result = &cur->next;
-      cur    = *result;
-    }
+      return &slot->exp;
   }
-  return result;
+  return miss_probe_unique_table (&probe);
 }
 
 /* Search for slice expression in hash table. Returns 0 if not found. */
@@ -1526,27 +1662,20 @@ find_slice_exp (Btor *btor, BtorNode *e0, uint32_t upper, uint32_t lower)
   assert (e0);
   assert (upper >= lower);
 
-  BtorNode *cur, **result;
-  uint32_t hash;
+  BtorNode *cur;
+  BtorNodeUniqueTableSlot *slot;
+  BtorNodeUniqueTableProbe probe;
 
-  hash = hash_slice_exp (e0, upper, lower);
-  hash &= btor->nodes_unique_table.size - 1;
-  result = btor->nodes_unique_table.chains + hash;
-  cur    = *result;
-  while (cur)
+  init_probe_unique_table (&probe, btor, hash_slice_exp (e0, upper, lower));
+  while ((slot = next_probe_unique_table (&probe)))
   {
-    assert (btor_node_is_regular (cur));
+    cur = slot->exp;
     if (cur->kind == BTOR_BV_SLICE_NODE && cur->e[0] == e0
         && btor_node_bv_slice_get_upper (cur) == upper
         && btor_node_bv_slice_get_lower (cur) == lower)
-      break;
-    else
-    {
-      result = &cur->next;
-      cur    = *result;
-    }
+      return &slot->exp;
   }
-  return result;
+  return miss_probe_unique_table (&probe);
 }
 
 static BtorNode **
@@ -1554,31 +1683,28 @@ find_bv_exp (Btor *btor, BtorNodeKind kind, BtorNode *e[], uint32_t arity)
 {
   bool equal;
   uint32_t i;
-  uint32_t hash;
-  BtorNode *cur, **result;
+  BtorNode *cur;
+  BtorNodeUniqueTableSlot *slot;
+  BtorNodeUniqueTableProbe probe;
 
   assert (kind != BTOR_BV_SLICE_NODE);
   assert (kind != BTOR_BV_CONST_NODE);
 
   sort_bv_exp (btor, kind, e);
-  hash = hash_bv_exp (btor, kind, arity, e);
-  hash &= btor->nodes_unique_table.size - 1;
-
-  result = btor->nodes_unique_table.chains + hash;
-  cur    = *result;
-  while (cur)
+  init_probe_unique_table (&probe, btor, hash_bv_exp (btor, kind, arity, e));
+  while ((slot = next_probe_unique_table (&probe)))
   {
-    assert (btor_node_is_regular (cur));
+    cur = slot->exp;
     if (cur->kind == kind && cur->arity == arity)
     {
       equal = true;
       /* special case for bv eq; (= (bvnot a) b) == (= a (bvnot b)) */
       if (kind == BTOR_BV_EQ_NODE && cur->e[0] == btor_node_invert (e[0])
           && cur->e[1] == btor_node_invert (e[1]))
-        break;
+        return &slot->exp;
       for (i = 0; i < arity && equal; i++)
         if (cur->e[i] != e[i]) equal = false;
-      if (equal) break;
+      if (equal) return &slot->exp;
 #ifndef NDEBUG
       if (btor_opt_get (btor, BTOR_OPT_SORT_EXP) > 0
           && btor_node_is_binary_commutative_kind (kind))
@@ -1587,10 +1713,8 @@ find_bv_exp (Btor *btor, BtorNodeKind kind, BtorNode *e[], uint32_t arity)
                     || !(cur->e[0] == e[1] && cur->e[1] == e[0]));
 #endif
     }
-    result = &(cur->next);
-    cur    = *result;
   }
-  return result;
+  return miss_probe_unique_table (&probe);
 }
 
 static int32_t compare_binder_exp (Btor *btor,
@@ -1616,6 +1740,8 @@ find_binder_exp (Btor *btor,
 
   BtorNode *cur, **result;
   uint32_t hash;
+  BtorNodeUniqueTableSlot *slot;
+  BtorNodeUniqueTableProbe probe;
 
   hash = hash_binder_exp (btor, param, body, params);
 
@@ -1626,23 +1752,21 @@ find_binder_exp (Btor *btor,
            hash);
 
   if (binder_hash) *binder_hash = hash;
-  hash &= btor->nodes_unique_table.size - 1;
-  result = btor->nodes_unique_table.chains + hash;
-  cur    = *result;
-  while (cur)
+  result = 0;
+  init_probe_unique_table (&probe, btor, hash);
+  while ((slot = next_probe_unique_table (&probe)))
   {
-    assert (btor_node_is_regular (cur));
+    cur = slot->exp;
     if (cur->kind == kind
         && ((!map && param == cur->e[0] && body == cur->e[1])
             || (((map || !cur->parameterized)
                  && compare_binder_exp (btor, param, body, cur, map)))))
-      break;
-    else
     {
-      result = &cur->next;
-      cur    = *result;
+      result = &slot->exp;
+      break;
     }
   }
+  if (!result) result = miss_probe_unique_table (&probe);
   assert (!*result || btor_node_is_binder (*result));
   BTORLOG (2,
            "found binder %s %s -> %s",
@@ -2241,9 +2365,7 @@ create_exp (Btor *btor, BtorNodeKind kind, uint32_t arity, BtorNode *e[])
         btor_hashint_table_delete (params);
     }
 
-    assert (btor->nodes_unique_table.num_elements < INT32_MAX);
-    btor->nodes_unique_table.num_elements++;
-    (*lookup)->unique = 1;
+    add_to_nodes_unique_table_exp (btor, *lookup);
   }
   else
   {
@@ -2294,9 +2416,7 @@ btor_node_create_bv_const (Btor *btor, const BtorBitVector *bits)
       lookup = find_const_exp (btor, lookupbits);
     }
     *lookup = new_const_exp_node (btor, lookupbits);
-    assert (btor->nodes_unique_table.num_elements < INT32_MAX);
-    btor->nodes_unique_table.num_elements += 1;
-    (*lookup)->unique = 1;
+    add_to_nodes_unique_table_exp (btor, *lookup);
   }
   else
     inc_exp_ref_counter (btor, *lookup);
@@ -2406,9 +2526,7 @@ unary_exp_slice_exp (Btor *btor, BtorNode *exp, uint32_t upper, uint32_t lower)
       lookup = find_slice_exp (btor, exp, upper, lower);
     }
     *lookup = new_slice_exp_node (btor, exp, upper, lower);
-    assert (btor->nodes_unique_table.num_elements < INT32_MAX);
-    btor->nodes_unique_table.num_elements++;
-    (*lookup)->unique = 1;
+    add_to_nodes_unique_table_exp (btor, *lookup);
   }
   else
     inc_exp_ref_counter (btor, *lookup);
@@ -102,7 +102,6 @@ extern const char *const g_btor_op2str[BTOR_NUM_OPS_NODE];
       BtorAIGVec *av;        /* synthesized AIG vector */                  \
       BtorPtrHashTable *rho; /* for finding array conflicts */             \
     };                                                                     \
-    BtorNode *next;         /* next in unique table */                     \
     BtorNode *simplified;   /* simplified expression */                    \
     Btor *btor;             /* boolector instance */                       \
     BtorNode *first_parent; /* head of parent list */                      \
@@ -260,6 +260,11 @@ btor_opt_init_opts (Btor *btor)
                 "aigerbin",
                 BTOR_OUTPUT_FORMAT_AIGER_BINARY,
                 "use the AIGER binary format as output file format");
+  add_opt_help (mm,
+                opts,
+                "binary",
+                BTOR_OUTPUT_FORMAT_BINARY,
+                "use Boolector's binary format as output file format");
   btor->options[BTOR_OPT_OUTPUT_FORMAT].options = opts;
 
   init_opt (btor,
@@ -413,6 +418,68 @@ btor_opt_init_opts (Btor *btor)
             0,
             3,
             "rewrite level");
+  init_opt (btor,
+            BTOR_OPT_RW_CACHE_SIZE,
+            false,
+            false,
+            "rw-cache-size",
+            0,
+            128,
+            1,
+            UINT16_MAX,
+            "maximum size of the rewrite cache in MB");
+  init_opt (btor,
+            BTOR_OPT_RW_CACHE_SHARED,
+            false,
+            true,
+            "rw-cache-shared",
+            0,
+            0,
+            0,
+            1,
+            "use process-wide rewrite cache shared between instances");
+  init_opt (btor,
+            BTOR_OPT_MODEL_GEN_LAZY,
+            false,
+            true,
+            "model-gen-lazy",
+            0,
+            0,
+            0,
+            1,
+            "generate model values on demand");
+  init_opt (btor,
+            BTOR_OPT_FUN_PRE_CONCURRENT,
+            false,
+            true,
+            "fun-pre-concurrent",
+            0,
+            0,
+            0,
+            1,
+            "run prop/sls preprocessing engine concurrently to the fun engine "
+            "(QF_BV only)");
+  init_opt (btor,
+            BTOR_OPT_FUN_MAX_LEMMAS,
+            false,
+            false,
+            "fun-max-lemmas",
+            0,
+            0,
+            0,
+            UINT32_MAX,
+            "maximum number of lemmas per refinement iteration "
+            "(0 for no limit)");
+  init_opt (btor,
+            BTOR_OPT_FUN_EAGER_UPDATES,
+            false,
+            true,
+            "fun-eager-updates",
+            0,
+            0,
+            0,
+            1,
+            "eagerly add read over write axioms");
   init_opt (btor,
             BTOR_OPT_SKELETON_PREPROC,
             false,
@@ -1410,6 +1477,17 @@ btor_opt_init_opts (Btor *btor)
             0,
             1,
             "enable non-destructive term substitutions");
+  init_opt (btor,
+            BTOR_OPT_DUMP_N_THREADS,
+            true,
+            false,
+            "dump-n-threads",
+            0,
+            0,
+            0,
+            UINT32_MAX,
+            "number of threads to count references when dumping large "
+            "formulas to SMT-LIB v2 (0: number of CPUs)");
 }
 
 static void
@@ -1672,6 +1750,15 @@ btor_opt_set (Btor *btor, const BtorOption opt, uint32_t val)
               "to clone/fork Lingeling");
   }
 #endif
+  else if (opt == BTOR_OPT_RW_CACHE_SIZE)
+  {
+    /* The rewrite cache only grows, drop it if it exceeds the limit. */
+    if (btor->rw_cache)
+    {
+      btor_rw_cache_set_max_size (btor->rw_cache,
+                                  val > o->max ? o->max : val);
+    }
+  }
 #ifndef NDEBUG
   else if (opt == BTOR_OPT_INCREMENTAL)
   {
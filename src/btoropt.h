@@ -90,7 +90,7 @@ extern const char *const g_btor_se_name[BTOR_SAT_ENGINE_MAX + 1];
 #define BTOR_OUTPUT_BASE_DFLT BTOR_OUTPUT_BASE_BIN
 
 #define BTOR_OUTPUT_FORMAT_MIN BTOR_OUTPUT_FORMAT_NONE
-#define BTOR_OUTPUT_FORMAT_MAX BTOR_OUTPUT_FORMAT_AIGER_BINARY
+#define BTOR_OUTPUT_FORMAT_MAX BTOR_OUTPUT_FORMAT_BINARY
 #define BTOR_OUTPUT_FORMAT_DFLT BTOR_OUTPUT_FORMAT_NONE
 
 #define BTOR_DP_QSORT_MIN BTOR_DP_QSORT_JUST
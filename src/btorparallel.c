@@ -0,0 +1,380 @@
+/*  Boolector: Satisfiability Modulo Theories (SMT) solver.
+ *
+ *  Copyright (C) 2007-2021 by the authors listed in the AUTHORS file.
+ *
+ *  This file is part of Boolector.
+ *  See COPYING for more information on using this software.
+ */
+
+#include "btorparallel.h"
+
+#include "btorabort.h"
+#include "btoraig.h"
+#include "btoraigvec.h"
+#include "btorcore.h"
+#include "btorlog.h"
+#include "btoropt.h"
+#include "btorsat.h"
+#include "preprocess/btorpreprocess.h"
+#include "utils/btorhashint.h"
+#include "utils/btorhashptr.h"
+#include "utils/btorstack.h"
+#include "utils/btorutil.h"
+
+#ifdef BTOR_HAVE_PTHREADS
+#include <pthread.h>
+#endif
+
+/*------------------------------------------------------------------------*/
+
+static void
+check_sequential (Btor *btor,
+                  BtorNodePtrStack *common,
+                  BtorNode **assumptions,
+                  uint32_t *sizes,
+                  uint32_t nsets,
+                  BtorSolverResult *results)
+{
+  assert (btor);
+  assert (common);
+
+  uint32_t i, j, k;
+
+  for (i = 0, k = 0; i < nsets; i++)
+  {
+    for (j = 0; j < BTOR_COUNT_STACK (*common); j++)
+      btor_assume_exp (btor, BTOR_PEEK_STACK (*common, j));
+    for (j = 0; j < sizes[i]; j++, k++) btor_assume_exp (btor, assumptions[k]);
+    results[i] = btor_check_sat (btor, -1, -1);
+  }
+}
+
+/*------------------------------------------------------------------------*/
+
+#ifdef BTOR_HAVE_PTHREADS
+
+/* State shared by all workers.  While the workers are running, the AIGs of
+ * the original instance are only read. */
+struct BtorParallel
+{
+  BtorAIGMgr *amgr;            /* AIG manager of the original instance */
+  BtorAIGPtrStack roots;       /* constraints and common assumptions */
+  BtorAIGPtrStack assumptions; /* assumptions of all sets */
+  uint32_t *sizes;             /* number of assumptions per set */
+  uint32_t *offsets;           /* first assumption per set */
+  uint32_t nsets;
+  uint32_t next;               /* next set to be checked */
+  BtorSolverResult *results;
+  pthread_mutex_t next_mutex;
+};
+
+typedef struct BtorParallel BtorParallel;
+
+/* A worker is a separate instance that only holds a SAT solver and the
+ * mapping of the shared AIGs to the CNF ids of its SAT solver. */
+struct BtorParallelWorker
+{
+  BtorParallel *par;
+  Btor *btor;
+  BtorIntHashTable *cnf_ids; /* maps AIG ids to CNF ids */
+  BtorIntStack lits;
+  uint32_t nchecked;
+  pthread_t thread;
+  bool threaded; /* 'thread' was created */
+};
+
+typedef struct BtorParallelWorker BtorParallelWorker;
+
+static void *
+check_sets (void *state)
+{
+  uint32_t i, j, set;
+  int32_t lit;
+  BtorParallelWorker *w;
+  BtorParallel *par;
+  BtorSATMgr *smgr;
+
+  w    = state;
+  par  = w->par;
+  smgr = btor_get_sat_mgr (w->btor);
+
+  for (i = 0; i < BTOR_COUNT_STACK (par->roots); i++)
+  {
+    lit = btor_aig_to_sat_tseitin_map (
+        par->amgr, smgr, w->cnf_ids, BTOR_PEEK_STACK (par->roots, i));
+    btor_sat_add (smgr, lit);
+    btor_sat_add (smgr, 0);
+  }
+
+  for (;;)
+  {
+    pthread_mutex_lock (&par->next_mutex);
+    set = par->next < par->nsets ? par->next++ : par->nsets;
+    pthread_mutex_unlock (&par->next_mutex);
+    if (set == par->nsets) break;
+
+    /* encode all assumptions of the set before assuming them */
+    BTOR_RESET_STACK (w->lits);
+    for (j = 0; j < par->sizes[set]; j++)
+    {
+      i   = par->offsets[set] + j;
+      lit = btor_aig_to_sat_tseitin_map (
+          par->amgr, smgr, w->cnf_ids, BTOR_PEEK_STACK (par->assumptions, i));
+      BTOR_PUSH_STACK (w->lits, lit);
+    }
+    for (j = 0; j < BTOR_COUNT_STACK (w->lits); j++)
+      btor_sat_assume (smgr, BTOR_PEEK_STACK (w->lits, j));
+    par->results[set] = btor_sat_check_sat (smgr, -1);
+    w->nchecked++;
+  }
+  return NULL;
+}
+
+static BtorAIG *
+exp_to_shared_aig (Btor *btor, BtorNode *exp)
+{
+  BtorAIG *res;
+
+  btor_synthesize_exp (btor, exp, 0);
+  assert (btor_node_real_addr (exp)->av);
+  assert (btor_node_real_addr (exp)->av->width == 1);
+  res = btor_node_real_addr (exp)->av->aigs[0];
+  return btor_node_is_inverted (exp) ? BTOR_INVERT_AIG (res) : res;
+}
+
+static BtorParallelWorker *
+new_worker (Btor *btor, BtorParallel *par, uint32_t id)
+{
+  char prefix[64];
+  BtorParallelWorker *w;
+  BtorSATMgr *smgr;
+  Btor *wbtor;
+
+  wbtor = btor_new ();
+  btor_opt_delete_opts (wbtor);
+  btor_opt_clone_opts (btor, wbtor);
+  snprintf (prefix,
+            sizeof (prefix),
+            "%s>w%u",
+            btor->msg->prefix ? btor->msg->prefix : "",
+            id);
+  btor_set_msg_prefix (wbtor, prefix);
+
+  smgr = btor_get_sat_mgr (wbtor);
+  btor_sat_enable_solver (smgr);
+  btor_sat_init (smgr);
+  BTOR_ABORT (!btor_sat_mgr_has_incremental_support (smgr),
+              "selected SAT solver '%s' does not support incremental mode",
+              smgr->name);
+
+  BTOR_CNEW (wbtor->mm, w);
+  w->par     = par;
+  w->btor    = wbtor;
+  w->cnf_ids = btor_hashint_map_new (wbtor->mm);
+  BTOR_INIT_STACK (wbtor->mm, w->lits);
+  return w;
+}
+
+static void
+delete_worker (BtorParallelWorker *w)
+{
+  Btor *wbtor;
+
+  wbtor = w->btor;
+  btor_hashint_map_delete (w->cnf_ids);
+  BTOR_RELEASE_STACK (w->lits);
+  BTOR_DELETE (wbtor->mm, w);
+  btor_delete (wbtor);
+}
+
+/* Returns false if the formula has to be checked sequentially. */
+static bool
+check_parallel (Btor *btor,
+                BtorNodePtrStack *common,
+                BtorNode **assumptions,
+                uint32_t *sizes,
+                uint32_t nsets,
+                uint32_t nthreads,
+                BtorSolverResult *results)
+{
+  assert (btor);
+  assert (common);
+
+  uint32_t i, j, k, nworkers;
+  BtorPtrHashTableIterator it;
+  BtorParallelWorker **workers;
+  BtorParallel par;
+  BtorMemMgr *mm;
+  BtorNode *cur;
+
+  if (nthreads < 2 || nsets < 2) return false;
+  if (btor_opt_get (btor, BTOR_OPT_ENGINE) != BTOR_ENGINE_FUN
+      || btor_opt_get (btor, BTOR_OPT_PRINT_DIMACS))
+    return false;
+
+  /* eliminate lambdas (define-fun) in the QF_BV case, as btor_check_sat */
+  if (btor->ufs->count == 0 && btor->feqs->count == 0
+      && btor->lambdas->count > 0)
+    btor_opt_set (btor, BTOR_OPT_BETA_REDUCE, BTOR_BETA_REDUCE_ALL);
+
+  mm = btor->mm;
+
+  if (btor_simplify (btor) == BTOR_RESULT_UNSAT)
+  {
+    for (i = 0; i < nsets; i++) results[i] = BTOR_RESULT_UNSAT;
+    return true;
+  }
+
+  /* the AIG encoding of functions is refined by the lemmas on demand loop,
+   * which is not shared */
+  if (btor->ufs->count || btor->lambdas->count || btor->feqs->count
+      || btor->quantifiers->count)
+    return false;
+
+  /* Synthesize constraints and assumptions once on the main thread, the
+   * workers only read the resulting AIGs.  The AIGs are encoded into the SAT
+   * solver of the main thread as soon as it is initialized. */
+  if (!btor_sat_is_initialized (btor_get_sat_mgr (btor)))
+    btor->synthesized_unencoded = true;
+  par.amgr = btor_get_aig_mgr (btor);
+  BTOR_INIT_STACK (mm, par.roots);
+  BTOR_INIT_STACK (mm, par.assumptions);
+  btor_iter_hashptr_init (&it, btor->unsynthesized_constraints);
+  btor_iter_hashptr_queue (&it, btor->synthesized_constraints);
+  while (btor_iter_hashptr_has_next (&it))
+  {
+    /* not btor_simplify_exp, which simplifies constraints to true */
+    cur = btor_node_get_simplified (btor, btor_iter_hashptr_next (&it));
+    BTOR_PUSH_STACK (par.roots, exp_to_shared_aig (btor, cur));
+  }
+  for (i = 0; i < BTOR_COUNT_STACK (btor->assertions); i++)
+  {
+    cur = btor_simplify_exp (btor, BTOR_PEEK_STACK (btor->assertions, i));
+    BTOR_PUSH_STACK (par.roots, exp_to_shared_aig (btor, cur));
+  }
+  for (i = 0; i < BTOR_COUNT_STACK (*common); i++)
+  {
+    cur = btor_simplify_exp (btor, BTOR_PEEK_STACK (*common, i));
+    BTOR_PUSH_STACK (par.roots, exp_to_shared_aig (btor, cur));
+  }
+
+  BTOR_NEWN (mm, par.offsets, nsets);
+  for (i = 0, k = 0; i < nsets; i++)
+  {
+    par.offsets[i] = k;
+    for (j = 0; j < sizes[i]; j++, k++)
+    {
+      cur = btor_simplify_exp (btor, assumptions[k]);
+      BTOR_PUSH_STACK (par.assumptions, exp_to_shared_aig (btor, cur));
+    }
+  }
+  par.sizes   = sizes;
+  par.nsets   = nsets;
+  par.next    = 0;
+  par.results = results;
+  pthread_mutex_init (&par.next_mutex, 0);
+
+  nworkers = nthreads < nsets ? nthreads : nsets;
+  BTOR_CNEWN (mm, workers, nworkers);
+  for (i = 0; i < nworkers; i++) workers[i] = new_worker (btor, &par, i);
+
+  BTOR_MSG (btor->msg,
+            1,
+            "checking %u assumption sets on %u threads over %zu shared AIGs",
+            nsets,
+            nworkers,
+            BTOR_COUNT_STACK (par.amgr->id2aig));
+
+  for (i = 0; i < nworkers; i++)
+    workers[i]->threaded =
+        !pthread_create (&workers[i]->thread, 0, check_sets, workers[i]);
+  /* workers without a thread check the remaining sets on this thread */
+  for (i = 0; i < nworkers; i++)
+    if (!workers[i]->threaded) check_sets (workers[i]);
+  for (i = 0; i < nworkers; i++)
+  {
+    if (workers[i]->threaded) pthread_join (workers[i]->thread, 0);
+    BTOR_MSG (btor->msg,
+              2,
+              "worker %u checked %u sets with %d CNF variables",
+              i,
+              workers[i]->nchecked,
+              btor_get_sat_mgr (workers[i]->btor)->maxvar);
+    delete_worker (workers[i]);
+  }
+
+  pthread_mutex_destroy (&par.next_mutex);
+  BTOR_DELETEN (mm, workers, nworkers);
+  BTOR_DELETEN (mm, par.offsets, nsets);
+  BTOR_RELEASE_STACK (par.assumptions);
+  BTOR_RELEASE_STACK (par.roots);
+  return true;
+}
+#endif
+
+/*------------------------------------------------------------------------*/
+
+void
+btor_check_sat_parallel (Btor *btor,
+                         BtorNode **assumptions,
+                         uint32_t *sizes,
+                         uint32_t nsets,
+                         uint32_t nthreads,
+                         BtorSolverResult *results)
+{
+  assert (btor);
+  assert (btor_opt_get (btor, BTOR_OPT_INCREMENTAL));
+  assert (!nsets || sizes);
+  assert (!nsets || results);
+
+  uint32_t i;
+  double start;
+  bool done;
+  BtorNode *cur;
+  BtorNodePtrStack common;
+  BtorPtrHashTableIterator it;
+
+  start = btor_util_time_stamp ();
+
+  if (btor->valid_assignments) btor_reset_incremental_usage (btor);
+
+  /* assumptions added since the last call apply to all sets */
+  BTOR_INIT_STACK (btor->mm, common);
+  btor_iter_hashptr_init (&it, btor->orig_assumptions);
+  while (btor_iter_hashptr_has_next (&it))
+  {
+    cur = btor_iter_hashptr_next (&it);
+    BTOR_PUSH_STACK (common, btor_node_copy (btor, cur));
+  }
+  btor_reset_assumptions (btor);
+
+  done = false;
+#ifdef BTOR_HAVE_PTHREADS
+  done = check_parallel (
+      btor, &common, assumptions, sizes, nsets, nthreads, results);
+#else
+  (void) nthreads;
+#endif
+  if (done)
+  {
+    btor->btor_sat_btor_called++;
+    btor->stats.parallel_checks++;
+  }
+  else
+  {
+    BTOR_MSG (btor->msg, 1, "checking %u assumption sets sequentially", nsets);
+    check_sequential (btor, &common, assumptions, sizes, nsets, results);
+    btor_reset_incremental_usage (btor);
+  }
+
+  for (i = 0; i < BTOR_COUNT_STACK (common); i++)
+    btor_node_release (btor, BTOR_PEEK_STACK (common, i));
+  BTOR_RELEASE_STACK (common);
+
+  btor->last_sat_result = BTOR_RESULT_UNKNOWN;
+  BTOR_MSG (btor->msg,
+            1,
+            "checked %u assumption sets in %.2f seconds",
+            nsets,
+            btor_util_time_stamp () - start);
+}
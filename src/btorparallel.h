@@ -0,0 +1,32 @@
+/*  Boolector: Satisfiability Modulo Theories (SMT) solver.
+ *
+ *  Copyright (C) 2007-2021 by the authors listed in the AUTHORS file.
+ *
+ *  This file is part of Boolector.
+ *  See COPYING for more information on using this software.
+ */
+
+#ifndef BTORPARALLEL_H_INCLUDED
+#define BTORPARALLEL_H_INCLUDED
+
+#include <stdint.h>
+#include "btortypes.h"
+
+/* Check 'nsets' sets of assumptions against the current formula on up to
+ * 'nthreads' threads.  Set i consists of the next 'sizes[i]' nodes in
+ * 'assumptions', its result is stored into 'results[i]'.  Assumptions added
+ * via btor_assume_exp since the last call to btor_check_sat are added to
+ * every set.
+ *
+ * The formula is simplified and bit-blasted once, each thread encodes the
+ * shared AIGs into its own SAT solver.  Formulas with functions or
+ * quantifiers are checked sequentially via btor_check_sat.  No model is
+ * available afterwards. */
+void btor_check_sat_parallel (Btor *btor,
+                              BtorNode **assumptions,
+                              uint32_t *sizes,
+                              uint32_t nsets,
+                              uint32_t nthreads,
+                              BtorSolverResult *results);
+
+#endif
@@ -10,6 +10,8 @@
 #include "boolector.h"
 #include "btorcore.h"
 #include "btoropt.h"
+#include "dumper/btordumpbin.h"
+#include "parser/btorbin.h"
 #include "parser/btorbtor.h"
 #include "parser/btorbtor2.h"
 #include "parser/btorsmt.h"
@@ -137,7 +139,12 @@ btor_parse (Btor *btor,
   BTOR_INIT_STACK (mem, prefix);
   *parsed_smt2 = false;
 
-  if (has_compressed_suffix (infile_name, ".btor"))
+  if (has_compressed_suffix (infile_name, ".btorbin"))
+  {
+    parser_api = btor_parsebin_parser_api ();
+    sprintf (msg, "parsing '%s'", infile_name);
+  }
+  else if (has_compressed_suffix (infile_name, ".btor"))
   {
     parser_api = btor_parsebtor_parser_api ();
     sprintf (msg, "parsing '%s'", infile_name);
@@ -153,8 +160,15 @@ btor_parse (Btor *btor,
     sprintf (msg, "parsing '%s'", infile_name);
     *parsed_smt2 = true;
   }
+  else if ((ch = getc (infile)) == BTOR_BIN_MAGIC[0])
+  {
+    ungetc (ch, infile);
+    parser_api = btor_parsebin_parser_api ();
+    sprintf (msg, "assuming binary input, parsing '%s'", infile_name);
+  }
   else
   {
+    if (ch != EOF) ungetc (ch, infile);
     first = second = 0;
     parser_api     = btor_parsebtor_parser_api ();
     sprintf (msg, "assuming BTOR input, parsing '%s'", infile_name);
@@ -132,10 +132,13 @@ check_rw_cache (
     result = btor_node_get_by_id (btor, cached_result_id);
     if (result)
     {
-      btor->rw_cache->num_get++;
       result = btor_node_copy (btor, btor_node_get_simplified (btor, result));
     }
   }
+  if (!result && btor_opt_get (btor, BTOR_OPT_RW_CACHE_SHARED))
+  {
+    result = btor_rw_cache_get_shared (btor->rw_cache, kind, id0, id1, id2);
+  }
   return result;
 }
 
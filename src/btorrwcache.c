@@ -8,6 +8,11 @@
 
 #include "btorrwcache.h"
 #include "btorcore.h"
+#include "btorexp.h"
+
+#ifdef BTOR_HAVE_PTHREADS
+#include <pthread.h>
+#endif
 
 static uint32_t hash_primes[] = {
     333444569u, 76891121u, 456790003u, 2654435761u};
@@ -48,6 +53,713 @@ is_valid_node (Btor *btor, int32_t id)
   return true;
 }
 
+/* Maximum number of cache entries that fit into 'mb' MB. */
+static uint32_t
+max_size_rw_cache (uint32_t mb)
+{
+  uint64_t bytes, res;
+
+  bytes = (uint64_t) mb << 20;
+  for (res = BTOR_RW_CACHE_WAYS;
+       2 * res * sizeof (BtorRwCacheTuple) <= bytes && 2 * res <= UINT32_MAX;
+       res *= 2)
+    ;
+  return res;
+}
+
+/* Returns the first entry of the set of tuple 't'. */
+static BtorRwCacheTuple *
+get_set_rw_cache (BtorRwCache *rwc, const BtorRwCacheTuple *t)
+{
+  uint32_t h, mask;
+
+  /* mix high bits into the low bits used for indexing */
+  h    = hash_rw_cache_tuple (t);
+  h    = (h ^ (h >> 16)) * 2246822519u;
+  h ^= h >> 13;
+  mask = rwc->size / BTOR_RW_CACHE_WAYS - 1;
+  return rwc->cache + (h & mask) * BTOR_RW_CACHE_WAYS;
+}
+
+static BtorRwCacheTuple *
+find_rw_cache (BtorRwCache *rwc, const BtorRwCacheTuple *t)
+{
+  uint32_t i;
+  BtorRwCacheTuple *set;
+
+  set = get_set_rw_cache (rwc, t);
+  for (i = 0; i < BTOR_RW_CACHE_WAYS; i++)
+  {
+    if (set[i].result && !compare_rw_cache_tuple (set + i, t)) return set + i;
+  }
+  return 0;
+}
+
+static void
+init_rw_cache (BtorRwCache *rwc, uint32_t size)
+{
+  assert (size >= BTOR_RW_CACHE_WAYS);
+  assert (!(size & (size - 1)));
+  rwc->size  = size;
+  rwc->count = 0;
+  BTOR_CNEWN (rwc->btor->mm, rwc->cache, size);
+}
+
+/* Double the number of sets.  The entries of a set are distributed over two
+ * sets, hence this never requires evicting entries. */
+static void
+enlarge_rw_cache (BtorRwCache *rwc)
+{
+  uint32_t i, j, old_size;
+  BtorRwCacheTuple *old_cache, *set;
+
+  old_size  = rwc->size;
+  old_cache = rwc->cache;
+  init_rw_cache (rwc, 2 * old_size);
+
+  for (i = 0; i < old_size; i++)
+  {
+    if (!old_cache[i].result) continue;
+    set = get_set_rw_cache (rwc, old_cache + i);
+    for (j = 0; set[j].result; j++) assert (j + 1 < BTOR_RW_CACHE_WAYS);
+    set[j]      = old_cache[i];
+    set[j].hand = 0;
+    rwc->count++;
+  }
+  BTOR_DELETEN (rwc->btor->mm, old_cache, old_size);
+}
+
+/* Returns an unused entry of 't's set, which is obtained by evicting an
+ * entry if the set is full and the cache can not be enlarged. */
+static BtorRwCacheTuple *
+get_free_rw_cache (BtorRwCache *rwc, const BtorRwCacheTuple *t)
+{
+  uint32_t i, w;
+  BtorRwCacheTuple *set;
+
+  set = get_set_rw_cache (rwc, t);
+  for (i = 0; i < BTOR_RW_CACHE_WAYS; i++)
+    if (!set[i].result) return set + i;
+
+  if (rwc->size < rwc->max_size)
+  {
+    enlarge_rw_cache (rwc);
+    return get_free_rw_cache (rwc, t);
+  }
+
+  /* evict the first entry that was not referenced since the hand of the set
+   * last passed it */
+  for (i = 0;; i++)
+  {
+    w = (set[0].hand + i) % BTOR_RW_CACHE_WAYS;
+    if (!set[w].referenced) break;
+    set[w].referenced = false;
+  }
+  set[0].hand = (w + 1) % BTOR_RW_CACHE_WAYS;
+  set[w].result = 0;
+  rwc->count--;
+  rwc->num_evict++;
+  return set + w;
+}
+
+/*------------------------------------------------------------------------*/
+/* process-wide shared rewrite cache                                      */
+/*------------------------------------------------------------------------*/
+
+/* Structural hash of nodes that can not be identified across instances
+ * (functions, parameters, ...).  Valid hashes are >= 2, 0 denotes a hash
+ * that was not computed yet. */
+#define BTOR_RW_HASH_NONE 1
+
+/* Number of independently locked shards and entries per shard. */
+#define BTOR_RW_SHARED_SHARDS 64
+#define BTOR_RW_SHARED_SHARD_SIZE (1u << 12)
+
+/* Maximum number of nodes below the children of a shared entry. */
+#define BTOR_RW_SHARED_MAX_NODES 32
+
+/* Entry of the shared cache.  Only rewrite results that are (possibly
+ * inverted) children or bit-vector constants are shared, since these can be
+ * reconstructed in any instance.  Entries are found via the structural
+ * hashes of the children, and a hit is verified against the serialized
+ * structure of the children, hence hash collisions are never returned. */
+struct BtorRwSharedTuple
+{
+  BtorNodeKind kind;   /* BTOR_INVALID_NODE if entry is unused */
+  uint64_t key[3];     /* structural hashes of the children */
+  uint64_t *seq;       /* serialized structure of the children */
+  uint32_t nseq;       /* length of 'seq' */
+  int8_t child;        /* index of the result child, -1 if constant */
+  bool inverted;       /* result is the inverted child */
+  bool referenced;     /* CLOCK reference bit */
+  uint8_t hand;        /* CLOCK hand of the set (first entry of a set only) */
+  BtorBitVector *bits; /* constant result */
+};
+
+typedef struct BtorRwSharedTuple BtorRwSharedTuple;
+
+struct BtorRwSharedShard
+{
+#ifdef BTOR_HAVE_PTHREADS
+  pthread_mutex_t lock;
+#endif
+  BtorMemMgr *mm;           /* owns the structures and constant results */
+  BtorRwSharedTuple *cache; /* allocated on first use */
+};
+
+typedef struct BtorRwSharedShard BtorRwSharedShard;
+
+/* The shared cache lives until the process exits. */
+static BtorRwSharedShard g_rw_shared[BTOR_RW_SHARED_SHARDS];
+
+static void
+delete_rw_shared (void)
+{
+  uint32_t i, j;
+  BtorRwSharedShard *shard;
+  BtorRwSharedTuple *t;
+
+  for (i = 0; i < BTOR_RW_SHARED_SHARDS; i++)
+  {
+    shard = g_rw_shared + i;
+#ifdef BTOR_HAVE_PTHREADS
+    pthread_mutex_lock (&shard->lock);
+#endif
+    if (shard->cache)
+    {
+      for (j = 0; j < BTOR_RW_SHARED_SHARD_SIZE; j++)
+      {
+        t = shard->cache + j;
+        if (t->seq) BTOR_DELETEN (shard->mm, t->seq, t->nseq);
+        if (t->bits) btor_bv_free (shard->mm, t->bits);
+      }
+      BTOR_DELETEN (shard->mm, shard->cache, BTOR_RW_SHARED_SHARD_SIZE);
+      btor_mem_mgr_delete (shard->mm);
+      shard->cache = 0;
+      shard->mm    = 0;
+    }
+#ifdef BTOR_HAVE_PTHREADS
+    pthread_mutex_unlock (&shard->lock);
+#endif
+  }
+}
+
+static void
+init_rw_shared (void)
+{
+#ifdef BTOR_HAVE_PTHREADS
+  uint32_t i;
+  for (i = 0; i < BTOR_RW_SHARED_SHARDS; i++)
+    pthread_mutex_init (&g_rw_shared[i].lock, 0);
+#endif
+  atexit (delete_rw_shared);
+}
+
+#ifdef BTOR_HAVE_PTHREADS
+static pthread_once_t g_rw_shared_once = PTHREAD_ONCE_INIT;
+#else
+static bool g_rw_shared_init = false;
+#endif
+
+static uint64_t
+mix_hash (uint64_t h, uint64_t v)
+{
+  h ^= v + 0x9e3779b97f4a7c15ull + (h << 6) + (h >> 2);
+  h ^= h >> 30;
+  h *= 0xbf58476d1ce4e5b9ull;
+  h ^= h >> 27;
+  h *= 0x94d049bb133111ebull;
+  h ^= h >> 31;
+  return h;
+}
+
+static uint64_t
+valid_hash (uint64_t h)
+{
+  return h < 2 ? h + 2 : h;
+}
+
+static uint64_t
+hash_leaf_shared (Btor *btor, BtorNode *exp)
+{
+  assert (btor_node_is_regular (exp));
+
+  uint32_t i, j, width;
+  uint64_t h, chunk;
+  const char *sym;
+  BtorBitVector *bits;
+
+  width = btor_node_bv_get_width (btor, exp);
+  h     = mix_hash (exp->kind, width);
+
+  if (btor_node_is_bv_const (exp))
+  {
+    bits = btor_node_bv_const_get_bits (exp);
+    if (width <= 64) return mix_hash (h, btor_bv_to_uint64 (bits));
+    for (i = 0; i < width; i += 64)
+    {
+      for (j = i, chunk = 0; j < width && j < i + 64; j++)
+        chunk |= (uint64_t) btor_bv_get_bit (bits, j) << (j - i);
+      h = mix_hash (h, chunk);
+    }
+    return h;
+  }
+
+  assert (btor_node_is_bv_var (exp));
+  /* Variables are identified by their symbol if they have one, and by their
+   * id otherwise (ids match for instances that create nodes in the same
+   * order). */
+  if ((sym = btor_node_get_symbol (btor, exp)))
+  {
+    for (chunk = 14695981039346656037ull; *sym; sym++)
+      chunk = (chunk ^ (unsigned char) *sym) * 1099511628211ull;
+    return mix_hash (h, chunk);
+  }
+  return mix_hash (mix_hash (h, BTOR_NUM_OPS_NODE), exp->id);
+}
+
+static bool
+is_hashable_shared (BtorNode *exp)
+{
+  switch (exp->kind)
+  {
+    case BTOR_BV_SLICE_NODE:
+    case BTOR_BV_AND_NODE:
+    case BTOR_BV_EQ_NODE:
+    case BTOR_BV_ADD_NODE:
+    case BTOR_BV_MUL_NODE:
+    case BTOR_BV_ULT_NODE:
+    case BTOR_BV_SLL_NODE:
+    case BTOR_BV_SRL_NODE:
+    case BTOR_BV_UDIV_NODE:
+    case BTOR_BV_UREM_NODE:
+    case BTOR_BV_CONCAT_NODE: return true;
+    case BTOR_COND_NODE: return btor_node_is_bv_cond (exp);
+    default: return false;
+  }
+}
+
+static uint64_t
+get_hash_shared (BtorRwCache *rwc, BtorNode *exp)
+{
+  BtorNode *real = btor_node_real_addr (exp);
+  uint64_t h;
+
+  BTOR_FIT_STACK (rwc->hashes, real->id);
+  h = rwc->hashes.start[real->id];
+  if (!h || h == BTOR_RW_HASH_NONE || !btor_node_is_inverted (exp)) return h;
+  return valid_hash (mix_hash (h, BTOR_NUM_OPS_NODE + 1));
+}
+
+/* Compute the structural hash of 'exp' (memoized by node id). */
+static uint64_t
+hash_node_shared (BtorRwCache *rwc, BtorNode *exp)
+{
+  bool ready;
+  uint32_t i;
+  uint64_t h, hc;
+  Btor *btor;
+  BtorNode *cur, *child;
+  BtorNodePtrStack visit;
+
+  if (get_hash_shared (rwc, exp)) return get_hash_shared (rwc, exp);
+
+  btor = rwc->btor;
+  BTOR_INIT_STACK (btor->mm, visit);
+  BTOR_PUSH_STACK (visit, btor_node_real_addr (exp));
+  while (!BTOR_EMPTY_STACK (visit))
+  {
+    cur = BTOR_TOP_STACK (visit);
+    if (get_hash_shared (rwc, cur))
+    {
+      (void) BTOR_POP_STACK (visit);
+      continue;
+    }
+
+    if (btor_node_is_bv_const (cur) || btor_node_is_bv_var (cur))
+    {
+      h = hash_leaf_shared (btor, cur);
+    }
+    else if (!is_hashable_shared (cur))
+    {
+      h = BTOR_RW_HASH_NONE;
+    }
+    else
+    {
+      for (i = 0, ready = true; i < cur->arity; i++)
+      {
+        child = btor_node_real_addr (cur->e[i]);
+        if (!get_hash_shared (rwc, child))
+        {
+          BTOR_PUSH_STACK (visit, child);
+          ready = false;
+        }
+      }
+      if (!ready) continue;
+
+      h = mix_hash (cur->kind, btor_node_bv_get_width (btor, cur));
+      if (btor_node_is_bv_slice (cur))
+      {
+        h = mix_hash (h, btor_node_bv_slice_get_upper (cur));
+        h = mix_hash (h, btor_node_bv_slice_get_lower (cur));
+      }
+      for (i = 0; i < cur->arity; i++)
+      {
+        hc = get_hash_shared (rwc, cur->e[i]);
+        if (hc == BTOR_RW_HASH_NONE)
+        {
+          h = hc;
+          break;
+        }
+        h = mix_hash (h, hc);
+      }
+    }
+    (void) BTOR_POP_STACK (visit);
+    rwc->hashes.start[cur->id] =
+        h == BTOR_RW_HASH_NONE ? h : valid_hash (h);
+  }
+  BTOR_RELEASE_STACK (visit);
+  return get_hash_shared (rwc, exp);
+}
+
+/* Reference to the serialized node 'exp', its index is stored in 'map'. */
+static uint64_t
+ref_shared (BtorIntHashTable *map, BtorNode *exp)
+{
+  uint64_t idx;
+
+  idx = btor_hashint_map_get (map, btor_node_real_addr (exp)->id)->as_int;
+  return idx << 1 | btor_node_is_inverted (exp);
+}
+
+/* Serialize the DAG below 'children' into 'seq' (nodes in post-order,
+ * referring to children by their index).  Returns false if it consists of
+ * more than BTOR_RW_SHARED_MAX_NODES nodes. */
+static bool
+serialize_shared (Btor *btor, BtorNode *children[3], BtorUInt64Stack *seq)
+{
+  bool ready, res;
+  uint32_t i, j, width, len;
+  uint64_t chunk;
+  const char *sym;
+  BtorBitVector *bits;
+  BtorNode *cur, *child;
+  BtorNodePtrStack visit;
+  BtorIntHashTable *map;
+
+  res = true;
+  map = btor_hashint_map_new (btor->mm);
+  BTOR_INIT_STACK (btor->mm, visit);
+  for (i = 0; i < 3; i++)
+    if (children[i]) BTOR_PUSH_STACK (visit, btor_node_real_addr (children[i]));
+
+  while (res && !BTOR_EMPTY_STACK (visit))
+  {
+    cur = BTOR_TOP_STACK (visit);
+    if (btor_hashint_map_contains (map, cur->id))
+    {
+      (void) BTOR_POP_STACK (visit);
+      continue;
+    }
+
+    if (!btor_node_is_bv_const (cur) && !btor_node_is_bv_var (cur))
+    {
+      assert (is_hashable_shared (cur));
+      for (i = 0, ready = true; i < cur->arity; i++)
+      {
+        child = btor_node_real_addr (cur->e[i]);
+        if (!btor_hashint_map_contains (map, child->id))
+        {
+          BTOR_PUSH_STACK (visit, child);
+          ready = false;
+        }
+      }
+      if (!ready) continue;
+    }
+    (void) BTOR_POP_STACK (visit);
+
+    if (map->count == BTOR_RW_SHARED_MAX_NODES)
+    {
+      res = false;
+      break;
+    }
+    btor_hashint_map_add (map, cur->id)->as_int = map->count;
+
+    width = btor_node_bv_get_width (btor, cur);
+    BTOR_PUSH_STACK (*seq, cur->kind);
+    BTOR_PUSH_STACK (*seq, width);
+    if (btor_node_is_bv_const (cur))
+    {
+      bits = btor_node_bv_const_get_bits (cur);
+      for (i = 0; i < width; i += 64)
+      {
+        for (j = i, chunk = 0; j < width && j < i + 64; j++)
+          chunk |= (uint64_t) btor_bv_get_bit (bits, j) << (j - i);
+        BTOR_PUSH_STACK (*seq, chunk);
+      }
+    }
+    else if (btor_node_is_bv_var (cur))
+    {
+      /* identified as in hash_leaf_shared */
+      if ((sym = btor_node_get_symbol (btor, cur)))
+      {
+        len = strlen (sym);
+        BTOR_PUSH_STACK (*seq, len + 1);
+        for (i = 0; i < len; i += 8)
+        {
+          for (j = i, chunk = 0; j < len && j < i + 8; j++)
+            chunk |= (uint64_t) (unsigned char) sym[j] << (8 * (j - i));
+          BTOR_PUSH_STACK (*seq, chunk);
+        }
+      }
+      else
+      {
+        BTOR_PUSH_STACK (*seq, 0);
+        BTOR_PUSH_STACK (*seq, cur->id);
+      }
+    }
+    else if (btor_node_is_bv_slice (cur))
+    {
+      BTOR_PUSH_STACK (*seq, btor_node_bv_slice_get_upper (cur));
+      BTOR_PUSH_STACK (*seq, btor_node_bv_slice_get_lower (cur));
+      BTOR_PUSH_STACK (*seq, ref_shared (map, cur->e[0]));
+    }
+    else
+    {
+      for (i = 0; i < cur->arity; i++)
+        BTOR_PUSH_STACK (*seq, ref_shared (map, cur->e[i]));
+    }
+  }
+
+  for (i = 0; res && i < 3; i++)
+    BTOR_PUSH_STACK (*seq,
+                     children[i] ? ref_shared (map, children[i]) : UINT64_MAX);
+
+  BTOR_RELEASE_STACK (visit);
+  btor_hashint_map_delete (map);
+  return res;
+}
+
+/* Initialize the shared tuple 't' for the (child) nodes with ids 'nid'.
+ * Returns false if some child can not be hashed structurally. */
+static bool
+init_tuple_shared (BtorRwCache *rwc,
+                   BtorRwSharedTuple *t,
+                   BtorNode *children[3],
+                   BtorNodeKind kind,
+                   const int32_t nid[3])
+{
+  uint32_t i;
+
+  BTOR_CLR (t);
+  t->kind = kind;
+  for (i = 0; i < 3; i++)
+  {
+    children[i] = 0;
+    if (!nid[i]) continue;
+    children[i] = btor_node_get_by_id (rwc->btor, nid[i]);
+    assert (children[i]);
+    t->key[i] = hash_node_shared (rwc, children[i]);
+    if (t->key[i] == BTOR_RW_HASH_NONE) return false;
+  }
+  return true;
+}
+
+/* Lock and return the shard of tuple 't' and the first entry of its set. */
+static BtorRwSharedShard *
+lock_shard_shared (const BtorRwSharedTuple *t, BtorRwSharedTuple **set)
+{
+  uint64_t h;
+  BtorRwSharedShard *shard;
+
+  h = mix_hash (mix_hash (mix_hash (t->kind, t->key[0]), t->key[1]), t->key[2]);
+#ifdef BTOR_HAVE_PTHREADS
+  pthread_once (&g_rw_shared_once, init_rw_shared);
+#else
+  if (!g_rw_shared_init)
+  {
+    g_rw_shared_init = true;
+    init_rw_shared ();
+  }
+#endif
+  shard = g_rw_shared + (h >> 32) % BTOR_RW_SHARED_SHARDS;
+#ifdef BTOR_HAVE_PTHREADS
+  pthread_mutex_lock (&shard->lock);
+#endif
+  if (!shard->cache)
+  {
+    shard->mm = btor_mem_mgr_new ();
+    BTOR_CNEWN (shard->mm, shard->cache, BTOR_RW_SHARED_SHARD_SIZE);
+  }
+  *set = shard->cache
+         + ((uint32_t) h & (BTOR_RW_SHARED_SHARD_SIZE / BTOR_RW_CACHE_WAYS - 1))
+               * BTOR_RW_CACHE_WAYS;
+  return shard;
+}
+
+static void
+unlock_shard_shared (BtorRwSharedShard *shard)
+{
+#ifdef BTOR_HAVE_PTHREADS
+  pthread_mutex_unlock (&shard->lock);
+#else
+  (void) shard;
+#endif
+}
+
+/* Entries are found via their structural hashes, which may collide. */
+static bool
+compare_tuple_shared (const BtorRwSharedTuple *t0, const BtorRwSharedTuple *t1)
+{
+  uint32_t i;
+
+  if (t0->kind != t1->kind) return false;
+  for (i = 0; i < 3; i++)
+  {
+    if (t0->key[i] != t1->key[i]) return false;
+  }
+  return true;
+}
+
+/* True if the cached entry 't' was added for children with the structure
+ * 'seq'. */
+static bool
+is_same_structure_shared (const BtorRwSharedTuple *t, BtorUInt64Stack *seq)
+{
+  return t->nseq == BTOR_COUNT_STACK (*seq)
+         && !memcmp (t->seq, seq->start, t->nseq * sizeof (uint64_t));
+}
+
+static BtorRwSharedTuple *
+find_shared (BtorRwSharedTuple *set, const BtorRwSharedTuple *t)
+{
+  uint32_t i;
+  for (i = 0; i < BTOR_RW_CACHE_WAYS; i++)
+  {
+    if (compare_tuple_shared (set + i, t)) return set + i;
+  }
+  return 0;
+}
+
+static void
+add_shared (BtorRwCache *rwc,
+            BtorNodeKind kind,
+            const int32_t nid[3],
+            int32_t result_nid)
+{
+  uint8_t hand;
+  uint32_t i, w;
+  BtorNode *children[3], *result;
+  BtorBitVector *bits;
+  BtorRwSharedTuple t, *set, *cached;
+  BtorRwSharedShard *shard;
+  BtorUInt64Stack seq;
+
+  if (!init_tuple_shared (rwc, &t, children, kind, nid)) return;
+
+  result = btor_node_get_by_id (rwc->btor, result_nid);
+  t.child = -1;
+  for (i = 0; i < 3; i++)
+  {
+    if (children[i]
+        && btor_node_real_addr (children[i]) == btor_node_real_addr (result))
+    {
+      t.child    = i;
+      t.inverted = btor_node_is_inverted (children[i])
+                   != btor_node_is_inverted (result);
+      break;
+    }
+  }
+  if (t.child < 0 && !btor_node_is_bv_const (result)) return;
+
+  BTOR_INIT_STACK (rwc->btor->mm, seq);
+  if (!serialize_shared (rwc->btor, children, &seq))
+  {
+    BTOR_RELEASE_STACK (seq);
+    return;
+  }
+
+  shard = lock_shard_shared (&t, &set);
+  if (!find_shared (set, &t))
+  {
+    /* evict the first entry that was not referenced since the hand of the
+     * set last passed it */
+    for (i = 0;; i++)
+    {
+      w = (set[0].hand + i) % BTOR_RW_CACHE_WAYS;
+      if (!set[w].kind || !set[w].referenced) break;
+      set[w].referenced = false;
+    }
+    hand   = (w + 1) % BTOR_RW_CACHE_WAYS;
+    cached = set + w;
+    if (cached->seq) BTOR_DELETEN (shard->mm, cached->seq, cached->nseq);
+    if (cached->bits) btor_bv_free (shard->mm, cached->bits);
+    *cached      = t;
+    set[0].hand  = hand;
+    cached->nseq = BTOR_COUNT_STACK (seq);
+    BTOR_NEWN (shard->mm, cached->seq, cached->nseq);
+    memcpy (cached->seq, seq.start, cached->nseq * sizeof (uint64_t));
+    if (t.child < 0)
+    {
+      bits = btor_node_bv_const_get_bits (result);
+      cached->bits = btor_node_is_inverted (result)
+                         ? btor_bv_not (shard->mm, bits)
+                         : btor_bv_copy (shard->mm, bits);
+    }
+  }
+  unlock_shard_shared (shard);
+  BTOR_RELEASE_STACK (seq);
+}
+
+BtorNode *
+btor_rw_cache_get_shared (BtorRwCache *rwc,
+                          BtorNodeKind kind,
+                          int32_t nid0,
+                          int32_t nid1,
+                          int32_t nid2)
+{
+  int32_t nid[3] = {nid0, nid1, nid2};
+  BtorNode *children[3], *result = 0;
+  BtorRwSharedTuple t, *set, *cached;
+  BtorRwSharedShard *shard;
+  BtorUInt64Stack seq;
+
+  /* nid1 and nid2 of slice nodes are indices, slices are never cached */
+  if (kind == BTOR_BV_SLICE_NODE) return 0;
+  if (!init_tuple_shared (rwc, &t, children, kind, nid)) return 0;
+
+  rwc->num_shared_get++;
+  BTOR_INIT_STACK (rwc->btor->mm, seq);
+  shard = lock_shard_shared (&t, &set);
+  if ((cached = find_shared (set, &t))
+      && serialize_shared (rwc->btor, children, &seq)
+      && is_same_structure_shared (cached, &seq))
+  {
+    cached->referenced = true;
+    if (cached->child < 0)
+    {
+      result = btor_exp_bv_const (rwc->btor, cached->bits);
+    }
+    else
+    {
+      result = children[(int32_t) cached->child];
+      if (cached->inverted) result = btor_node_invert (result);
+      result = btor_node_copy (rwc->btor, result);
+    }
+    rwc->num_shared_hits++;
+  }
+  unlock_shard_shared (shard);
+  BTOR_RELEASE_STACK (seq);
+  return result;
+}
+
+void
+btor_rw_cache_reset_hashes (BtorRwCache *rwc)
+{
+  assert (rwc);
+  BTOR_RELEASE_STACK (rwc->hashes);
+}
+
 int32_t
 btor_rw_cache_get (BtorRwCache *rwc,
                    BtorNodeKind kind,
@@ -65,11 +777,13 @@ btor_rw_cache_get (BtorRwCache *rwc,
   }
 #endif
 
-  BtorRwCacheTuple t   = {.kind = kind, .n = {nid0, nid1, nid2}};
-  BtorPtrHashBucket *b = btor_hashptr_table_get (rwc->cache, &t);
-  if (b)
+  BtorRwCacheTuple t       = {.kind = kind, .n = {nid0, nid1, nid2}};
+  BtorRwCacheTuple *cached = find_rw_cache (rwc, &t);
+  rwc->num_get++;
+  if (cached)
   {
-    BtorRwCacheTuple *cached = b->key;
+    cached->referenced = true;
+    rwc->num_hits++;
     return cached->result;
   }
   return 0;
@@ -105,35 +819,33 @@ btor_rw_cache_add (BtorRwCache *rwc,
     return;
   }
 
-  int32_t cached_result_id;
-  if ((cached_result_id = btor_rw_cache_get (rwc, kind, nid0, nid1, nid2)))
+  if (btor_opt_get (rwc->btor, BTOR_OPT_RW_CACHE_SHARED))
   {
-    /* This can only happen if the node corresponding to cached_result_id does
+    int32_t nid[3] = {nid0, nid1, nid2};
+    add_shared (rwc, kind, nid, result);
+  }
+
+  BtorRwCacheTuple t = {.kind = kind, .n = {nid0, nid1, nid2}};
+  BtorRwCacheTuple *cached;
+  if ((cached = find_rw_cache (rwc, &t)))
+  {
+    /* This can only happen if the node corresponding to cached->result does
      * not exist anymore (= deallocated). */
-    if (cached_result_id != result)
-    {
-      assert (btor_node_get_by_id (rwc->btor, cached_result_id) == 0);
-      BtorRwCacheTuple t   = {.kind = kind, .n = {nid0, nid1, nid2}};
-      BtorPtrHashBucket *b = btor_hashptr_table_get (rwc->cache, &t);
-      assert (b);
-      BtorRwCacheTuple *cached = b->key;
-      cached->result           = result;  // Update the result
+    if (cached->result != result)
+    {
+      assert (btor_node_get_by_id (rwc->btor, cached->result) == 0);
+      cached->result = result;  // Update the result
       rwc->num_update++;
     }
     return;
   }
 
-  BtorRwCacheTuple *t;
-  BTOR_CNEW (rwc->btor->mm, t);
-  t->kind   = kind;
-  t->n[0]   = nid0;
-  t->n[1]   = nid1;
-  t->n[2]   = nid2;
-  t->result = result;
+  cached         = get_free_rw_cache (rwc, &t);
+  *cached        = t;
+  cached->result = result;
+  rwc->count++;
   rwc->num_add++;
 
-  btor_hashptr_table_add (rwc->cache, t);
-
   if (rwc->num_add % 100000 == 0)
   {
     btor_rw_cache_gc (rwc);
@@ -144,31 +856,27 @@ void
 btor_rw_cache_init (BtorRwCache *rwc, Btor *btor)
 {
   assert (rwc);
-  rwc->btor       = btor;
-  rwc->cache      = btor_hashptr_table_new (btor->mm,
-                                       (BtorHashPtr) hash_rw_cache_tuple,
-                                       (BtorCmpPtr) compare_rw_cache_tuple);
-  rwc->num_add    = 0;
-  rwc->num_get    = 0;
-  rwc->num_update = 0;
-  rwc->num_remove = 0;
+  rwc->btor            = btor;
+  rwc->num_add         = 0;
+  rwc->num_get         = 0;
+  rwc->num_hits        = 0;
+  rwc->num_update      = 0;
+  rwc->num_remove      = 0;
+  rwc->num_evict       = 0;
+  rwc->num_shared_get  = 0;
+  rwc->num_shared_hits = 0;
+  rwc->max_size =
+      max_size_rw_cache (btor_opt_get (btor, BTOR_OPT_RW_CACHE_SIZE));
+  BTOR_INIT_STACK (btor->mm, rwc->hashes);
+  init_rw_cache (rwc, BTOR_RW_CACHE_WAYS);
 }
 
 void
 btor_rw_cache_delete (BtorRwCache *rwc)
 {
   assert (rwc);
-
-  BtorPtrHashTableIterator it;
-  BtorRwCacheTuple *t;
-
-  btor_iter_hashptr_init (&it, rwc->cache);
-  while (btor_iter_hashptr_has_next (&it))
-  {
-    t = btor_iter_hashptr_next (&it);
-    BTOR_DELETE (rwc->btor->mm, t);
-  }
-  btor_hashptr_table_delete (rwc->cache);
+  BTOR_DELETEN (rwc->btor->mm, rwc->cache, rwc->size);
+  BTOR_RELEASE_STACK (rwc->hashes);
 }
 
 void
@@ -178,9 +886,17 @@ btor_rw_cache_reset (BtorRwCache *rwc)
   assert (rwc->btor->mm);
   assert (rwc->cache);
 
-  Btor *btor = rwc->btor;
   btor_rw_cache_delete (rwc);
-  btor_rw_cache_init (rwc, btor);
+  init_rw_cache (rwc, BTOR_RW_CACHE_WAYS);
+}
+
+void
+btor_rw_cache_set_max_size (BtorRwCache *rwc, uint32_t mb)
+{
+  assert (rwc);
+
+  rwc->max_size = max_size_rw_cache (mb);
+  if (rwc->size > rwc->max_size) btor_rw_cache_reset (rwc);
 }
 
 void
@@ -190,23 +906,20 @@ btor_rw_cache_gc (BtorRwCache *rwc)
   assert (rwc->cache);
 
   bool remove;
-  BtorPtrHashTableIterator it;
+  uint32_t i;
   BtorRwCacheTuple *t;
   BtorNodeKind kind;
 
-  Btor *btor            = rwc->btor;
-  BtorPtrHashTable *old = rwc->cache;
-
-  rwc->cache = btor_hashptr_table_new (btor->mm, old->hash, old->cmp);
+  Btor *btor = rwc->btor;
 
   /* We remove all cache entries that store invalid children node ids. An
    * invalid node is either a node that does not exist anymore (deallocated) or
    * if the node id belongs to a proxy node. Proxy nodes are never used to
    * query the cache and are therefore useless cache entries. */
-  btor_iter_hashptr_init (&it, old);
-  while (btor_iter_hashptr_has_next (&it))
+  for (i = 0; i < rwc->size; i++)
   {
-    t = btor_iter_hashptr_next (&it);
+    t = rwc->cache + i;
+    if (!t->result) continue;
     kind = t->kind;
 
     remove = !is_valid_node (btor, t->n[0]);
@@ -227,13 +940,16 @@ btor_rw_cache_gc (BtorRwCache *rwc)
 
     if (remove)
     {
-      BTOR_DELETE (btor->mm, t);
+      t->result = 0;
+      rwc->count--;
       rwc->num_remove++;
     }
-    else
-    {
-      btor_hashptr_table_add (rwc->cache, t);
-    }
   }
-  btor_hashptr_table_delete (old);
+}
+
+size_t
+btor_rw_cache_size (BtorRwCache *rwc)
+{
+  return sizeof (BtorRwCache) + rwc->size * sizeof (BtorRwCacheTuple)
+         + BTOR_SIZE_STACK (rwc->hashes) * sizeof (uint64_t);
 }
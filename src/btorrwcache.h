@@ -10,7 +10,6 @@
 #define BTORRWCACHE_H_INCLUDED
 
 #include "btornode.h"
-#include "utils/btorhashptr.h"
 
 /* Cache entry that stores the result of rewriting a node with kind 'kind' and
  * it's children 'n'.
@@ -20,21 +19,40 @@ struct BtorRwCacheTuple
 {
   BtorNodeKind kind;
   int32_t n[3];
-  int32_t result;
+  int32_t result;  /* 0 if entry is unused */
+  bool referenced; /* CLOCK reference bit */
+  uint8_t hand;    /* CLOCK hand of the set (first entry of a set only) */
 };
 
 typedef struct BtorRwCacheTuple BtorRwCacheTuple;
 
+/* Number of entries per set. */
+#define BTOR_RW_CACHE_WAYS 4
+
 /* Stores all cache entries and some statistics. Note that the statistics are
- * not reset if btor_rw_cache_reset() or btor_rw_cache_gc() is called. */
+ * not reset if btor_rw_cache_reset() or btor_rw_cache_gc() is called.
+ *
+ * The cache is set associative with BTOR_RW_CACHE_WAYS entries per set,
+ * which are stored inline.  If all entries of a set are used, the cache is
+ * enlarged up to the size given by BTOR_OPT_RW_CACHE_SIZE.  After that, an
+ * entry of the set is evicted (CLOCK per set, i.e., entries that were used
+ * since the hand of their set last passed them get a second chance). */
 struct BtorRwCache
 {
   Btor *btor;
-  BtorPtrHashTable *cache;  /* Hash table of BtorRwCacheTuple. */
-  uint64_t num_add;         /* Number of cached rewrite rules. */
-  uint64_t num_get;         /* Number of cache checks. */
-  uint64_t num_update;      /* Number of updated cache entries. */
-  uint64_t num_remove;      /* Number of removed cache entries (GC). */
+  BtorRwCacheTuple *cache; /* Array of 'size' entries. */
+  uint32_t size;           /* Number of entries (power of two). */
+  uint32_t count;          /* Number of used entries. */
+  uint32_t max_size;       /* Maximum number of entries. */
+  uint64_t num_add;        /* Number of cached rewrite rules. */
+  uint64_t num_get;        /* Number of cache checks. */
+  uint64_t num_hits;       /* Number of cache hits. */
+  uint64_t num_update;     /* Number of updated cache entries. */
+  uint64_t num_remove;     /* Number of removed cache entries (GC). */
+  uint64_t num_evict;      /* Number of evicted cache entries. */
+  uint64_t num_shared_get;  /* Number of shared cache checks. */
+  uint64_t num_shared_hits; /* Number of shared cache hits. */
+  BtorUInt64Stack hashes;   /* Structural hashes indexed by node id. */
 };
 
 typedef struct BtorRwCache BtorRwCache;
@@ -63,8 +81,27 @@ void btor_rw_cache_delete (BtorRwCache *cache);
 /* Reset the rewrite cache. */
 void btor_rw_cache_reset (BtorRwCache *cache);
 
+/* Limit the size of the rewrite cache to 'mb' MB, which resets the cache if
+ * it is larger. */
+void btor_rw_cache_set_max_size (BtorRwCache *cache, uint32_t mb);
+
 /* Remove all cache entries that contain invalid nodes (= deallocated) or
  * proxies as children. */
 void btor_rw_cache_gc (BtorRwCache *cache);
 
+/* Check if any instance already cached a rewritten node with the same
+ * structure in the process-wide shared cache (BTOR_OPT_RW_CACHE_SHARED).
+ * Returns a new reference to the result or 0 if not cached. */
+BtorNode *btor_rw_cache_get_shared (BtorRwCache *cache,
+                                    BtorNodeKind kind,
+                                    int32_t nid0,
+                                    int32_t nid1,
+                                    int32_t nid2);
+
+/* Invalidate all memoized structural hashes (e.g., if a symbol changed). */
+void btor_rw_cache_reset_hashes (BtorRwCache *cache);
+
+/* Returns the size of the rewrite cache in Byte. */
+size_t btor_rw_cache_size (BtorRwCache *cache);
+
 #endif
@@ -169,6 +169,8 @@ btor_sat_mgr_new (Btor *btor)
   BTOR_CNEW (btor->mm, smgr);
   smgr->btor   = btor;
   smgr->output = stdout;
+  BTOR_INIT_STACK (btor->mm, smgr->scopes);
+  BTOR_INIT_STACK (btor->mm, smgr->popped);
   return smgr;
 }
 
@@ -186,6 +188,13 @@ btor_sat_mgr_has_incremental_support (const BtorSATMgr *smgr)
   return smgr->api.assume != 0 && smgr->api.failed != 0;
 }
 
+bool
+btor_sat_mgr_has_melt_support (const BtorSATMgr *smgr)
+{
+  if (!smgr) return false;
+  return smgr->api.melt != 0;
+}
+
 void
 btor_sat_mgr_set_term (BtorSATMgr *smgr, int32_t (*fun) (void *), void *state)
 {
@@ -205,6 +214,7 @@ btor_sat_mgr_clone (Btor *btor, BtorSATMgr *smgr)
 
   BtorSATMgr *res;
   BtorMemMgr *mm;
+  size_t i;
 
   BTOR_ABORT (!btor_sat_mgr_has_clone_support (smgr),
               "SAT solver does not support cloning");
@@ -219,6 +229,14 @@ btor_sat_mgr_clone (Btor *btor, BtorSATMgr *smgr)
           &smgr->inc_required,
           (char *) smgr + sizeof (*smgr) - (char *) &smgr->inc_required);
   BTOR_CLR (&res->term);
+  BTOR_INIT_STACK (mm, res->scopes);
+  for (i = 0; i < BTOR_COUNT_STACK (smgr->scopes); i++)
+    BTOR_PUSH_STACK (res->scopes, BTOR_PEEK_STACK (smgr->scopes, i));
+  BTOR_ADJUST_STACK (smgr->scopes, res->scopes);
+  BTOR_INIT_STACK (mm, res->popped);
+  for (i = 0; i < BTOR_COUNT_STACK (smgr->popped); i++)
+    BTOR_PUSH_STACK (res->popped, BTOR_PEEK_STACK (smgr->popped, i));
+  BTOR_ADJUST_STACK (smgr->popped, res->popped);
   return res;
 }
 
@@ -229,12 +247,29 @@ btor_sat_is_initialized (BtorSATMgr *smgr)
   return smgr->initialized;
 }
 
+/* Allocate the activation literal of the current scope if it has not been
+ * allocated yet.  Must be called before generating a CNF index or adding a
+ * clause within a scope. */
+static void
+ensure_scope_guard (BtorSATMgr *smgr)
+{
+  int32_t guard;
+
+  if (BTOR_EMPTY_STACK (smgr->scopes)) return;
+  if (BTOR_TOP_STACK (smgr->scopes)) return;
+  guard = inc_max_var (smgr);
+  if (guard > smgr->maxvar) smgr->maxvar = guard;
+  BTOR_ABORT (guard <= 0, "CNF id overflow");
+  BTOR_POKE_STACK (smgr->scopes, BTOR_COUNT_STACK (smgr->scopes) - 1, guard);
+}
+
 int32_t
 btor_sat_mgr_next_cnf_id (BtorSATMgr *smgr)
 {
   int32_t result;
   assert (smgr);
   assert (smgr->initialized);
+  ensure_scope_guard (smgr);
   result = inc_max_var (smgr);
   if (abs (result) > smgr->maxvar) smgr->maxvar = abs (result);
   BTOR_ABORT (result <= 0, "CNF id overflow");
@@ -261,6 +296,8 @@ btor_sat_mgr_delete (BtorSATMgr *smgr)
    * reset_sat has not been called
    */
   if (smgr->initialized) btor_sat_reset (smgr);
+  BTOR_RELEASE_STACK (smgr->scopes);
+  BTOR_RELEASE_STACK (smgr->popped);
   BTOR_DELETE (smgr->btor->mm, smgr);
 }
 
@@ -354,9 +391,13 @@ btor_sat_init (BtorSATMgr *smgr)
     setterm (smgr);
   }
 
-  smgr->true_lit = btor_sat_mgr_next_cnf_id (smgr);
-  btor_sat_add (smgr, smgr->true_lit);
-  btor_sat_add (smgr, 0);
+  /* the unit clause for the constant true literal is added outside of
+   * any scope, it must never be disabled */
+  smgr->true_lit = inc_max_var (smgr);
+  smgr->maxvar   = smgr->true_lit;
+  add (smgr, smgr->true_lit);
+  add (smgr, 0);
+  smgr->clauses++;
   btor_sat_set_output (smgr, stdout);
 }
 
@@ -379,7 +420,13 @@ btor_sat_add (BtorSATMgr *smgr, int32_t lit)
   assert (smgr->initialized);
   assert (abs (lit) <= smgr->maxvar);
   assert (!smgr->satcalls || smgr->inc_required);
-  if (!lit) smgr->clauses++;
+  ensure_scope_guard (smgr);
+  if (!lit)
+  {
+    if (!BTOR_EMPTY_STACK (smgr->scopes))
+      add (smgr, -BTOR_TOP_STACK (smgr->scopes));
+    smgr->clauses++;
+  }
   add (smgr, lit);
 }
 
@@ -391,7 +438,8 @@ btor_sat_check_sat (BtorSATMgr *smgr, int32_t limit)
   assert (!smgr->inc_required || btor_sat_mgr_has_incremental_support (smgr));
 
   double start = btor_util_time_stamp ();
-  int32_t sat_res;
+  int32_t sat_res, guard;
+  size_t i;
   BtorSolverResult res;
   BTOR_MSG (smgr->btor->msg,
             2,
@@ -399,6 +447,11 @@ btor_sat_check_sat (BtorSATMgr *smgr, int32_t limit)
             smgr->name,
             limit);
   assert (!smgr->satcalls || smgr->inc_required);
+  for (i = 0; i < BTOR_COUNT_STACK (smgr->scopes); i++)
+  {
+    guard = BTOR_PEEK_STACK (smgr->scopes, i);
+    if (guard) assume (smgr, guard);
+  }
   smgr->satcalls++;
   setterm (smgr);
   sat_res = sat (smgr, limit);
@@ -435,12 +488,61 @@ btor_sat_repr (BtorSATMgr *smgr, int32_t lit)
 void
 btor_sat_reset (BtorSATMgr *smgr)
 {
+  size_t i;
   assert (smgr != NULL);
   assert (smgr->initialized);
   BTOR_MSG (smgr->btor->msg, 2, "resetting %s", smgr->name);
   reset (smgr);
   smgr->solver      = 0;
   smgr->initialized = false;
+  smgr->maxvar      = 0;
+  /* activation literals are not valid anymore */
+  for (i = 0; i < BTOR_COUNT_STACK (smgr->scopes); i++)
+    BTOR_POKE_STACK (smgr->scopes, i, 0);
+  BTOR_RESET_STACK (smgr->popped);
+}
+
+void
+btor_sat_push_scope (BtorSATMgr *smgr)
+{
+  assert (smgr);
+  BTOR_PUSH_STACK (smgr->scopes, 0);
+}
+
+void
+btor_sat_pop_scope (BtorSATMgr *smgr)
+{
+  assert (smgr);
+
+  int32_t guard;
+
+  /* the SAT manager may have been created after the scope was opened (e.g.
+   * for clones of the expression layer only), in which case nothing has been
+   * guarded */
+  if (BTOR_EMPTY_STACK (smgr->scopes)) return;
+  guard = BTOR_POP_STACK (smgr->scopes);
+  if (guard) BTOR_PUSH_STACK (smgr->popped, guard);
+}
+
+int32_t
+btor_sat_disable_popped_scopes (BtorSATMgr *smgr)
+{
+  assert (smgr);
+
+  int32_t guard, res;
+
+  res = 0;
+  while (!BTOR_EMPTY_STACK (smgr->popped))
+  {
+    guard = BTOR_POP_STACK (smgr->popped);
+    assert (smgr->initialized);
+    add (smgr, -guard);
+    add (smgr, 0);
+    smgr->clauses++;
+    melt (smgr, guard);
+    if (!res || guard < res) res = guard;
+  }
+  return res;
 }
 
 int32_t
@@ -43,6 +43,13 @@ struct BtorSATMgr
   int32_t true_lit;
   int32_t maxvar;
 
+  /* activation literals of open scopes, 0 if no clause has been added to the
+   * scope yet (see btor_sat_push_scope) */
+  BtorIntStack scopes;
+  /* activation literals of popped scopes whose clauses have not been
+   * disabled yet (see btor_sat_disable_popped_scopes) */
+  BtorIntStack popped;
+
   double sat_time;
 
   struct
@@ -97,6 +104,8 @@ bool btor_sat_mgr_has_clone_support (const BtorSATMgr *smgr);
 
 bool btor_sat_mgr_has_incremental_support (const BtorSATMgr *smgr);
 
+bool btor_sat_mgr_has_melt_support (const BtorSATMgr *smgr);
+
 void btor_sat_mgr_set_term (BtorSATMgr *smgr,
                             int32_t (*fun) (void *),
                             void *state);
@@ -174,4 +183,26 @@ int32_t btor_sat_fixed (BtorSATMgr *smgr, int32_t lit);
 /* Resets the status of the SAT solver. */
 void btor_sat_reset (BtorSATMgr *smgr);
 
+/* Opens a new scope.  All clauses added while the scope is open are guarded
+ * by an activation literal of the scope, which is assumed on every call to
+ * 'btor_sat_check_sat' until the scope is closed.  The activation literal is
+ * allocated lazily, before any CNF index generated within the scope.
+ */
+void btor_sat_push_scope (BtorSATMgr *smgr);
+
+/* Closes the current scope.  Its activation literal is not assumed anymore,
+ * but its clauses are only disabled permanently with the next call to
+ * 'btor_sat_disable_popped_scopes' (the solver state, e.g., failed
+ * assumptions, is preserved until then).
+ */
+void btor_sat_pop_scope (BtorSATMgr *smgr);
+
+/* Permanently disables all clauses added within scopes popped since the last
+ * call by asserting the negations of their activation literals.  Returns the
+ * smallest of these activation literals (0 if no clause has been added within
+ * the popped scopes), i.e., all CNF indices generated within the popped
+ * scopes are greater than the returned literal.
+ */
+int32_t btor_sat_disable_popped_scopes (BtorSATMgr *smgr);
+
 #endif
@@ -28,6 +28,10 @@
 #include "utils/btorunionfind.h"
 #include "utils/btorutil.h"
 
+#ifdef BTOR_HAVE_PTHREADS
+#include <pthread.h>
+#endif
+
 /*------------------------------------------------------------------------*/
 
 static BtorFunSolver *
@@ -48,8 +52,12 @@ clone_fun_solver (Btor *clone, BtorFunSolver *slv, BtorNodeMap *exp_map)
   memcpy (res, slv, sizeof (BtorFunSolver));
 
   res->btor   = clone;
-  res->lemmas = btor_hashptr_table_clone (
-      clone->mm, slv->lemmas, btor_clone_key_as_node, 0, exp_map, 0);
+  res->lemmas = btor_hashptr_table_clone (clone->mm,
+                                          slv->lemmas,
+                                          btor_clone_key_as_node,
+                                          btor_clone_data_as_int,
+                                          exp_map,
+                                          0);
 
   btor_clone_node_ptr_stack (
       clone->mm, &slv->cur_lemmas, &res->cur_lemmas, exp_map, false);
@@ -239,6 +247,13 @@ configure_sat_mgr (Btor *btor)
       smgr->inc_required && !btor_sat_mgr_has_incremental_support (smgr),
       "selected SAT solver '%s' does not support incremental mode",
       smgr->name);
+
+  /* encode nodes synthesized by btor_check_sat_parallel */
+  if (btor->synthesized_unencoded)
+  {
+    btor_synthesized_to_sat (btor);
+    btor->synthesized_unencoded = false;
+  }
 }
 
 static BtorSolverResult
@@ -273,12 +288,29 @@ timed_sat_sat (Btor *btor, int32_t limit)
   return res;
 }
 
+/* Synthesized nodes that are not reachable from any constraint are not
+ * encoded again after the SAT solver has been reset (see
+ * btor_synthesized_to_sat), their assignment is evaluated instead. */
+static bool
+is_encoded (BtorNode *exp)
+{
+  assert (btor_node_is_regular (exp));
+  assert (btor_node_is_synth (exp));
+
+  uint32_t i;
+
+  for (i = 0; i < exp->av->width; i++)
+    if (!btor_aig_get_cnf_id (exp->av->aigs[i])) return false;
+  return true;
+}
+
 static bool
 has_bv_assignment (Btor *btor, BtorNode *exp)
 {
   exp = btor_node_real_addr (exp);
   return (btor->bv_model && btor_hashint_map_contains (btor->bv_model, exp->id))
-         || btor_node_is_synth (exp) || btor_node_is_bv_const (exp);
+         || (btor_node_is_synth (exp) && is_encoded (exp))
+         || btor_node_is_bv_const (exp);
 }
 
 static BtorBitVector *
@@ -298,8 +330,8 @@ get_bv_assignment (Btor *btor, BtorNode *exp)
     bv = btor_bv_copy (btor->mm, d->as_ptr);
   else /* cache assignment to avoid querying the sat solver multiple times */
   {
-    /* synthesized nodes are always encoded and have an assignment */
-    if (btor_node_is_synth (real_exp))
+    /* encoded synthesized nodes have an assignment */
+    if (btor_node_is_synth (real_exp) && is_encoded (real_exp))
       bv = btor_bv_get_assignment (btor->mm, real_exp);
     else if (btor_node_is_bv_const (real_exp))
       bv = btor_bv_copy (btor->mm, btor_node_bv_const_get_bits (real_exp));
@@ -341,19 +373,29 @@ new_exp_layer_clone_for_dual_prop (Btor *btor,
   assert (exp_map);
   assert (root);
 
+  uint32_t i;
   double start;
   Btor *clone;
   BtorNode *cur, *and;
+  BtorNodePtrStack roots;
   BtorPtrHashTableIterator it;
 
   /* empty formula */
   if (btor->unsynthesized_constraints->count == 0) return 0;
 
   start = btor_util_time_stamp ();
-  clone = btor_clone_exp_layer (btor, exp_map, true);
-  assert (!clone->synthesized_constraints->count);
-  assert (clone->embedded_constraints->count == 0);
-  assert (clone->unsynthesized_constraints->count);
+
+  /* only the cone of the constraints and assumptions is needed */
+  assert (btor->embedded_constraints->count == 0);
+  BTOR_INIT_STACK (btor->mm, roots);
+  btor_iter_hashptr_init (&it, btor->unsynthesized_constraints);
+  btor_iter_hashptr_queue (&it, btor->synthesized_constraints);
+  btor_iter_hashptr_queue (&it, btor->assumptions);
+  while (btor_iter_hashptr_has_next (&it))
+    BTOR_PUSH_STACK (roots, btor_iter_hashptr_next (&it));
+  clone = btor_clone_cone (
+      btor, roots.start, BTOR_COUNT_STACK (roots), exp_map);
+  clone->slv = btor_new_fun_solver (clone);
 
   btor_opt_set (clone, BTOR_OPT_MODEL_GEN, 0);
   btor_opt_set (clone, BTOR_OPT_INCREMENTAL, 1);
@@ -365,12 +407,10 @@ new_exp_layer_clone_for_dual_prop (Btor *btor,
   btor_opt_set_str (clone, BTOR_OPT_SAT_ENGINE, "plain=1");
   configure_sat_mgr (clone);
 
-  btor_iter_hashptr_init (&it, clone->unsynthesized_constraints);
-  btor_iter_hashptr_queue (&it, clone->assumptions);
-  while (btor_iter_hashptr_has_next (&it))
+  for (i = 0; i < BTOR_COUNT_STACK (roots); i++)
   {
-    cur                                   = btor_iter_hashptr_next (&it);
-    btor_node_real_addr (cur)->constraint = 0;
+    cur = btor_nodemap_mapped (*exp_map, BTOR_PEEK_STACK (roots, i));
+    assert (cur);
     if (!*root)
     {
       *root = btor_node_copy (clone, cur);
@@ -382,21 +422,7 @@ new_exp_layer_clone_for_dual_prop (Btor *btor,
       *root = and;
     }
   }
-
-  btor_iter_hashptr_init (&it, clone->unsynthesized_constraints);
-  btor_iter_hashptr_queue (&it, clone->assumptions);
-  while (btor_iter_hashptr_has_next (&it))
-    btor_node_release (clone, btor_iter_hashptr_next (&it));
-  btor_hashptr_table_delete (clone->unsynthesized_constraints);
-  btor_hashptr_table_delete (clone->assumptions);
-  clone->unsynthesized_constraints =
-      btor_hashptr_table_new (clone->mm,
-                              (BtorHashPtr) btor_node_hash_by_id,
-                              (BtorCmpPtr) btor_node_compare_by_id);
-  clone->assumptions =
-      btor_hashptr_table_new (clone->mm,
-                              (BtorHashPtr) btor_node_hash_by_id,
-                              (BtorCmpPtr) btor_node_compare_by_id);
+  BTOR_RELEASE_STACK (roots);
 
   BTOR_FUN_SOLVER (btor)->time.search_init_apps_cloning +=
       btor_util_time_stamp () - start;
@@ -1414,6 +1440,74 @@ mk_premise (Btor *btor, BtorNode *args, BtorNode *prem[], uint32_t num_prem)
   return res;
 }
 
+/* for every read a on a store f = write (g, j, v) with index i, add
+ *   i = j -> a = v  and  i != j -> a = g(i)
+ * and continue with read g(i) */
+static void
+add_update_axioms (Btor *btor)
+{
+  uint32_t i;
+  BtorNode *cur, *fun, *app, *eq, *con, *axiom;
+  BtorNodePtrStack visit;
+  BtorPtrHashTableIterator it;
+  BtorMemMgr *mm;
+  BtorIntHashTable *cache;
+
+  mm = btor->mm;
+  BTOR_INIT_STACK (mm, visit);
+  /* we don't have to traverse synthesized_constraints as we already added
+   * the axioms for them in a previous sat call */
+  btor_iter_hashptr_init (&it, btor->unsynthesized_constraints);
+  btor_iter_hashptr_queue (&it, btor->assumptions);
+  while (btor_iter_hashptr_has_next (&it))
+  {
+    cur = btor_iter_hashptr_next (&it);
+    cur = btor_node_get_simplified (btor, cur);
+    BTOR_PUSH_STACK (visit, cur);
+  }
+
+  cache = btor_hashint_table_new (mm);
+  while (!BTOR_EMPTY_STACK (visit))
+  {
+    cur = btor_node_real_addr (BTOR_POP_STACK (visit));
+
+    if (cur->parameterized || btor_hashint_table_contains (cache, cur->id))
+      continue;
+
+    btor_hashint_table_add (cache, cur->id);
+    for (i = 0; i < cur->arity; i++) BTOR_PUSH_STACK (visit, cur->e[i]);
+
+    if (!btor_node_is_apply (cur) || !btor_node_is_update (cur->e[0]))
+      continue;
+
+    fun = cur->e[0];
+    eq  = mk_equal_args (btor, cur->e[1], fun->e[1]);
+
+    con   = btor_exp_eq (btor, cur, fun->e[2]);
+    axiom = btor_exp_implies (btor, eq, con);
+    btor_assert_exp (btor, axiom);
+    btor_node_release (btor, axiom);
+    btor_node_release (btor, con);
+
+    app   = btor_exp_apply (btor, fun->e[0], cur->e[1]);
+    con   = btor_exp_eq (btor, cur, app);
+    axiom = btor_exp_implies (btor, btor_node_invert (eq), con);
+    btor_assert_exp (btor, axiom);
+    btor_node_release (btor, axiom);
+    btor_node_release (btor, con);
+    btor_node_release (btor, eq);
+
+    /* 'app' is referenced by the axiom */
+    BTOR_PUSH_STACK (visit, app);
+    btor_node_release (btor, app);
+
+    BTOR_FUN_SOLVER (btor)->stats.update_axioms += 2;
+    BTORLOG (2, "add update axioms for %s", btor_util_node2string (cur));
+  }
+  BTOR_RELEASE_STACK (visit);
+  btor_hashint_table_delete (cache);
+}
+
 static void
 add_lemma (Btor *btor, BtorNode *fun, BtorNode *app1, BtorNode *app2)
 {
@@ -1512,7 +1606,8 @@ add_lemma (Btor *btor, BtorNode *fun, BtorNode *app1, BtorNode *app2)
   assert (lemma != btor->true_exp);
   if (!btor_hashptr_table_get (slv->lemmas, lemma))
   {
-    btor_hashptr_table_add (slv->lemmas, btor_node_copy (btor, lemma));
+    btor_hashptr_table_add (slv->lemmas, btor_node_copy (btor, lemma))
+        ->data.as_int = lemma_size;
     BTOR_PUSH_STACK (slv->cur_lemmas, lemma);
     slv->stats.lod_refinements++;
     slv->stats.lemmas_size_sum += lemma_size;
@@ -1520,6 +1615,8 @@ add_lemma (Btor *btor, BtorNode *fun, BtorNode *app1, BtorNode *app2)
       BTOR_FIT_STACK (slv->stats.lemmas_size, lemma_size);
     slv->stats.lemmas_size.start[lemma_size] += 1;
   }
+  else
+    slv->stats.reused_lemmas++;
   btor_node_release (btor, lemma);
 
   /* cleanup */
@@ -1537,6 +1634,73 @@ add_lemma (Btor *btor, BtorNode *fun, BtorNode *app1, BtorNode *app2)
   BTOR_FUN_SOLVER (btor)->time.lemma_gen += btor_util_time_stamp () - start;
 }
 
+struct BtorFunLemma
+{
+  BtorNode *lemma;
+  uint32_t size;
+};
+
+typedef struct BtorFunLemma BtorFunLemma;
+
+static int32_t
+compare_lemmas_by_size_qsort_asc (const void *p1, const void *p2)
+{
+  const BtorFunLemma *l1, *l2;
+
+  l1 = (const BtorFunLemma *) p1;
+  l2 = (const BtorFunLemma *) p2;
+  if (l1->size != l2->size) return l1->size < l2->size ? -1 : 1;
+  return btor_node_real_addr (l1->lemma)->id
+         - btor_node_real_addr (l2->lemma)->id;
+}
+
+/* Only keep the 'max' strongest lemmas of the current refinement iteration,
+ * where a lemma is considered stronger the less premises it has.  Deferred
+ * lemmas are removed from the lemma cache, hence they are generated again if
+ * the conflict still occurs in the next iteration. */
+static void
+limit_lemmas (Btor *btor, uint32_t max)
+{
+  assert (btor);
+  assert (btor->slv);
+  assert (btor->slv->kind == BTOR_FUN_SOLVER_KIND);
+  assert (max > 0);
+
+  uint32_t i, n;
+  BtorFunSolver *slv;
+  BtorPtrHashBucket *b;
+  BtorFunLemma *lemmas;
+  BtorNode *lemma;
+
+  slv = BTOR_FUN_SOLVER (btor);
+  n   = BTOR_COUNT_STACK (slv->cur_lemmas);
+  if (n <= max) return;
+
+  BTOR_NEWN (btor->mm, lemmas, n);
+  for (i = 0; i < n; i++)
+  {
+    lemma = BTOR_PEEK_STACK (slv->cur_lemmas, i);
+    b     = btor_hashptr_table_get (slv->lemmas, lemma);
+    assert (b);
+    lemmas[i].lemma = lemma;
+    lemmas[i].size  = b->data.as_int;
+  }
+  qsort (lemmas, n, sizeof (BtorFunLemma), compare_lemmas_by_size_qsort_asc);
+
+  BTOR_RESET_STACK (slv->cur_lemmas);
+  for (i = 0; i < max; i++) BTOR_PUSH_STACK (slv->cur_lemmas, lemmas[i].lemma);
+  for (i = max; i < n; i++)
+  {
+    btor_hashptr_table_remove (slv->lemmas, lemmas[i].lemma, 0, 0);
+    slv->stats.lod_refinements--;
+    slv->stats.lemmas_size_sum -= lemmas[i].size;
+    slv->stats.lemmas_size.start[lemmas[i].size] -= 1;
+    slv->stats.deferred_lemmas++;
+    btor_node_release (btor, lemmas[i].lemma);
+  }
+  BTOR_DELETEN (btor->mm, lemmas, n);
+}
+
 static void
 push_applies_for_propagation (Btor *btor,
                               BtorNode *exp,
@@ -1632,21 +1796,391 @@ find_conflict_app (Btor *btor, BtorNode *app, BtorIntHashTable *conf_apps)
   return res;
 }
 
+/* Partial beta reduction of a lambda w.r.t. the arguments of an apply.  The
+ * reduction only depends on the arguments (as nodes) and on the values of the
+ * conditions evaluated while reducing.  It is therefore kept across
+ * refinement rounds of a sat call and reused as long as these conditions
+ * have the same values. */
+struct BtorFunBetaResult
+{
+  BtorNode *fun;          /* reduced lambda */
+  BtorNode *value;        /* result of the partial beta reduction */
+  BtorNodePtrStack conds; /* evaluated conditions, inverted if false */
+};
+
+typedef struct BtorFunBetaResult BtorFunBetaResult;
+
+static void
+delete_beta_result (Btor *btor, BtorFunBetaResult *res)
+{
+  while (!BTOR_EMPTY_STACK (res->conds))
+    btor_node_release (btor, BTOR_POP_STACK (res->conds));
+  BTOR_RELEASE_STACK (res->conds);
+  btor_node_release (btor, res->value);
+  BTOR_DELETE (btor->mm, res);
+}
+
+static void
+delete_beta_results (Btor *btor, BtorIntHashTable *beta_results)
+{
+  BtorIntHashTableIterator it;
+
+  btor_iter_hashint_init (&it, beta_results);
+  while (btor_iter_hashint_has_next (&it))
+    delete_beta_result (btor, btor_iter_hashint_next_data (&it)->as_ptr);
+  btor_hashint_map_delete (beta_results);
+}
+
+static bool
+is_valid_beta_result (Btor *btor, BtorFunBetaResult *res, BtorNode *fun)
+{
+  bool valid;
+  uint32_t i;
+  BtorBitVector *bv;
+
+  if (res->fun != fun) return false;
+  for (i = 0, valid = true; valid && i < BTOR_COUNT_STACK (res->conds); i++)
+  {
+    bv    = btor_eval_exp (btor, BTOR_PEEK_STACK (res->conds, i));
+    valid = btor_bv_is_true (bv);
+    btor_bv_free (btor->mm, bv);
+  }
+  return valid;
+}
+
+/* Partially beta reduce lambda 'fun' w.r.t. the arguments 'args' of 'app',
+ * or reuse the reduction of a previous refinement round. */
+static BtorFunBetaResult *
+beta_reduce_partial_app (Btor *btor,
+                         BtorNode *fun,
+                         BtorNode *app,
+                         BtorNode *args,
+                         BtorIntHashTable *beta_results)
+{
+  BtorFunBetaResult *res;
+  BtorHashTableData *d;
+  BtorPtrHashTable *cond_if, *cond_else;
+  BtorPtrHashTableIterator it;
+
+  if ((d = btor_hashint_map_get (beta_results, app->id)))
+  {
+    res = d->as_ptr;
+    if (is_valid_beta_result (btor, res, fun))
+    {
+      BTOR_FUN_SOLVER (btor)->stats.propagations_reused++;
+      return res;
+    }
+    delete_beta_result (btor, res);
+  }
+  else
+    d = btor_hashint_map_add (beta_results, app->id);
+
+  cond_if   = btor_hashptr_table_new (btor->mm,
+                                    (BtorHashPtr) btor_node_hash_by_id,
+                                    (BtorCmpPtr) btor_node_compare_by_id);
+  cond_else = btor_hashptr_table_new (btor->mm,
+                                      (BtorHashPtr) btor_node_hash_by_id,
+                                      (BtorCmpPtr) btor_node_compare_by_id);
+  BTOR_CNEW (btor->mm, res);
+  BTOR_INIT_STACK (btor->mm, res->conds);
+  res->fun = fun;
+  btor_beta_assign_args (btor, fun, args);
+  res->value =
+      btor_beta_reduce_partial_collect (btor, fun, cond_if, cond_else);
+  btor_beta_unassign_params (btor, fun);
+
+  btor_iter_hashptr_init (&it, cond_if);
+  while (btor_iter_hashptr_has_next (&it))
+    BTOR_PUSH_STACK (res->conds, btor_iter_hashptr_next (&it));
+  btor_iter_hashptr_init (&it, cond_else);
+  while (btor_iter_hashptr_has_next (&it))
+    BTOR_PUSH_STACK (res->conds,
+                     btor_node_invert (btor_iter_hashptr_next (&it)));
+  btor_hashptr_table_delete (cond_if);
+  btor_hashptr_table_delete (cond_else);
+
+  d->as_ptr = res;
+  return res;
+}
+
+/* Propagation state of an apply, which is kept across the refinement rounds
+ * of a sat call.  An apply does not have to be propagated again as long as
+ * the assignments observed while propagating it do not change. */
+struct BtorFunPropRecord
+{
+  BtorNode *app;
+  BtorNodePtrStack funs;    /* functions with 'app' in their rho table */
+  BtorNodePtrStack obs;     /* nodes with observed assignments */
+  BtorBitVectorPtrStack bv; /* observed assignments of 'obs' */
+  BtorNodePtrStack conds;   /* conditions evaluated by beta reduction */
+  BtorIntStack merged;      /* ids of applies that stopped at a rho entry of
+                               'app' with the same value */
+  bool complete;            /* propagation ended without conflict */
+};
+
+typedef struct BtorFunPropRecord BtorFunPropRecord;
+
+struct BtorFunPropState
+{
+  BtorIntHashTable *records; /* maps apply ids to BtorFunPropRecord */
+  BtorPtrHashTable *funs;    /* functions with a rho table */
+  BtorNodePtrStack changed;  /* applies propagated again in current round */
+};
+
+typedef struct BtorFunPropState BtorFunPropState;
+
+static void
+observe_assignment (Btor *btor, BtorFunPropRecord *rec, BtorNode *exp)
+{
+  BTOR_PUSH_STACK (rec->obs, btor_node_copy (btor, exp));
+  BTOR_PUSH_STACK (rec->bv, get_bv_assignment (btor, exp));
+}
+
+static void
+observe_args_assignment (Btor *btor, BtorFunPropRecord *rec, BtorNode *args)
+{
+  BtorArgsIterator it;
+
+  btor_iter_args_init (&it, args);
+  while (btor_iter_args_has_next (&it))
+    observe_assignment (btor, rec, btor_iter_args_next (&it));
+}
+
+static BtorFunPropRecord *
+get_prop_record (Btor *btor, BtorFunPropState *state, BtorNode *app)
+{
+  BtorFunPropRecord *rec;
+  BtorHashTableData *d;
+
+  if ((d = btor_hashint_map_get (state->records, app->id))) return d->as_ptr;
+
+  BTOR_CNEW (btor->mm, rec);
+  rec->app = btor_node_copy (btor, app);
+  BTOR_INIT_STACK (btor->mm, rec->funs);
+  BTOR_INIT_STACK (btor->mm, rec->obs);
+  BTOR_INIT_STACK (btor->mm, rec->bv);
+  BTOR_INIT_STACK (btor->mm, rec->conds);
+  BTOR_INIT_STACK (btor->mm, rec->merged);
+  observe_args_assignment (
+      btor, rec, btor_node_get_simplified (btor, app->e[1]));
+  observe_assignment (btor, rec, app);
+  btor_hashint_map_add (state->records, app->id)->as_ptr = rec;
+  return rec;
+}
+
+static void
+delete_prop_record (Btor *btor, BtorFunPropRecord *rec)
+{
+  while (!BTOR_EMPTY_STACK (rec->obs))
+    btor_node_release (btor, BTOR_POP_STACK (rec->obs));
+  while (!BTOR_EMPTY_STACK (rec->bv))
+    btor_bv_free (btor->mm, BTOR_POP_STACK (rec->bv));
+  while (!BTOR_EMPTY_STACK (rec->conds))
+    btor_node_release (btor, BTOR_POP_STACK (rec->conds));
+  BTOR_RELEASE_STACK (rec->funs);
+  BTOR_RELEASE_STACK (rec->obs);
+  BTOR_RELEASE_STACK (rec->bv);
+  BTOR_RELEASE_STACK (rec->conds);
+  BTOR_RELEASE_STACK (rec->merged);
+  btor_node_release (btor, rec->app);
+  BTOR_DELETE (btor->mm, rec);
+}
+
+static bool
+is_changed_prop_record (Btor *btor, BtorFunPropRecord *rec)
+{
+  bool changed;
+  uint32_t i;
+  BtorBitVector *bv;
+
+  changed = !rec->complete;
+  for (i = 0; !changed && i < BTOR_COUNT_STACK (rec->obs); i++)
+  {
+    bv      = get_bv_assignment (btor, BTOR_PEEK_STACK (rec->obs, i));
+    changed = btor_bv_compare (bv, BTOR_PEEK_STACK (rec->bv, i)) != 0;
+    btor_bv_free (btor->mm, bv);
+  }
+  for (i = 0; !changed && i < BTOR_COUNT_STACK (rec->conds); i++)
+  {
+    bv      = btor_eval_exp (btor, BTOR_PEEK_STACK (rec->conds, i));
+    changed = !btor_bv_is_true (bv);
+    btor_bv_free (btor->mm, bv);
+  }
+  return changed;
+}
+
+static void
+init_prop_state (Btor *btor, BtorFunPropState *state)
+{
+  state->records = btor_hashint_map_new (btor->mm);
+  state->funs    = btor_hashptr_table_new (btor->mm,
+                                        (BtorHashPtr) btor_node_hash_by_id,
+                                        (BtorCmpPtr) btor_node_compare_by_id);
+  BTOR_INIT_STACK (btor->mm, state->changed);
+}
+
+static void
+reset_prop_state_changed (Btor *btor, BtorFunPropState *state)
+{
+  while (!BTOR_EMPTY_STACK (state->changed))
+    btor_node_release (btor, BTOR_POP_STACK (state->changed));
+}
+
+/* Delete the propagation state of a sat call, including the rho tables of
+ * functions that were not handed over to 'functions_with_model'. */
+static void
+delete_prop_state (Btor *btor, BtorFunPropState *state)
+{
+  BtorNode *fun;
+  BtorIntHashTableIterator iit;
+  BtorPtrHashTableIterator pit;
+
+  btor_iter_hashint_init (&iit, state->records);
+  while (btor_iter_hashint_has_next (&iit))
+    delete_prop_record (btor, btor_iter_hashint_next_data (&iit)->as_ptr);
+  btor_hashint_map_delete (state->records);
+
+  btor_iter_hashptr_init (&pit, state->funs);
+  while (btor_iter_hashptr_has_next (&pit))
+  {
+    fun = btor_iter_hashptr_next (&pit);
+    if (fun->rho)
+    {
+      btor_hashptr_table_delete (fun->rho);
+      fun->rho = 0;
+    }
+    btor_node_release (btor, fun);
+  }
+  btor_hashptr_table_delete (state->funs);
+
+  reset_prop_state_changed (btor, state);
+  BTOR_RELEASE_STACK (state->changed);
+}
+
+/* Determine the applies that have to be propagated again in this refinement
+ * round, i.e., applies whose observed assignments changed, or that depend on
+ * the rho entry of such an apply.  Their rho entries are removed and they are
+ * pushed onto 'prop_stack'.  All other applies are marked as propagated. */
+static void
+update_prop_state (Btor *btor,
+                   BtorFunPropState *state,
+                   BtorNodePtrStack *prop_stack,
+                   BtorPtrHashTable *cleanup_table)
+{
+  int32_t id;
+  uint32_t i;
+  BtorNode *fun, *app, *args;
+  BtorFunPropRecord *rec;
+  BtorHashTableData *d;
+  BtorIntStack visit;
+  BtorIntHashTable *changed;
+  BtorPtrHashTable *funs, *rho;
+  BtorIntHashTableIterator iit;
+  BtorPtrHashTableIterator pit, rit;
+
+  BTOR_INIT_STACK (btor->mm, visit);
+  changed = btor_hashint_table_new (btor->mm);
+  funs    = btor_hashptr_table_new (btor->mm,
+                                 (BtorHashPtr) btor_node_hash_by_id,
+                                 (BtorCmpPtr) btor_node_compare_by_id);
+
+  btor_iter_hashint_init (&iit, state->records);
+  while (btor_iter_hashint_has_next (&iit))
+  {
+    rec = btor_iter_hashint_next_data (&iit)->as_ptr;
+    if (is_changed_prop_record (btor, rec))
+      BTOR_PUSH_STACK (visit, rec->app->id);
+  }
+
+  while (!BTOR_EMPTY_STACK (visit))
+  {
+    id = BTOR_POP_STACK (visit);
+    if (btor_hashint_table_contains (changed, id)) continue;
+    if (!(d = btor_hashint_map_get (state->records, id))) continue;
+    btor_hashint_table_add (changed, id);
+    rec = d->as_ptr;
+    for (i = 0; i < BTOR_COUNT_STACK (rec->merged); i++)
+      BTOR_PUSH_STACK (visit, BTOR_PEEK_STACK (rec->merged, i));
+    for (i = 0; i < BTOR_COUNT_STACK (rec->funs); i++)
+    {
+      fun = BTOR_PEEK_STACK (rec->funs, i);
+      if (!btor_hashptr_table_get (funs, fun))
+        btor_hashptr_table_add (funs, fun);
+    }
+  }
+
+  /* the keys of removed entries are hashed w.r.t. outdated assignments,
+   * hence we rebuild the rho tables rather than removing entries */
+  btor_iter_hashptr_init (&pit, funs);
+  while (btor_iter_hashptr_has_next (&pit))
+  {
+    fun = btor_iter_hashptr_next (&pit);
+    assert (fun->rho);
+    rho = btor_hashptr_table_new (btor->mm,
+                                  (BtorHashPtr) hash_args_assignment,
+                                  (BtorCmpPtr) compare_args_assignments);
+    btor_iter_hashptr_init (&rit, fun->rho);
+    while (btor_iter_hashptr_has_next (&rit))
+    {
+      app  = rit.bucket->data.as_ptr;
+      args = btor_iter_hashptr_next (&rit);
+      if (btor_hashint_table_contains (changed, app->id)) continue;
+      btor_hashptr_table_add (rho, args)->data.as_ptr = app;
+    }
+    btor_hashptr_table_delete (fun->rho);
+    fun->rho = rho;
+  }
+  btor_hashptr_table_delete (funs);
+
+  btor_iter_hashint_init (&iit, changed);
+  while (btor_iter_hashint_has_next (&iit))
+  {
+    id  = btor_iter_hashint_next (&iit);
+    rec = btor_hashint_map_get (state->records, id)->as_ptr;
+    app = rec->app;
+    assert (!app->propagated);
+    /* 'app' may only be referenced by an outdated partial beta reduction */
+    BTOR_PUSH_STACK (state->changed, btor_node_copy (btor, app));
+    BTOR_PUSH_STACK (*prop_stack, app);
+    BTOR_PUSH_STACK (*prop_stack, app->e[0]);
+    BTORLOG (2, "push changed apply: %s", btor_util_node2string (app));
+    btor_hashint_map_remove (state->records, id, 0);
+    delete_prop_record (btor, rec);
+  }
+
+  btor_iter_hashint_init (&iit, state->records);
+  while (btor_iter_hashint_has_next (&iit))
+  {
+    rec = btor_iter_hashint_next_data (&iit)->as_ptr;
+    app = rec->app;
+    app->propagated = 1;
+    btor_hashptr_table_add (cleanup_table, app);
+    BTOR_FUN_SOLVER (btor)->stats.propagations_skipped++;
+  }
+
+  btor_hashint_table_delete (changed);
+  BTOR_RELEASE_STACK (visit);
+}
+
 static void
 propagate (Btor *btor,
            BtorNodePtrStack *prop_stack,
            BtorPtrHashTable *cleanup_table,
-           BtorIntHashTable *apply_search_cache)
+           BtorIntHashTable *apply_search_cache,
+           BtorIntHashTable *beta_results,
+           BtorFunPropState *state)
 {
   assert (btor);
   assert (btor->slv);
   assert (btor->slv->kind == BTOR_FUN_SOLVER_KIND);
   assert (prop_stack);
   assert (cleanup_table);
+  assert (state);
   assert (apply_search_cache);
+  assert (beta_results);
 
   double start;
-  uint32_t opt_eager_lemmas;
+  uint32_t i, opt_eager_lemmas;
   bool prop_down, conflict, restart;
   BtorBitVector *bv;
   BtorMemMgr *mm;
@@ -1654,8 +2188,8 @@ propagate (Btor *btor,
   BtorNode *fun, *app, *args, *fun_value, *cur;
   BtorNode *hashed_app;
   BtorPtrHashBucket *b;
-  BtorPtrHashTableIterator it;
-  BtorPtrHashTable *conds;
+  BtorFunBetaResult *beta;
+  BtorFunPropRecord *rec;
   BtorIntHashTable *conf_apps;
 
   start            = btor_util_time_stamp ();
@@ -1700,14 +2234,15 @@ propagate (Btor *btor,
     assert (btor_node_is_args (args));
 
     push_applies_for_propagation (btor, args, prop_stack, apply_search_cache);
+    rec = get_prop_record (btor, state, app);
 
     if (!fun->rho)
     {
       fun->rho = btor_hashptr_table_new (mm,
                                          (BtorHashPtr) hash_args_assignment,
                                          (BtorCmpPtr) compare_args_assignments);
-      if (!btor_hashptr_table_get (cleanup_table, fun))
-        btor_hashptr_table_add (cleanup_table, fun);
+      if (!btor_hashptr_table_get (state->funs, fun))
+        btor_hashptr_table_add (state->funs, btor_node_copy (btor, fun));
     }
     else
     {
@@ -1741,25 +2276,38 @@ propagate (Btor *btor,
           /* stop at first conflict */
           if (restart) break;
         }
+        else if (hashed_app != app)
+        {
+          /* 'app' has to be propagated again if 'hashed_app' changes */
+          BTOR_PUSH_STACK (
+              get_prop_record (btor, state, hashed_app)->merged, app->id);
+          rec->complete = true;
+        }
         continue;
       }
     }
     assert (fun->rho);
     assert (!btor_hashptr_table_get (fun->rho, args));
     btor_hashptr_table_add (fun->rho, args)->data.as_ptr = app;
+    BTOR_PUSH_STACK (rec->funs, fun);
     BTORLOG (1,
              "  save app: %s (%s)",
              btor_util_node2string (args),
              btor_util_node2string (app));
 
     /* skip array vars/uf */
-    if (btor_node_is_uf (fun)) continue;
+    if (btor_node_is_uf (fun))
+    {
+      rec->complete = true;
+      continue;
+    }
 
     if (btor_node_is_fun_cond (fun))
     {
       push_applies_for_propagation (
           btor, fun->e[0], prop_stack, apply_search_cache);
       bv = get_bv_assignment (btor, fun->e[0]);
+      observe_assignment (btor, rec, fun->e[0]);
 
       /* propagate over function ite */
       BTORLOG (1, "  propagate down: %s", btor_util_node2string (app));
@@ -1774,9 +2322,12 @@ propagate (Btor *btor,
     }
     else if (btor_node_is_update (fun))
     {
+      observe_args_assignment (btor, rec, fun->e[1]);
       if (compare_args_assignments (fun->e[1], args) == 0)
       {
-        if (!equal_bv_assignments (app, fun->e[2]))
+        observe_assignment (btor, rec, fun->e[2]);
+        rec->complete = equal_bv_assignments (app, fun->e[2]);
+        if (!rec->complete)
         {
           BTORLOG (1, "\e[1;31m");
           BTORLOG (1, "update conflict at: %s", btor_util_node2string (fun));
@@ -1820,13 +2371,12 @@ propagate (Btor *btor,
     }
 
     assert (btor_node_is_lambda (fun));
-    conds = btor_hashptr_table_new (mm,
-                                    (BtorHashPtr) btor_node_hash_by_id,
-                                    (BtorCmpPtr) btor_node_compare_by_id);
-    btor_beta_assign_args (btor, fun, args);
-    fun_value = btor_beta_reduce_partial (btor, fun, conds);
+    beta      = beta_reduce_partial_app (btor, fun, app, args, beta_results);
+    fun_value = beta->value;
     assert (!btor_node_is_fun (fun_value));
-    btor_beta_unassign_params (btor, fun);
+    for (i = 0; i < BTOR_COUNT_STACK (beta->conds); i++)
+      BTOR_PUSH_STACK (rec->conds,
+                       btor_node_copy (btor, BTOR_PEEK_STACK (beta->conds, i)));
 
     prop_down = false;
     if (!btor_node_is_inverted (fun_value) && btor_node_is_apply (fun_value))
@@ -1841,7 +2391,14 @@ propagate (Btor *btor,
       app->propagated = 0;
       BTORLOG (1, "  propagate down: %s", btor_util_node2string (app));
     }
-    else if (!equal_bv_assignments (app, fun_value))
+    else
+    {
+      observe_assignment (btor, rec, fun_value);
+      conflict      = !equal_bv_assignments (app, fun_value);
+      rec->complete = !conflict;
+    }
+
+    if (conflict)
     {
       BTORLOG (1, "\e[1;31m");
       BTORLOG (1, "BR conflict at: %s", btor_util_node2string (fun));
@@ -1858,21 +2415,14 @@ propagate (Btor *btor,
         restart = false;
       slv->stats.beta_reduction_conflicts++;
       add_lemma (btor, fun, app, 0);
-      conflict = true;
     }
 
     /* we have a conflict and the values are inconsistent, we do not have
      * to push applies onto 'prop_stack' that produce this inconsistent
      * value */
-    if (conflict)
-    {
-      btor_iter_hashptr_init (&it, conds);
-      while (btor_iter_hashptr_has_next (&it))
-        btor_node_release (btor, btor_iter_hashptr_next (&it));
-    }
     /* push applies onto 'prop_stack' that are necesary to derive 'fun_value'
      */
-    else
+    if (!conflict)
     {
       /* in case of down propagation 'fun_value' is a function application
        * and we can propagate 'app' instead. hence, we to not have to
@@ -1882,21 +2432,24 @@ propagate (Btor *btor,
             btor, fun_value, prop_stack, apply_search_cache);
 
       /* push applies in evaluated conditions */
-      btor_iter_hashptr_init (&it, conds);
-      while (btor_iter_hashptr_has_next (&it))
+      for (i = 0; i < BTOR_COUNT_STACK (beta->conds); i++)
       {
-        cur = btor_iter_hashptr_next (&it);
+        cur = BTOR_PEEK_STACK (beta->conds, i);
         push_applies_for_propagation (
             btor, cur, prop_stack, apply_search_cache);
-        btor_node_release (btor, cur);
       }
     }
-    btor_hashptr_table_delete (conds);
-    btor_node_release (btor, fun_value);
 
     /* stop at first conflict */
     if (restart && conflict) break;
   }
+
+  /* applies left on 'prop_stack' have to be propagated in the next round */
+  for (i = 0; i < BTOR_COUNT_STACK (*prop_stack); i += 2)
+  {
+    app = BTOR_PEEK_STACK (*prop_stack, i);
+    if (!app->propagated) get_prop_record (btor, state, app)->complete = false;
+  }
   btor_hashint_table_delete (conf_apps);
   slv->time.prop += btor_util_time_stamp () - start;
 }
@@ -2227,21 +2780,61 @@ push_unreachable_applies (Btor *btor, BtorNodePtrStack *init_apps)
   btor_hashint_table_delete (cache);
 }
 
+/* Collect the applies below inputs that are not reachable from the roots.
+ * Each input is followed by its applies and terminated by 0, which allows
+ * to reuse the result in every refinement round. */
+static void
+search_unreferenced_input_applies (Btor *btor, BtorNodePtrStack *input_apps)
+{
+  uint32_t i;
+  BtorNode *cur;
+  BtorNodePtrStack apps;
+  BtorIntHashTable *cache;
+  BtorPtrHashTableIterator it;
+
+  BTOR_INIT_STACK (btor->mm, apps);
+  cache = btor_hashint_table_new (btor->mm);
+
+  btor_iter_hashptr_init (&it, btor->inputs);
+  while (btor_iter_hashptr_has_next (&it))
+  {
+    cur = btor_simplify_exp (btor, btor_iter_hashptr_next (&it));
+    if (btor_node_real_addr (cur)->parents > 0 || btor_node_is_fun (cur))
+      continue;
+    push_applies_for_propagation (btor, cur, &apps, cache);
+    if (BTOR_EMPTY_STACK (apps)) continue;
+
+    BTOR_PUSH_STACK (*input_apps, cur);
+    /* 'apps' contains pairs of applies and their functions */
+    for (i = 0; i < BTOR_COUNT_STACK (apps); i += 2)
+      BTOR_PUSH_STACK (*input_apps, BTOR_PEEK_STACK (apps, i));
+    BTOR_PUSH_STACK (*input_apps, 0);
+    BTOR_RESET_STACK (apps);
+  }
+
+  btor_hashint_table_delete (cache);
+  BTOR_RELEASE_STACK (apps);
+}
+
 static void
 check_and_resolve_conflicts (Btor *btor,
                              Btor *clone,
                              BtorNode *clone_root,
                              BtorNodeMap *exp_map,
                              BtorNodePtrStack *init_apps,
-                             BtorIntHashTable *init_apps_cache)
+                             BtorIntHashTable *init_apps_cache,
+                             BtorNodePtrStack *input_apps,
+                             BtorIntHashTable *beta_results,
+                             BtorFunPropState *prop_state)
 {
   assert (btor);
   assert (btor->slv);
   assert (btor->slv->kind == BTOR_FUN_SOLVER_KIND);
 
   double start, start_cleanup;
-  bool found_conflicts;
+  bool found_conflicts, skip;
   int32_t i;
+  uint32_t j;
   BtorMemMgr *mm;
   BtorFunSolver *slv;
   BtorNode *app, *cur;
@@ -2273,15 +2866,24 @@ check_and_resolve_conflicts (Btor *btor,
    * computed for the substituted variable is correct. hence, we need to check
    * the applies for consistency and push them onto the propagation stack.
    * this also applies for don't care reasoning.
+   * the applies below these inputs do not change between refinement rounds,
+   * but lemmas may add parents to an input, hence we only cache the search
+   * and check for parents in every round.
    */
-  btor_iter_hashptr_init (&pit, btor->inputs);
-  while (btor_iter_hashptr_has_next (&pit))
+  for (j = 0; j < BTOR_COUNT_STACK (*input_apps); j++)
   {
-    cur = btor_simplify_exp (btor, btor_iter_hashptr_next (&pit));
+    cur = BTOR_PEEK_STACK (*input_apps, j);
     /* no parents -> is not reachable from the roots */
-    if (btor_node_real_addr (cur)->parents > 0 || btor_node_is_fun (cur))
-      continue;
-    push_applies_for_propagation (btor, cur, &prop_stack, apply_search_cache);
+    skip = btor_node_real_addr (cur)->parents > 0;
+    for (j++; (app = BTOR_PEEK_STACK (*input_apps, j)); j++)
+    {
+      if (skip || btor_hashint_table_contains (apply_search_cache, app->id))
+        continue;
+      btor_hashint_table_add (apply_search_cache, app->id);
+      BTOR_PUSH_STACK (prop_stack, app);
+      BTOR_PUSH_STACK (prop_stack, app->e[0]);
+      BTORLOG (2, "push apply: %s", btor_util_node2string (app));
+    }
   }
 
   if (clone)
@@ -2321,8 +2923,19 @@ check_and_resolve_conflicts (Btor *btor,
     BTORLOG (2, "push apply: %s", btor_util_node2string (app));
   }
 
-  propagate (btor, &prop_stack, cleanup_table, apply_search_cache);
+  /* applies propagated in previous rounds are only propagated again if the
+   * assignments they depend on changed */
+  update_prop_state (btor, prop_state, &prop_stack, cleanup_table);
+
+  propagate (btor,
+             &prop_stack,
+             cleanup_table,
+             apply_search_cache,
+             beta_results,
+             prop_state);
   found_conflicts = BTOR_COUNT_STACK (slv->cur_lemmas) > 0;
+  if (found_conflicts && btor_opt_get (btor, BTOR_OPT_FUN_MAX_LEMMAS) > 0)
+    limit_lemmas (btor, btor_opt_get (btor, BTOR_OPT_FUN_MAX_LEMMAS));
 
   /* check consistency of array/uf equalities */
   if (!found_conflicts && btor->feqs->count > 0)
@@ -2354,33 +2967,33 @@ check_and_resolve_conflicts (Btor *btor,
   {
     cur = btor_iter_hashptr_next (&pit);
     assert (btor_node_is_regular (cur));
-    if (btor_node_is_apply (cur))
-    {
-      /* generate model for apply */
-      if (!found_conflicts)
-        btor_bv_free (btor->mm, get_bv_assignment (btor, cur));
-      cur->propagated = 0;
-    }
-    else
+    assert (btor_node_is_apply (cur));
+    /* generate model for apply */
+    if (!found_conflicts)
+      btor_bv_free (btor->mm, get_bv_assignment (btor, cur));
+    cur->propagated = 0;
+  }
+
+  /* the rho tables are kept across refinement rounds and otherwise deleted
+   * with the propagation state */
+  if (!found_conflicts)
+  {
+    btor_iter_hashptr_init (&pit, prop_state->funs);
+    while (btor_iter_hashptr_has_next (&pit))
     {
-      assert (btor_node_is_fun (cur));
+      cur = btor_iter_hashptr_next (&pit);
       assert (cur->rho);
-
-      if (found_conflicts)
-      {
-        btor_hashptr_table_delete (cur->rho);
-        cur->rho = 0;
-      }
-      else
-      {
-        /* remember functions for incremental usage (and prevent
-         * premature release in case that function is released via API
-         * call) */
-        BTOR_PUSH_STACK (btor->functions_with_model,
-                         btor_node_copy (btor, cur));
-      }
+      /* remember functions for incremental usage (and prevent premature
+       * release in case that function is released via API call) */
+      BTOR_PUSH_STACK (btor->functions_with_model, cur);
     }
+    btor_hashptr_table_delete (prop_state->funs);
+    prop_state->funs =
+        btor_hashptr_table_new (mm,
+                                (BtorHashPtr) btor_node_hash_by_id,
+                                (BtorCmpPtr) btor_node_compare_by_id);
   }
+  reset_prop_state_changed (btor, prop_state);
   slv->time.prop_cleanup += btor_util_time_stamp () - start_cleanup;
   btor_hashptr_table_delete (cleanup_table);
   BTOR_RELEASE_STACK (prop_stack);
@@ -2405,6 +3018,158 @@ reset_lemma_cache (BtorFunSolver *slv)
                                         (BtorCmpPtr) btor_node_compare_by_id);
 }
 
+/*------------------------------------------------------------------------*/
+
+/* Prop or SLS engine run on a clone concurrently to the lemmas on demand
+ * loop (BTOR_OPT_FUN_PRE_CONCURRENT).  Whichever finishes first terminates
+ * the other. */
+struct BtorFunPreSolver
+{
+  Btor *btor;              /* original instance */
+  Btor *clone;             /* runs the prop/sls engine */
+  BtorOptEngine engine;    /* BTOR_ENGINE_PROP or BTOR_ENGINE_SLS */
+  BtorSolverResult result; /* BTOR_RESULT_SAT if prop/sls engine won */
+  bool done;               /* one of both engines is done (done_mutex) */
+  /* SAT solver termination callback of the original instance */
+  int32_t (*term_fun) (void *);
+  void *term_state;
+#ifdef BTOR_HAVE_PTHREADS
+  pthread_t thread;
+  pthread_mutex_t done_mutex;
+#endif
+};
+
+typedef struct BtorFunPreSolver BtorFunPreSolver;
+
+#ifdef BTOR_HAVE_PTHREADS
+static bool
+is_done_presolver (BtorFunPreSolver *ps)
+{
+  bool res;
+  pthread_mutex_lock (&ps->done_mutex);
+  res = ps->done;
+  pthread_mutex_unlock (&ps->done_mutex);
+  return res;
+}
+
+static int32_t
+terminate_presolver (void *state)
+{
+  return is_done_presolver (state);
+}
+
+static int32_t
+terminate_sat_presolver (void *state)
+{
+  BtorFunPreSolver *ps = state;
+  if (is_done_presolver (ps)) return 1;
+  return ps->term_fun ? ps->term_fun (ps->term_state) : 0;
+}
+
+static void *
+presolver_work (void *state)
+{
+  BtorFunPreSolver *ps;
+  BtorSolverResult res;
+
+  ps  = state;
+  res = ps->clone->slv->api.sat (ps->clone->slv);
+  pthread_mutex_lock (&ps->done_mutex);
+  /* the prop/sls engines only determine unsat for trivially false
+   * constraints, which does not give us failed assumptions */
+  if (!ps->done && res == BTOR_RESULT_SAT)
+  {
+    ps->done   = true;
+    ps->result = res;
+  }
+  pthread_mutex_unlock (&ps->done_mutex);
+  return NULL;
+}
+
+static BtorFunPreSolver *
+start_presolver (Btor *btor, BtorOptEngine engine)
+{
+  assert (btor);
+  assert (engine == BTOR_ENGINE_PROP || engine == BTOR_ENGINE_SLS);
+
+  BtorFunPreSolver *ps;
+  BtorSATMgr *smgr;
+  Btor *clone;
+
+  BTOR_CNEW (btor->mm, ps);
+  ps->btor   = btor;
+  ps->engine = engine;
+  ps->result = BTOR_RESULT_UNKNOWN;
+
+  clone = btor_clone_exp_layer (btor, 0, true);
+  clone->slv->api.delet (clone->slv);
+  btor_opt_set (clone, BTOR_OPT_ENGINE, engine);
+  clone->slv = engine == BTOR_ENGINE_PROP ? btor_new_prop_solver (clone)
+                                          : btor_new_sls_solver (clone);
+  btor_set_term (clone, terminate_presolver, ps);
+  ps->clone = clone;
+
+  /* the SAT solver of the original instance (re)installs its termination
+   * callback on every call, hence chaining it here is sufficient */
+  smgr           = btor_get_sat_mgr (btor);
+  ps->term_fun   = smgr->term.fun;
+  ps->term_state = smgr->term.state;
+  btor_sat_mgr_set_term (smgr, terminate_sat_presolver, ps);
+
+  pthread_mutex_init (&ps->done_mutex, 0);
+  pthread_create (&ps->thread, 0, presolver_work, ps);
+
+  BTOR_MSG (btor->msg,
+            1,
+            "started %s engine concurrently",
+            engine == BTOR_ENGINE_PROP ? "PROP" : "SLS");
+  return ps;
+}
+
+/* Terminate and join the prop/sls engine and return the result of whichever
+ * engine finished first. */
+static BtorSolverResult
+stop_presolver (BtorFunPreSolver *ps, BtorSolverResult result)
+{
+  assert (ps);
+
+  Btor *btor, *clone;
+
+  btor  = ps->btor;
+  clone = ps->clone;
+
+  pthread_mutex_lock (&ps->done_mutex);
+  ps->done = true;
+  pthread_mutex_unlock (&ps->done_mutex);
+  pthread_join (ps->thread, 0);
+  pthread_mutex_destroy (&ps->done_mutex);
+
+  btor_sat_mgr_set_term (btor_get_sat_mgr (btor), ps->term_fun, ps->term_state);
+
+  /* print prop/sls solver statistics */
+  clone->slv->api.print_stats (clone->slv);
+  clone->slv->api.print_time_stats (clone->slv);
+
+  if (result == BTOR_RESULT_UNKNOWN && ps->result == BTOR_RESULT_SAT)
+  {
+    result = BTOR_RESULT_SAT;
+    BTOR_FUN_SOLVER (btor)->stats.presolver_sat++;
+    BTOR_MSG (btor->msg, 1, "");
+    BTOR_MSG (btor->msg,
+              1,
+              "%s engine determined 'sat'",
+              ps->engine == BTOR_ENGINE_PROP ? "PROP" : "SLS");
+    /* the clone shares the node ids of the original instance */
+    btor_model_delete (btor);
+    btor->bv_model = btor_model_clone_bv (btor, clone->bv_model, true);
+  }
+
+  btor_delete (clone);
+  BTOR_DELETE (btor->mm, ps);
+  return result;
+}
+#endif
+
 static BtorSolverResult
 sat_fun_solver (BtorFunSolver *slv)
 {
@@ -2414,13 +3179,15 @@ sat_fun_solver (BtorFunSolver *slv)
   assert (slv->btor->slv == (BtorSolver *) slv);
 
   uint32_t i;
-  bool done;
+  bool pre, done;
   BtorSolverResult result;
   Btor *btor, *clone;
   BtorNode *clone_root, *lemma;
   BtorNodeMap *exp_map;
-  BtorIntHashTable *init_apps_cache;
-  BtorNodePtrStack init_apps;
+  BtorIntHashTable *init_apps_cache, *beta_results;
+  BtorNodePtrStack init_apps, input_apps;
+  BtorFunPreSolver *presolver;
+  BtorFunPropState prop_state;
 
   btor = slv->btor;
   assert (!btor->inconsistent);
@@ -2429,15 +3196,35 @@ sat_fun_solver (BtorFunSolver *slv)
    * traversing the whole formula every refinement round */
   BTOR_INIT_STACK (btor->mm, init_apps);
   init_apps_cache = btor_hashint_table_new (btor->mm);
+  /* same for applies below inputs that are not reachable from the roots */
+  BTOR_INIT_STACK (btor->mm, input_apps);
+  /* partial beta reductions of lambdas, reused across refinement rounds */
+  beta_results = btor_hashint_map_new (btor->mm);
+  /* rho tables and propagated applies, updated in every refinement round */
+  init_prop_state (btor, &prop_state);
 
   clone      = 0;
   clone_root = 0;
   exp_map    = 0;
+  presolver  = 0;
+
+  pre = (btor_opt_get (btor, BTOR_OPT_FUN_PREPROP)
+         || btor_opt_get (btor, BTOR_OPT_FUN_PRESLS))
+        && btor->ufs->count == 0 && btor->feqs->count == 0
+        && btor->lambdas->count == 0;
+
+#ifdef BTOR_HAVE_PTHREADS
+  if (pre && btor_opt_get (btor, BTOR_OPT_FUN_PRE_CONCURRENT))
+  {
+    presolver = start_presolver (btor,
+                                 btor_opt_get (btor, BTOR_OPT_FUN_PREPROP)
+                                     ? BTOR_ENGINE_PROP
+                                     : BTOR_ENGINE_SLS);
+    pre       = false;
+  }
+#endif
 
-  if ((btor_opt_get (btor, BTOR_OPT_FUN_PREPROP)
-       || btor_opt_get (btor, BTOR_OPT_FUN_PRESLS))
-      && btor->ufs->count == 0 && btor->feqs->count == 0
-      && btor->lambdas->count == 0)
+  if (pre)
   {
     BtorSolver *preslv;
     BtorOptEngine eopt;
@@ -2492,12 +3279,17 @@ sat_fun_solver (BtorFunSolver *slv)
 
   if (btor->feqs->count > 0) add_function_inequality_constraints (btor);
 
+  if (btor_opt_get (btor, BTOR_OPT_FUN_EAGER_UPDATES)) add_update_axioms (btor);
+
   /* initialize dual prop clone */
   if (btor_opt_get (btor, BTOR_OPT_FUN_DUAL_PROP))
   {
     clone = new_exp_layer_clone_for_dual_prop (btor, &exp_map, &clone_root);
   }
 
+  if (btor->ufs->count > 0 || btor->lambdas->count > 0)
+    search_unreferenced_input_applies (btor, &input_apps);
+
   while (true)
   {
     if (btor_terminate (btor)
@@ -2518,6 +3310,12 @@ sat_fun_solver (BtorFunSolver *slv)
     assert (btor_dbg_check_all_hash_tables_proxy_free (btor));
     assert (btor_dbg_check_all_hash_tables_simp_free (btor));
 
+#ifdef BTOR_HAVE_PTHREADS
+    /* the prop/sls engine may be done before bit-blasting is, and not every
+     * SAT solver supports termination */
+    if (presolver && is_done_presolver (presolver)) goto UNKNOWN;
+#endif
+
     /* make SAT call on bv skeleton */
     btor_add_again_assumptions (btor);
     result = timed_sat_sat (btor, slv->sat_limit);
@@ -2527,7 +3325,8 @@ sat_fun_solver (BtorFunSolver *slv)
     else if (result == BTOR_RESULT_UNKNOWN)
     {
       assert (slv->sat_limit > -1 || btor->cbs.term.done
-              || btor_opt_get (btor, BTOR_OPT_PRINT_DIMACS));
+              || btor_opt_get (btor, BTOR_OPT_PRINT_DIMACS)
+              || presolver);
       goto DONE;
     }
 
@@ -2535,8 +3334,15 @@ sat_fun_solver (BtorFunSolver *slv)
 
     if (btor->ufs->count == 0 && btor->lambdas->count == 0) break;
 
-    check_and_resolve_conflicts (
-        btor, clone, clone_root, exp_map, &init_apps, init_apps_cache);
+    check_and_resolve_conflicts (btor,
+                                 clone,
+                                 clone_root,
+                                 exp_map,
+                                 &init_apps,
+                                 init_apps_cache,
+                                 &input_apps,
+                                 beta_results,
+                                 &prop_state);
     if (BTOR_EMPTY_STACK (slv->cur_lemmas)) break;
     slv->stats.refinement_iterations++;
 
@@ -2575,7 +3381,14 @@ sat_fun_solver (BtorFunSolver *slv)
 
 DONE:
   BTOR_RELEASE_STACK (init_apps);
+  BTOR_RELEASE_STACK (input_apps);
   btor_hashint_table_delete (init_apps_cache);
+  delete_beta_results (btor, beta_results);
+  delete_prop_state (btor, &prop_state);
+
+#ifdef BTOR_HAVE_PTHREADS
+  if (presolver) result = stop_presolver (presolver, result);
+#endif
 
   if (clone)
   {
@@ -2606,6 +3419,11 @@ generate_model_fun_solver (BtorFunSolver *slv,
     btor_model_init_bv (slv->btor, &slv->btor->bv_model);
   btor_model_init_fun (slv->btor, &slv->btor->fun_model);
 
+  /* values are generated on demand by btor_model_get_bv/btor_model_get_fun */
+  slv->btor->lazy_model =
+      !model_for_all_nodes && btor_opt_get (slv->btor, BTOR_OPT_MODEL_GEN_LAZY);
+  if (slv->btor->lazy_model) return;
+
   btor_model_generate (slv->btor,
                        slv->btor->bv_model,
                        slv->btor->fun_model,
@@ -2650,6 +3468,13 @@ print_stats_fun_solver (BtorFunSolver *slv)
                 1,
                 "  %4d extensionality lemmas",
                 slv->stats.extensionality_lemmas);
+      BTOR_MSG (
+          btor->msg, 1, "  %4d update axioms", slv->stats.update_axioms);
+      BTOR_MSG (btor->msg, 1, "  %4d reused lemmas", slv->stats.reused_lemmas);
+      BTOR_MSG (btor->msg,
+                1,
+                "  %4d deferred lemmas",
+                slv->stats.deferred_lemmas);
       BTOR_MSG (btor->msg,
                 1,
                 "  %.1f average lemma size",
@@ -2677,6 +3502,14 @@ print_stats_fun_solver (BtorFunSolver *slv)
   BTOR_MSG (btor->msg, 1, "%7lld propagations", slv->stats.propagations);
   BTOR_MSG (
       btor->msg, 1, "%7lld propagations down", slv->stats.propagations_down);
+  BTOR_MSG (btor->msg,
+            1,
+            "%7lld propagations reused",
+            slv->stats.propagations_reused);
+  BTOR_MSG (btor->msg,
+            1,
+            "%7lld propagations skipped",
+            slv->stats.propagations_skipped);
 
   if (btor_opt_get (btor, BTOR_OPT_FUN_DUAL_PROP))
   {
@@ -2691,6 +3524,12 @@ print_stats_fun_solver (BtorFunSolver *slv)
               slv->stats.dp_failed_applies,
               slv->stats.dp_assumed_applies);
   }
+
+  if (btor_opt_get (btor, BTOR_OPT_FUN_PRE_CONCURRENT))
+    BTOR_MSG (btor->msg,
+              1,
+              "%d sat calls decided by concurrent prop/sls engine",
+              slv->stats.presolver_sat);
 }
 
 static void
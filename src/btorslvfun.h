@@ -37,6 +37,13 @@ struct BtorFunSolver
     uint32_t function_congruence_conflicts;
     uint32_t beta_reduction_conflicts;
     uint32_t extensionality_lemmas;
+    uint32_t update_axioms; /* number of eager read over write axioms */
+    uint32_t reused_lemmas;   /* number of conflicts resolved by an
+                                 already generated lemma */
+    uint32_t deferred_lemmas; /* number of lemmas not added due to
+                                 BTOR_OPT_FUN_MAX_LEMMAS */
+    uint32_t presolver_sat;   /* number of sat calls decided by the
+                                 concurrent prop/sls engine */
 
     BtorUIntStack lemmas_size;      /* distribution of n-size lemmas */
     uint_least64_t lemmas_size_sum; /* sum of the size of all added lemmas */
@@ -53,6 +60,12 @@ struct BtorFunSolver
     uint_least64_t eval_exp_calls;
     uint_least64_t propagations;
     uint_least64_t propagations_down;
+    uint_least64_t propagations_reused; /* propagations over lambdas that
+                                           reuse the partial beta reduction
+                                           of a previous refinement round */
+    uint_least64_t propagations_skipped; /* applies not propagated again
+                                            since the assignments they
+                                            depend on did not change */
   } stats;
 
   struct
@@ -121,6 +121,8 @@ enum BtorOption
         `Aiger ascii format <http://fmv.jku.at/papers/BiereHeljankoWieringa-FMV-TR-11-2.pdf>`_
       * BTOR_OUTPUT_FORMAT_AIGER_BINARY:
         `Aiger binary format <http://fmv.jku.at/papers/BiereHeljankoWieringa-FMV-TR-11-2.pdf>`_
+      * BTOR_OUTPUT_FORMAT_BINARY:
+        Boolector's binary formula format (fast to load, see boolector_dump_binary)
   */
   BTOR_OPT_OUTPUT_FORMAT,
 
@@ -835,6 +837,90 @@ enum BtorOption
    */
   BTOR_OPT_QUANT_MINISCOPE,
 
+  /*!
+    * **BTOR_OPT_RW_CACHE_SIZE**
+
+      Set the maximum size of the rewrite cache in MB (default: 128).  If the
+      cache is full, least recently used entries are evicted.
+   */
+  BTOR_OPT_RW_CACHE_SIZE,
+
+  /*!
+    * **BTOR_OPT_RW_CACHE_SHARED**
+
+      Enable (``value``: 1) or disable (``value``: 0) the process-wide rewrite
+      cache, which is shared between all Boolector instances that enable
+      this option (and is thread-safe).  Entries are keyed by structural
+      hashes instead of node ids, and hence rewrite results learned by one
+      instance are reused by instances that create structurally equivalent
+      terms.  Variables are identified by their symbol and width, or, if they
+      do not have a symbol, by their id.
+
+      * True (``value``: 1)
+      * False (``value``: 0) [**default**]
+   */
+  BTOR_OPT_RW_CACHE_SHARED,
+
+  /*!
+    * **BTOR_OPT_MODEL_GEN_LAZY**
+
+      Enable (``value``: 1) or disable (``value``: 0) lazy model generation.
+      If enabled, model values are not generated for all asserted expressions
+      after a satisfiable call to boolector_sat, but for the cone of an
+      expression when its assignment is queried for the first time, and are
+      cached until the next call to boolector_sat.  Querying the model of an
+      array or function generates model values for all asserted expressions.
+      This is only supported by engine BTOR_ENGINE_FUN and ignored if a model
+      for all expressions is requested (``BTOR_OPT_MODEL_GEN``: 2).
+
+      * True (``value``: 1)
+      * False (``value``: 0) [**default**]
+   */
+  BTOR_OPT_MODEL_GEN_LAZY,
+
+  /*!
+    * **BTOR_OPT_FUN_PRE_CONCURRENT**
+
+      Enable (``value``: 1) or disable (``value``: 0) running the prop or sls
+      engine enabled via BTOR_OPT_FUN_PREPROP or BTOR_OPT_FUN_PRESLS
+      concurrently to (rather than before) the fun engine.  The prop/sls
+      engine is run on a clone in a separate thread, and whichever engine
+      finishes first terminates the other.  Requires pthreads, falls back to
+      running the engines sequentially otherwise.
+
+      * True (``value``: 1)
+      * False (``value``: 0) [**default**]
+   */
+  BTOR_OPT_FUN_PRE_CONCURRENT,
+
+  /*!
+    * **BTOR_OPT_FUN_MAX_LEMMAS**
+
+      | Set the maximum number of lemmas added per refinement iteration of
+        the fun engine (``value``: 0 for no limit).  If more conflicts are
+        found (see BTOR_OPT_FUN_EAGER_LEMMAS), lemmas with fewer premises are
+        considered stronger and added first, the remaining conflicts are
+        checked again in the next refinement iteration.
+      | Default: 0
+   */
+  BTOR_OPT_FUN_MAX_LEMMAS,
+
+  /*!
+    * **BTOR_OPT_FUN_EAGER_UPDATES**
+
+      Enable (``value``: 1) or disable (``value``: 0) eager instantiation of
+      read over write axioms.  If enabled, the fun engine adds the axioms for
+      all reads on stores (and their reads on the stored-to arrays) to the
+      SAT solver before the first refinement iteration.  Consistency of
+      reads over writes is then enforced by the SAT solver during search
+      rather than via lemmas on demand after a full model was found, at the
+      cost of a larger bit vector skeleton.
+
+      * True (``value``: 1)
+      * False (``value``: 0) [**default**]
+   */
+  BTOR_OPT_FUN_EAGER_UPDATES,
+
   /* internal options --------------------------------------------------- */
 
   BTOR_OPT_SORT_EXP,
@@ -855,6 +941,7 @@ enum BtorOption
   BTOR_OPT_QUANT_FIXSYNTH,
   BTOR_OPT_RW_ZERO_LOWER_SLICE,
   BTOR_OPT_NONDESTR_SUBST,
+  BTOR_OPT_DUMP_N_THREADS,
   /* this MUST be the last entry! */
   BTOR_OPT_NUM_OPTS,
 };
@@ -916,6 +1003,7 @@ enum BtorOptOutputFormat
   BTOR_OUTPUT_FORMAT_SMT2,
   BTOR_OUTPUT_FORMAT_AIGER_ASCII,
   BTOR_OUTPUT_FORMAT_AIGER_BINARY,
+  BTOR_OUTPUT_FORMAT_BINARY,
 };
 typedef enum BtorOptOutputFormat BtorOptOutputFormat;
 
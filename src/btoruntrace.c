@@ -436,6 +436,7 @@ enum
 };
 
 BTOR_DECLARE_STACK (BoolectorSort, BoolectorSort);
+BTOR_DECLARE_STACK (BoolectorNodePtr, BoolectorNode *);
 
 #define BTOR_STR_LEN 40
 
@@ -462,6 +463,7 @@ parse (FILE *file)
   uint32_t len, buffer_len, val;
   char *buffer, *tok, *basename;
   BoolectorNode **tmp;
+  uint64_t *values;
   BtorPtrHashTable *hmap;
   BtorOption opt;
   Btor *btor;
@@ -483,6 +485,9 @@ parse (FILE *file)
   BtorIntStack arg_int;
   BtorCharPtrStack arg_str;
   BoolectorSortStack sort_stack;
+  BoolectorNodePtrStack set_nodes;
+  BtorUIntStack set_sizes;
+  int32_t *set_results;
 
   Btor *tmpbtor;
   FILE *outfile;
@@ -771,6 +776,31 @@ NEXT:
       ret_int = boolector_limited_sat (btor, arg1_int, arg2_int);
       exp_ret = g_btorunt->ignore_sat ? RET_SKIP : RET_INT;
     }
+    else if (!strcmp (tok, "sat_parallel"))
+    {
+      arg1_uint = parse_uint_arg (tok); /* nsets */
+      arg2_uint = parse_uint_arg (tok); /* nthreads */
+      BTOR_INIT_STACK (g_btorunt->mm, set_sizes);
+      BTOR_INIT_STACK (g_btorunt->mm, set_nodes);
+      for (i = 0; i < arg1_uint; i++)
+      {
+        val = parse_uint_arg (tok); /* size of set */
+        BTOR_PUSH_STACK (set_sizes, val);
+        for (; val > 0; val--) /* assumptions */
+          BTOR_PUSH_STACK (set_nodes, hmap_get (hmap, parse_str_arg (tok)));
+      }
+      parse_check_last_arg (tok);
+      BTOR_NEWN (g_btorunt->mm, set_results, arg1_uint);
+      boolector_sat_parallel (btor,
+                              set_nodes.start,
+                              set_sizes.start,
+                              arg1_uint,
+                              arg2_uint,
+                              set_results);
+      BTOR_DELETEN (g_btorunt->mm, set_results, arg1_uint);
+      BTOR_RELEASE_STACK (set_nodes);
+      BTOR_RELEASE_STACK (set_sizes);
+    }
     else if (!strcmp (tok, "simplify"))
     {
       PARSE_ARGS0 (tok);
@@ -1753,6 +1783,32 @@ NEXT:
       PARSE_ARGS1 (tok, str);
       boolector_free_bv_assignment (btor, hmap_get (hmap, arg1_str));
     }
+    else if (!strcmp (tok, "bv_assignment_u64"))
+    {
+      PARSE_ARGS1 (tok, str);
+      (void) boolector_bv_assignment_u64 (btor, hmap_get (hmap, arg1_str));
+      exp_ret = RET_SKIP;
+    }
+    else if (!strcmp (tok, "bv_assignment_words"))
+    {
+      PARSE_ARGS2 (tok, str, uint);
+      BTOR_NEWN (g_btorunt->mm, values, arg2_uint);
+      boolector_bv_assignment_words (
+          btor, hmap_get (hmap, arg1_str), values, arg2_uint);
+      BTOR_DELETEN (g_btorunt->mm, values, arg2_uint);
+    }
+    else if (!strcmp (tok, "bv_assignments"))
+    {
+      arg1_uint = parse_uint_arg (tok); /* n */
+      BTOR_NEWN (g_btorunt->mm, tmp, arg1_uint);
+      for (i = 0; i < arg1_uint; i++) /* nodes */
+        tmp[i] = hmap_get (hmap, parse_str_arg (tok));
+      parse_check_last_arg (tok);
+      BTOR_NEWN (g_btorunt->mm, values, arg1_uint);
+      boolector_bv_assignments (btor, tmp, arg1_uint, values);
+      BTOR_DELETEN (g_btorunt->mm, values, arg1_uint);
+      BTOR_DELETEN (g_btorunt->mm, tmp, arg1_uint);
+    }
     else if (!strcmp (tok, "array_assignment"))
     {
       PARSE_ARGS1 (tok, str);
@@ -1926,7 +1982,8 @@ NEXT:
       PARSE_ARGS1 (tok, str);
       boolector_dump_smt2_node (btor, stdout, hmap_get (hmap, arg1_str));
     }
-    else if (!strcmp (tok, "dump_btor") || !strcmp (tok, "dump_smt2"))
+    else if (!strcmp (tok, "dump_btor") || !strcmp (tok, "dump_smt2")
+             || !strcmp (tok, "dump_binary"))
     {
       PARSE_ARGS0 (tok);
 
@@ -1934,6 +1991,8 @@ NEXT:
       {
         if (!strcmp (tok, "dump_btor"))
           boolector_dump_btor (btor, stdout);
+        else if (!strcmp (tok, "dump_binary"))
+          boolector_dump_binary (btor, stdout);
         else
           boolector_dump_smt2 (btor, stdout);
       }
@@ -1954,6 +2013,13 @@ NEXT:
           assert (outfile);
           boolector_dump_btor (btor, outfile);
         }
+        else if (!strcmp (tok, "dump_binary"))
+        {
+          sprintf (outfilename, "/tmp/%s.%s", basename, "btorbin");
+          outfile = fopen (outfilename, "w");
+          assert (outfile);
+          boolector_dump_binary (btor, outfile);
+        }
         else
         {
           sprintf (outfilename, "/tmp/%s.%s", basename, "smt2");
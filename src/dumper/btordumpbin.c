@@ -0,0 +1,520 @@
+/*  Boolector: Satisfiability Modulo Theories (SMT) solver.
+ *
+ *  Copyright (C) 2007-2021 by the authors listed in the AUTHORS file.
+ *
+ *  This file is part of Boolector.
+ *  See COPYING for more information on using this software.
+ */
+
+#include "btordumpbin.h"
+#include "btorbv.h"
+#include "btorcore.h"
+#include "btorexp.h"
+#include "btornode.h"
+#include "btorsort.h"
+#include "utils/btorhashint.h"
+#include "utils/btorhashptr.h"
+#include "utils/btormem.h"
+#include "utils/btorstack.h"
+
+#include <string.h>
+
+#define BTOR_BIN_BUFFER_SIZE (1 << 16)
+
+typedef struct BtorDumpBin BtorDumpBin;
+
+struct BtorDumpBin
+{
+  Btor *btor;
+  FILE *file;
+  BtorIntHashTable *node_index; /* node id -> index in 'nodes' */
+  BtorIntHashTable *sort_index; /* sort id -> index in 'sorts' */
+  BtorNodePtrStack nodes;       /* children before parents */
+  BtorNodePtrStack consts;      /* constants in order of 'nodes' */
+  BtorNodePtrStack symbols;     /* nodes with symbols in order of 'nodes' */
+  BtorSortIdStack sorts;        /* components before compound sorts */
+  size_t pos;
+  unsigned char buf[BTOR_BIN_BUFFER_SIZE];
+};
+
+/*------------------------------------------------------------------------*/
+
+static void
+flush_bin (BtorDumpBin *bin)
+{
+  if (bin->pos) fwrite (bin->buf, 1, bin->pos, bin->file);
+  bin->pos = 0;
+}
+
+static void
+put_bytes_bin (BtorDumpBin *bin, const void *bytes, size_t n)
+{
+  if (bin->pos + n > BTOR_BIN_BUFFER_SIZE)
+  {
+    flush_bin (bin);
+    if (n > BTOR_BIN_BUFFER_SIZE)
+    {
+      fwrite (bytes, 1, n, bin->file);
+      return;
+    }
+  }
+  memcpy (bin->buf + bin->pos, bytes, n);
+  bin->pos += n;
+}
+
+static void
+put_uint_bin (BtorDumpBin *bin, uint64_t val)
+{
+  unsigned char *p;
+
+  /* a varint has at most 10 bytes */
+  if (bin->pos + 10 > BTOR_BIN_BUFFER_SIZE) flush_bin (bin);
+  p = bin->buf + bin->pos;
+  while (val >= 0x80)
+  {
+    *p++ = (unsigned char) (val | 0x80);
+    val >>= 7;
+  }
+  *p++     = (unsigned char) val;
+  bin->pos = p - bin->buf;
+}
+
+/*------------------------------------------------------------------------*/
+
+static uint32_t
+node_index_bin (BtorDumpBin *bin, BtorNode *exp)
+{
+  BtorHashTableData *d;
+
+  d = btor_hashint_map_get (bin->node_index,
+                            btor_node_real_addr (exp)->id);
+  assert (d);
+  assert (d->as_int >= 0);
+  return (uint32_t) d->as_int;
+}
+
+/* Reference to 'child' relative to the node with index 'index'. */
+static void
+put_child_bin (BtorDumpBin *bin, uint32_t index, BtorNode *child)
+{
+  uint32_t cindex;
+
+  child  = btor_node_get_simplified (bin->btor, child);
+  cindex = node_index_bin (bin, child);
+  assert (cindex < index);
+  put_uint_bin (bin,
+                ((uint64_t) (index - cindex) << 1)
+                    | btor_node_is_inverted (child));
+}
+
+/*------------------------------------------------------------------------*/
+
+static void
+collect_sort_bin (BtorDumpBin *bin, BtorSortId id)
+{
+  uint32_t i;
+  BtorSort *sort;
+  BtorSortIdStack visit;
+  BtorHashTableData *d;
+
+  BTOR_INIT_STACK (bin->btor->mm, visit);
+  BTOR_PUSH_STACK (visit, id);
+  while (!BTOR_EMPTY_STACK (visit))
+  {
+    id = BTOR_POP_STACK (visit);
+    d  = btor_hashint_map_get (bin->sort_index, id);
+    if (!d)
+    {
+      btor_hashint_map_add (bin->sort_index, id)->as_int = -1;
+      BTOR_PUSH_STACK (visit, id);
+      sort = btor_sort_get_by_id (bin->btor, id);
+      if (sort->kind == BTOR_TUPLE_SORT)
+      {
+        for (i = 0; i < sort->tuple.num_elements; i++)
+          BTOR_PUSH_STACK (visit, sort->tuple.elements[i]->id);
+      }
+      else if (sort->kind == BTOR_FUN_SORT)
+      {
+        BTOR_PUSH_STACK (visit, sort->fun.codomain->id);
+        BTOR_PUSH_STACK (visit, sort->fun.domain->id);
+      }
+    }
+    else if (d->as_int == -1)
+    {
+      d->as_int = BTOR_COUNT_STACK (bin->sorts);
+      BTOR_PUSH_STACK (bin->sorts, id);
+    }
+  }
+  BTOR_RELEASE_STACK (visit);
+}
+
+static void
+collect_nodes_bin (BtorDumpBin *bin, BtorNode *root)
+{
+  uint32_t i;
+  BtorNode *cur;
+  BtorNodePtrStack visit;
+  BtorHashTableData *d;
+  BtorPtrHashTable *rho;
+  BtorPtrHashTableIterator it;
+
+  BTOR_INIT_STACK (bin->btor->mm, visit);
+  BTOR_PUSH_STACK (visit, root);
+  while (!BTOR_EMPTY_STACK (visit))
+  {
+    cur = BTOR_POP_STACK (visit);
+    cur = btor_node_real_addr (btor_node_get_simplified (bin->btor, cur));
+    d   = btor_hashint_map_get (bin->node_index, cur->id);
+    if (!d)
+    {
+      btor_hashint_map_add (bin->node_index, cur->id)->as_int = -1;
+      BTOR_PUSH_STACK (visit, cur);
+      for (i = 0; i < cur->arity; i++) BTOR_PUSH_STACK (visit, cur->e[i]);
+      if (btor_node_is_lambda (cur)
+          && (rho = btor_node_lambda_get_static_rho (cur)))
+      {
+        btor_iter_hashptr_init (&it, rho);
+        while (btor_iter_hashptr_has_next (&it))
+        {
+          BTOR_PUSH_STACK (visit, it.bucket->data.as_ptr);
+          BTOR_PUSH_STACK (visit, btor_iter_hashptr_next (&it));
+        }
+      }
+    }
+    else if (d->as_int == -1)
+    {
+      d->as_int = BTOR_COUNT_STACK (bin->nodes);
+      BTOR_PUSH_STACK (bin->nodes, cur);
+      if (btor_node_is_bv_const (cur))
+        BTOR_PUSH_STACK (bin->consts, cur);
+      else if (btor_node_is_bv_var (cur) || btor_node_is_param (cur)
+               || btor_node_is_uf (cur))
+      {
+        collect_sort_bin (bin, cur->sort_id);
+        if (btor_node_get_symbol (bin->btor, cur))
+          BTOR_PUSH_STACK (bin->symbols, cur);
+      }
+    }
+  }
+  BTOR_RELEASE_STACK (visit);
+}
+
+/* Inputs eliminated by simplification are not reachable from the roots and
+ * are added as nodes without children after all other nodes.  Hence, an
+ * input is always dumped after the expression it was substituted with. */
+static void
+collect_input_bin (BtorDumpBin *bin, BtorNode *input)
+{
+  assert (btor_node_is_regular (input));
+
+  if (btor_hashint_map_contains (bin->node_index, input->id)) return;
+  btor_hashint_map_add (bin->node_index, input->id)->as_int =
+      BTOR_COUNT_STACK (bin->nodes);
+  BTOR_PUSH_STACK (bin->nodes, input);
+  collect_sort_bin (bin, input->sort_id);
+  if (btor_node_get_symbol (bin->btor, input))
+    BTOR_PUSH_STACK (bin->symbols, input);
+}
+
+/*------------------------------------------------------------------------*/
+
+static void
+dump_sorts_bin (BtorDumpBin *bin)
+{
+  uint32_t i, j;
+  BtorSort *sort;
+
+  put_uint_bin (bin, BTOR_BIN_SECTION_SORTS);
+  put_uint_bin (bin, BTOR_COUNT_STACK (bin->sorts));
+  for (i = 0; i < BTOR_COUNT_STACK (bin->sorts); i++)
+  {
+    sort = btor_sort_get_by_id (bin->btor, BTOR_PEEK_STACK (bin->sorts, i));
+    put_uint_bin (bin, sort->kind);
+    switch (sort->kind)
+    {
+      case BTOR_BOOL_SORT: break;
+      case BTOR_BV_SORT: put_uint_bin (bin, sort->bitvec.width); break;
+      case BTOR_TUPLE_SORT:
+        put_uint_bin (bin, sort->tuple.num_elements);
+        for (j = 0; j < sort->tuple.num_elements; j++)
+          put_uint_bin (
+              bin,
+              btor_hashint_map_get (bin->sort_index,
+                                    sort->tuple.elements[j]->id)
+                  ->as_int);
+        break;
+      default:
+        assert (sort->kind == BTOR_FUN_SORT);
+        put_uint_bin (
+            bin,
+            btor_hashint_map_get (bin->sort_index, sort->fun.domain->id)
+                ->as_int);
+        put_uint_bin (
+            bin,
+            btor_hashint_map_get (bin->sort_index, sort->fun.codomain->id)
+                ->as_int);
+        put_uint_bin (bin, sort->fun.is_array);
+    }
+  }
+}
+
+static void
+dump_consts_bin (BtorDumpBin *bin)
+{
+  uint32_t i, j, k, width;
+  unsigned char byte;
+  BtorBitVector *bits;
+
+  put_uint_bin (bin, BTOR_BIN_SECTION_CONSTS);
+  put_uint_bin (bin, BTOR_COUNT_STACK (bin->consts));
+  for (i = 0; i < BTOR_COUNT_STACK (bin->consts); i++)
+  {
+    bits  = btor_node_bv_const_get_bits (BTOR_PEEK_STACK (bin->consts, i));
+    width = btor_bv_get_width (bits);
+    put_uint_bin (bin, width);
+    for (j = 0; j < width; j += 8)
+    {
+      for (byte = 0, k = 0; k < 8 && j + k < width; k++)
+        byte |= btor_bv_get_bit (bits, j + k) << k;
+      put_bytes_bin (bin, &byte, 1);
+    }
+  }
+}
+
+static void
+dump_symbols_bin (BtorDumpBin *bin)
+{
+  uint32_t i;
+  size_t len;
+  char *symbol;
+
+  put_uint_bin (bin, BTOR_BIN_SECTION_SYMBOLS);
+  put_uint_bin (bin, BTOR_COUNT_STACK (bin->symbols));
+  for (i = 0; i < BTOR_COUNT_STACK (bin->symbols); i++)
+  {
+    symbol =
+        btor_node_get_symbol (bin->btor, BTOR_PEEK_STACK (bin->symbols, i));
+    len = strlen (symbol);
+    put_uint_bin (bin, len);
+    put_bytes_bin (bin, symbol, len);
+  }
+}
+
+static void
+dump_nodes_bin (BtorDumpBin *bin)
+{
+  uint32_t i, j, nconsts, nsymbols;
+  BtorNodeKind kind;
+  BtorNode *cur, *args, *value;
+  BtorPtrHashTable *rho;
+  BtorPtrHashTableIterator it;
+
+  put_uint_bin (bin, BTOR_BIN_SECTION_NODES);
+  put_uint_bin (bin, BTOR_COUNT_STACK (bin->nodes));
+  nconsts = nsymbols = 0;
+  for (i = 0; i < BTOR_COUNT_STACK (bin->nodes); i++)
+  {
+    cur  = BTOR_PEEK_STACK (bin->nodes, i);
+    kind = cur->kind;
+    /* eliminated inputs (see collect_input_bin) */
+    if (kind == BTOR_PROXY_NODE)
+      kind = btor_sort_is_fun (bin->btor, cur->sort_id) ? BTOR_UF_NODE
+                                                         : BTOR_VAR_NODE;
+    put_uint_bin (
+        bin,
+        kind | (cur->is_array ? BTOR_BIN_FLAG_IS_ARRAY : 0)
+                   << BTOR_BIN_KIND_BITS);
+    switch (kind)
+    {
+      case BTOR_BV_CONST_NODE:
+        assert (BTOR_PEEK_STACK (bin->consts, nconsts) == cur);
+        put_uint_bin (bin, nconsts++);
+        break;
+      case BTOR_VAR_NODE:
+      case BTOR_PARAM_NODE:
+      case BTOR_UF_NODE:
+        put_uint_bin (
+            bin, btor_hashint_map_get (bin->sort_index, cur->sort_id)->as_int);
+        if (nsymbols < BTOR_COUNT_STACK (bin->symbols)
+            && BTOR_PEEK_STACK (bin->symbols, nsymbols) == cur)
+          put_uint_bin (bin, ++nsymbols);
+        else
+          put_uint_bin (bin, 0);
+        break;
+      case BTOR_BV_SLICE_NODE:
+        put_child_bin (bin, i, cur->e[0]);
+        put_uint_bin (bin, btor_node_bv_slice_get_upper (cur));
+        put_uint_bin (bin, btor_node_bv_slice_get_lower (cur));
+        break;
+      case BTOR_ARGS_NODE:
+        put_uint_bin (bin, cur->arity);
+        for (j = 0; j < cur->arity; j++) put_child_bin (bin, i, cur->e[j]);
+        break;
+      case BTOR_LAMBDA_NODE:
+        put_child_bin (bin, i, cur->e[0]);
+        put_child_bin (bin, i, cur->e[1]);
+        rho = btor_node_lambda_get_static_rho (cur);
+        put_uint_bin (bin, rho ? rho->count : 0);
+        if (!rho) break;
+        btor_iter_hashptr_init (&it, rho);
+        while (btor_iter_hashptr_has_next (&it))
+        {
+          value = it.bucket->data.as_ptr;
+          args  = btor_iter_hashptr_next (&it);
+          put_child_bin (bin, i, args);
+          put_child_bin (bin, i, value);
+        }
+        break;
+      default:
+        for (j = 0; j < cur->arity; j++) put_child_bin (bin, i, cur->e[j]);
+    }
+  }
+}
+
+/*------------------------------------------------------------------------*/
+
+static void
+dump_inputs_bin (BtorDumpBin *bin)
+{
+  uint32_t flags;
+  BtorNode *input, *subst;
+  BtorHashTableData *data;
+  BtorPtrHashTableIterator it;
+
+  put_uint_bin (bin, BTOR_BIN_SECTION_INPUTS);
+  put_uint_bin (bin, bin->btor->inputs->count);
+  btor_iter_hashptr_init (&it, bin->btor->inputs);
+  while (btor_iter_hashptr_has_next (&it))
+  {
+    data  = &it.bucket->data;
+    input = btor_iter_hashptr_next (&it);
+    flags = data->flag ? BTOR_BIN_INPUT_BOOL : 0;
+    subst = btor_node_get_simplified (bin->btor, input);
+    if (subst != input) flags |= BTOR_BIN_INPUT_SUBST;
+    put_uint_bin (bin, node_index_bin (bin, input));
+    put_uint_bin (bin, flags);
+    put_uint_bin (bin, (uint32_t) data->as_int);
+    if (flags & BTOR_BIN_INPUT_SUBST)
+      put_uint_bin (bin,
+                    ((uint64_t) node_index_bin (bin, subst) << 1)
+                        | btor_node_is_inverted (subst));
+  }
+}
+
+static void
+dump_bin (Btor *btor,
+          FILE *file,
+          BtorNode **roots,
+          uint32_t nroots,
+          bool with_inputs)
+{
+  assert (btor);
+  assert (file);
+  assert (roots || !nroots);
+
+  uint32_t i;
+  BtorNode *root, *input;
+  BtorDumpBin *bin;
+  BtorPtrHashTableIterator it;
+
+  BTOR_CNEW (btor->mm, bin);
+  bin->btor       = btor;
+  bin->file       = file;
+  bin->node_index = btor_hashint_map_new (btor->mm);
+  bin->sort_index = btor_hashint_map_new (btor->mm);
+  BTOR_INIT_STACK (btor->mm, bin->nodes);
+  BTOR_INIT_STACK (btor->mm, bin->consts);
+  BTOR_INIT_STACK (btor->mm, bin->symbols);
+  BTOR_INIT_STACK (btor->mm, bin->sorts);
+
+  for (i = 0; i < nroots; i++) collect_nodes_bin (bin, roots[i]);
+  if (with_inputs)
+  {
+    btor_iter_hashptr_init (&it, btor->inputs);
+    while (btor_iter_hashptr_has_next (&it))
+      collect_nodes_bin (bin, btor_iter_hashptr_next (&it));
+    btor_iter_hashptr_init (&it, btor->inputs);
+    while (btor_iter_hashptr_has_next (&it))
+    {
+      input = btor_iter_hashptr_next (&it);
+      if (btor_node_get_simplified (btor, input) != input)
+        collect_input_bin (bin, input);
+    }
+  }
+
+  put_bytes_bin (bin, BTOR_BIN_MAGIC, BTOR_BIN_MAGIC_SIZE);
+  put_uint_bin (bin, BTOR_BIN_VERSION);
+  dump_sorts_bin (bin);
+  dump_consts_bin (bin);
+  dump_symbols_bin (bin);
+  dump_nodes_bin (bin);
+  if (with_inputs)
+  {
+    dump_inputs_bin (bin);
+    if (btor->simplified) put_uint_bin (bin, BTOR_BIN_SECTION_SIMPLIFIED);
+  }
+
+  put_uint_bin (bin, BTOR_BIN_SECTION_ROOTS);
+  put_uint_bin (bin, nroots);
+  for (i = 0; i < nroots; i++)
+  {
+    root = btor_node_get_simplified (btor, roots[i]);
+    put_uint_bin (bin,
+                  ((uint64_t) node_index_bin (bin, root) << 1)
+                      | btor_node_is_inverted (root));
+  }
+  put_uint_bin (bin, BTOR_BIN_SECTION_END);
+  flush_bin (bin);
+
+  BTOR_RELEASE_STACK (bin->sorts);
+  BTOR_RELEASE_STACK (bin->symbols);
+  BTOR_RELEASE_STACK (bin->consts);
+  BTOR_RELEASE_STACK (bin->nodes);
+  btor_hashint_map_delete (bin->sort_index);
+  btor_hashint_map_delete (bin->node_index);
+  BTOR_DELETE (btor->mm, bin);
+}
+
+void
+btor_dumpbin_dump_nodes (Btor *btor,
+                         FILE *file,
+                         BtorNode **roots,
+                         uint32_t nroots)
+{
+  dump_bin (btor, file, roots, nroots, false);
+}
+
+void
+btor_dumpbin_dump (Btor *btor, FILE *file)
+{
+  assert (btor);
+  assert (file);
+
+  BtorNode *tmp;
+  BtorNodePtrStack roots;
+  BtorPtrHashTableIterator it;
+
+  BTOR_INIT_STACK (btor->mm, roots);
+
+  if (btor->inconsistent)
+    BTOR_PUSH_STACK (roots, btor_exp_false (btor));
+  else if (btor->unsynthesized_constraints->count == 0
+           && btor->synthesized_constraints->count == 0)
+    BTOR_PUSH_STACK (roots, btor_exp_true (btor));
+  else
+  {
+    btor_iter_hashptr_init (&it, btor->unsynthesized_constraints);
+    btor_iter_hashptr_queue (&it, btor->synthesized_constraints);
+    while (btor_iter_hashptr_has_next (&it))
+    {
+      tmp = btor_iter_hashptr_next (&it);
+      BTOR_PUSH_STACK (roots, btor_node_copy (btor, tmp));
+    }
+  }
+
+  dump_bin (btor, file, roots.start, BTOR_COUNT_STACK (roots), true);
+
+  while (!BTOR_EMPTY_STACK (roots))
+    btor_node_release (btor, BTOR_POP_STACK (roots));
+  BTOR_RELEASE_STACK (roots);
+}
@@ -0,0 +1,92 @@
+/*  Boolector: Satisfiability Modulo Theories (SMT) solver.
+ *
+ *  Copyright (C) 2007-2021 by the authors listed in the AUTHORS file.
+ *
+ *  This file is part of Boolector.
+ *  See COPYING for more information on using this software.
+ */
+#ifndef BTORDUMPBIN_H_INCLUDED
+#define BTORDUMPBIN_H_INCLUDED
+
+#include <stdint.h>
+#include <stdio.h>
+#include "btortypes.h"
+
+/*------------------------------------------------------------------------*/
+/* Binary formula format.
+ *
+ * All numbers are unsigned LEB128 varints.  A file starts with the 8 byte
+ * magic BTOR_BIN_MAGIC followed by the format version and a sequence of
+ * sections, each introduced by its section tag and terminated by
+ * BTOR_BIN_SECTION_END.  All tables are indexed from 0 in the order of their
+ * entries:
+ *
+ *   SORTS    <n> n x (<kind> <bv: width>
+ *                            <tuple: m m x sort>
+ *                            <fun: domain codomain is_array>)
+ *   CONSTS   <n> n x (<width> <(width + 7) / 8 bytes, least significant first>)
+ *   SYMBOLS  <n> n x (<len> <len bytes>)
+ *   NODES    <n> n x (<kind | flags << 5> <payload>)
+ *   INPUTS   <n> n x (<node> <flags> <id> [<ref>])   (optional)
+ *   SIMPLIFIED                                       (optional)
+ *   ROOTS    <n> n x <ref>
+ *
+ * Nodes are written after their children.  A child reference within the
+ * NODES section is ((index of node - index of child) << 1 | inverted), a root
+ * reference is (index of node << 1 | inverted).  Symbol references are
+ * (index + 1), 0 means no symbol.  The node payload depends on the kind:
+ *
+ *   const          <const>
+ *   var, param     <sort> <symbol>
+ *   uf             <sort> <symbol>
+ *   slice          <child> <upper> <lower>
+ *   args           <arity> arity x <child>
+ *   lambda         <param> <body> <n> n x (<args> <value>)  (static rho)
+ *   others         arity x <child>
+ *
+ * The ROOTS section lists the constraints of the formula.  The INPUTS section
+ * lists the inputs of the formula in the order they were created, with their
+ * BTOR ids (0 if none), including inputs that were eliminated by
+ * simplification.  Such an input is dumped as a node without references after
+ * all other nodes and is followed by a reference to the expression it was
+ * substituted with, which allows to reload a simplified formula and still get
+ * models for all of its inputs.  The SIMPLIFIED tag has no payload and
+ * follows the INPUTS section if the formula was simplified, in which case
+ * it is not simplified again after loading (unless constraints are added). */
+
+#define BTOR_BIN_MAGIC "\177BTORBIN"
+#define BTOR_BIN_MAGIC_SIZE 8
+#define BTOR_BIN_VERSION 1
+
+#define BTOR_BIN_FLAG_IS_ARRAY 1
+#define BTOR_BIN_KIND_BITS 5
+
+#define BTOR_BIN_INPUT_SUBST 1
+#define BTOR_BIN_INPUT_BOOL 2
+
+enum BtorBinSection
+{
+  BTOR_BIN_SECTION_END = 0,
+  BTOR_BIN_SECTION_SORTS,
+  BTOR_BIN_SECTION_CONSTS,
+  BTOR_BIN_SECTION_SYMBOLS,
+  BTOR_BIN_SECTION_NODES,
+  BTOR_BIN_SECTION_ROOTS,
+  BTOR_BIN_SECTION_INPUTS,
+  BTOR_BIN_SECTION_SIMPLIFIED,
+};
+typedef enum BtorBinSection BtorBinSection;
+
+/*------------------------------------------------------------------------*/
+
+/* Dump the given nodes as roots of a formula in binary format. */
+void btor_dumpbin_dump_nodes (Btor *btor,
+                              FILE *file,
+                              BtorNode **roots,
+                              uint32_t nroots);
+
+/* Dump the current formula in binary format, including the inputs of the
+ * formula and their substitutions. */
+void btor_dumpbin_dump (Btor *btor, FILE *file);
+
+#endif
@@ -22,6 +22,100 @@
 
 #include <ctype.h>
 #include <limits.h>
+#include <stdarg.h>
+
+#ifdef BTOR_HAVE_PTHREADS
+#include <pthread.h>
+#include <unistd.h>
+#endif
+
+/*------------------------------------------------------------------------*/
+
+/* Size of the output buffer used when dumping a whole formula. */
+#define BTOR_SMT_DUMP_BUF_SIZE (1u << 20)
+/* Size of the output buffer used when dumping single nodes, sorts and
+ * values (e.g., when printing models). */
+#define BTOR_SMT_DUMP_NODE_BUF_SIZE (1u << 12)
+
+struct BtorSMTWriter
+{
+  FILE *file;
+  char *buf;
+  size_t size;
+  size_t len;
+};
+
+typedef struct BtorSMTWriter BtorSMTWriter;
+
+static void
+smt_flush (BtorSMTWriter *out)
+{
+  assert (out);
+  if (out->len) fwrite (out->buf, 1, out->len, out->file);
+  out->len = 0;
+}
+
+static inline void
+smt_putc (BtorSMTWriter *out, char ch)
+{
+  assert (out);
+  if (out->len == out->size) smt_flush (out);
+  out->buf[out->len++] = ch;
+}
+
+static void
+smt_puts (BtorSMTWriter *out, const char *str)
+{
+  assert (out);
+  assert (str);
+
+  size_t len;
+
+  len = strlen (str);
+  if (out->len + len > out->size)
+  {
+    smt_flush (out);
+    /* does not fit into the buffer, write through */
+    if (len > out->size)
+    {
+      fwrite (str, 1, len, out->file);
+      return;
+    }
+  }
+  memcpy (out->buf + out->len, str, len);
+  out->len += len;
+}
+
+static void
+smt_printf (BtorSMTWriter *out, const char *fmt, ...)
+{
+  assert (out);
+  assert (fmt);
+
+  int32_t len;
+  size_t avail;
+  va_list ap;
+
+  avail = out->size - out->len;
+  va_start (ap, fmt);
+  len = vsnprintf (out->buf + out->len, avail, fmt, ap);
+  va_end (ap);
+  assert (len >= 0);
+  if ((size_t) len < avail)
+  {
+    out->len += len;
+    return;
+  }
+  smt_flush (out);
+  va_start (ap, fmt);
+  if ((size_t) len < out->size)
+    out->len = vsnprintf (out->buf, out->size, fmt, ap);
+  else
+    vfprintf (out->file, fmt, ap);
+  va_end (ap);
+}
+
+/*------------------------------------------------------------------------*/
 
 struct BtorSMTDumpContext
 {
@@ -33,7 +127,7 @@ struct BtorSMTDumpContext
   BtorPtrHashTable *idtab;
   BtorPtrHashTable *roots;
   BtorPtrHashTable *const_cache;
-  FILE *file;
+  BtorSMTWriter out;
   uint32_t maxid;
   uint32_t pretty_print;
   uint32_t open_lets;
@@ -44,8 +138,10 @@ struct BtorSMTDumpContext
 typedef struct BtorSMTDumpContext BtorSMTDumpContext;
 
 static BtorSMTDumpContext *
-new_smt_dump_context (Btor *btor, FILE *file)
+new_smt_dump_context (Btor *btor, FILE *file, size_t buf_size)
 {
+  assert (buf_size);
+
   BtorSMTDumpContext *sdc;
   BTOR_CNEW (btor->mm, sdc);
 
@@ -69,10 +165,12 @@ new_smt_dump_context (Btor *btor, FILE *file)
       btor->mm, (BtorHashPtr) btor_bv_hash, (BtorCmpPtr) btor_bv_compare);
   /* use pointer for hashing and comparison */
   sdc->roots        = btor_hashptr_table_new (btor->mm, 0, 0);
-  sdc->file         = file;
+  sdc->out.file     = file;
+  sdc->out.size     = buf_size;
   sdc->maxid        = 1;
   sdc->pretty_print = btor_opt_get (btor, BTOR_OPT_PRETTY_PRINT);
   sdc->newline      = sdc->pretty_print == 1;
+  BTOR_NEWN (btor->mm, sdc->out.buf, buf_size);
   return sdc;
 }
 
@@ -81,6 +179,9 @@ delete_smt_dump_context (BtorSMTDumpContext *sdc)
 {
   BtorPtrHashTableIterator it;
 
+  smt_flush (&sdc->out);
+  BTOR_DELETEN (sdc->btor->mm, sdc->out.buf, sdc->out.size);
+
   btor_hashptr_table_delete (sdc->dump);
   btor_hashptr_table_delete (sdc->dumped);
   btor_hashptr_table_delete (sdc->boolean);
@@ -191,9 +292,9 @@ dump_smt_id (BtorSMTDumpContext *sdc, BtorNode *exp)
       if (sym && !isdigit ((int32_t) sym[0]))
       {
         if (symbol_needs_quotes (sym))
-          fprintf (sdc->file, "|%s|", sym);
+          smt_printf (&sdc->out, "|%s|", sym);
         else
-          fputs (sym, sdc->file);
+          smt_puts (&sdc->out, sym);
         return;
       }
       break;
@@ -205,7 +306,7 @@ dump_smt_id (BtorSMTDumpContext *sdc, BtorNode *exp)
     default: type = "$e";
   }
 
-  fprintf (sdc->file, "%s%u", type, smt_id (sdc, exp));
+  smt_printf (&sdc->out, "%s%u", type, smt_id (sdc, exp));
 }
 
 static bool
@@ -215,11 +316,11 @@ is_boolean (BtorSMTDumpContext *sdc, BtorNode *exp)
   return btor_hashptr_table_get (sdc->boolean, exp) != 0;
 }
 
-void
-btor_dumpsmt_dump_const_value (Btor *btor,
-                               const BtorBitVector *bits,
-                               uint32_t base,
-                               FILE *file)
+static void
+dump_const_value_smt (Btor *btor,
+                      const BtorBitVector *bits,
+                      uint32_t base,
+                      BtorSMTWriter *out)
 {
   assert (btor);
   assert (bits);
@@ -232,21 +333,36 @@ btor_dumpsmt_dump_const_value (Btor *btor,
   if (base == BTOR_OUTPUT_BASE_DEC)
   {
     val = btor_bv_to_dec_char (btor->mm, bits);
-    fprintf (file, "(_ bv%s %d)", val, btor_bv_get_width (bits));
+    smt_printf (out, "(_ bv%s %d)", val, btor_bv_get_width (bits));
   }
   else if (base == BTOR_OUTPUT_BASE_HEX && btor_bv_get_width (bits) % 4 == 0)
   {
     val = btor_bv_to_hex_char (btor->mm, bits);
-    fprintf (file, "#x%s", val);
+    smt_puts (out, "#x");
+    smt_puts (out, val);
   }
   else
   {
     val = btor_bv_to_char (btor->mm, bits);
-    fprintf (file, "#b%s", val);
+    smt_puts (out, "#b");
+    smt_puts (out, val);
   }
   btor_mem_freestr (btor->mm, val);
 }
 
+void
+btor_dumpsmt_dump_const_value (Btor *btor,
+                               const BtorBitVector *bits,
+                               uint32_t base,
+                               FILE *file)
+{
+  char buf[BTOR_SMT_DUMP_NODE_BUF_SIZE];
+  BtorSMTWriter out = {file, buf, sizeof buf, 0};
+
+  dump_const_value_smt (btor, bits, base, &out);
+  smt_flush (&out);
+}
+
 static void
 dump_const_value_aux_smt (BtorSMTDumpContext *sdc, BtorBitVector *bits)
 {
@@ -254,12 +370,10 @@ dump_const_value_aux_smt (BtorSMTDumpContext *sdc, BtorBitVector *bits)
   assert (bits);
 
   uint32_t base;
-  FILE *file;
   char *val;
   BtorPtrHashBucket *b;
 
   base = btor_opt_get (sdc->btor, BTOR_OPT_OUTPUT_NUMBER_FORMAT);
-  file = sdc->file;
 
   /* converting consts to decimal/hex is costly. we now always dump the value of
    * constants. in order to avoid computing the same value again we cache
@@ -279,7 +393,7 @@ dump_const_value_aux_smt (BtorSMTDumpContext *sdc, BtorBitVector *bits)
                               btor_bv_copy (sdc->btor->mm, bits))
           ->data.as_str = val;
     }
-    fprintf (file, "(_ bv%s %d)", val, btor_bv_get_width (bits));
+    smt_printf (&sdc->out, "(_ bv%s %d)", val, btor_bv_get_width (bits));
   }
   else if (base == BTOR_OUTPUT_BASE_HEX && btor_bv_get_width (bits) % 4 == 0)
   {
@@ -295,55 +409,57 @@ dump_const_value_aux_smt (BtorSMTDumpContext *sdc, BtorBitVector *bits)
                               btor_bv_copy (sdc->btor->mm, bits))
           ->data.as_str = val;
     }
-    fprintf (file, "#x%s", val);
+    smt_puts (&sdc->out, "#x");
+    smt_puts (&sdc->out, val);
   }
   else
-    btor_dumpsmt_dump_const_value (sdc->btor, bits, base, file);
+    dump_const_value_smt (sdc->btor, bits, base, &sdc->out);
 }
 
-void
-btor_dumpsmt_dump_sort (BtorSort *sort, FILE *file)
+static void
+dump_sort_smt (BtorSort *sort, BtorSMTWriter *out)
 {
   uint32_t i;
   const char *fmt;
 
   switch (sort->kind)
   {
-    case BTOR_BOOL_SORT: fputs ("Bool", file); break;
+    case BTOR_BOOL_SORT: smt_puts (out, "Bool"); break;
 
     case BTOR_BV_SORT:
       fmt = "(_ BitVec %d)";
-      fprintf (file, fmt, sort->bitvec.width);
+      smt_printf (out, fmt, sort->bitvec.width);
       break;
 
     case BTOR_ARRAY_SORT:
       fmt = "(Array (_ BitVec %d) (_ BitVec %d))";
       assert (sort->array.index->kind == BTOR_BV_SORT);
       assert (sort->array.element->kind == BTOR_BV_SORT);
-      fprintf (file,
-               fmt,
-               sort->array.index->bitvec.width,
-               sort->array.element->bitvec.width);
+      smt_printf (out,
+                  fmt,
+                  sort->array.index->bitvec.width,
+                  sort->array.element->bitvec.width);
       break;
 
     case BTOR_FUN_SORT:
       /* print domain */
-      fputc ('(', file);
+      smt_putc (out, '(');
       if (sort->fun.domain->kind == BTOR_TUPLE_SORT)
       {
         for (i = 0; i < sort->fun.domain->tuple.num_elements; i++)
         {
-          btor_dumpsmt_dump_sort (sort->fun.domain->tuple.elements[i], file);
-          if (i < sort->fun.domain->tuple.num_elements - 1) fputc (' ', file);
+          dump_sort_smt (sort->fun.domain->tuple.elements[i], out);
+          if (i < sort->fun.domain->tuple.num_elements - 1)
+            smt_putc (out, ' ');
         }
       }
       else
-        btor_dumpsmt_dump_sort (sort->fun.domain, file);
-      fputc (')', file);
-      fputc (' ', file);
+        dump_sort_smt (sort->fun.domain, out);
+      smt_putc (out, ')');
+      smt_putc (out, ' ');
 
       /* print co-domain */
-      btor_dumpsmt_dump_sort (sort->fun.codomain, file);
+      dump_sort_smt (sort->fun.codomain, out);
       break;
 
     default: assert (0);
@@ -351,10 +467,20 @@ btor_dumpsmt_dump_sort (BtorSort *sort, FILE *file)
 }
 
 void
-btor_dumpsmt_dump_sort_node (BtorNode *exp, FILE *file)
+btor_dumpsmt_dump_sort (BtorSort *sort, FILE *file)
+{
+  char buf[BTOR_SMT_DUMP_NODE_BUF_SIZE];
+  BtorSMTWriter out = {file, buf, sizeof buf, 0};
+
+  dump_sort_smt (sort, &out);
+  smt_flush (&out);
+}
+
+static void
+dump_sort_node_smt (BtorNode *exp, BtorSMTWriter *out)
 {
   assert (exp);
-  assert (file);
+  assert (out);
 
   Btor *btor;
   BtorSortId s_fid, s_tid, s_cid, s_did;
@@ -369,18 +495,31 @@ btor_dumpsmt_dump_sort_node (BtorNode *exp, FILE *file)
     assert (btor_sort_is_tuple (btor, s_tid));
     s_did = btor_sort_get_by_id (btor, s_tid)->tuple.elements[0]->id;
     s_cid = btor_sort_fun_get_codomain (btor, s_fid);
-    fprintf (file,
-             "(Array (_ BitVec %d) (_ BitVec %d))",
-             btor_sort_bv_get_width (btor, s_did),
-             btor_sort_bv_get_width (btor, s_cid));
+    smt_printf (out,
+                "(Array (_ BitVec %d) (_ BitVec %d))",
+                btor_sort_bv_get_width (btor, s_did),
+                btor_sort_bv_get_width (btor, s_cid));
   }
   else
   {
     sort = btor_sort_get_by_id (exp->btor, btor_node_get_sort_id (exp));
-    btor_dumpsmt_dump_sort (sort, file);
+    dump_sort_smt (sort, out);
   }
 }
 
+void
+btor_dumpsmt_dump_sort_node (BtorNode *exp, FILE *file)
+{
+  assert (exp);
+  assert (file);
+
+  char buf[BTOR_SMT_DUMP_NODE_BUF_SIZE];
+  BtorSMTWriter out = {file, buf, sizeof buf, 0};
+
+  dump_sort_node_smt (exp, &out);
+  smt_flush (&out);
+}
+
 #if 0
 static void
 extract_store (BtorSMTDumpContext * sdc, BtorNode * exp,
@@ -532,7 +671,7 @@ static void
 print_indent (BtorSMTDumpContext *sdc)
 {
   uint32_t i;
-  for (i = 0; i < sdc->indent; i++) fputc (' ', sdc->file);
+  for (i = 0; i < sdc->indent; i++) smt_putc (&sdc->out, ' ');
 }
 
 static inline void
@@ -540,17 +679,17 @@ open_sexp (BtorSMTDumpContext *sdc)
 {
   if (sdc->pretty_print && sdc->indent > 0 && sdc->newline)
   {
-    fputc ('\n', sdc->file);
+    smt_putc (&sdc->out, '\n');
     print_indent (sdc);
   }
-  fputc ('(', sdc->file);
+  smt_putc (&sdc->out, '(');
   sdc->indent++;
 }
 
 static inline void
 close_sexp (BtorSMTDumpContext *sdc)
 {
-  fputc (')', sdc->file);
+  smt_putc (&sdc->out, ')');
   sdc->indent--;
 }
 
@@ -693,23 +832,23 @@ recursively_dump_exp_smt (BtorSMTDumpContext *sdc,
     /* open s-expression */
     if (!btor_hashptr_table_get (visited, real_exp))
     {
-      if (add_space) fputc (' ', sdc->file);
+      if (add_space) smt_putc (&sdc->out, ' ');
 
       /* wrap node with zero_extend */
       if (zero_extend)
       {
-        fputc (' ', sdc->file);
+        smt_putc (&sdc->out, ' ');
         open_sexp (sdc);
-        fprintf (sdc->file, "(_ zero_extend %d) ", zero_extend);
+        smt_printf (&sdc->out, "(_ zero_extend %d) ", zero_extend);
       }
 
       /* always print constants */
       if (btor_node_is_bv_const (real_exp))
       {
         if (exp == sdc->btor->true_exp && !expect_bv)
-          fputs ("true", sdc->file);
+          smt_puts (&sdc->out, "true");
         else if (exp == btor_node_invert (sdc->btor->true_exp) && !expect_bv)
-          fputs ("false", sdc->file);
+          smt_puts (&sdc->out, "false");
         else if (btor_node_is_inverted (exp))
         {
           bits = btor_bv_not (sdc->btor->mm,
@@ -732,25 +871,25 @@ recursively_dump_exp_smt (BtorSMTDumpContext *sdc,
       if (expect_bool && !is_bool)
       {
         open_sexp (sdc);
-        fputs ("= ", sdc->file);
+        smt_puts (&sdc->out, "= ");
         bits = btor_bv_one (sdc->btor->mm, 1);
         dump_const_value_aux_smt (sdc, bits);
         btor_bv_free (sdc->btor->mm, bits);
-        fputc (' ', sdc->file);
+        smt_putc (&sdc->out, ' ');
       }
 
       /* wrap node with bvnot/not */
       if (btor_node_is_inverted (exp))
       {
         open_sexp (sdc);
-        fputs (expect_bv || !is_bool ? "bvnot " : "not ", sdc->file);
+        smt_puts (&sdc->out, expect_bv || !is_bool ? "bvnot " : "not ");
       }
 
       /* wrap bool node and make it a bit vector expression */
       if (is_bool && expect_bv)
       {
         open_sexp (sdc);
-        fputs ("ite ", sdc->file);
+        smt_puts (&sdc->out, "ite ");
       }
 
       if (btor_hashptr_table_get (sdc->dumped, real_exp)
@@ -772,7 +911,8 @@ recursively_dump_exp_smt (BtorSMTDumpContext *sdc,
 
       if (depth_limit && depth >= depth_limit)
       {
-        fprintf (sdc->file, "%s_%d", g_kind2smt[real_exp->kind], real_exp->id);
+        smt_printf (
+            &sdc->out, "%s_%d", g_kind2smt[real_exp->kind], real_exp->id);
         goto CLOSE_WRAPPER;
       }
 
@@ -846,7 +986,7 @@ recursively_dump_exp_smt (BtorSMTDumpContext *sdc,
               if (i < BTOR_COUNT_STACK (indices) - 1)
               {
                 open_sexp (sdc);
-                fputs ("store ", sdc->file);
+                smt_puts (&sdc->out, "store ");
                 PUSH_DUMP_NODE (exp, 1, 0, 1, 0, depth + 1);
               }
             }
@@ -954,25 +1094,25 @@ recursively_dump_exp_smt (BtorSMTDumpContext *sdc,
       /* open s-expression */
       assert (op);
       open_sexp (sdc);
-      fprintf (sdc->file, "%s", op);
+      smt_puts (&sdc->out, op);
 
       if (btor_node_is_bv_slice (real_exp))
       {
         fmt = "%d %d)";
-        fprintf (sdc->file,
-                 fmt,
-                 btor_node_bv_slice_get_upper (real_exp),
-                 btor_node_bv_slice_get_lower (real_exp));
+        smt_printf (&sdc->out,
+                    fmt,
+                    btor_node_bv_slice_get_upper (real_exp),
+                    btor_node_bv_slice_get_lower (real_exp));
       }
       else if (btor_node_is_const_array (real_exp))
       {
-        fputs ("(as const ", sdc->file);
-        btor_dumpsmt_dump_sort_node (real_exp, sdc->file);
-        fputs (") ", sdc->file);
+        smt_puts (&sdc->out, "(as const ");
+        dump_sort_node_smt (real_exp, &sdc->out);
+        smt_puts (&sdc->out, ") ");
       }
       else if (btor_node_is_quantifier (real_exp))
       {
-        fputs (" (", sdc->file);
+        smt_puts (&sdc->out, " (");
         btor_iter_binder_init (&node_it, real_exp);
         tmp = 0;
         while (btor_iter_binder_has_next (&node_it))
@@ -981,24 +1121,24 @@ recursively_dump_exp_smt (BtorSMTDumpContext *sdc,
 
           if (tmp->kind != real_exp->kind) break;
 
-          if (tmp != real_exp) fputc (' ', sdc->file);
+          if (tmp != real_exp) smt_putc (&sdc->out, ' ');
           if (sdc->pretty_print)
           {
-            fputc ('\n', sdc->file);
+            smt_putc (&sdc->out, '\n');
             print_indent (sdc);
           }
-          fputc ('(', sdc->file);
+          smt_putc (&sdc->out, '(');
           dump_smt_id (sdc, tmp->e[0]);
-          fputc (' ', sdc->file);
-          btor_dumpsmt_dump_sort_node (tmp->e[0], sdc->file);
-          fputc (')', sdc->file);
+          smt_putc (&sdc->out, ' ');
+          dump_sort_node_smt (tmp->e[0], &sdc->out);
+          smt_putc (&sdc->out, ')');
           btor_hashptr_table_add (sdc->dumped, tmp->e[0]);
           btor_hashptr_table_add (sdc->dumped, tmp);
         }
         assert (tmp);
         assert (btor_node_is_regular (tmp));
         assert (btor_node_is_quantifier (tmp));
-        fputc (')', sdc->file);
+        smt_putc (&sdc->out, ')');
 
         if (tmp->kind == real_exp->kind)
         {
@@ -1010,10 +1150,10 @@ recursively_dump_exp_smt (BtorSMTDumpContext *sdc,
           PUSH_DUMP_NODE (tmp, 0, 1, 1, 0, depth + 1);
 
 #if 0
-	      fprintf (sdc->file, " ((%s ",
+	      smt_printf (&sdc->out, " ((%s ",
 		       btor_get_symbol_exp (sdc->btor, real_exp->e[0]));
-	      btor_dumpsmt_dump_sort_node (real_exp->e[0], sdc->file);
-	      fprintf (sdc->file, "))");
+	      dump_sort_node_smt (real_exp->e[0], &sdc->out);
+	      smt_printf (&sdc->out, "))");
 	      btor_hashptr_table_add (sdc->dumped, real_exp->e[0]);
 	      if (real_exp->e[1] == btor_node_binder_get_body (real_exp))
 		recursively_dump_exp_let_smt (
@@ -1037,11 +1177,11 @@ recursively_dump_exp_smt (BtorSMTDumpContext *sdc,
       /* wrap boolean expressions in bit vector expression */
       if (is_bool && expect_bv && !btor_node_is_bv_const (real_exp))
       {
-        fputc (' ', sdc->file);
+        smt_putc (&sdc->out, ' ');
         bits = btor_bv_one (sdc->btor->mm, 1);
         dump_const_value_aux_smt (sdc, bits);
         btor_bv_free (sdc->btor->mm, bits);
-        fputc (' ', sdc->file);
+        smt_putc (&sdc->out, ' ');
         bits = btor_bv_new (sdc->btor->mm, 1);
         dump_const_value_aux_smt (sdc, bits);
         btor_bv_free (sdc->btor->mm, bits);
@@ -1083,15 +1223,15 @@ dump_let_smt (BtorSMTDumpContext *sdc, BtorNode *exp)
 
   open_sexp (sdc);
   sdc->indent--;
-  fputs ("let (", sdc->file);
-  fputc ('(', sdc->file);
+  smt_puts (&sdc->out, "let (");
+  smt_putc (&sdc->out, '(');
   dump_smt_id (sdc, exp);  // TODO (ma): better symbol for lets?
-  fputc (' ', sdc->file);
+  smt_putc (&sdc->out, ' ');
   newline      = sdc->newline;
   sdc->newline = false;
   recursively_dump_exp_smt (sdc, exp, !is_boolean (sdc, exp), 0);
   sdc->newline = newline;
-  fputs ("))", sdc->file);
+  smt_puts (&sdc->out, "))");
   sdc->open_lets++;
   assert (btor_hashptr_table_get (sdc->dumped, exp));
 }
@@ -1170,7 +1310,7 @@ recursively_dump_exp_let_smt (BtorSMTDumpContext *sdc,
       cur = BTOR_PEEK_STACK (shared, i);
       assert (btor_node_is_regular (cur));
       dump_let_smt (sdc, cur);
-      fputc (' ', sdc->file);
+      smt_putc (&sdc->out, ' ');
     }
 
     recursively_dump_exp_smt (sdc, exp, expect_bv, depth_limit);
@@ -1178,7 +1318,7 @@ recursively_dump_exp_let_smt (BtorSMTDumpContext *sdc,
     /* close lets */
     for (i = 0; i < BTOR_COUNT_STACK (shared); i++)
     {
-      fputc (')', sdc->file);
+      smt_putc (&sdc->out, ')');
       //      close_sexp (sdc);
       sdc->open_lets--;
     }
@@ -1198,17 +1338,17 @@ dump_fun_let_smt2 (BtorSMTDumpContext *sdc, BtorNode *exp)
 
   is_bool = is_boolean (sdc, exp);
   open_sexp (sdc);
-  fputs ("define-fun ", sdc->file);
+  smt_puts (&sdc->out, "define-fun ");
   dump_smt_id (sdc, exp);
-  fputs (" () ", sdc->file);
+  smt_puts (&sdc->out, " () ");
   if (is_bool)
-    fputs ("Bool", sdc->file);
+    smt_puts (&sdc->out, "Bool");
   else
-    btor_dumpsmt_dump_sort_node (exp, sdc->file);
-  fputc (' ', sdc->file);
+    dump_sort_node_smt (exp, &sdc->out);
+  smt_putc (&sdc->out, ' ');
   recursively_dump_exp_smt (sdc, exp, !is_bool, 0);
   close_sexp (sdc);
-  fputc ('\n', sdc->file);
+  smt_putc (&sdc->out, '\n');
   assert (btor_hashptr_table_get (sdc->dumped, exp));
 }
 
@@ -1281,14 +1421,14 @@ dump_fun_smt2 (BtorSMTDumpContext *sdc, BtorNode *fun, bool print_lambda)
   /* dump function signature */
   if (print_lambda)
   {
-    fputs ("(lambda ", sdc->file);
+    smt_puts (&sdc->out, "(lambda ");
   }
   else
   {
-    fputs ("(define-fun ", sdc->file);
+    smt_puts (&sdc->out, "(define-fun ");
     dump_smt_id (sdc, fun);
   }
-  fputs (" (", sdc->file);
+  smt_puts (&sdc->out, " (");
 
   btor_iter_lambda_init (&it, fun);
   while (btor_iter_lambda_has_next (&it))
@@ -1300,20 +1440,20 @@ dump_fun_smt2 (BtorSMTDumpContext *sdc, BtorNode *fun, bool print_lambda)
       btor_hashptr_table_add (mark, param);
     btor_hashptr_table_add (sdc->dumped, cur);
     btor_hashptr_table_add (sdc->dumped, param);
-    if (fun != cur) fputc (' ', sdc->file);
-    fputc ('(', sdc->file);
+    if (fun != cur) smt_putc (&sdc->out, ' ');
+    smt_putc (&sdc->out, '(');
     dump_smt_id (sdc, param);
-    fputc (' ', sdc->file);
-    btor_dumpsmt_dump_sort_node (param, sdc->file);
-    fputc (')', sdc->file);
+    smt_putc (&sdc->out, ' ');
+    dump_sort_node_smt (param, &sdc->out);
+    smt_putc (&sdc->out, ')');
   }
-  fputs (") ", sdc->file);
+  smt_puts (&sdc->out, ") ");
 
   if (is_boolean (sdc, fun_body))
-    fputs ("Bool", sdc->file);
+    smt_puts (&sdc->out, "Bool");
   else
-    btor_dumpsmt_dump_sort_node (fun_body, sdc->file);
-  fputc (sdc->pretty_print ? '\n' : ' ', sdc->file);
+    dump_sort_node_smt (fun_body, &sdc->out);
+  smt_putc (&sdc->out, sdc->pretty_print ? '\n' : ' ');
 
   assert (sdc->open_lets == 0);
 
@@ -1330,17 +1470,17 @@ dump_fun_smt2 (BtorSMTDumpContext *sdc, BtorNode *fun, bool print_lambda)
     assert (btor_node_is_regular (cur));
     assert (cur->parameterized);
     dump_let_smt (sdc, cur);
-    fputc (' ', sdc->file);
+    smt_putc (&sdc->out, ' ');
   }
   recursively_dump_exp_smt (sdc, fun_body, !is_boolean (sdc, fun_body), 0);
 
   /* close lets */
-  for (i = 0; i < sdc->open_lets; i++) fputc (')', sdc->file);
+  for (i = 0; i < sdc->open_lets; i++) smt_putc (&sdc->out, ')');
   //    close_sexp (sdc);
   sdc->open_lets = 0;
 
   /* close define-fun */
-  fputs (")\n", sdc->file);
+  smt_puts (&sdc->out, ")\n");
 
   /* due to lambda hashing it is possible that a lambda in 'fun' is shared in
    * different functions. hence, we have to check if all lambda parents of
@@ -1391,13 +1531,13 @@ static void
 dump_declare_fun_smt (BtorSMTDumpContext *sdc, BtorNode *exp)
 {
   assert (!btor_hashptr_table_get (sdc->dumped, exp));
-  fputs ("(declare-fun ", sdc->file);
+  smt_puts (&sdc->out, "(declare-fun ");
   dump_smt_id (sdc, exp);
-  fputc (' ', sdc->file);
+  smt_putc (&sdc->out, ' ');
   if (btor_node_is_bv_var (exp) || btor_node_is_uf_array (exp))
-    fputs ("() ", sdc->file);
-  btor_dumpsmt_dump_sort_node (exp, sdc->file);
-  fputs (")\n", sdc->file);
+    smt_puts (&sdc->out, "() ");
+  dump_sort_node_smt (exp, &sdc->out);
+  smt_puts (&sdc->out, ")\n");
   btor_hashptr_table_add (sdc->dumped, exp);
 }
 
@@ -1409,12 +1549,12 @@ dump_assert_smt2 (BtorSMTDumpContext *sdc, BtorNode *exp)
   assert (btor_node_bv_get_width (sdc->btor, exp) == 1);
 
   open_sexp (sdc);
-  fputs ("assert ", sdc->file);
-  if (!is_boolean (sdc, exp)) fputs ("(distinct ", sdc->file);
+  smt_puts (&sdc->out, "assert ");
+  if (!is_boolean (sdc, exp)) smt_puts (&sdc->out, "(distinct ");
   recursively_dump_exp_smt (sdc, exp, 0, 0);
-  if (!is_boolean (sdc, exp)) fputs (" #b0)", sdc->file);
+  if (!is_boolean (sdc, exp)) smt_puts (&sdc->out, " #b0)");
   close_sexp (sdc);
-  fputc ('\n', sdc->file);
+  smt_putc (&sdc->out, '\n');
 }
 
 static void
@@ -1425,7 +1565,7 @@ set_logic_smt (BtorSMTDumpContext *sdc, const char *logic)
   const char *fmt;
 
   fmt = "(set-logic %s)\n";
-  fprintf (sdc->file, fmt, logic);
+  smt_printf (&sdc->out, fmt, logic);
 }
 
 static uint32_t
@@ -1457,6 +1597,120 @@ get_references (BtorSMTDumpContext *sdc, BtorNode *exp)
   return refs;
 }
 
+#ifdef BTOR_HAVE_PTHREADS
+/* Minimum number of expressions for which reference counts are computed by
+ * several threads. */
+#define BTOR_SMT_DUMP_PAR_MIN_EXPS (1u << 15)
+#define BTOR_SMT_DUMP_MAX_THREADS 8
+
+struct BtorSMTRefsWorker
+{
+  BtorSMTDumpContext *sdc;
+  BtorNode **exps;
+  uint32_t *refs;
+  uint32_t from;
+  uint32_t to;
+};
+
+typedef struct BtorSMTRefsWorker BtorSMTRefsWorker;
+
+static void *
+refs_worker (void *state)
+{
+  uint32_t i;
+  BtorSMTRefsWorker *w;
+
+  w = state;
+  for (i = w->from; i < w->to; i++)
+    w->refs[i] = get_references (w->sdc, w->exps[i]);
+  return 0;
+}
+
+static uint32_t
+get_num_threads (Btor *btor, uint32_t nexps)
+{
+  long ncpus;
+
+  if (nexps < BTOR_SMT_DUMP_PAR_MIN_EXPS) return 1;
+  ncpus = btor_opt_get (btor, BTOR_OPT_DUMP_N_THREADS);
+  if (!ncpus) ncpus = sysconf (_SC_NPROCESSORS_ONLN);
+  if (ncpus < 1) return 1;
+  if (ncpus > BTOR_SMT_DUMP_MAX_THREADS) return BTOR_SMT_DUMP_MAX_THREADS;
+  return ncpus;
+}
+#endif
+
+/* Add the reference counts of the expressions on 'exps' (sorted by id) to
+ * their counters in sdc->dump.  Counting the references of an expression only
+ * reads the node graph, sdc->dump and sdc->roots, hence for large formulas
+ * this is split among several threads, and the results are applied in order
+ * afterwards. */
+static void
+compute_references (BtorSMTDumpContext *sdc, BtorNodePtrStack *exps)
+{
+  uint32_t i, n, *refs;
+  BtorNode *cur, *e;
+  BtorPtrHashBucket *b;
+  BtorArgsIterator ait;
+  BtorMemMgr *mm;
+#ifdef BTOR_HAVE_PTHREADS
+  uint32_t t, nthreads, chunk;
+  bool started[BTOR_SMT_DUMP_MAX_THREADS];
+  pthread_t threads[BTOR_SMT_DUMP_MAX_THREADS];
+  BtorSMTRefsWorker workers[BTOR_SMT_DUMP_MAX_THREADS];
+#endif
+
+  n = BTOR_COUNT_STACK (*exps);
+  if (!n) return;
+
+  mm = sdc->btor->mm;
+  BTOR_NEWN (mm, refs, n);
+
+#ifdef BTOR_HAVE_PTHREADS
+  nthreads = get_num_threads (sdc->btor, n);
+  chunk    = (n + nthreads - 1) / nthreads;
+  for (t = 0; t < nthreads; t++)
+  {
+    workers[t].sdc  = sdc;
+    workers[t].exps = exps->start;
+    workers[t].refs = refs;
+    workers[t].from = t * chunk < n ? t * chunk : n;
+    workers[t].to   = (t + 1) * chunk < n ? (t + 1) * chunk : n;
+    /* the first chunk is processed by the calling thread */
+    started[t] = t > 0
+                 && !pthread_create (&threads[t], 0, refs_worker, &workers[t]);
+  }
+  for (t = 0; t < nthreads; t++)
+    if (!started[t]) refs_worker (&workers[t]);
+  for (t = 1; t < nthreads; t++)
+    if (started[t]) pthread_join (threads[t], 0);
+#else
+  for (i = 0; i < n; i++) refs[i] = get_references (sdc, exps->start[i]);
+#endif
+
+  for (i = 0; i < n; i++)
+  {
+    cur = BTOR_PEEK_STACK (*exps, i);
+    b   = btor_hashptr_table_get (sdc->dump, cur);
+    assert (b);
+    /* cache result for later reuse */
+    b->data.as_int += refs[i];
+
+    /* update references for expressions under argument nodes */
+    if (btor_node_is_args (cur) && b->data.as_int > 0)
+    {
+      btor_iter_args_init (&ait, cur);
+      while (btor_iter_args_has_next (&ait))
+      {
+        e = btor_node_real_addr (btor_iter_args_next (&ait));
+        assert (btor_hashptr_table_get (sdc->dump, e));
+        btor_hashptr_table_get (sdc->dump, e)->data.as_int += b->data.as_int;
+      }
+    }
+  }
+  BTOR_DELETEN (mm, refs, n);
+}
+
 static bool
 has_lambda_parents_only (BtorNode *exp)
 {
@@ -1532,7 +1786,6 @@ dump_smt (BtorSMTDumpContext *sdc)
   BtorNodePtrStack visit, all, vars, shared, ufs, larr;
   BtorPtrHashBucket *b;
   BtorPtrHashTableIterator it;
-  BtorArgsIterator ait;
   BtorPtrHashTable *static_rho;
 
   mm = sdc->btor->mm;
@@ -1616,26 +1869,7 @@ dump_smt (BtorSMTDumpContext *sdc)
   if (all.start)
     qsort (all.start, BTOR_COUNT_STACK (all), sizeof e, cmp_node_id);
 
-  for (i = 0; i < BTOR_COUNT_STACK (all); i++)
-  {
-    cur = BTOR_PEEK_STACK (all, i);
-    b   = btor_hashptr_table_get (sdc->dump, cur);
-    assert (b);
-    /* cache result for later reuse */
-    b->data.as_int += get_references (sdc, cur);
-
-    /* update references for expressions under argument nodes */
-    if (btor_node_is_args (cur) && b->data.as_int > 0)
-    {
-      btor_iter_args_init (&ait, cur);
-      while (btor_iter_args_has_next (&ait))
-      {
-        e = btor_node_real_addr (btor_iter_args_next (&ait));
-        assert (btor_hashptr_table_get (sdc->dump, e));
-        btor_hashptr_table_get (sdc->dump, e)->data.as_int += b->data.as_int;
-      }
-    }
-  }
+  compute_references (sdc, &all);
 
   /* collect globally shared expressions */
   for (i = 0; i < BTOR_COUNT_STACK (all); i++)
@@ -1751,9 +1985,10 @@ dump_smt (BtorSMTDumpContext *sdc)
   BTOR_RELEASE_STACK (ufs);
   BTOR_RELEASE_STACK (larr);
 
-  fputs ("(check-sat)\n", sdc->file);
-  fputs ("(exit)\n", sdc->file);
-  fflush (sdc->file);
+  smt_puts (&sdc->out, "(check-sat)\n");
+  smt_puts (&sdc->out, "(exit)\n");
+  smt_flush (&sdc->out);
+  fflush (sdc->out.file);
 }
 
 static void
@@ -1767,7 +2002,7 @@ dump_smt_aux (Btor *btor, FILE *file, BtorNode **roots, uint32_t nroots)
   BtorPtrHashTableIterator it;
   BtorSMTDumpContext *sdc;
 
-  sdc = new_smt_dump_context (btor, file);
+  sdc = new_smt_dump_context (btor, file, BTOR_SMT_DUMP_BUF_SIZE);
 
   if (nroots)
   {
@@ -1819,24 +2054,24 @@ btor_dumpsmt_dump_node (Btor *btor, FILE *file, BtorNode *exp, uint32_t depth)
   BtorNode *cur, *real_exp, *binder;
   BtorSMTDumpContext *sdc;
   BtorNodePtrStack visit, all;
-  BtorArgsIterator ait;
-  BtorPtrHashBucket *b;
 
   real_exp = btor_node_real_addr (exp);
 
   BTOR_INIT_STACK (btor->mm, all);
   BTOR_INIT_STACK (btor->mm, visit);
-  sdc          = new_smt_dump_context (btor, file);
+  sdc          = new_smt_dump_context (
+      btor, file, BTOR_SMT_DUMP_NODE_BUF_SIZE);
   sdc->newline = false;
 
   if (!exp)
   {
-    fprintf (file, "null\n");
+    smt_puts (&sdc->out, "null\n");
     goto CLEANUP;
   }
   else if (btor_node_is_args (real_exp))
   {
-    fprintf (file, "%s_%d\n", g_kind2smt[real_exp->kind], real_exp->id);
+    smt_printf (
+        &sdc->out, "%s_%d\n", g_kind2smt[real_exp->kind], real_exp->id);
     goto CLEANUP;
   }
   else if (btor_node_is_bv_var (exp) || btor_node_is_uf (exp))
@@ -1869,27 +2104,7 @@ btor_dumpsmt_dump_node (Btor *btor, FILE *file, BtorNode *exp, uint32_t depth)
   if (all.start)
     qsort (all.start, BTOR_COUNT_STACK (all), sizeof (BtorNode *), cmp_node_id);
 
-  for (i = 0; i < BTOR_COUNT_STACK (all); i++)
-  {
-    cur = BTOR_PEEK_STACK (all, i);
-    b   = btor_hashptr_table_get (sdc->dump, cur);
-    assert (b);
-    assert (b->data.as_int == 0);
-    /* cache result for later reuse */
-    b->data.as_int = get_references (sdc, cur);
-
-    /* update references for expressions under argument nodes */
-    if (btor_node_is_args (cur) && b->data.as_int > 0)
-    {
-      btor_iter_args_init (&ait, cur);
-      while (btor_iter_args_has_next (&ait))
-      {
-        cur = btor_node_real_addr (btor_iter_args_next (&ait));
-        assert (btor_hashptr_table_get (sdc->dump, cur));
-        btor_hashptr_table_get (sdc->dump, cur)->data.as_int += b->data.as_int;
-      }
-    }
-  }
+  compute_references (sdc, &all);
 
   mark_boolean (sdc, &all);
   if (btor_node_is_lambda (exp) && !btor_node_is_array (exp))
@@ -0,0 +1,734 @@
+/*  Boolector: Satisfiability Modulo Theories (SMT) solver.
+ *
+ *  Copyright (C) 2007-2021 by the authors listed in the AUTHORS file.
+ *
+ *  This file is part of Boolector.
+ *  See COPYING for more information on using this software.
+ */
+
+#include "btoraiger.h"
+
+#include "boolector.h"
+#include "btorcore.h"
+#include "btorexp.h"
+#include "btormsg.h"
+#include "btornode.h"
+#include "utils/btormem.h"
+#include "utils/btorstack.h"
+
+#include <assert.h>
+#include <ctype.h>
+#include <stdarg.h>
+#include <stdint.h>
+#include <string.h>
+
+/*------------------------------------------------------------------------*/
+
+/* Marks and gates (ASCII format) which are currently being resolved. */
+#define BTOR_AIGER_AND_MARK 0x80000000u
+
+struct BtorAIGERParser
+{
+  BtorMemMgr *mm;
+  BtorMC *mc;
+  Btor *btor;
+
+  FILE *infile;
+  const char *infile_name;
+  int32_t lineno;
+  bool saved;
+  int32_t saved_char;
+  char *error;
+
+  bool binary;
+  uint32_t maxvar;
+  uint32_t ninputs, nlatches, noutputs, nands;
+  uint32_t nbad, nconstraints, njustice, nfairness;
+
+  BtorNode **vars;       /* maps variables to nodes, 0 if not defined yet */
+  uint32_t *inputs;      /* input literals */
+  uint32_t *latches;     /* latch literals */
+  uint32_t *next;        /* next state literals of latches */
+  uint32_t *reset;       /* reset literals of latches */
+  uint32_t *outputs;     /* output literals */
+  uint32_t *bad;         /* bad state literals */
+  uint32_t *constraints; /* invariant constraint literals */
+  uint32_t *ands;        /* 'lhs rhs0 rhs1' triples (ASCII format only) */
+  uint32_t *and_of_var;  /* maps variables to and gate + 1 (ASCII only) */
+
+  BoolectorSort sort; /* 1-bit sort of inputs and latches */
+  BtorCharStack symbol;
+};
+
+typedef struct BtorAIGERParser BtorAIGERParser;
+
+/*------------------------------------------------------------------------*/
+
+static bool
+perr_aiger (BtorAIGERParser *parser, const char *fmt, ...)
+{
+  size_t bytes;
+  va_list ap;
+
+  if (!parser->error)
+  {
+    va_start (ap, fmt);
+    bytes = btor_mem_parse_error_msg_length (parser->infile_name, fmt, ap);
+    va_end (ap);
+
+    va_start (ap, fmt);
+    parser->error = btor_mem_parse_error_msg (
+        parser->mm, parser->infile_name, parser->lineno, 0, fmt, ap, bytes);
+    va_end (ap);
+  }
+  return false;
+}
+
+static int32_t
+nextch_aiger (BtorAIGERParser *parser)
+{
+  int32_t ch;
+
+  if (parser->saved)
+  {
+    ch            = parser->saved_char;
+    parser->saved = false;
+  }
+  else
+    ch = getc (parser->infile);
+
+  if (ch == '\n') parser->lineno++;
+
+  return ch;
+}
+
+static void
+savech_aiger (BtorAIGERParser *parser, int32_t ch)
+{
+  assert (!parser->saved);
+
+  parser->saved_char = ch;
+  parser->saved      = true;
+
+  if (ch == '\n')
+  {
+    assert (parser->lineno > 1);
+    parser->lineno--;
+  }
+}
+
+/*------------------------------------------------------------------------*/
+
+static bool
+read_uint_aiger (BtorAIGERParser *parser, const char *what, uint32_t *res)
+{
+  int32_t ch;
+  uint32_t digit;
+
+  ch = nextch_aiger (parser);
+  if (!isdigit (ch)) return perr_aiger (parser, "expected %s", what);
+
+  *res = 0;
+  do
+  {
+    digit = ch - '0';
+    if (*res > (UINT32_MAX - digit) / 10)
+      return perr_aiger (parser, "%s too large", what);
+    *res = 10 * *res + digit;
+  } while (isdigit (ch = nextch_aiger (parser)));
+  savech_aiger (parser, ch);
+  return true;
+}
+
+static bool
+expect_char_aiger (BtorAIGERParser *parser, int32_t expected, const char *what)
+{
+  int32_t ch;
+
+  ch = nextch_aiger (parser);
+  if (ch == expected) return true;
+  if (ch == EOF) return perr_aiger (parser, "unexpected end of file");
+  return perr_aiger (parser,
+                     "expected %s after %s",
+                     expected == ' ' ? "space" : "newline",
+                     what);
+}
+
+static bool
+read_lit_aiger (BtorAIGERParser *parser,
+                const char *what,
+                uint32_t *res,
+                int32_t sep)
+{
+  if (!read_uint_aiger (parser, what, res)) return false;
+  if (*res / 2 > parser->maxvar)
+    return perr_aiger (parser, "invalid %s %u", what, *res);
+  return expect_char_aiger (parser, sep, what);
+}
+
+/* Read a delta of the binary and gate encoding. */
+static bool
+read_delta_aiger (BtorAIGERParser *parser, uint32_t *res)
+{
+  assert (!parser->saved);
+
+  int32_t ch;
+  uint32_t shift;
+
+  *res  = 0;
+  shift = 0;
+  do
+  {
+    if ((ch = getc (parser->infile)) == EOF)
+      return perr_aiger (parser, "unexpected end of file in and gates");
+    if (shift > 28 || (shift == 28 && (ch & 0x70)))
+      return perr_aiger (parser, "invalid and gate delta");
+    *res |= (uint32_t) (ch & 0x7f) << shift;
+    shift += 7;
+  } while (ch & 0x80);
+  return true;
+}
+
+/*------------------------------------------------------------------------*/
+
+static bool
+get_lit_aiger (BtorAIGERParser *parser, uint32_t lit, BtorNode **res)
+{
+  assert (lit / 2 <= parser->maxvar);
+
+  BtorNode *exp;
+
+  *res = 0;
+  if (!(exp = parser->vars[lit / 2]))
+    return perr_aiger (parser, "undefined literal %u", lit);
+  *res = lit & 1 ? btor_node_invert (exp) : exp;
+  return true;
+}
+
+static bool
+check_new_var_aiger (BtorAIGERParser *parser, uint32_t lit, const char *what)
+{
+  if (!lit || (lit & 1))
+    return perr_aiger (parser, "invalid %s literal %u", what, lit);
+  if (parser->vars[lit / 2]
+      || (parser->and_of_var && parser->and_of_var[lit / 2]))
+    return perr_aiger (parser, "variable %u defined twice", lit / 2);
+  return true;
+}
+
+/* BtorMC expects nodes with external references. */
+static BoolectorNode *
+export_node_aiger (Btor *btor, BtorNode *exp)
+{
+  BtorNode *res;
+
+  res = btor_node_copy (btor, exp);
+  btor_node_inc_ext_ref_counter (btor, res);
+  return BTOR_EXPORT_BOOLECTOR_NODE (res);
+}
+
+/*------------------------------------------------------------------------*/
+
+static bool
+parse_header_aiger (BtorAIGERParser *parser)
+{
+  int32_t ch;
+  uint32_t i, counts[9];
+  uint64_t nvars;
+  const char *names[9] = {"maximum variable index",
+                          "number of inputs",
+                          "number of latches",
+                          "number of outputs",
+                          "number of and gates",
+                          "number of bad state properties",
+                          "number of invariant constraints",
+                          "number of justice properties",
+                          "number of fairness constraints"};
+
+  if (nextch_aiger (parser) != 'a'
+      || ((ch = nextch_aiger (parser)) != 'i' && ch != 'a')
+      || nextch_aiger (parser) != 'g')
+    return perr_aiger (parser, "expected 'aig' or 'aag' header");
+  parser->binary = ch == 'i';
+
+  memset (counts, 0, sizeof counts);
+  for (i = 0; i < 9; i++)
+  {
+    if (i >= 5)
+    {
+      ch = nextch_aiger (parser);
+      savech_aiger (parser, ch);
+      if (ch == '\n') break;
+    }
+    if (!expect_char_aiger (parser, ' ', i ? names[i - 1] : "header")
+        || !read_uint_aiger (parser, names[i], counts + i))
+      return false;
+  }
+  if (!expect_char_aiger (parser, '\n', "header")) return false;
+
+  parser->maxvar       = counts[0];
+  parser->ninputs      = counts[1];
+  parser->nlatches     = counts[2];
+  parser->noutputs     = counts[3];
+  parser->nands        = counts[4];
+  parser->nbad         = counts[5];
+  parser->nconstraints = counts[6];
+  parser->njustice     = counts[7];
+  parser->nfairness    = counts[8];
+
+  if (parser->maxvar >= INT32_MAX)
+    return perr_aiger (parser, "maximum variable index too large");
+
+  nvars = (uint64_t) parser->ninputs + parser->nlatches + parser->nands;
+  if (nvars > parser->maxvar
+      || (parser->binary && nvars != parser->maxvar))
+    return perr_aiger (parser,
+                       "invalid maximum variable index %u",
+                       parser->maxvar);
+  return true;
+}
+
+static bool
+parse_inputs_aiger (BtorAIGERParser *parser)
+{
+  uint32_t i, lit;
+  BoolectorNode *input;
+
+  for (i = 0; i < parser->ninputs; i++)
+  {
+    if (parser->binary)
+      lit = 2 * (i + 1);
+    else if (!read_lit_aiger (parser, "input", &lit, '\n')
+             || !check_new_var_aiger (parser, lit, "input"))
+      return false;
+    parser->inputs[i] = lit;
+
+    input = btor_mc_input (parser->mc, parser->sort, 0);
+    parser->vars[lit / 2] =
+        btor_node_copy (parser->btor, BTOR_IMPORT_BOOLECTOR_NODE (input));
+    boolector_release (parser->btor, input);
+  }
+  return true;
+}
+
+static bool
+parse_latches_aiger (BtorAIGERParser *parser)
+{
+  int32_t ch;
+  uint32_t i, lit;
+  BoolectorNode *state;
+
+  for (i = 0; i < parser->nlatches; i++)
+  {
+    if (parser->binary)
+      lit = 2 * (parser->ninputs + i + 1);
+    else if (!read_lit_aiger (parser, "latch", &lit, ' ')
+             || !check_new_var_aiger (parser, lit, "latch"))
+      return false;
+    parser->latches[i] = lit;
+
+    if (!read_uint_aiger (parser, "next state literal", parser->next + i))
+      return false;
+    if (parser->next[i] / 2 > parser->maxvar)
+      return perr_aiger (
+          parser, "invalid next state literal %u", parser->next[i]);
+
+    /* AIGER 1.9 reset value, latches are initialized with 0 otherwise */
+    parser->reset[i] = 0;
+    if ((ch = nextch_aiger (parser)) == ' ')
+    {
+      if (!read_lit_aiger (parser, "reset value", parser->reset + i, '\n'))
+        return false;
+      if (parser->reset[i] > 1 && parser->reset[i] != lit)
+        return perr_aiger (parser, "invalid reset value %u", parser->reset[i]);
+    }
+    else if (ch != '\n')
+      return perr_aiger (parser, "expected newline after next state literal");
+
+    state = btor_mc_state (parser->mc, parser->sort, 0);
+    parser->vars[lit / 2] =
+        btor_node_copy (parser->btor, BTOR_IMPORT_BOOLECTOR_NODE (state));
+    boolector_release (parser->btor, state);
+  }
+  return true;
+}
+
+static bool
+parse_lits_aiger (BtorAIGERParser *parser,
+                  const char *what,
+                  uint32_t *lits,
+                  uint32_t n)
+{
+  uint32_t i, lit;
+
+  for (i = 0; i < n; i++)
+  {
+    if (!read_lit_aiger (parser, what, &lit, '\n')) return false;
+    if (lits) lits[i] = lit;
+  }
+  return true;
+}
+
+static bool
+parse_justice_aiger (BtorAIGERParser *parser)
+{
+  uint32_t i, size;
+  uint64_t nlits;
+
+  nlits = 0;
+  for (i = 0; i < parser->njustice; i++)
+  {
+    if (!read_uint_aiger (parser, "justice property size", &size)
+        || !expect_char_aiger (parser, '\n', "justice property size"))
+      return false;
+    nlits += size;
+  }
+  for (; nlits; nlits--)
+    if (!parse_lits_aiger (parser, "justice literal", 0, 1)) return false;
+  return parse_lits_aiger (parser, "fairness literal", 0, parser->nfairness);
+}
+
+static bool
+parse_binary_ands_aiger (BtorAIGERParser *parser)
+{
+  uint32_t i, lhs, rhs0, rhs1, delta;
+  BtorNode *e0, *e1;
+
+  for (i = 0; i < parser->nands; i++)
+  {
+    lhs = 2 * (parser->ninputs + parser->nlatches + i + 1);
+    if (!read_delta_aiger (parser, &delta)) return false;
+    if (!delta || delta > lhs)
+      return perr_aiger (parser, "invalid delta in and gate %u", lhs);
+    rhs0 = lhs - delta;
+    if (!read_delta_aiger (parser, &delta)) return false;
+    if (delta > rhs0)
+      return perr_aiger (parser, "invalid delta in and gate %u", lhs);
+    rhs1 = rhs0 - delta;
+
+    /* children are defined before their parents in binary format */
+    get_lit_aiger (parser, rhs0, &e0);
+    get_lit_aiger (parser, rhs1, &e1);
+    parser->vars[lhs / 2] = btor_exp_bv_and (parser->btor, e0, e1);
+  }
+  return true;
+}
+
+static bool
+parse_ascii_ands_aiger (BtorAIGERParser *parser)
+{
+  uint32_t i, lhs, *and;
+
+  for (i = 0; i < parser->nands; i++)
+  {
+    and = parser->ands + 3 * i;
+    if (!read_lit_aiger (parser, "and gate", &lhs, ' ')
+        || !check_new_var_aiger (parser, lhs, "and gate")
+        || !read_lit_aiger (parser, "and gate input", and + 1, ' ')
+        || !read_lit_aiger (parser, "and gate input", and + 2, '\n'))
+      return false;
+    and[0]                      = lhs;
+    parser->and_of_var[lhs / 2] = i + 1;
+  }
+  return true;
+}
+
+/* Create the and gates of the ASCII format, which may be given in any order,
+ * in topological order. */
+static bool
+resolve_ands_aiger (BtorAIGERParser *parser)
+{
+  uint32_t i, j, var, cvar, *and;
+  BtorNode *e0, *e1;
+  BtorUIntStack visit;
+  bool res;
+
+  res = true;
+  BTOR_INIT_STACK (parser->mm, visit);
+  for (i = 0; res && i < parser->nands; i++)
+  {
+    BTOR_PUSH_STACK (visit, parser->ands[3 * i] / 2);
+    while (res && !BTOR_EMPTY_STACK (visit))
+    {
+      var = BTOR_TOP_STACK (visit);
+      if (parser->vars[var])
+      {
+        (void) BTOR_POP_STACK (visit);
+        continue;
+      }
+      and = parser->ands + 3 * ((parser->and_of_var[var] & ~BTOR_AIGER_AND_MARK)
+                                - 1);
+      if (parser->and_of_var[var] & BTOR_AIGER_AND_MARK)
+      {
+        (void) BTOR_POP_STACK (visit);
+        get_lit_aiger (parser, and[1], &e0);
+        get_lit_aiger (parser, and[2], &e1);
+        parser->vars[var] = btor_exp_bv_and (parser->btor, e0, e1);
+        continue;
+      }
+      parser->and_of_var[var] |= BTOR_AIGER_AND_MARK;
+      for (j = 1; j < 3; j++)
+      {
+        cvar = and[j] / 2;
+        if (parser->vars[cvar]) continue;
+        if (!parser->and_of_var[cvar])
+          res = perr_aiger (parser, "undefined literal %u", and[j]);
+        else if (parser->and_of_var[cvar] & BTOR_AIGER_AND_MARK)
+          res = perr_aiger (parser, "cyclic definition of and gate %u", and[0]);
+        else
+          BTOR_PUSH_STACK (visit, cvar);
+      }
+    }
+  }
+  BTOR_RELEASE_STACK (visit);
+  return res;
+}
+
+static bool
+parse_symbols_aiger (BtorAIGERParser *parser)
+{
+  int32_t ch, type;
+  uint32_t pos, n;
+  BtorNode *exp;
+
+  for (;;)
+  {
+    type = nextch_aiger (parser);
+    if (type == EOF) break;
+    if (type == 'c')
+    {
+      /* start of comment section */
+      ch = nextch_aiger (parser);
+      if (ch == '\n' || ch == EOF) break;
+      savech_aiger (parser, ch);
+    }
+
+    switch (type)
+    {
+      case 'i': n = parser->ninputs; break;
+      case 'l': n = parser->nlatches; break;
+      case 'o': n = parser->noutputs; break;
+      case 'b': n = parser->nbad; break;
+      case 'c': n = parser->nconstraints; break;
+      case 'j': n = parser->njustice; break;
+      case 'f': n = parser->nfairness; break;
+      default: return perr_aiger (parser, "invalid symbol table entry");
+    }
+    if (!read_uint_aiger (parser, "symbol position", &pos)
+        || !expect_char_aiger (parser, ' ', "symbol position"))
+      return false;
+    if (pos >= n) return perr_aiger (parser, "invalid symbol position %u", pos);
+
+    BTOR_RESET_STACK (parser->symbol);
+    while ((ch = nextch_aiger (parser)) != '\n')
+    {
+      if (ch == EOF) return perr_aiger (parser, "unexpected end of file");
+      BTOR_PUSH_STACK (parser->symbol, ch);
+    }
+    BTOR_PUSH_STACK (parser->symbol, 0);
+
+    /* only inputs and states are named, properties may share nodes */
+    if (type != 'i' && type != 'l') continue;
+    exp = parser->vars[(type == 'i' ? parser->inputs : parser->latches)[pos]
+                       / 2];
+    if (!parser->symbol.start[0]
+        || btor_hashptr_table_get (parser->btor->symbols, parser->symbol.start)
+        || btor_node_get_symbol (parser->btor, exp))
+      continue;
+    btor_node_set_symbol (parser->btor, exp, parser->symbol.start);
+  }
+  return true;
+}
+
+/*------------------------------------------------------------------------*/
+
+static void
+add_root_aiger (BtorAIGERParser *parser,
+                BtorNode *exp,
+                uint32_t (*add) (BtorMC *, BoolectorNode *))
+{
+  BoolectorNode *root;
+
+  root = export_node_aiger (parser->btor, exp);
+  add (parser->mc, root);
+  boolector_release (parser->btor, root);
+}
+
+static bool
+setup_mc_aiger (BtorAIGERParser *parser, bool checkall)
+{
+  uint32_t i, nprops, *props;
+  BtorNode *exp, *tmp, *prop;
+  BoolectorNode *state, *next, *init;
+  Btor *btor;
+
+  btor = parser->btor;
+
+  for (i = 0; i < parser->nlatches; i++)
+  {
+    if (!get_lit_aiger (parser, parser->next[i], &exp)) return false;
+    state = export_node_aiger (btor, parser->vars[parser->latches[i] / 2]);
+    next  = export_node_aiger (btor, exp);
+    btor_mc_next (parser->mc, state, next);
+    boolector_release (btor, next);
+    if (parser->reset[i] != parser->latches[i])
+    {
+      get_lit_aiger (parser, parser->reset[i], &exp);
+      init = export_node_aiger (btor, exp);
+      btor_mc_init (parser->mc, state, init);
+      boolector_release (btor, init);
+    }
+    boolector_release (btor, state);
+  }
+
+  for (i = 0; i < parser->nconstraints; i++)
+  {
+    if (!get_lit_aiger (parser, parser->constraints[i], &exp)) return false;
+    add_root_aiger (parser, exp, btor_mc_constraint);
+  }
+
+  /* AIGER 1.0 encodes bad state properties as outputs */
+  props  = parser->nbad ? parser->bad : parser->outputs;
+  nprops = parser->nbad ? parser->nbad : parser->noutputs;
+
+  if (!nprops && parser->njustice)
+    return perr_aiger (parser, "justice properties not supported");
+  if (parser->njustice || parser->nfairness)
+    BTOR_MSG (btor->msg,
+              1,
+              "ignoring %u justice properties and %u fairness constraints",
+              parser->njustice,
+              parser->nfairness);
+
+  prop = 0;
+  for (i = 0; i < nprops; i++)
+  {
+    if (!get_lit_aiger (parser, props[i], &exp))
+    {
+      if (prop) btor_node_release (btor, prop);
+      return false;
+    }
+    if (!checkall)
+      add_root_aiger (parser, exp, btor_mc_bad);
+    else if (!prop)
+      prop = btor_node_copy (btor, exp);
+    else
+    {
+      tmp = btor_exp_bv_or (btor, prop, exp);
+      btor_node_release (btor, prop);
+      prop = tmp;
+    }
+  }
+  if (prop)
+  {
+    add_root_aiger (parser, prop, btor_mc_bad);
+    btor_node_release (btor, prop);
+  }
+  return true;
+}
+
+/*------------------------------------------------------------------------*/
+
+#define NEW_LITS_AIGER(lits, n)     \
+  do                                \
+  {                                 \
+    if (n) BTOR_NEWN (mm, lits, n); \
+  } while (0)
+
+#define DELETE_LITS_AIGER(lits, n)        \
+  do                                      \
+  {                                       \
+    if (lits) BTOR_DELETEN (mm, lits, n); \
+  } while (0)
+
+char *
+btor_parseaiger_mc (BtorMC *mc,
+                    FILE *infile,
+                    const char *infile_name,
+                    bool checkall)
+{
+  assert (mc);
+  assert (infile);
+  assert (infile_name);
+
+  uint32_t i;
+  bool res;
+  BtorAIGERParser parser;
+  BtorMemMgr *mm;
+
+  mm = mc->mm;
+  memset (&parser, 0, sizeof parser);
+  parser.mm          = mm;
+  parser.mc          = mc;
+  parser.btor        = mc->btor;
+  parser.infile      = infile;
+  parser.infile_name = infile_name;
+  parser.lineno      = 1;
+  BTOR_INIT_STACK (mm, parser.symbol);
+
+  BTOR_MSG (parser.btor->msg, 1, "parsing %s", infile_name);
+
+  res = parse_header_aiger (&parser);
+  if (res)
+  {
+    parser.sort = boolector_bitvec_sort (parser.btor, 1);
+    BTOR_CNEWN (mm, parser.vars, parser.maxvar + 1);
+    parser.vars[0] = btor_exp_false (parser.btor);
+    NEW_LITS_AIGER (parser.inputs, parser.ninputs);
+    NEW_LITS_AIGER (parser.latches, parser.nlatches);
+    NEW_LITS_AIGER (parser.next, parser.nlatches);
+    NEW_LITS_AIGER (parser.reset, parser.nlatches);
+    NEW_LITS_AIGER (parser.outputs, parser.noutputs);
+    NEW_LITS_AIGER (parser.bad, parser.nbad);
+    NEW_LITS_AIGER (parser.constraints, parser.nconstraints);
+    if (!parser.binary && parser.nands)
+    {
+      BTOR_NEWN (mm, parser.ands, 3 * parser.nands);
+      BTOR_CNEWN (mm, parser.and_of_var, parser.maxvar + 1);
+    }
+
+    res = parse_inputs_aiger (&parser) && parse_latches_aiger (&parser)
+          && parse_lits_aiger (
+              &parser, "output", parser.outputs, parser.noutputs)
+          && parse_lits_aiger (&parser, "bad state", parser.bad, parser.nbad)
+          && parse_lits_aiger (&parser,
+                               "invariant constraint",
+                               parser.constraints,
+                               parser.nconstraints)
+          && parse_justice_aiger (&parser)
+          && (parser.binary ? parse_binary_ands_aiger (&parser)
+                            : parse_ascii_ands_aiger (&parser)
+                                  && resolve_ands_aiger (&parser))
+          && parse_symbols_aiger (&parser)
+          && setup_mc_aiger (&parser, checkall);
+  }
+
+  if (res)
+    BTOR_MSG (parser.btor->msg,
+              1,
+              "parsed %u inputs, %u latches and %u and gates",
+              parser.ninputs,
+              parser.nlatches,
+              parser.nands);
+
+  if (parser.vars)
+  {
+    for (i = 0; i <= parser.maxvar; i++)
+      if (parser.vars[i]) btor_node_release (parser.btor, parser.vars[i]);
+    BTOR_DELETEN (mm, parser.vars, parser.maxvar + 1);
+  }
+  DELETE_LITS_AIGER (parser.inputs, parser.ninputs);
+  DELETE_LITS_AIGER (parser.latches, parser.nlatches);
+  DELETE_LITS_AIGER (parser.next, parser.nlatches);
+  DELETE_LITS_AIGER (parser.reset, parser.nlatches);
+  DELETE_LITS_AIGER (parser.outputs, parser.noutputs);
+  DELETE_LITS_AIGER (parser.bad, parser.nbad);
+  DELETE_LITS_AIGER (parser.constraints, parser.nconstraints);
+  DELETE_LITS_AIGER (parser.ands, 3 * parser.nands);
+  DELETE_LITS_AIGER (parser.and_of_var, parser.maxvar + 1);
+  if (parser.sort) boolector_release_sort (parser.btor, parser.sort);
+  BTOR_RELEASE_STACK (parser.symbol);
+
+  assert (res || parser.error);
+  return res ? 0 : parser.error;
+}
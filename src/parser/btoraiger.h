@@ -0,0 +1,35 @@
+/*  Boolector: Satisfiability Modulo Theories (SMT) solver.
+ *
+ *  Copyright (C) 2007-2021 by the authors listed in the AUTHORS file.
+ *
+ *  This file is part of Boolector.
+ *  See COPYING for more information on using this software.
+ */
+
+#ifndef BTORAIGER_H_INCLUDED
+#define BTORAIGER_H_INCLUDED
+
+#include "btormc.h"
+
+#include <stdbool.h>
+#include <stdio.h>
+
+/* Parse a sequential circuit in ASCII ('aag') or binary ('aig') AIGER format
+ * (including the AIGER 1.9 header extensions for bad state properties,
+ * invariant constraints, justice properties and fairness constraints) into
+ * model checker 'mc'.  Inputs and latches are added as 1-bit inputs and
+ * states, and bad state properties (or outputs if there are none) as bad
+ * state properties.  If 'checkall' is true, the disjunction of all bad state
+ * properties is added as a single property.  Justice properties and
+ * fairness constraints are not supported and ignored if there are safety
+ * properties to check.
+ *
+ * Returns 0 on success, and an error message otherwise, which has to be
+ * released with 'btor_mem_freestr (mc->mm, error)'.
+ */
+char *btor_parseaiger_mc (BtorMC *mc,
+                          FILE *infile,
+                          const char *infile_name,
+                          bool checkall);
+
+#endif
@@ -0,0 +1,853 @@
+/*  Boolector: Satisfiability Modulo Theories (SMT) solver.
+ *
+ *  Copyright (C) 2007-2021 by the authors listed in the AUTHORS file.
+ *
+ *  This file is part of Boolector.
+ *  See COPYING for more information on using this software.
+ */
+
+#include "parser/btorbin.h"
+#include "btorbv.h"
+#include "btorcore.h"
+#include "btorexp.h"
+#include "btormsg.h"
+#include "btornode.h"
+#include "btorsort.h"
+#include "dumper/btordumpbin.h"
+#include "utils/btorhashptr.h"
+#include "utils/btormem.h"
+
+#include <assert.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#define BTOR_BIN_BLOCK_SIZE (1 << 16)
+
+/*------------------------------------------------------------------------*/
+
+struct BtorBINParser
+{
+  BtorMemMgr *mm;
+  Btor *btor;
+  char *error;
+  const char *infile_name;
+
+  bool mapped;
+  size_t size;
+  unsigned char *start;     /* mapped file or buffer */
+  const unsigned char *bin; /* start of binary data */
+  const unsigned char *pos;
+  const unsigned char *end;
+
+  uint32_t nsorts, nconsts, nsymbols, nnodes;
+  BtorSortId *sorts;
+  BtorNode **consts;
+  char **symbols;
+  BtorNode **nodes;
+
+  bool found_funs, found_quants;
+};
+
+typedef struct BtorBINParser BtorBINParser;
+
+/*------------------------------------------------------------------------*/
+
+/* Binary input has no lines, errors report the byte offset instead. */
+static bool
+perr_bin (BtorBINParser *parser, const char *fmt, ...)
+{
+  size_t bytes;
+  va_list ap;
+
+  if (!parser->error)
+  {
+    va_start (ap, fmt);
+    bytes = btor_mem_parse_error_msg_length (parser->infile_name, fmt, ap);
+    va_end (ap);
+
+    va_start (ap, fmt);
+    parser->error = btor_mem_parse_error_msg (parser->mm,
+                                              parser->infile_name,
+                                              parser->pos - parser->bin,
+                                              0,
+                                              fmt,
+                                              ap,
+                                              bytes);
+    va_end (ap);
+  }
+  return false;
+}
+
+/*------------------------------------------------------------------------*/
+
+static BtorBINParser *
+new_bin_parser (Btor *btor)
+{
+  BtorMemMgr *mm = btor_mem_mgr_new ();
+  BtorBINParser *res;
+
+  BTOR_NEW (mm, res);
+  BTOR_CLR (res);
+
+  res->mm   = mm;
+  res->btor = btor;
+
+  return res;
+}
+
+static void
+delete_bin_parser (BtorBINParser *parser)
+{
+  BtorMemMgr *mm;
+
+  mm = parser->mm;
+  btor_mem_freestr (mm, parser->error);
+  BTOR_DELETE (mm, parser);
+  btor_mem_mgr_delete (mm);
+}
+
+/*------------------------------------------------------------------------*/
+
+/* Regular input files are mapped into memory, all other input is read into
+ * a buffer as a whole. */
+static void
+open_input_bin (BtorBINParser *parser, FILE *infile)
+{
+  struct stat st;
+  off_t offset;
+  void *start;
+  size_t n, size;
+
+  if (!fstat (fileno (infile), &st) && S_ISREG (st.st_mode)
+      && (offset = ftello (infile)) >= 0 && st.st_size > offset)
+  {
+    start = mmap (0, st.st_size, PROT_READ, MAP_PRIVATE, fileno (infile), 0);
+    if (start != MAP_FAILED)
+    {
+#ifdef MADV_SEQUENTIAL
+      (void) madvise (start, st.st_size, MADV_SEQUENTIAL);
+#endif
+      parser->mapped = true;
+      parser->size   = st.st_size;
+      parser->start  = start;
+      parser->bin    = parser->start + offset;
+      parser->end    = parser->start + st.st_size;
+      parser->pos    = parser->bin;
+      return;
+    }
+  }
+
+  size = 0;
+  parser->size = BTOR_BIN_BLOCK_SIZE;
+  BTOR_NEWN (parser->mm, parser->start, parser->size);
+  while ((n = fread (parser->start + size, 1, parser->size - size, infile)))
+  {
+    size += n;
+    if (size == parser->size)
+    {
+      BTOR_REALLOC (parser->mm, parser->start, parser->size, 2 * parser->size);
+      parser->size *= 2;
+    }
+  }
+  parser->bin = parser->pos = parser->start;
+  parser->end = parser->start + size;
+}
+
+static void
+close_input_bin (BtorBINParser *parser)
+{
+  if (!parser->start) return;
+  if (parser->mapped)
+    (void) munmap (parser->start, parser->size);
+  else
+    BTOR_DELETEN (parser->mm, parser->start, parser->size);
+  parser->start = 0;
+}
+
+/*------------------------------------------------------------------------*/
+
+static bool
+get_uint_bin (BtorBINParser *parser, uint64_t *res)
+{
+  uint32_t shift;
+  uint64_t byte;
+
+  *res = 0;
+  for (shift = 0;; shift += 7)
+  {
+    if (parser->pos == parser->end)
+      return perr_bin (parser, "unexpected end of file");
+    byte = *parser->pos++;
+    if (shift == 63 && byte > 1) return perr_bin (parser, "invalid number");
+    *res |= (byte & 0x7f) << shift;
+    if (!(byte & 0x80)) return true;
+  }
+}
+
+static bool
+get_uint32_bin (BtorBINParser *parser, const char *what, uint32_t *res)
+{
+  uint64_t val;
+
+  if (!get_uint_bin (parser, &val)) return false;
+  if (val > UINT32_MAX) return perr_bin (parser, "invalid %s", what);
+  *res = val;
+  return true;
+}
+
+/* Every table entry takes at least one byte, which bounds the size of
+ * tables allocated for corrupted input. */
+static bool
+get_count_bin (BtorBINParser *parser, const char *what, uint32_t *res)
+{
+  if (!get_uint32_bin (parser, what, res)) return false;
+  if (*res > (size_t) (parser->end - parser->pos))
+    return perr_bin (parser, "invalid number of %s", what);
+  return true;
+}
+
+static bool
+get_section_bin (BtorBINParser *parser, BtorBinSection section)
+{
+  uint64_t val;
+
+  if (!get_uint_bin (parser, &val)) return false;
+  if (val != (uint64_t) section)
+    return perr_bin (parser, "unexpected section %u", (uint32_t) val);
+  return true;
+}
+
+static bool
+get_sort_bin (BtorBINParser *parser, uint32_t nsorts, BtorSortId *res)
+{
+  uint32_t idx;
+
+  *res = 0;
+  if (!get_uint32_bin (parser, "sort", &idx)) return false;
+  if (idx >= nsorts) return perr_bin (parser, "invalid sort %u", idx);
+  *res = parser->sorts[idx];
+  return true;
+}
+
+static bool
+get_child_bin (BtorBINParser *parser, uint32_t index, BtorNode **res)
+{
+  uint64_t ref, delta;
+
+  if (!get_uint_bin (parser, &ref)) return false;
+  delta = ref >> 1;
+  if (!delta || delta > index)
+    return perr_bin (parser, "invalid child reference");
+  *res = parser->nodes[index - delta];
+  if (ref & 1) *res = btor_node_invert (*res);
+  return true;
+}
+
+/*------------------------------------------------------------------------*/
+
+static bool
+parse_sorts_bin (BtorBINParser *parser)
+{
+  uint32_t i, j, kind, m, width, is_array;
+  BtorSortId domain, codomain;
+  BtorSortIdStack elements;
+  Btor *btor;
+  bool res;
+
+  btor = parser->btor;
+  res  = true;
+  BTOR_INIT_STACK (parser->mm, elements);
+
+  if (!get_section_bin (parser, BTOR_BIN_SECTION_SORTS)
+      || !get_count_bin (parser, "sorts", &parser->nsorts))
+    return false;
+  if (parser->nsorts)
+    BTOR_CNEWN (parser->mm, parser->sorts, parser->nsorts);
+
+  for (i = 0; res && i < parser->nsorts; i++)
+  {
+    if (!(res = get_uint32_bin (parser, "sort kind", &kind))) break;
+    switch (kind)
+    {
+      case BTOR_BOOL_SORT: parser->sorts[i] = btor_sort_bool (btor); break;
+      case BTOR_BV_SORT:
+        if (!(res = get_uint32_bin (parser, "bit-width", &width))) break;
+        if (!width)
+        {
+          res = perr_bin (parser, "invalid bit-width");
+          break;
+        }
+        parser->sorts[i] = btor_sort_bv (btor, width);
+        break;
+      case BTOR_TUPLE_SORT:
+        if (!(res = get_count_bin (parser, "tuple elements", &m))) break;
+        if (!m)
+        {
+          res = perr_bin (parser, "empty tuple sort");
+          break;
+        }
+        BTOR_RESET_STACK (elements);
+        for (j = 0; res && j < m; j++)
+        {
+          if (!(res = get_sort_bin (parser, i, &domain))) break;
+          if (btor_sort_is_tuple (btor, domain))
+            res = perr_bin (parser, "invalid tuple element sort");
+          else
+            BTOR_PUSH_STACK (elements, domain);
+        }
+        if (res) parser->sorts[i] = btor_sort_tuple (btor, elements.start, m);
+        break;
+      case BTOR_FUN_SORT:
+        if (!(res = get_sort_bin (parser, i, &domain))
+            || !(res = get_sort_bin (parser, i, &codomain))
+            || !(res = get_uint32_bin (parser, "array flag", &is_array)))
+          break;
+        if (!btor_sort_is_tuple (btor, domain)
+            || btor_sort_is_tuple (btor, codomain)
+            || btor_sort_is_fun (btor, codomain)
+            || (is_array && btor_sort_tuple_get_arity (btor, domain) != 1))
+        {
+          res = perr_bin (parser, "invalid function sort");
+          break;
+        }
+        parser->sorts[i] = btor_sort_fun (btor, domain, codomain);
+        if (is_array)
+          btor_sort_get_by_id (btor, parser->sorts[i])->fun.is_array = true;
+        break;
+      default: res = perr_bin (parser, "invalid sort kind %u", kind);
+    }
+  }
+
+  BTOR_RELEASE_STACK (elements);
+  return res;
+}
+
+static bool
+parse_consts_bin (BtorBINParser *parser)
+{
+  uint32_t i, j, k, width;
+  BtorBitVector *bits;
+
+  if (!get_section_bin (parser, BTOR_BIN_SECTION_CONSTS)
+      || !get_count_bin (parser, "constants", &parser->nconsts))
+    return false;
+  if (parser->nconsts)
+    BTOR_CNEWN (parser->mm, parser->consts, parser->nconsts);
+
+  for (i = 0; i < parser->nconsts; i++)
+  {
+    if (!get_uint32_bin (parser, "bit-width", &width)) return false;
+    if (!width) return perr_bin (parser, "invalid bit-width");
+    if ((width - 1) / 8 + 1 > (size_t) (parser->end - parser->pos))
+      return perr_bin (parser, "unexpected end of file");
+    bits = btor_bv_new (parser->btor->mm, width);
+    for (j = 0; j < width; j += 8, parser->pos++)
+      for (k = 0; k < 8 && j + k < width; k++)
+        if ((*parser->pos >> k) & 1) btor_bv_set_bit (bits, j + k, 1);
+    parser->consts[i] = btor_exp_bv_const (parser->btor, bits);
+    btor_bv_free (parser->btor->mm, bits);
+  }
+  return true;
+}
+
+static bool
+parse_symbols_bin (BtorBINParser *parser)
+{
+  uint32_t i, len;
+
+  if (!get_section_bin (parser, BTOR_BIN_SECTION_SYMBOLS)
+      || !get_count_bin (parser, "symbols", &parser->nsymbols))
+    return false;
+  if (parser->nsymbols)
+    BTOR_CNEWN (parser->mm, parser->symbols, parser->nsymbols);
+
+  for (i = 0; i < parser->nsymbols; i++)
+  {
+    if (!get_uint32_bin (parser, "symbol length", &len)) return false;
+    if (len > (size_t) (parser->end - parser->pos))
+      return perr_bin (parser, "unexpected end of file");
+    if (!len || memchr (parser->pos, 0, len))
+      return perr_bin (parser, "invalid symbol");
+    BTOR_NEWN (parser->mm, parser->symbols[i], len + 1);
+    memcpy (parser->symbols[i], parser->pos, len);
+    parser->symbols[i][len] = 0;
+    parser->pos += len;
+  }
+  return true;
+}
+
+/*------------------------------------------------------------------------*/
+
+static bool
+is_bv_bin (Btor *btor, BtorNode *exp)
+{
+  return !btor_node_is_fun (exp) && !btor_node_is_args (exp)
+         && btor_sort_is_bv (btor, btor_node_get_sort_id (exp));
+}
+
+static bool
+is_same_bv_bin (Btor *btor, BtorNode *e0, BtorNode *e1)
+{
+  return is_bv_bin (btor, e0) && is_bv_bin (btor, e1)
+         && btor_node_get_sort_id (e0) == btor_node_get_sort_id (e1);
+}
+
+static bool
+is_args_of_bin (Btor *btor, BtorNode *args, BtorNode *fun)
+{
+  return btor_node_is_regular (args) && btor_node_is_args (args)
+         && btor_node_is_regular (fun) && btor_node_is_fun (fun)
+         && btor_node_get_sort_id (args)
+                == btor_sort_fun_get_domain (btor, btor_node_get_sort_id (fun));
+}
+
+static bool
+is_unbound_param_bin (BtorNode *param)
+{
+  return btor_node_is_regular (param) && btor_node_is_param (param)
+         && !btor_node_param_is_bound (param);
+}
+
+/* Check the preconditions of the expression constructors, which are only
+ * asserted by the solver itself. */
+static bool
+check_node_bin (Btor *btor, BtorNodeKind kind, BtorNode *e[], uint32_t arity)
+{
+  uint32_t i;
+  BtorSortId codomain;
+
+  switch (kind)
+  {
+    case BTOR_BV_AND_NODE:
+    case BTOR_BV_ADD_NODE:
+    case BTOR_BV_MUL_NODE:
+    case BTOR_BV_ULT_NODE:
+    case BTOR_BV_SLL_NODE:
+    case BTOR_BV_SRL_NODE:
+    case BTOR_BV_UDIV_NODE:
+    case BTOR_BV_UREM_NODE:
+    case BTOR_BV_EQ_NODE: return is_same_bv_bin (btor, e[0], e[1]);
+    case BTOR_FUN_EQ_NODE:
+      return btor_node_is_regular (e[0]) && btor_node_is_fun (e[0])
+             && btor_node_is_regular (e[1]) && btor_node_is_fun (e[1])
+             && btor_node_get_sort_id (e[0]) == btor_node_get_sort_id (e[1]);
+    case BTOR_BV_CONCAT_NODE:
+      return is_bv_bin (btor, e[0]) && is_bv_bin (btor, e[1])
+             && btor_node_bv_get_width (btor, e[0])
+                    <= UINT32_MAX - btor_node_bv_get_width (btor, e[1]);
+    case BTOR_APPLY_NODE: return is_args_of_bin (btor, e[1], e[0]);
+    case BTOR_LAMBDA_NODE:
+      return is_unbound_param_bin (e[0]) && !btor_node_is_args (e[1]);
+    case BTOR_FORALL_NODE:
+    case BTOR_EXISTS_NODE:
+      return is_unbound_param_bin (e[0]) && is_bv_bin (btor, e[1])
+             && btor_node_bv_get_width (btor, e[1]) == 1;
+    case BTOR_COND_NODE:
+      if (!is_bv_bin (btor, e[0]) || btor_node_bv_get_width (btor, e[0]) != 1
+          || btor_node_get_sort_id (e[1]) != btor_node_get_sort_id (e[2])
+          || btor_node_is_args (e[1]))
+        return false;
+      return !btor_node_is_fun (e[1])
+             || (btor_node_is_regular (e[1]) && btor_node_is_regular (e[2]));
+    case BTOR_UPDATE_NODE:
+      if (!is_args_of_bin (btor, e[1], e[0])) return false;
+      codomain =
+          btor_sort_fun_get_codomain (btor, btor_node_get_sort_id (e[0]));
+      return is_bv_bin (btor, e[2]) && btor_node_get_sort_id (e[2]) == codomain;
+    default:
+      assert (kind == BTOR_ARGS_NODE);
+      if (arity < 1 || arity > 3) return false;
+      for (i = 0; i < arity; i++)
+      {
+        if (btor_node_is_fun (e[i])) return false;
+        if (btor_node_is_args (e[i])
+            && (i != 2 || !btor_node_is_regular (e[i])))
+          return false;
+      }
+      return true;
+  }
+}
+
+static bool
+parse_symbol_ref_bin (BtorBINParser *parser, char **res)
+{
+  uint32_t idx;
+
+  *res = 0;
+  if (!get_uint32_bin (parser, "symbol", &idx)) return false;
+  if (idx > parser->nsymbols) return perr_bin (parser, "invalid symbol");
+  *res = idx ? parser->symbols[idx - 1] : 0;
+  if (*res && btor_hashptr_table_get (parser->btor->symbols, *res))
+    return perr_bin (parser, "symbol '%s' already defined", *res);
+  return true;
+}
+
+static bool
+parse_static_rho_bin (BtorBINParser *parser, uint32_t index, BtorNode *lambda)
+{
+  uint32_t i, n;
+  BtorNode *args, *value;
+  BtorPtrHashTable *rho;
+  Btor *btor;
+
+  btor = parser->btor;
+  rho  = 0;
+
+  if (!get_count_bin (parser, "static rho entries", &n)) return false;
+  /* keep the static rho of a lambda that already existed */
+  if (n && btor_node_is_lambda (lambda)
+      && !btor_node_lambda_get_static_rho (lambda))
+    rho = btor_hashptr_table_new (btor->mm,
+                                  (BtorHashPtr) btor_node_hash_by_id,
+                                  (BtorCmpPtr) btor_node_compare_by_id);
+
+  for (i = 0; i < n; i++)
+  {
+    if (!get_child_bin (parser, index, &args)
+        || !get_child_bin (parser, index, &value))
+      break;
+    if (!btor_node_is_regular (args) || !btor_node_is_args (args)
+        || btor_node_is_fun (value) || btor_node_is_args (value))
+    {
+      perr_bin (parser, "invalid static rho");
+      break;
+    }
+    if (rho && !btor_hashptr_table_get (rho, args))
+      btor_hashptr_table_add (rho, btor_node_copy (btor, args))->data.as_ptr =
+          btor_node_copy (btor, value);
+  }
+
+  if (rho) btor_node_lambda_set_static_rho (lambda, rho);
+  return !parser->error;
+}
+
+static bool
+parse_nodes_bin (BtorBINParser *parser)
+{
+  uint32_t i, j, header, idx, upper, lower, arity;
+  BtorNodeKind kind;
+  BtorNode *e[3], *res;
+  BtorSortId sort;
+  char *symbol;
+  Btor *btor;
+
+  btor = parser->btor;
+
+  if (!get_section_bin (parser, BTOR_BIN_SECTION_NODES)
+      || !get_count_bin (parser, "nodes", &parser->nnodes))
+    return false;
+  if (parser->nnodes)
+    BTOR_CNEWN (parser->mm, parser->nodes, parser->nnodes);
+
+  for (i = 0; i < parser->nnodes; i++)
+  {
+    if (!get_uint32_bin (parser, "node header", &header)) return false;
+    kind = header & ((1 << BTOR_BIN_KIND_BITS) - 1);
+    if (kind == BTOR_INVALID_NODE || kind >= BTOR_PROXY_NODE
+        || (header >> BTOR_BIN_KIND_BITS) & ~BTOR_BIN_FLAG_IS_ARRAY)
+      return perr_bin (parser, "invalid node kind");
+
+    res = 0;
+    switch (kind)
+    {
+      case BTOR_BV_CONST_NODE:
+        if (!get_uint32_bin (parser, "constant", &idx)) return false;
+        if (idx >= parser->nconsts) return perr_bin (parser, "invalid constant");
+        res = btor_node_copy (btor, parser->consts[idx]);
+        break;
+
+      case BTOR_VAR_NODE:
+      case BTOR_PARAM_NODE:
+      case BTOR_UF_NODE:
+        if (!get_sort_bin (parser, parser->nsorts, &sort)
+            || !parse_symbol_ref_bin (parser, &symbol))
+          return false;
+        if (kind == BTOR_UF_NODE)
+        {
+          if (!btor_sort_is_fun (btor, sort))
+            return perr_bin (parser, "invalid sort for function");
+          res               = btor_exp_uf (btor, sort, symbol);
+          parser->found_funs = true;
+        }
+        else if (!btor_sort_is_bv (btor, sort))
+          return perr_bin (parser, "invalid sort for bit-vector");
+        else if (kind == BTOR_VAR_NODE)
+          res = btor_exp_var (btor, sort, symbol);
+        else
+          res = btor_exp_param (btor, sort, symbol);
+        break;
+
+      case BTOR_BV_SLICE_NODE:
+        if (!get_child_bin (parser, i, &e[0])
+            || !get_uint32_bin (parser, "upper index", &upper)
+            || !get_uint32_bin (parser, "lower index", &lower))
+          return false;
+        if (!is_bv_bin (btor, e[0]) || upper < lower
+            || upper >= btor_node_bv_get_width (btor, e[0]))
+          return perr_bin (parser, "invalid slice");
+        res = btor_exp_bv_slice (btor, e[0], upper, lower);
+        break;
+
+      default:
+        if (kind == BTOR_ARGS_NODE)
+        {
+          if (!get_uint32_bin (parser, "arity", &arity)) return false;
+          if (arity < 1 || arity > 3) return perr_bin (parser, "invalid arity");
+        }
+        else
+          arity = kind == BTOR_COND_NODE || kind == BTOR_UPDATE_NODE ? 3 : 2;
+        for (j = 0; j < arity; j++)
+          if (!get_child_bin (parser, i, &e[j])) return false;
+        if (!check_node_bin (btor, kind, e, arity))
+          return perr_bin (parser, "invalid operands of '%s'",
+                           g_btor_op2str[kind]);
+        res = btor_exp_create (btor, kind, e, arity);
+        if (kind == BTOR_LAMBDA_NODE)
+        {
+          parser->found_funs = true;
+          if (!parse_static_rho_bin (parser, i, btor_node_real_addr (res)))
+          {
+            btor_node_release (btor, res);
+            return false;
+          }
+        }
+        else if (kind == BTOR_FORALL_NODE || kind == BTOR_EXISTS_NODE)
+          parser->found_quants = true;
+    }
+
+    assert (res);
+    if ((header >> BTOR_BIN_KIND_BITS) & BTOR_BIN_FLAG_IS_ARRAY
+        && btor_node_is_fun (res))
+      btor_node_real_addr (res)->is_array = 1;
+    parser->nodes[i] = res;
+  }
+  return true;
+}
+
+static bool
+is_input_bin (Btor *btor, BtorNode *exp)
+{
+  return btor_node_is_regular (exp)
+         && (btor_node_is_bv_var (exp) || btor_node_is_uf (exp))
+         && !btor_hashptr_table_get (btor->inputs, exp);
+}
+
+/* Register the inputs of the formula and restore the substitutions of
+ * inputs that were eliminated before dumping.  Without an INPUTS section,
+ * all variables and functions are registered in the order of their nodes. */
+static bool
+parse_inputs_bin (BtorBINParser *parser)
+{
+  uint32_t i, n, idx, flags, id;
+  uint64_t ref;
+  BtorNode *input, *subst;
+  BtorHashTableData *data;
+  Btor *btor;
+
+  btor = parser->btor;
+
+  if (parser->pos == parser->end || *parser->pos != BTOR_BIN_SECTION_INPUTS)
+  {
+    for (i = 0; i < parser->nnodes; i++)
+      if (is_input_bin (btor, parser->nodes[i]))
+        btor_hashptr_table_add (btor->inputs,
+                                btor_node_copy (btor, parser->nodes[i]));
+    return true;
+  }
+  parser->pos++;
+
+  if (!get_count_bin (parser, "inputs", &n)) return false;
+  for (i = 0; i < n; i++)
+  {
+    if (!get_uint32_bin (parser, "input", &idx)) return false;
+    if (idx >= parser->nnodes || !is_input_bin (btor, parser->nodes[idx]))
+      return perr_bin (parser, "invalid input");
+    input = parser->nodes[idx];
+    if (!get_uint32_bin (parser, "input flags", &flags)) return false;
+    if (flags & ~(BTOR_BIN_INPUT_SUBST | BTOR_BIN_INPUT_BOOL)
+        || ((flags & BTOR_BIN_INPUT_BOOL)
+            && (!is_bv_bin (btor, input)
+                || btor_node_bv_get_width (btor, input) != 1)))
+      return perr_bin (parser, "invalid input flags");
+    if (!get_uint32_bin (parser, "input id", &id)) return false;
+    if (id > INT32_MAX) return perr_bin (parser, "invalid input id");
+
+    if (flags & BTOR_BIN_INPUT_SUBST)
+    {
+      if (!get_uint_bin (parser, &ref)) return false;
+      /* the substitution must be dumped before the input, which excludes
+       * cyclic substitutions */
+      if ((ref >> 1) >= idx) return perr_bin (parser, "invalid substitution");
+      subst = parser->nodes[ref >> 1];
+      if (ref & 1) subst = btor_node_invert (subst);
+      subst = btor_node_get_simplified (btor, subst);
+      if (btor_node_real_addr (subst) == input || btor_node_is_args (subst)
+          || btor_node_get_sort_id (subst) != btor_node_get_sort_id (input)
+          || btor_node_real_addr (subst)->parameterized)
+        return perr_bin (parser, "invalid substitution");
+      btor_set_simplified_exp (btor, input, subst);
+    }
+    data = &btor_hashptr_table_add (btor->inputs, btor_node_copy (btor, input))
+                ->data;
+    data->flag   = (flags & BTOR_BIN_INPUT_BOOL) != 0;
+    data->as_int = id;
+  }
+  return true;
+}
+
+static bool
+parse_roots_bin (BtorBINParser *parser)
+{
+  bool simplified;
+  uint32_t i, n;
+  uint64_t ref;
+  BtorNode *root;
+  Btor *btor;
+
+  btor = parser->btor;
+
+  /* the roots stay simplified if they are the only constraints */
+  simplified = false;
+  if (parser->pos != parser->end
+      && *parser->pos == BTOR_BIN_SECTION_SIMPLIFIED)
+  {
+    parser->pos++;
+    simplified = btor->simplified
+                 || (!btor->unsynthesized_constraints->count
+                     && !btor->synthesized_constraints->count
+                     && !btor->varsubst_constraints->count
+                     && !btor->embedded_constraints->count);
+  }
+
+  if (!get_section_bin (parser, BTOR_BIN_SECTION_ROOTS)
+      || !get_count_bin (parser, "roots", &n))
+    return false;
+
+  for (i = 0; i < n; i++)
+  {
+    if (!get_uint_bin (parser, &ref)) return false;
+    if ((ref >> 1) >= parser->nnodes)
+      return perr_bin (parser, "invalid root reference");
+    root = parser->nodes[ref >> 1];
+    if (ref & 1) root = btor_node_invert (root);
+    if (!is_bv_bin (btor, root) || btor_node_bv_get_width (btor, root) != 1)
+      return perr_bin (parser, "root is not a boolean");
+    if (btor_node_real_addr (root)->parameterized)
+      return perr_bin (parser, "root is parameterized");
+    btor_assert_exp (btor, root);
+  }
+  if (!get_section_bin (parser, BTOR_BIN_SECTION_END)) return false;
+  btor->simplified = simplified;
+  return true;
+}
+
+/*------------------------------------------------------------------------*/
+
+static void
+release_tables_bin (BtorBINParser *parser)
+{
+  uint32_t i;
+  Btor *btor;
+
+  btor = parser->btor;
+
+  if (parser->nodes)
+  {
+    for (i = 0; i < parser->nnodes && parser->nodes[i]; i++)
+      btor_node_release (btor, parser->nodes[i]);
+    BTOR_DELETEN (parser->mm, parser->nodes, parser->nnodes);
+  }
+  if (parser->symbols)
+  {
+    for (i = 0; i < parser->nsymbols && parser->symbols[i]; i++)
+      BTOR_DELETEN (
+          parser->mm, parser->symbols[i], strlen (parser->symbols[i]) + 1);
+    BTOR_DELETEN (parser->mm, parser->symbols, parser->nsymbols);
+  }
+  if (parser->consts)
+  {
+    for (i = 0; i < parser->nconsts && parser->consts[i]; i++)
+      btor_node_release (btor, parser->consts[i]);
+    BTOR_DELETEN (parser->mm, parser->consts, parser->nconsts);
+  }
+  if (parser->sorts)
+  {
+    for (i = 0; i < parser->nsorts && parser->sorts[i]; i++)
+      btor_sort_release (btor, parser->sorts[i]);
+    BTOR_DELETEN (parser->mm, parser->sorts, parser->nsorts);
+  }
+}
+
+static const char *
+parse_bin_parser (BtorBINParser *parser,
+                  BtorIntStack *prefix,
+                  FILE *infile,
+                  const char *infile_name,
+                  FILE *outfile,
+                  BtorParseResult *res)
+{
+  assert (parser);
+  assert (infile);
+  assert (infile_name);
+  (void) prefix;
+  (void) outfile;
+
+  uint64_t version;
+
+  BTOR_MSG (parser->btor->msg, 1, "parsing %s", infile_name);
+
+  BTOR_CLR (res);
+  parser->infile_name = infile_name;
+
+  open_input_bin (parser, infile);
+
+  if ((size_t) (parser->end - parser->pos) < BTOR_BIN_MAGIC_SIZE
+      || memcmp (parser->pos, BTOR_BIN_MAGIC, BTOR_BIN_MAGIC_SIZE))
+    perr_bin (parser, "invalid binary header");
+  else
+  {
+    parser->pos += BTOR_BIN_MAGIC_SIZE;
+    if (get_uint_bin (parser, &version))
+    {
+      if (version != BTOR_BIN_VERSION)
+        perr_bin (parser, "unsupported version %u", (uint32_t) version);
+      else
+        (void) (parse_sorts_bin (parser) && parse_consts_bin (parser)
+                && parse_symbols_bin (parser) && parse_nodes_bin (parser)
+                && parse_inputs_bin (parser) && parse_roots_bin (parser));
+    }
+  }
+
+  BTOR_MSG (parser->btor->msg,
+            1,
+            "parsed %u nodes with %u constants and %u symbols",
+            parser->nnodes,
+            parser->nconsts,
+            parser->nsymbols);
+
+  release_tables_bin (parser);
+  close_input_bin (parser);
+
+  if (parser->found_quants)
+    res->logic = BTOR_LOGIC_BV;
+  else if (parser->found_funs)
+    res->logic = BTOR_LOGIC_QF_AUFBV;
+  else
+    res->logic = BTOR_LOGIC_QF_BV;
+  res->status = BOOLECTOR_UNKNOWN;
+
+  return parser->error;
+}
+
+static BtorParserAPI parsebin_parser_api = {
+    (BtorInitParser) new_bin_parser,
+    (BtorResetParser) delete_bin_parser,
+    (BtorParse) parse_bin_parser,
+};
+
+const BtorParserAPI *
+btor_parsebin_parser_api ()
+{
+  return &parsebin_parser_api;
+}
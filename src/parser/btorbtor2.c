@@ -7,10 +7,16 @@
  */
 
 #include "btor2parser.h"
+#include "btorbv.h"
+#include "btorcore.h"
+#include "btorexp.h"
 #include "btormsg.h"
+#include "btornode.h"
 #include "btorparse.h"
+#include "btorsort.h"
 #include "btortypes.h"
 #include "utils/btorhashint.h"
+#include "utils/btorhashptr.h"
 #include "utils/btormem.h"
 #include "utils/btorutil.h"
 
@@ -33,10 +39,15 @@ struct BtorBTOR2Parser
   char *error;
   const char *infile_name;
   Btor2Parser *bfr;
+  bool found_arrays;
 };
 
 typedef struct BtorBTOR2Parser BtorBTOR2Parser;
 
+/* Maximum ratio of the largest id to the number of lines for which the id
+ * indexed tables of the direct construction path are used. */
+#define BTOR_BTOR2_MAX_ID_RATIO 4
+
 /*------------------------------------------------------------------------*/
 
 static void
@@ -88,19 +99,13 @@ delete_btor2_parser (BtorBTOR2Parser *parser)
   btor_mem_mgr_delete (mm);
 }
 
-static const char *
-parse_btor2_parser (BtorBTOR2Parser *parser,
-                    BtorIntStack *prefix,
-                    FILE *infile,
-                    const char *infile_name,
-                    FILE *outfile,
-                    BtorParseResult *res)
+/* Construct the formula via the public API.  This is required if API calls
+ * are traced or mirrored to a shadow clone, which rely on the parser using
+ * API calls only. */
+static void
+parse_btor2_api (BtorBTOR2Parser *parser)
 {
   assert (parser);
-  assert (infile);
-  assert (infile_name);
-  (void) prefix;
-  (void) outfile;
 
   uint32_t i, bw;
   int64_t j, signed_arg, unsigned_arg;
@@ -112,41 +117,10 @@ parse_btor2_parser (BtorBTOR2Parser *parser,
   BoolectorNode *e[3], *node, *tmp;
   BoolectorSort sort, sort_index, sort_elem;
   BtorMemMgr *mm;
-  BtorMsg *msg;
   Btor *btor;
-  bool found_arrays, found_lambdas;
 
   btor = parser->btor;
-  msg  = boolector_get_btor_msg (btor);
-
-  BTOR_MSG (msg, 1, "parsing %s", infile_name);
-
-  BTOR_CLR (res);
-
-  mm = parser->mm;
-
-  found_arrays = false;
-  found_lambdas = false;
-
-  nodemap = 0;
-  sortmap = 0;
-
-  parser->infile_name = infile_name;
-
-  /* btor2parser doesn't allow to pass the prefix, we have to rewind to the
-   * beginning of the input file instead. */
-  if (fseek (infile, 0L, SEEK_SET))
-  {
-    perr_btor2 (parser, 0, "error when rewinding input file");
-    goto DONE;
-  }
-
-  if (!btor2parser_read_lines (parser->bfr, infile))
-  {
-    parser->error = btor_mem_strdup (mm, btor2parser_error (parser->bfr));
-    assert (parser->error);
-    goto DONE;
-  }
+  mm   = parser->mm;
 
   sortmap = btor_hashint_map_new (mm);
   nodemap = btor_hashint_map_new (mm);
@@ -189,15 +163,9 @@ parse_btor2_parser (BtorBTOR2Parser *parser,
       unsigned_arg = signed_arg < 0 ? -signed_arg : signed_arg;
       assert (btor_hashint_map_contains (nodemap, unsigned_arg));
       tmp = btor_hashint_map_get (nodemap, unsigned_arg)->as_ptr;
-      if (signed_arg < 0)
-      {
-        e[i] = boolector_not (btor, tmp);
-        boolector_release (btor, tmp);
-      }
-      else
-      {
-        e[i] = tmp;
-      }
+      /* negated arguments are released after the line has been processed,
+       * the negation may be rewritten to a different node */
+      e[i] = signed_arg < 0 ? boolector_not (btor, tmp) : tmp;
       assert (e[i]);
     }
 
@@ -303,7 +271,7 @@ parse_btor2_parser (BtorBTOR2Parser *parser,
         else
         {
           node = boolector_array (btor, sort, line->symbol);
-          found_arrays = true;
+          parser->found_arrays = true;
         }
         boolector_set_btor_id (btor, node, line->id);
         break;
@@ -594,8 +562,10 @@ parse_btor2_parser (BtorBTOR2Parser *parser,
                     line->id,
                     "model checking extensions not supported by boolector, try "
                     "btormc instead");
-        goto DONE;
     }
+    for (i = 0; i < line->nargs; i++)
+      if (line->args[i] < 0) boolector_release (btor, e[i]);
+    if (parser->error) goto DONE;
     assert (!sort || !node || boolector_get_sort (btor, node) == sort);
     if (node)
     {
@@ -604,34 +574,522 @@ parse_btor2_parser (BtorBTOR2Parser *parser,
     }
   }
 DONE:
-  if (nodemap)
+  btor_iter_hashint_init (&it, nodemap);
+  while (btor_iter_hashint_has_next (&it))
+  {
+    j    = it.cur_pos;
+    node = btor_iter_hashint_next_data (&it)->as_ptr;
+    boolector_release (btor, node);
+  }
+  btor_hashint_map_delete (nodemap);
+  btor_iter_hashint_init (&it, sortmap);
+  while (btor_iter_hashint_has_next (&it))
+    boolector_release_sort (btor, btor_iter_hashint_next_data (&it)->as_ptr);
+  btor_hashint_map_delete (sortmap);
+}
+
+/*------------------------------------------------------------------------*/
+
+static bool
+is_bv_btor2 (Btor *btor, BtorNode *exp)
+{
+  return btor_sort_is_bv (btor, btor_node_get_sort_id (exp));
+}
+
+static bool
+is_bool_btor2 (Btor *btor, BtorNode *exp)
+{
+  return btor_sort_is_bool (btor, btor_node_get_sort_id (exp));
+}
+
+/* Check the arguments of 'line', which is otherwise done by the public API
+ * (which aborts on invalid arguments). */
+static bool
+check_args_btor2 (BtorBTOR2Parser *parser, Btor2Line *line, BtorNode *e[])
+{
+  uint32_t i, w0, w1;
+  BtorSortId s;
+  Btor *btor;
+
+  btor = parser->btor;
+
+  switch (line->tag)
+  {
+    case BTOR2_TAG_output: return true;
+
+    case BTOR2_TAG_eq:
+    case BTOR2_TAG_neq:
+      if (btor_node_get_sort_id (e[0]) != btor_node_get_sort_id (e[1]))
+        goto INVALID;
+      return true;
+
+    case BTOR2_TAG_constraint:
+    case BTOR2_TAG_iff:
+    case BTOR2_TAG_implies:
+      for (i = 0; i < line->nargs; i++)
+        if (!is_bool_btor2 (btor, e[i])) goto INVALID;
+      return true;
+
+    case BTOR2_TAG_ite:
+      if (!is_bool_btor2 (btor, e[0])
+          || btor_node_get_sort_id (e[1]) != btor_node_get_sort_id (e[2]))
+        goto INVALID;
+      return true;
+
+    case BTOR2_TAG_read:
+    case BTOR2_TAG_write:
+      s = btor_node_get_sort_id (e[0]);
+      if (!btor_sort_is_array (btor, s)
+          || btor_sort_array_get_index (btor, s)
+                 != btor_node_get_sort_id (e[1])
+          || (line->tag == BTOR2_TAG_write
+              && btor_sort_array_get_element (btor, s)
+                     != btor_node_get_sort_id (e[2])))
+        goto INVALID;
+      return true;
+
+    default: break;
+  }
+
+  for (i = 0; i < line->nargs; i++)
+    if (!is_bv_btor2 (btor, e[i])) goto INVALID;
+  w0 = line->nargs ? btor_node_bv_get_width (btor, e[0]) : 0;
+  w1 = line->nargs > 1 ? btor_node_bv_get_width (btor, e[1]) : 0;
+
+  switch (line->tag)
+  {
+    case BTOR2_TAG_concat:
+      if (w0 > UINT32_MAX - w1) goto INVALID;
+      break;
+
+    case BTOR2_TAG_rol:
+    case BTOR2_TAG_ror:
+    case BTOR2_TAG_sll:
+    case BTOR2_TAG_sra:
+    case BTOR2_TAG_srl:
+      if (w0 != w1
+          && (!btor_util_is_power_of_2 (w0) || btor_util_log_2 (w0) != w1))
+        goto INVALID;
+      break;
+
+    case BTOR2_TAG_slice:
+      if (line->args[2] < 0 || line->args[1] < line->args[2]
+          || line->args[1] >= w0)
+        goto INVALID;
+      break;
+
+    case BTOR2_TAG_sext:
+    case BTOR2_TAG_uext:
+      if (line->args[1] < 0 || line->args[1] > UINT32_MAX - w0) goto INVALID;
+      break;
+
+    default:
+      if (line->nargs == 2 && w0 != w1) goto INVALID;
+  }
+  return true;
+INVALID:
+  perr_btor2 (parser, line->lineno, "invalid arguments to '%s'", line->name);
+  return false;
+}
+
+static BtorNode *
+shift_btor2 (Btor *btor,
+             BtorNode *(*fun) (Btor *, BtorNode *, BtorNode *),
+             BtorNode *e0,
+             BtorNode *e1)
+{
+  uint32_t w0, w1;
+  BtorNode *tmp, *res;
+
+  w0 = btor_node_bv_get_width (btor, e0);
+  w1 = btor_node_bv_get_width (btor, e1);
+  if (w0 == w1) return fun (btor, e0, e1);
+  tmp = btor_exp_bv_uext (btor, e1, w0 - w1);
+  res = fun (btor, e0, tmp);
+  btor_node_release (btor, tmp);
+  return res;
+}
+
+static BtorNode *
+const_btor2 (Btor *btor, Btor2Line *line, uint32_t bw)
+{
+  BtorBitVector *bv;
+  BtorNode *res;
+
+  if (line->tag == BTOR2_TAG_const)
+    bv = btor_bv_char_to_bv (btor->mm, line->constant);
+  else if (line->tag == BTOR2_TAG_constd)
+    bv = btor_bv_constd (btor->mm, line->constant, bw);
+  else
+    bv = btor_bv_consth (btor->mm, line->constant, bw);
+  res = btor_exp_bv_const (btor, bv);
+  btor_bv_free (btor->mm, bv);
+  return res;
+}
+
+/* Construct the formula via the internal API.  Sorts and nodes are kept in
+ * tables indexed by line id, and since BTOR2 ids are increasing, the size of
+ * these tables is known after reading all lines.  This avoids the argument
+ * checks, API tracing and external reference handling of the public API for
+ * every line, as well as the node lookups in hash tables. */
+static void
+parse_btor2_direct (BtorBTOR2Parser *parser, int64_t max_id)
+{
+  assert (parser);
+  assert (max_id >= 0);
+  assert (max_id <= INT32_MAX);
+
+  uint32_t i, bw;
+  int64_t j, id;
+  Btor2LineIterator lit;
+  Btor2Line *line;
+  BtorNode **nodes, *e[3], *node;
+  BtorSortId *sorts, sort, sort_index, sort_elem;
+  BtorMemMgr *mm;
+  Btor *btor;
+  size_t size;
+
+  btor = parser->btor;
+  mm   = parser->mm;
+  size = (size_t) max_id + 1;
+
+  BTOR_CNEWN (mm, nodes, size);
+  BTOR_CNEWN (mm, sorts, size);
+
+  lit = btor2parser_iter_init (parser->bfr);
+  while ((line = btor2parser_iter_next (&lit)))
   {
-    btor_iter_hashint_init (&it, nodemap);
-    while (btor_iter_hashint_has_next (&it))
+    assert (line->id > 0 && line->id <= max_id);
+
+    node = 0;
+    sort = 0;
+
+    /* sort ----------------------------------------------------------------  */
+
+    if (line->tag != BTOR2_TAG_sort && line->sort.id)
+    {
+      if (line->sort.id < 0 || line->sort.id > max_id
+          || !(sort = sorts[line->sort.id]))
+      {
+        perr_btor2 (parser, line->lineno, "undefined sort");
+        goto DONE;
+      }
+    }
+
+    /* arguments -----------------------------------------------------------  */
+
+    for (i = 0; i < line->nargs; i++)
     {
-      j    = it.cur_pos;
-      node = btor_iter_hashint_next_data (&it)->as_ptr;
-      boolector_release (btor, node);
+      j = line->args[i] < 0 ? -line->args[i] : line->args[i];
+      if (j > max_id || !nodes[j])
+      {
+        perr_btor2 (parser, line->lineno, "undefined argument");
+        goto DONE;
+      }
+      e[i] = line->args[i] < 0 ? btor_node_invert (nodes[j]) : nodes[j];
+    }
+    if (!check_args_btor2 (parser, line, e)) goto DONE;
+
+    switch (line->tag)
+    {
+      case BTOR2_TAG_add: node = btor_exp_bv_add (btor, e[0], e[1]); break;
+      case BTOR2_TAG_and: node = btor_exp_bv_and (btor, e[0], e[1]); break;
+      case BTOR2_TAG_concat:
+        node = btor_exp_bv_concat (btor, e[0], e[1]);
+        break;
+
+      case BTOR2_TAG_const:
+      case BTOR2_TAG_constd:
+      case BTOR2_TAG_consth:
+        assert (line->constant);
+        if (!sort || !btor_sort_is_bv (btor, sort))
+        {
+          perr_btor2 (parser, line->lineno, "expected bit-vector sort");
+          goto DONE;
+        }
+        bw = btor_sort_bv_get_width (btor, sort);
+        if ((line->tag == BTOR2_TAG_const
+             && !btor_util_check_bin_to_bv (mm, line->constant, bw))
+            || (line->tag == BTOR2_TAG_constd
+                && !btor_util_check_dec_to_bv (mm, line->constant, bw))
+            || (line->tag == BTOR2_TAG_consth
+                && !btor_util_check_hex_to_bv (mm, line->constant, bw)))
+        {
+          perr_btor2 (parser,
+                      line->lineno,
+                      "invalid '%s' %s of bw %u",
+                      line->name,
+                      line->constant,
+                      bw);
+          goto DONE;
+        }
+        node = const_btor2 (btor, line, bw);
+        break;
+
+      case BTOR2_TAG_constraint: btor_assert_exp (btor, e[0]); break;
+      case BTOR2_TAG_dec: node = btor_exp_bv_dec (btor, e[0]); break;
+      case BTOR2_TAG_eq: node = btor_exp_eq (btor, e[0], e[1]); break;
+      case BTOR2_TAG_iff: node = btor_exp_iff (btor, e[0], e[1]); break;
+      case BTOR2_TAG_implies:
+        node = btor_exp_implies (btor, e[0], e[1]);
+        break;
+      case BTOR2_TAG_inc: node = btor_exp_bv_inc (btor, e[0]); break;
+
+      case BTOR2_TAG_input:
+        if (!sort)
+        {
+          perr_btor2 (parser, line->lineno, "missing sort");
+          goto DONE;
+        }
+        if (line->symbol
+            && btor_hashptr_table_get (btor->symbols, line->symbol))
+        {
+          perr_btor2 (parser,
+                      line->lineno,
+                      "symbol '%s' is already in use",
+                      line->symbol);
+          goto DONE;
+        }
+        if (btor_sort_is_bv (btor, sort))
+          node = btor_exp_var (btor, sort, line->symbol);
+        else
+        {
+          node                 = btor_exp_array (btor, sort, line->symbol);
+          parser->found_arrays = true;
+        }
+        (void) btor_hashptr_table_add (btor->inputs,
+                                       btor_node_copy (btor, node));
+        btor_node_set_btor_id (btor, node, line->id);
+        break;
+
+      case BTOR2_TAG_ite:
+        node = btor_exp_cond (btor, e[0], e[1], e[2]);
+        break;
+      case BTOR2_TAG_mul: node = btor_exp_bv_mul (btor, e[0], e[1]); break;
+      case BTOR2_TAG_nand: node = btor_exp_bv_nand (btor, e[0], e[1]); break;
+      case BTOR2_TAG_neq: node = btor_exp_ne (btor, e[0], e[1]); break;
+      case BTOR2_TAG_neg: node = btor_exp_bv_neg (btor, e[0]); break;
+      case BTOR2_TAG_nor: node = btor_exp_bv_nor (btor, e[0], e[1]); break;
+      case BTOR2_TAG_not: node = btor_exp_bv_not (btor, e[0]); break;
+
+      case BTOR2_TAG_one:
+      case BTOR2_TAG_ones:
+      case BTOR2_TAG_zero:
+        if (!sort || !btor_sort_is_bv (btor, sort))
+        {
+          perr_btor2 (parser, line->lineno, "expected bit-vector sort");
+          goto DONE;
+        }
+        if (line->tag == BTOR2_TAG_one)
+          node = btor_exp_bv_one (btor, sort);
+        else if (line->tag == BTOR2_TAG_ones)
+          node = btor_exp_bv_ones (btor, sort);
+        else
+          node = btor_exp_bv_zero (btor, sort);
+        break;
+
+      case BTOR2_TAG_or: node = btor_exp_bv_or (btor, e[0], e[1]); break;
+
+      case BTOR2_TAG_output:
+        BTOR_PUSH_STACK (btor->outputs, btor_node_copy (btor, e[0]));
+        break;
+
+      case BTOR2_TAG_read: node = btor_exp_read (btor, e[0], e[1]); break;
+      case BTOR2_TAG_redand: node = btor_exp_bv_redand (btor, e[0]); break;
+      case BTOR2_TAG_redor: node = btor_exp_bv_redor (btor, e[0]); break;
+      case BTOR2_TAG_redxor: node = btor_exp_bv_redxor (btor, e[0]); break;
+      case BTOR2_TAG_rol:
+        node = shift_btor2 (btor, btor_exp_bv_rol, e[0], e[1]);
+        break;
+      case BTOR2_TAG_ror:
+        node = shift_btor2 (btor, btor_exp_bv_ror, e[0], e[1]);
+        break;
+      case BTOR2_TAG_saddo: node = btor_exp_bv_saddo (btor, e[0], e[1]); break;
+      case BTOR2_TAG_sdiv: node = btor_exp_bv_sdiv (btor, e[0], e[1]); break;
+      case BTOR2_TAG_sdivo: node = btor_exp_bv_sdivo (btor, e[0], e[1]); break;
+      case BTOR2_TAG_sext:
+        node = btor_exp_bv_sext (btor, e[0], line->args[1]);
+        break;
+      case BTOR2_TAG_sgt: node = btor_exp_bv_sgt (btor, e[0], e[1]); break;
+      case BTOR2_TAG_sgte: node = btor_exp_bv_sgte (btor, e[0], e[1]); break;
+      case BTOR2_TAG_slice:
+        node = btor_exp_bv_slice (btor, e[0], line->args[1], line->args[2]);
+        break;
+      case BTOR2_TAG_sll:
+        node = shift_btor2 (btor, btor_exp_bv_sll, e[0], e[1]);
+        break;
+      case BTOR2_TAG_slt: node = btor_exp_bv_slt (btor, e[0], e[1]); break;
+      case BTOR2_TAG_slte: node = btor_exp_bv_slte (btor, e[0], e[1]); break;
+
+      case BTOR2_TAG_sort:
+        if (line->sort.tag == BTOR2_TAG_SORT_bitvec)
+        {
+          assert (line->sort.bitvec.width);
+          sort = btor_sort_bv (btor, line->sort.bitvec.width);
+        }
+        else
+        {
+          assert (line->sort.tag == BTOR2_TAG_SORT_array);
+          id = line->sort.array.index;
+          sort_index = id > 0 && id <= max_id ? sorts[id] : 0;
+          id = line->sort.array.element;
+          sort_elem = id > 0 && id <= max_id ? sorts[id] : 0;
+          if (!sort_index || !sort_elem || !btor_sort_is_bv (btor, sort_index)
+              || !btor_sort_is_bv (btor, sort_elem))
+          {
+            perr_btor2 (parser, line->lineno, "invalid array sort");
+            goto DONE;
+          }
+          sort = btor_sort_array (btor, sort_index, sort_elem);
+        }
+        assert (!sorts[line->id]);
+        sorts[line->id] = sort;
+        sort            = 0;
+        break;
+
+      case BTOR2_TAG_smod: node = btor_exp_bv_smod (btor, e[0], e[1]); break;
+      case BTOR2_TAG_smulo: node = btor_exp_bv_smulo (btor, e[0], e[1]); break;
+      case BTOR2_TAG_sra:
+        node = shift_btor2 (btor, btor_exp_bv_sra, e[0], e[1]);
+        break;
+      case BTOR2_TAG_srem: node = btor_exp_bv_srem (btor, e[0], e[1]); break;
+      case BTOR2_TAG_srl:
+        node = shift_btor2 (btor, btor_exp_bv_srl, e[0], e[1]);
+        break;
+      case BTOR2_TAG_ssubo: node = btor_exp_bv_ssubo (btor, e[0], e[1]); break;
+      case BTOR2_TAG_sub: node = btor_exp_bv_sub (btor, e[0], e[1]); break;
+      case BTOR2_TAG_uaddo: node = btor_exp_bv_uaddo (btor, e[0], e[1]); break;
+      case BTOR2_TAG_udiv: node = btor_exp_bv_udiv (btor, e[0], e[1]); break;
+      case BTOR2_TAG_uext:
+        node = btor_exp_bv_uext (btor, e[0], line->args[1]);
+        break;
+      case BTOR2_TAG_ugt: node = btor_exp_bv_ugt (btor, e[0], e[1]); break;
+      case BTOR2_TAG_ugte: node = btor_exp_bv_ugte (btor, e[0], e[1]); break;
+      case BTOR2_TAG_ult: node = btor_exp_bv_ult (btor, e[0], e[1]); break;
+      case BTOR2_TAG_ulte: node = btor_exp_bv_ulte (btor, e[0], e[1]); break;
+      case BTOR2_TAG_umulo: node = btor_exp_bv_umulo (btor, e[0], e[1]); break;
+      case BTOR2_TAG_urem: node = btor_exp_bv_urem (btor, e[0], e[1]); break;
+      case BTOR2_TAG_usubo: node = btor_exp_bv_usubo (btor, e[0], e[1]); break;
+      case BTOR2_TAG_write:
+        node = btor_exp_write (btor, e[0], e[1], e[2]);
+        break;
+      case BTOR2_TAG_xnor: node = btor_exp_bv_xnor (btor, e[0], e[1]); break;
+      case BTOR2_TAG_xor: node = btor_exp_bv_xor (btor, e[0], e[1]); break;
+
+      default:
+        assert (line->tag == BTOR2_TAG_bad
+             || line->tag == BTOR2_TAG_fair
+             || line->tag == BTOR2_TAG_init
+             || line->tag == BTOR2_TAG_justice
+             || line->tag == BTOR2_TAG_next
+             || line->tag == BTOR2_TAG_state);
+        perr_btor2 (parser,
+                    line->lineno,
+                    "model checking extensions not supported by boolector, try "
+                    "btormc instead");
+        goto DONE;
+    }
+    if (node)
+    {
+      assert (!nodes[line->id]);
+      nodes[line->id] = node;
+      if (sort && btor_node_get_sort_id (node) != sort)
+      {
+        perr_btor2 (parser,
+                    line->lineno,
+                    "sort of '%s' does not match its declared sort",
+                    line->name);
+        goto DONE;
+      }
     }
-    btor_hashint_map_delete (nodemap);
   }
-  if (sortmap)
+DONE:
+  for (j = 1; j <= max_id; j++)
   {
-    btor_iter_hashint_init (&it, sortmap);
-    while (btor_iter_hashint_has_next (&it))
-      boolector_release_sort (btor, btor_iter_hashint_next_data (&it)->as_ptr);
-    btor_hashint_map_delete (sortmap);
+    if (nodes[j]) btor_node_release (btor, nodes[j]);
+    if (sorts[j]) btor_sort_release (btor, sorts[j]);
   }
-  if (res)
+  BTOR_DELETEN (mm, nodes, size);
+  BTOR_DELETEN (mm, sorts, size);
+}
+
+/* The public API is required for tracing and shadow clones, and handles
+ * symbols and assertions within push/pop scopes.  Ids that are too large or
+ * too sparse are left to the hash table based construction. */
+static bool
+use_api_btor2 (Btor *btor, int64_t max_id, int64_t nlines)
+{
+#ifndef NDEBUG
+  if (btor->clone) return true;
+#endif
+  return btor->apitrace || btor->num_push_pop
+         || BTOR_COUNT_STACK (btor->assertions_trail) || max_id > INT32_MAX
+         || max_id > BTOR_BTOR2_MAX_ID_RATIO * nlines + 1024;
+}
+
+static const char *
+parse_btor2_parser (BtorBTOR2Parser *parser,
+                    BtorIntStack *prefix,
+                    FILE *infile,
+                    const char *infile_name,
+                    FILE *outfile,
+                    BtorParseResult *res)
+{
+  assert (parser);
+  assert (infile);
+  assert (infile_name);
+  (void) prefix;
+  (void) outfile;
+
+  int64_t max_id, nlines;
+  Btor2LineIterator lit;
+  Btor *btor;
+
+  btor = parser->btor;
+
+  BTOR_MSG (btor->msg, 1, "parsing %s", infile_name);
+
+  BTOR_CLR (res);
+
+  parser->infile_name = infile_name;
+
+  /* btor2parser doesn't allow to pass the prefix, we have to rewind to the
+   * beginning of the input file instead. */
+  if (fseek (infile, 0L, SEEK_SET))
+    perr_btor2 (parser, 0, "error when rewinding input file");
+  else if (!btor2parser_read_lines (parser->bfr, infile))
+  {
+    parser->error =
+        btor_mem_strdup (parser->mm, btor2parser_error (parser->bfr));
+    assert (parser->error);
+  }
+  else
   {
-    if (found_arrays || found_lambdas)
-      res->logic = BTOR_LOGIC_QF_AUFBV;
+    nlines = 0;
+    lit    = btor2parser_iter_init (parser->bfr);
+    while (btor2parser_iter_next (&lit)) nlines++;
+    max_id = btor2parser_max_id (parser->bfr);
+
+    if (use_api_btor2 (btor, max_id, nlines))
+    {
+      BTOR_MSG (
+          btor->msg, 1, "constructing %" PRId64 " lines via API", nlines);
+      parse_btor2_api (parser);
+    }
     else
-      res->logic = BTOR_LOGIC_QF_BV;
-    res->status = BOOLECTOR_UNKNOWN;
+    {
+      BTOR_MSG (btor->msg, 1, "constructing %" PRId64 " lines", nlines);
+      parse_btor2_direct (parser, max_id);
+    }
   }
-  if (parser->error) return parser->error;
-  return 0;
+
+  if (parser->found_arrays)
+    res->logic = BTOR_LOGIC_QF_AUFBV;
+  else
+    res->logic = BTOR_LOGIC_QF_BV;
+  res->status = BOOLECTOR_UNKNOWN;
+
+  return parser->error;
 }
 
 static BtorParserAPI parsebtor2_parser_api = {
@@ -12,6 +12,7 @@
 #include "btorcore.h"
 #include "btormsg.h"
 #include "btoropt.h"
+#include "utils/btorhashint.h"
 #include "utils/btormem.h"
 #include "utils/btorutil.h"
 
@@ -19,6 +20,12 @@
 #include <limits.h>
 #include <stdarg.h>
 #include <stdbool.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 /*------------------------------------------------------------------------*/
 
@@ -28,6 +35,7 @@ BTOR_DECLARE_STACK (BoolectorNodePtr, BoolectorNode *);
 
 void boolector_print_value_smt2 (Btor *, BoolectorNode *, char *, FILE *);
 void boolector_var_mark_bool (Btor *, BoolectorNode *);
+BoolectorNode *boolector_const_bv (Btor *, const BtorBitVector *);
 
 /*------------------------------------------------------------------------*/
 
@@ -337,8 +345,16 @@ typedef enum BtorSMT2CharClass
   BTOR_SYMBOL_CHAR_CLASS_SMT2            = (1 << 3),
   BTOR_QUOTED_SYMBOL_CHAR_CLASS_SMT2     = (1 << 4),
   BTOR_KEYWORD_CHAR_CLASS_SMT2           = (1 << 5),
+  BTOR_BINARY_DIGIT_CHAR_CLASS_SMT2      = (1 << 6),
 } BtorSMT2CharClass;
 
+/* Size of the input buffer if the input file can not be mapped. */
+#define BTOR_SMT2_BLOCK_SIZE (1 << 16)
+
+/* Work and token stacks larger than this (in elements) are released after
+ * the command that needed them, rather than kept at their peak size. */
+#define BTOR_SMT2_MAX_RETAINED_STACK (1 << 16)
+
 typedef struct BtorSMT2Parser
 {
   Btor *btor;
@@ -360,18 +376,31 @@ typedef struct BtorSMT2Parser
   unsigned char cc[256];
   FILE *infile;
   char *infile_name;
+  struct
+  {
+    unsigned char *start; /* mapped input file or input block */
+    unsigned char *pos;   /* next unread character */
+    unsigned char *end;   /* end of valid input in 'start' */
+    size_t size;          /* size of mapping or allocated block */
+    bool mapped;
+    bool drained; /* no input left in the buffer of 'infile' */
+  } buf;
   FILE *outfile;
   double parse_start;
   bool store_tokens; /* needed for parsing terms in get-value */
   BtorIntStack *prefix;
   BtorCharStack token, tokens;
+  BtorCharStack constant; /* digits of (_ bvN w) while reading w */
   BoolectorSortStack sorts;
+  BtorIntHashTable *sort_ids; /* sorts already held in 'sorts' */
   BtorSMT2ItemStack work;
   BtorSMT2Coo coo, lastcoo, nextcoo, perrcoo;
   BtorSMT2Node *last_node;
   BtorParseResult *res;
   BoolectorNodePtrStack sat_assuming_assumptions;
   uint32_t scope_level;
+  BtorSMT2NodePtrStack scoped; /* symbols inserted in open scopes */
+  BtorUIntStack scope_marks;   /* start of each open scope in 'scoped' */
   struct
   {
     uint32_t size, count;
@@ -520,6 +549,113 @@ hash_name_smt2 (BtorSMT2Parser *parser, const char *name)
   return res & (parser->symbol.size - 1);
 }
 
+/*------------------------------------------------------------------------*/
+
+/* Regular input files are mapped into memory, all other input (pipes,
+ * terminals) is read in blocks via read(2), which returns the input that is
+ * available without waiting for a full block.  This keeps interactive use
+ * responsive (e.g., 'check-sat' is answered before the next line is typed). */
+static void
+open_input_smt2 (BtorSMT2Parser *parser)
+{
+  struct stat st;
+  off_t offset;
+  void *start;
+
+  BTOR_CLR (&parser->buf);
+
+  if (!fstat (fileno (parser->infile), &st) && S_ISREG (st.st_mode)
+      && (offset = ftello (parser->infile)) >= 0 && st.st_size > offset)
+  {
+    start = mmap (0, st.st_size, PROT_READ, MAP_PRIVATE,
+                  fileno (parser->infile), 0);
+    if (start != MAP_FAILED)
+    {
+#ifdef MADV_SEQUENTIAL
+      (void) madvise (start, st.st_size, MADV_SEQUENTIAL);
+#endif
+      parser->buf.mapped = true;
+      parser->buf.size   = st.st_size;
+      parser->buf.start  = start;
+      parser->buf.pos    = parser->buf.start + offset;
+      parser->buf.end    = parser->buf.start + st.st_size;
+      return;
+    }
+  }
+
+  parser->buf.size = BTOR_SMT2_BLOCK_SIZE;
+  BTOR_NEWN (parser->mem, parser->buf.start, parser->buf.size);
+  parser->buf.pos = parser->buf.end = parser->buf.start;
+}
+
+static void
+close_input_smt2 (BtorSMT2Parser *parser)
+{
+  if (!parser->buf.start) return;
+  if (parser->buf.mapped)
+  {
+    /* leave the input file at the first unread character */
+    (void) fseeko (
+        parser->infile, parser->buf.pos - parser->buf.start, SEEK_SET);
+    (void) munmap (parser->buf.start, parser->buf.size);
+  }
+  else
+    BTOR_DELETEN (parser->mem, parser->buf.start, parser->buf.size);
+  BTOR_CLR (&parser->buf);
+}
+
+/* Read the next block of input.  Returns false on end-of-file. */
+static bool
+fill_input_smt2 (BtorSMT2Parser *parser)
+{
+  int32_t ch, fd, flags;
+  ssize_t n;
+  unsigned char *p, *end;
+
+  assert (parser->buf.pos == parser->buf.end);
+  if (parser->buf.mapped || !parser->buf.start) return false;
+
+  ch  = 0;
+  fd  = fileno (parser->infile);
+  p   = parser->buf.start;
+  end = p + parser->buf.size;
+
+  /* 'infile' may already have buffered input (e.g., read while detecting the
+   * input format), which is consumed without blocking first */
+  if (!parser->buf.drained)
+  {
+    flags = fcntl (fd, F_GETFL);
+    if (flags != -1) (void) fcntl (fd, F_SETFL, flags | O_NONBLOCK);
+    while (p < end && (ch = getc_unlocked (parser->infile)) != EOF) *p++ = ch;
+    if (flags != -1) (void) fcntl (fd, F_SETFL, flags);
+    parser->buf.drained = ch == EOF;
+    clearerr (parser->infile);
+  }
+
+  if (p == parser->buf.start)
+  {
+    do
+      n = read (fd, p, parser->buf.size);
+    while (n < 0 && errno == EINTR);
+    if (n > 0) p += n;
+  }
+
+  parser->buf.pos = parser->buf.start;
+  parser->buf.end = p;
+  return p > parser->buf.start;
+}
+
+/* True if the next characters can be taken directly from the input buffer,
+ * i.e., there is no saved character or prefix pending. */
+static bool
+buffered_input_smt2 (BtorSMT2Parser *parser)
+{
+  return !parser->saved
+         && (!parser->prefix
+             || parser->nprefix >= BTOR_COUNT_STACK (*parser->prefix))
+         && parser->buf.pos < parser->buf.end;
+}
+
 static int32_t
 nextch_smt2 (BtorSMT2Parser *parser)
 {
@@ -529,8 +665,10 @@ nextch_smt2 (BtorSMT2Parser *parser)
   else if (parser->prefix
            && parser->nprefix < BTOR_COUNT_STACK (*parser->prefix))
     res = parser->prefix->start[parser->nprefix++];
+  else if (parser->buf.pos < parser->buf.end || fill_input_smt2 (parser))
+    res = *parser->buf.pos++;
   else
-    res = getc (parser->infile);
+    res = EOF;
   if (res == '\n')
   {
     parser->nextcoo.x++;
@@ -544,10 +682,9 @@ nextch_smt2 (BtorSMT2Parser *parser)
 }
 
 static void
-enlarge_symbol_table_smt2 (BtorSMT2Parser *parser)
+resize_symbol_table_smt2 (BtorSMT2Parser *parser, uint32_t new_size)
 {
   uint32_t old_size        = parser->symbol.size;
-  uint32_t new_size        = old_size ? 2 * old_size : 1;
   BtorSMT2Node **old_table = parser->symbol.table, *p, **q;
   BtorSMT2NodePtrStack chain;
   uint32_t h, i;
@@ -630,7 +767,8 @@ insert_symbol_smt2 (BtorSMT2Parser *parser, BtorSMT2Node *symbol)
   BtorSMT2Node *p;
 
   if (parser->symbol.size <= parser->symbol.count)
-    enlarge_symbol_table_smt2 (parser);
+    resize_symbol_table_smt2 (
+        parser, parser->symbol.size ? 2 * parser->symbol.size : 1);
 
   /* always add new symbol as first element to collision chain (required for
    * scoping) */
@@ -641,6 +779,7 @@ insert_symbol_smt2 (BtorSMT2Parser *parser, BtorSMT2Node *symbol)
   symbol->next            = p;
   parser->symbol.count++;
   assert (parser->symbol.count > 0);
+  if (symbol->scope_level) BTOR_PUSH_STACK (parser->scoped, symbol);
   BTOR_MSG (parser->btor->msg,
             2,
             "insert symbol '%s' at scope level %u",
@@ -667,6 +806,30 @@ release_symbol_smt2 (BtorSMT2Parser *parser, BtorSMT2Node *symbol)
   BTOR_DELETE (parser->mem, symbol);
 }
 
+/* Symbols bound by let, quantifiers and function definitions are removed
+ * before their scope is closed.  They are usually the most recently inserted
+ * symbols, hence we search from the top of the current scope. */
+static void
+forget_scoped_symbol_smt2 (BtorSMT2Parser *parser, BtorSMT2Node *symbol)
+{
+  BtorSMT2Node **p, **mark;
+
+  mark = parser->scoped.start;
+  if (!BTOR_EMPTY_STACK (parser->scope_marks))
+    mark += BTOR_TOP_STACK (parser->scope_marks);
+
+  for (p = parser->scoped.top; p > mark;)
+  {
+    if (*--p == symbol)
+    {
+      *p = 0;
+      break;
+    }
+  }
+  while (parser->scoped.top > mark && !BTOR_TOP_STACK (parser->scoped))
+    (void) BTOR_POP_STACK (parser->scoped);
+}
+
 static void
 remove_symbol_smt2 (BtorSMT2Parser *parser, BtorSMT2Node *symbol)
 {
@@ -686,6 +849,7 @@ remove_symbol_smt2 (BtorSMT2Parser *parser, BtorSMT2Node *symbol)
     ;
   assert (*p == symbol);
   *p = symbol->next;
+  if (symbol->scope_level) forget_scoped_symbol_smt2 (parser, symbol);
   release_symbol_smt2 (parser, symbol);
   assert (parser->symbol.count > 0);
   parser->symbol.count--;
@@ -717,6 +881,7 @@ static void
 open_new_scope (BtorSMT2Parser *parser)
 {
   parser->scope_level++;
+  BTOR_PUSH_STACK (parser->scope_marks, BTOR_COUNT_STACK (parser->scoped));
 
   BTOR_MSG (parser->btor->msg,
             2,
@@ -728,26 +893,32 @@ static void
 close_current_scope (BtorSMT2Parser *parser)
 {
   double start;
-  uint32_t i;
-  BtorSMT2Node *node, *next;
+  uint32_t mark, size;
+  BtorSMT2Node *node;
 
   start = btor_util_time_stamp ();
 
+  assert (!BTOR_EMPTY_STACK (parser->scope_marks));
+  mark = BTOR_TOP_STACK (parser->scope_marks);
+
   if (!parser->global_declarations)
   {
-    /* delete symbols from current scope */
-    for (i = 0; i < parser->symbol.size; i++)
+    /* delete symbols from current scope, removing the top symbol also pops
+     * all symbols above the mark that were already removed */
+    while (BTOR_COUNT_STACK (parser->scoped) > mark)
     {
-      node = parser->symbol.table[i];
-      while (node)
-      {
-        next = node->next;
-        if (node->scope_level == parser->scope_level)
-          remove_symbol_smt2 (parser, node);
-        node = next;
-      }
+      node = BTOR_TOP_STACK (parser->scoped);
+      assert (node);
+      assert (node->scope_level == parser->scope_level);
+      remove_symbol_smt2 (parser, node);
     }
+    /* give memory of large closed scopes back */
+    for (size = parser->symbol.size; parser->symbol.count < size / 4;)
+      size /= 2;
+    if (size < parser->symbol.size) resize_symbol_table_smt2 (parser, size);
   }
+  parser->scoped.top = parser->scoped.start + mark;
+  (void) BTOR_POP_STACK (parser->scope_marks);
 
   BTOR_MSG (parser->btor->msg,
             2,
@@ -768,6 +939,9 @@ init_char_classes_smt2 (BtorSMT2Parser *parser)
   for (p = btor_decimal_digits_smt2; *p; p++)
     cc[(unsigned char) *p] |= BTOR_DECIMAL_DIGIT_CHAR_CLASS_SMT2;
 
+  cc['0'] |= BTOR_BINARY_DIGIT_CHAR_CLASS_SMT2;
+  cc['1'] |= BTOR_BINARY_DIGIT_CHAR_CLASS_SMT2;
+
   for (p = btor_hexadecimal_digits_smt2; *p; p++)
     cc[(unsigned char) *p] |= BTOR_HEXADECIMAL_DIGIT_CHAR_CLASS_SMT2;
 
@@ -1006,10 +1180,14 @@ new_smt2_parser (Btor *btor)
 
   BTOR_INIT_STACK (mem, res->work);
   BTOR_INIT_STACK (mem, res->sorts);
+  BTOR_INIT_STACK (mem, res->scoped);
+  BTOR_INIT_STACK (mem, res->scope_marks);
+  res->sort_ids = btor_hashint_table_new (mem);
 
   BTOR_INIT_STACK (mem, res->sat_assuming_assumptions);
   BTOR_INIT_STACK (mem, res->token);
   BTOR_INIT_STACK (mem, res->tokens);
+  BTOR_INIT_STACK (mem, res->constant);
 
   init_char_classes_smt2 (res);
 
@@ -1042,6 +1220,8 @@ delete_smt2_parser (BtorSMT2Parser *parser)
   BtorMemMgr *mem = parser->mem;
 
   while (parser->scope_level) close_current_scope (parser);
+  BTOR_RELEASE_STACK (parser->scoped);
+  BTOR_RELEASE_STACK (parser->scope_marks);
 
   release_symbols_smt2 (parser);
   release_work_smt2 (parser);
@@ -1052,6 +1232,7 @@ delete_smt2_parser (BtorSMT2Parser *parser)
   while (!BTOR_EMPTY_STACK (parser->sorts))
     boolector_release_sort (parser->btor, BTOR_POP_STACK (parser->sorts));
   BTOR_RELEASE_STACK (parser->sorts);
+  btor_hashint_table_delete (parser->sort_ids);
 
   while (!BTOR_EMPTY_STACK (parser->sat_assuming_assumptions))
   {
@@ -1061,6 +1242,7 @@ delete_smt2_parser (BtorSMT2Parser *parser)
   BTOR_RELEASE_STACK (parser->sat_assuming_assumptions);
   BTOR_RELEASE_STACK (parser->token);
   BTOR_RELEASE_STACK (parser->tokens);
+  BTOR_RELEASE_STACK (parser->constant);
 
   BTOR_DELETE (mem, parser);
   btor_mem_mgr_delete (mem);
@@ -1103,6 +1285,61 @@ pushch_smt2 (BtorSMT2Parser *parser, int32_t ch)
   storech_smt2 (parser, ch);
 }
 
+/* Append all following characters of class 'cc' to the current token.
+ * Returns the first character that is not of class 'cc' (which is consumed
+ * as with nextch_smt2).  Runs of characters are copied directly from the
+ * input buffer. */
+static int32_t
+scan_smt2 (BtorSMT2Parser *parser, uint32_t cc)
+{
+  int32_t ch;
+  size_t n;
+  unsigned char *p;
+
+  for (;;)
+  {
+    if (!parser->store_tokens && buffered_input_smt2 (parser))
+    {
+      for (p = parser->buf.pos; p < parser->buf.end && (parser->cc[*p] & cc);
+           p++)
+        ;
+      n = p - parser->buf.pos;
+      while (BTOR_SIZE_STACK (parser->token) - BTOR_COUNT_STACK (parser->token)
+             < n)
+        BTOR_ENLARGE_STACK (parser->token);
+      memcpy (parser->token.top, parser->buf.pos, n);
+      parser->token.top += n;
+      parser->buf.pos = p;
+      /* token characters never contain new lines */
+      parser->nextcoo.y += n;
+    }
+    ch = nextch_smt2 (parser);
+    if (!(cc_smt2 (parser, ch) & cc)) return ch;
+    pushch_smt2 (parser, ch);
+  }
+}
+
+/* Skip the rest of a comment.  Returns the terminating new line or EOF. */
+static int32_t
+skip_comment_smt2 (BtorSMT2Parser *parser)
+{
+  int32_t ch;
+  unsigned char *p;
+
+  for (;;)
+  {
+    if (buffered_input_smt2 (parser))
+    {
+      p = memchr (parser->buf.pos, '\n', parser->buf.end - parser->buf.pos);
+      if (!p) p = parser->buf.end;
+      parser->nextcoo.y += p - parser->buf.pos;
+      parser->buf.pos = p;
+    }
+    ch = nextch_smt2 (parser);
+    if (ch == '\n' || ch == EOF) return ch;
+  }
+}
+
 static int32_t
 read_token_aux_smt2 (BtorSMT2Parser *parser)
 {
@@ -1124,12 +1361,11 @@ RESTART:
   } while (isspace_smt2 (ch));
   if (ch == ';')
   {
-    while ((ch = nextch_smt2 (parser)) != '\n')
-      if (ch == EOF)
-      {
-        assert (!BTOR_INVALID_TAG_SMT2);
-        return !perr_smt2 (parser, "unexpected end-of-file in comment");
-      }
+    if (skip_comment_smt2 (parser) == EOF)
+    {
+      assert (!BTOR_INVALID_TAG_SMT2);
+      return !perr_smt2 (parser, "unexpected end-of-file in comment");
+    }
     goto RESTART;
   }
   cc = cc_smt2 (parser, ch);
@@ -1158,12 +1394,7 @@ RESTART:
       if (ch != '0' && ch != '1')
         return !perr_smt2 (parser, "expected '0' or '1' after '#b'");
       pushch_smt2 (parser, ch);
-      for (;;)
-      {
-        ch = nextch_smt2 (parser);
-        if (ch != '0' && ch != '1') break;
-        pushch_smt2 (parser, ch);
-      }
+      ch = scan_smt2 (parser, BTOR_BINARY_DIGIT_CHAR_CLASS_SMT2);
       savech_smt2 (parser, ch);
       pushch_smt2 (parser, 0);
       return BTOR_BINARY_CONSTANT_TAG_SMT2;
@@ -1176,13 +1407,7 @@ RESTART:
       if (!(cc_smt2 (parser, ch) & BTOR_HEXADECIMAL_DIGIT_CHAR_CLASS_SMT2))
         return !perr_smt2 (parser, "expected hexa-decimal digit after '#x'");
       pushch_smt2 (parser, ch);
-      for (;;)
-      {
-        ch = nextch_smt2 (parser);
-        if (!(cc_smt2 (parser, ch) & BTOR_HEXADECIMAL_DIGIT_CHAR_CLASS_SMT2))
-          break;
-        pushch_smt2 (parser, ch);
-      }
+      ch = scan_smt2 (parser, BTOR_HEXADECIMAL_DIGIT_CHAR_CLASS_SMT2);
       savech_smt2 (parser, ch);
       pushch_smt2 (parser, 0);
       return BTOR_HEXADECIMAL_CONSTANT_TAG_SMT2;
@@ -1249,12 +1474,7 @@ RESTART:
     if (!(cc_smt2 (parser, ch) & BTOR_KEYWORD_CHAR_CLASS_SMT2))
       return !cerr_smt2 (parser, "unexpected", ch, "after ':'");
     pushch_smt2 (parser, ch);
-    while ((cc_smt2 (parser, ch = nextch_smt2 (parser))
-            & BTOR_KEYWORD_CHAR_CLASS_SMT2))
-    {
-      assert (ch != EOF);
-      pushch_smt2 (parser, ch);
-    }
+    ch = scan_smt2 (parser, BTOR_KEYWORD_CHAR_CLASS_SMT2);
     savech_smt2 (parser, ch);
     pushch_smt2 (parser, 0);
     if (!(node = find_symbol_smt2 (parser, parser->token.start)))
@@ -1279,12 +1499,7 @@ RESTART:
       if (!(cc_smt2 (parser, ch) & BTOR_DECIMAL_DIGIT_CHAR_CLASS_SMT2))
         return !perr_smt2 (parser, "expected decimal digit after '0.'");
       pushch_smt2 (parser, ch);
-      for (;;)
-      {
-        ch = nextch_smt2 (parser);
-        if (!(cc_smt2 (parser, ch) & BTOR_DECIMAL_DIGIT_CHAR_CLASS_SMT2)) break;
-        pushch_smt2 (parser, ch);
-      }
+      ch = scan_smt2 (parser, BTOR_DECIMAL_DIGIT_CHAR_CLASS_SMT2);
     }
     savech_smt2 (parser, ch);
     pushch_smt2 (parser, 0);
@@ -1293,12 +1508,7 @@ RESTART:
   else if (cc & BTOR_DECIMAL_DIGIT_CHAR_CLASS_SMT2)
   {
     pushch_smt2 (parser, ch);
-    for (;;)
-    {
-      ch = nextch_smt2 (parser);
-      if (!(cc_smt2 (parser, ch) & BTOR_DECIMAL_DIGIT_CHAR_CLASS_SMT2)) break;
-      pushch_smt2 (parser, ch);
-    }
+    ch = scan_smt2 (parser, BTOR_DECIMAL_DIGIT_CHAR_CLASS_SMT2);
     if (ch == '.')
     {
       pushch_smt2 (parser, '.');
@@ -1315,12 +1525,7 @@ RESTART:
             parser, "expected decimal digit after '%s'", parser->token.start);
       }
       pushch_smt2 (parser, ch);
-      for (;;)
-      {
-        ch = nextch_smt2 (parser);
-        if (!(cc_smt2 (parser, ch) & BTOR_DECIMAL_DIGIT_CHAR_CLASS_SMT2)) break;
-        pushch_smt2 (parser, ch);
-      }
+      ch = scan_smt2 (parser, BTOR_DECIMAL_DIGIT_CHAR_CLASS_SMT2);
     }
     savech_smt2 (parser, ch);
     pushch_smt2 (parser, 0);
@@ -1329,12 +1534,7 @@ RESTART:
   else if (cc & BTOR_SYMBOL_CHAR_CLASS_SMT2)
   {
     pushch_smt2 (parser, ch);
-    for (;;)
-    {
-      ch = nextch_smt2 (parser);
-      if (!(cc_smt2 (parser, ch) & BTOR_SYMBOL_CHAR_CLASS_SMT2)) break;
-      pushch_smt2 (parser, ch);
-    }
+    ch = scan_smt2 (parser, BTOR_SYMBOL_CHAR_CLASS_SMT2);
     savech_smt2 (parser, ch);
     pushch_smt2 (parser, 0);
     if (!strcmp (parser->token.start, "_")) return BTOR_UNDERSCORE_TAG_SMT2;
@@ -3187,11 +3387,10 @@ parse_open_term_indexed (BtorSMT2Parser *parser, BtorSMT2Item *item_cur)
   assert (parser);
   assert (item_cur);
 
-  uint32_t width, width2;
+  uint32_t width;
   int32_t tag;
   BtorSMT2Node *node;
   BoolectorNode *exp;
-  BoolectorSort s;
   Btor *btor;
 
   btor = parser->btor;
@@ -3257,53 +3456,37 @@ parse_open_term_indexed (BtorSMT2Parser *parser, BtorSMT2Item *item_cur)
            && is_bvconst_str_smt2 (parser->token.start))
   {
     char *constr, *decstr;
+    BtorBitVector *bv;
     BtorSMT2Coo coo;
-    exp    = 0;
-    decstr = btor_mem_strdup (parser->mem, parser->token.start + 2);
-    constr = btor_util_dec_to_bin_str (parser->mem, parser->token.start + 2);
+    exp = 0;
+    /* keep the digits, the token is overwritten when reading the width */
+    BTOR_RESET_STACK (parser->constant);
+    for (decstr = parser->token.start + 2; *decstr; decstr++)
+      BTOR_PUSH_STACK (parser->constant, *decstr);
+    BTOR_PUSH_STACK (parser->constant, 0);
+    decstr = parser->constant.start;
     coo    = parser->coo;
     coo.y += 2;
     if (parse_uint32_smt2 (parser, false, &width))
     {
-      width2 = strlen (constr);
-      if (width2 > width)
+      if ((bv = btor_bv_dec_to_bv (parser->mem, decstr, width)))
       {
+        exp = boolector_const_bv (btor, bv);
+        btor_bv_free (parser->mem, bv);
+      }
+      else
+      {
+        constr          = btor_util_dec_to_bin_str (parser->mem, decstr);
         parser->perrcoo = coo;
         (void) perr_smt2 (parser,
                           "decimal constant '%s' needs %d bits which "
                           "exceeds bit-width '%d'",
                           decstr,
-                          width2,
+                          (uint32_t) strlen (constr),
                           width);
-      }
-      else if (width2 == width)
-        exp = boolector_const (btor, constr);
-      else if (!width2)
-      {
-        s   = boolector_bitvec_sort (btor, width);
-        exp = boolector_zero (btor, s);
-        boolector_release_sort (btor, s);
-      }
-      else
-      {
-        BtorBitVector *constrbv = 0, *uconstrbv;
-        char *uconstr;
-        if (!strcmp (constr, ""))
-          uconstrbv = btor_bv_new (parser->mem, width - width2);
-        else
-        {
-          constrbv  = btor_bv_char_to_bv (parser->mem, constr);
-          uconstrbv = btor_bv_uext (parser->mem, constrbv, width - width2);
-        }
-        uconstr = btor_bv_to_char (parser->mem, uconstrbv);
-        exp     = boolector_const (btor, uconstr);
-        btor_mem_freestr (parser->mem, uconstr);
-        btor_bv_free (parser->mem, uconstrbv);
-        if (constrbv) btor_bv_free (parser->mem, constrbv);
+        btor_mem_freestr (parser->mem, constr);
       }
     }
-    btor_mem_freestr (parser->mem, decstr);
-    btor_mem_freestr (parser->mem, constr);
     if (!exp) return 0;
     assert (boolector_get_width (btor, exp) == width);
     assert (item_cur > parser->work.start);
@@ -3496,9 +3679,10 @@ parse_open_term (BtorSMT2Parser *parser, int32_t tag)
 {
   assert (parser);
 
-  uint32_t width, width2;
+  uint32_t width;
   BtorSMT2Item *item_cur;
   BtorSMT2Node *sym, *new_sym;
+  BtorBitVector *bv;
   BoolectorSort s;
   Btor *btor;
 
@@ -3597,36 +3781,18 @@ parse_open_term (BtorSMT2Parser *parser, int32_t tag)
   }
   else if (tag == BTOR_BINARY_CONSTANT_TAG_SMT2)
   {
+    bv            = btor_bv_char_to_bv (parser->mem, parser->token.start + 2);
     item_cur->tag = BTOR_EXP_TAG_SMT2;
-    item_cur->exp = boolector_const (btor, parser->token.start + 2);
+    item_cur->exp = boolector_const_bv (btor, bv);
+    btor_bv_free (parser->mem, bv);
   }
   else if (tag == BTOR_HEXADECIMAL_CONSTANT_TAG_SMT2)
   {
-    char *constr, *uconstr;
-    BtorBitVector *constrbv = 0, *uconstrbv;
-    constr = btor_util_hex_to_bin_str (parser->mem, parser->token.start + 2);
-    width2 = strlen (constr);
-    width  = strlen (parser->token.start + 2) * 4;
-    assert (width2 <= width);
-    if (width2 == width)
-      uconstr = btor_mem_strdup (parser->mem, constr);
-    else
-    {
-      if (!strcmp (constr, ""))
-        uconstrbv = btor_bv_new (parser->mem, width - width2);
-      else
-      {
-        constrbv  = btor_bv_char_to_bv (parser->mem, constr);
-        uconstrbv = btor_bv_uext (parser->mem, constrbv, width - width2);
-      }
-      uconstr = btor_bv_to_char (parser->mem, uconstrbv);
-      btor_bv_free (parser->mem, uconstrbv);
-      if (constrbv) btor_bv_free (parser->mem, constrbv);
-    }
+    width         = strlen (parser->token.start + 2) * 4;
+    bv            = btor_bv_consth (parser->mem, parser->token.start + 2, width);
     item_cur->tag = BTOR_EXP_TAG_SMT2;
-    item_cur->exp = boolector_const (btor, uconstr);
-    btor_mem_freestr (parser->mem, uconstr);
-    btor_mem_freestr (parser->mem, constr);
+    item_cur->exp = boolector_const_bv (btor, bv);
+    btor_bv_free (parser->mem, bv);
   }
   else
   {
@@ -3772,6 +3938,22 @@ parse_bit_width_smt2 (BtorSMT2Parser *parser, uint32_t *width)
   return str2uint32_smt2 (parser, true, parser->token.start, width) ? 1 : 0;
 }
 
+/* Sorts are hash-consed, thus the parser only needs to keep one reference to
+ * each sort it created, no matter how often the sort occurs in the input. */
+static void
+hold_sort_smt2 (BtorSMT2Parser *parser, BoolectorSort sort)
+{
+  int32_t id = BTOR_IMPORT_BOOLECTOR_SORT (sort);
+
+  if (btor_hashint_table_contains (parser->sort_ids, id))
+  {
+    boolector_release_sort (parser->btor, sort);
+    return;
+  }
+  btor_hashint_table_add (parser->sort_ids, id);
+  BTOR_PUSH_STACK (parser->sorts, sort);
+}
+
 /*
  * skiptokens = 1 -> skip BTOR_LPAR_TAG_SMT2
  * skiptokens = 2 -> skip BTOR_UNDERSCORE_TAG_SMT2
@@ -3823,7 +4005,7 @@ parse_bitvec_sort (BtorSMT2Parser *parser,
             "parsed bit-vector sort of width %d",
             width);
   *resptr = boolector_bitvec_sort (parser->btor, width);
-  BTOR_PUSH_STACK (parser->sorts, *resptr);
+  hold_sort_smt2 (parser, *resptr);
 
   return read_rpar_smt2 (parser, " to close bit-vector sort");
 }
@@ -3843,7 +4025,7 @@ parse_array_sort (BtorSMT2Parser *parser, int32_t tag, BoolectorSort *sort)
     if (!parse_sort (parser, tag, false, &value)) return 0;
     if (!read_rpar_smt2 (parser, " after element sort of Array")) return 0;
     *sort = boolector_array_sort (parser->btor, index, value);
-    BTOR_PUSH_STACK (parser->sorts, *sort);
+    hold_sort_smt2 (parser, *sort);
     return 1;
   }
   else if (tag == EOF)
@@ -3862,7 +4044,7 @@ parse_sort (BtorSMT2Parser *parser,
   if (tag == BTOR_BOOL_TAG_SMT2)
   {
     *sort = boolector_bool_sort (parser->btor);
-    BTOR_PUSH_STACK (parser->sorts, *sort);
+    hold_sort_smt2 (parser, *sort);
     return 1;
   }
   else if (tag == BTOR_LPAR_TAG_SMT2)
@@ -4314,7 +4496,7 @@ declare_sort_smt2 (BtorSMT2Parser *parser)
   sort                   = boolector_bitvec_sort (parser->btor, opt_bit_width);
   sort_alias->sort       = 1;
   sort_alias->sort_alias = sort;
-  BTOR_PUSH_STACK (parser->sorts, sort);
+  hold_sort_smt2 (parser, sort);
   return read_rpar_smt2 (parser, " to close sort declaration");
 }
 
@@ -4580,6 +4762,21 @@ read_exp_list (BtorSMT2Parser *parser,
   return 1;
 }
 
+/* A single large command, e.g. 'define-fun' with a deeply nested body, must
+ * not keep the parser stacks at their peak size for the rest of the script. */
+static void
+shrink_stacks_smt2 (BtorSMT2Parser *parser)
+{
+  if (BTOR_EMPTY_STACK (parser->work)
+      && BTOR_SIZE_STACK (parser->work) > BTOR_SMT2_MAX_RETAINED_STACK)
+    BTOR_RELEASE_STACK (parser->work);
+  if (BTOR_SIZE_STACK (parser->token) > BTOR_SMT2_MAX_RETAINED_STACK)
+    BTOR_RELEASE_STACK (parser->token);
+  if (BTOR_EMPTY_STACK (parser->tokens)
+      && BTOR_SIZE_STACK (parser->tokens) > BTOR_SMT2_MAX_RETAINED_STACK)
+    BTOR_RELEASE_STACK (parser->tokens);
+}
+
 static int32_t
 read_command_smt2 (BtorSMT2Parser *parser)
 {
@@ -4917,6 +5114,7 @@ read_command_smt2 (BtorSMT2Parser *parser)
           parser, "unsupported command '%s'", parser->token.start);
       break;
   }
+  shrink_stacks_smt2 (parser);
   parser->commands.all++;
   return 1;
 }
@@ -4942,11 +5140,14 @@ parse_smt2_parser (BtorSMT2Parser *parser,
   parser->parse_start = start;
   BTOR_CLR (res);
   parser->res = res;
+  open_input_smt2 (parser);
 
   while (read_command_smt2 (parser) && !parser->done
          && !boolector_terminate (parser->btor))
     ;
 
+  close_input_smt2 (parser);
+
   if (parser->error) return parser->error;
 
   if (!boolector_terminate (parser->btor))
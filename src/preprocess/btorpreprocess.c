@@ -30,6 +30,32 @@
 #include "utils/btornodeiter.h"
 #include "utils/btorutil.h"
 
+/* Beta-reduce applies on lambdas and add ackermann constraints.  These
+ * consider all applies, not only those below constraints. */
+static void
+process_applies (Btor *btor)
+{
+  /* rewrite/beta-reduce applies on lambdas */
+  if (btor_opt_get (btor, BTOR_OPT_BETA_REDUCE))
+  {
+    /* If no UFs or function equalities are present, we eagerly eliminate all
+     * remaining lambdas. */
+    if (btor->ufs->count == 0 && btor->feqs->count == 0
+        && !btor_opt_get (btor, BTOR_OPT_INCREMENTAL))
+    {
+      BTOR_MSG (btor->msg,
+                1,
+                "no UFs or function equalities, enable beta-reduction=all");
+      btor_opt_set (btor, BTOR_OPT_BETA_REDUCE, BTOR_BETA_REDUCE_ALL);
+    }
+    btor_eliminate_applies (btor);
+  }
+
+  /* add ackermann constraints for all uninterpreted functions */
+  if (btor_opt_get (btor, BTOR_OPT_ACKERMANN))
+    btor_add_ackermann_constraints (btor);
+}
+
 int32_t
 btor_simplify (Btor *btor)
 {
@@ -49,6 +75,21 @@ btor_simplify (Btor *btor)
 
   if (btor->inconsistent) goto DONE;
 
+  /* The constraints did not change since they were simplified (or loaded in
+   * simplified form), only applies created since then are processed. */
+  if (btor->simplified)
+  {
+    process_applies (btor);
+    if (btor->inconsistent) goto DONE;
+    if (!btor->varsubst_constraints->count
+        && !btor->embedded_constraints->count)
+    {
+      btor->simplified = true;
+      btor->stats.simplifications_skipped++;
+      goto DONE;
+    }
+  }
+
   /* empty varsubst_constraints table if variable substitution was disabled
    * after adding variable substitution constraints (they are still in
    * unsynthesized_constraints).
@@ -169,25 +210,7 @@ btor_simplify (Btor *btor)
     if (btor->varsubst_constraints->count || btor->embedded_constraints->count)
       continue;
 
-    /* rewrite/beta-reduce applies on lambdas */
-    if (btor_opt_get (btor, BTOR_OPT_BETA_REDUCE))
-    {
-      /* If no UFs or function equalities are present, we eagerly eliminate all
-       * remaining lambdas. */
-      if (btor->ufs->count == 0 && btor->feqs->count == 0
-          && !btor_opt_get (btor, BTOR_OPT_INCREMENTAL))
-      {
-        BTOR_MSG (btor->msg,
-                  1,
-                  "no UFs or function equalities, enable beta-reduction=all");
-        btor_opt_set (btor, BTOR_OPT_BETA_REDUCE, BTOR_BETA_REDUCE_ALL);
-      }
-      btor_eliminate_applies (btor);
-    }
-
-    /* add ackermann constraints for all uninterpreted functions */
-    if (btor_opt_get (btor, BTOR_OPT_ACKERMANN))
-      btor_add_ackermann_constraints (btor);
+    process_applies (btor);
 
     if (btor_opt_get (btor, BTOR_OPT_REWRITE_LEVEL) > 2
         && btor_opt_get (btor, BTOR_OPT_SIMP_NORMAMLIZE_ADDERS))
@@ -196,6 +219,8 @@ btor_simplify (Btor *btor)
   } while (btor->varsubst_constraints->count
            || btor->embedded_constraints->count);
 
+  btor->simplified = !btor->inconsistent;
+
 DONE:
   delta = btor_util_time_stamp () - start;
   btor->time.simplify += delta;
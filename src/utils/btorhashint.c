@@ -9,73 +9,113 @@
 #include "utils/btorhashint.h"
 #include <assert.h>
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
 /*------------------------------------------------------------------------*/
 
-#define HOP_RANGE 32
-#define ADD_RANGE 8 * HOP_RANGE
+/* Slots are organized in groups of GROUP_SIZE slots, which are probed at
+ * once.  Every slot has a control byte, which is either EMPTY, DELETED or
+ * holds the 7 most significant bits of the hash of the key stored in that
+ * slot (cf. SwissTable). */
+#define GROUP_SIZE 16
+#define INIT_SIZE 32
+
+#define CTRL_EMPTY 0x80
+#define CTRL_DELETED 0xfe
 
 /*------------------------------------------------------------------------*/
 
 static inline uint32_t
 hash (uint32_t h)
 {
-  return h;
-  return h * 2654435761;
+  return h * 2654435761u;
 }
 
-static inline size_t
-pow2size (size_t size)
+static inline uint8_t
+hash2ctrl (uint32_t h)
 {
-  return size;  // - HOP_RANGE;
+  return h >> 25;
 }
 
+/* Maximum number of used (full or deleted) slots (load factor of 7/8). */
 static inline size_t
-initsize (size_t size)
+max_used (size_t size)
 {
-  return size;  // + HOP_RANGE;
+  return size - size / 8;
 }
 
-#if 0
-#ifndef NDEBUG
-#include <stdio.h>
-static void
-print_int_hash_table (BtorIntHashTable * t)
+/* Returns a bit mask of the slots in the group starting at 'ctrl' with
+ * control byte 'c'. */
+static inline uint32_t
+match_group (const uint8_t *ctrl, uint8_t c)
 {
-  size_t i;
-
-  printf ("keys: ");
-  for (i = 0; i < t->size; i++)
-    {
-      if (i % HOP_RANGE == 0)
-	printf ("|");
-      printf ("%d[%d]", t->keys[i], t->hop_info[i]);
-      if (i < t->size - 1)
-	printf (".");
-    }
-  printf ("|\n");
-}
+#if defined(__SSE2__)
+  __m128i group = _mm_loadu_si128 ((const __m128i *) ctrl);
+  return _mm_movemask_epi8 (_mm_cmpeq_epi8 (group, _mm_set1_epi8 ((char) c)));
+#else
+  uint32_t i, res = 0;
+  for (i = 0; i < GROUP_SIZE; i++)
+    if (ctrl[i] == c) res |= 1u << i;
+  return res;
 #endif
+}
+
+/* Returns a bit mask of the empty or deleted slots in the group starting at
+ * 'ctrl' (both have the most significant bit set). */
+static inline uint32_t
+match_group_free (const uint8_t *ctrl)
+{
+#if defined(__SSE2__)
+  return _mm_movemask_epi8 (_mm_loadu_si128 ((const __m128i *) ctrl));
+#else
+  uint32_t i, res = 0;
+  for (i = 0; i < GROUP_SIZE; i++)
+    if (ctrl[i] & 0x80) res |= 1u << i;
+  return res;
 #endif
+}
 
-#if 0
-static void
-print_density (BtorIntHashTable *t, int32_t key)
+static inline int
+first_match (uint32_t mask)
 {
-  size_t j, insert_pos = hash (key) & (pow2size (t->size) - 1);
-  for (j = 0; j < t->size; j++)
-    if (j % 20 == 0)
-      printf ("|");
-    else
-      printf (" ");
-  printf ("\n");
-  for (j = 0; j < t->size; j++)
-    if (j == insert_pos)
-      printf ("%c", t->keys[j] ? 'O' : 'F');
-    else
-      printf ("%c", t->keys[j] ? 'x' : '.'); 
-  printf ("\n");
+  assert (mask);
+  return __builtin_ctz (mask);
+}
+
+/*
+ * Find the position of 'key' in 't'.  Groups are probed quadratically
+ * (triangular numbers), which visits all groups since the number of groups is
+ * a power of two.  The probe sequence of a key stops at the first group with
+ * an empty slot.
+ * If 'key' is not in 't' the function returns 't->size' and stores the first
+ * empty or deleted slot of the probe sequence in 'free_pos' (if not 0).
+ */
+static inline size_t
+find (const BtorIntHashTable *t, int32_t key, size_t *free_pos)
+{
+  size_t g, step, mask;
+  uint32_t h, m;
+  uint8_t c;
+
+  h    = hash (key);
+  c    = hash2ctrl (h);
+  mask = t->size - 1;
+  g    = h & mask & ~((size_t) GROUP_SIZE - 1);
+
+  if (free_pos) *free_pos = t->size;
+  for (step = GROUP_SIZE;; g = (g + step) & mask, step += GROUP_SIZE)
+  {
+    for (m = match_group (t->ctrl + g, c); m; m &= m - 1)
+      if (t->keys[g + first_match (m)] == key) return g + first_match (m);
+    if (free_pos && *free_pos == t->size && (m = match_group_free (t->ctrl + g)))
+      *free_pos = g + first_match (m);
+    if (match_group (t->ctrl + g, CTRL_EMPTY)) break;
+    assert (step <= t->size);
+  }
+  return t->size;
 }
-#endif
 
 /*
  * try to add 'key' to 't'.
@@ -86,121 +126,61 @@ print_density (BtorIntHashTable *t, int32_t key)
 static size_t
 add (BtorIntHashTable *t, int32_t key)
 {
-  bool found, moved;
-  size_t i, j, size, pos, move_pos, rem_move_dist;
-  uint32_t h;
-  uint8_t move_hop_info, *hop_info;
-  int32_t *keys;
-  BtorHashTableData *data;
-
-  keys     = t->keys;
-  hop_info = t->hop_info;
-  size     = t->size;
-  data     = t->data;
-  h        = hash (key);
-  i        = h & (pow2size (size) - 1);
-
-  /* search a free position within the ADD_RANGE window */
-  found = false;
-  for (j = 0, pos = i + j; j < ADD_RANGE && pos < size; j++, pos = i + j)
-  {
-    if (!keys[pos])
-    {
-      found = true;
-      break;
-    }
-    /* already in hash table */
-    else if (keys[pos] == key)
-    {
-      assert (pos < i + HOP_RANGE);
-      return pos;
-    }
-  }
-
-  /* no suitable index found for moving key, needs resizing */
-  if (!found) return size;
+  size_t pos, free_pos;
 
-  found = false;
-  moved = true;
-  do
-  {
-    assert (!keys[pos]);
-    if (pos - i < HOP_RANGE)
-    {
-      found = true;
-      break;
-    }
+  pos = find (t, key, &free_pos);
+  if (pos < t->size) return pos; /* already in hash table */
 
-    /* needs resizing */
-    if (!moved) return size;
+  /* first empty or deleted slot in the probe sequence of 'key' */
+  pos = free_pos;
+  assert (pos < t->size);
 
-    /* 'pos' contains a free index */
-    move_pos = pos - (HOP_RANGE - 1);
-    moved    = false;
-    for (j = HOP_RANGE - 1; j > 0; j--)
-    {
-      move_hop_info = hop_info[move_pos];
-      rem_move_dist = HOP_RANGE - 1 - move_hop_info;
-
-      /* not suitable for moving as remaining move distance 'rem_move_dist'
-       * is smaller than the required move distance 'j' */
-      if (rem_move_dist < j)
-      {
-        move_pos++;
-        continue;
-      }
-
-      /* move key to free position 'pos' */
-      keys[pos]     = keys[move_pos];
-      hop_info[pos] = move_hop_info + j; /* update hop info */
-      assert (hop_info[pos] < HOP_RANGE);
-      keys[move_pos]     = 0;
-      hop_info[move_pos] = 0;
-      if (data)
-      {
-        data[pos] = data[move_pos];
-        memset (&data[move_pos], 0, sizeof (*data));
-        data[move_pos].as_ptr = 0;
-      }
-      pos   = move_pos;
-      moved = true;
-      break;
-    }
-  } while (true);
+  if (t->ctrl[pos] == CTRL_DELETED)
+  {
+    assert (t->deleted > 0);
+    t->deleted -= 1;
+  }
+  /* needs resizing */
+  else if (t->count + t->deleted + 1 > max_used (t->size))
+    return t->size;
 
-  assert (found);
-  keys[pos]     = key;
-  hop_info[pos] = pos - i; /* store number of hops */
-  assert (hop_info[pos] < HOP_RANGE);
+  assert (!t->keys[pos]);
+  t->keys[pos] = key;
+  t->ctrl[pos] = hash2ctrl (hash (key));
   t->count += 1;
   return pos;
 }
 
+/* Rehash 't' into a table of size 'new_size', which also removes all
+ * deleted slots. */
 static void
-resize (BtorIntHashTable *t)
+resize (BtorIntHashTable *t, size_t new_size)
 {
 #ifndef NDEBUG
   size_t old_count;
 #endif
-  size_t i, new_pos, old_size, new_size;
+  size_t i, new_pos, old_size;
   int32_t key, *old_keys;
-  uint8_t *old_hop_info;
+  uint8_t *old_ctrl;
   BtorHashTableData *old_data;
 
-  old_size     = t->size;
-  old_keys     = t->keys;
-  old_hop_info = t->hop_info;
-  old_data     = t->data;
+  old_size = t->size;
+  old_keys = t->keys;
+  old_ctrl = t->ctrl;
+  old_data = t->data;
 #ifndef NDEBUG
   old_count = t->count;
 #endif
   assert (old_size > 0);
-  new_size = initsize ((pow2size (old_size)) * 2);
+  assert (new_size >= old_size);
+  assert (!(new_size & (new_size - 1)));
   BTOR_CNEWN (t->mm, t->keys, new_size);
-  BTOR_CNEWN (t->mm, t->hop_info, new_size);
+  BTOR_NEWN (t->mm, t->ctrl, new_size);
+  memset (t->ctrl, CTRL_EMPTY, new_size);
   if (old_data) BTOR_CNEWN (t->mm, t->data, new_size);
-  t->count = 0;
-  t->size  = new_size;
+  t->count   = 0;
+  t->deleted = 0;
+  t->size    = new_size;
 
   for (i = 0; i < old_size; i++)
   {
@@ -213,11 +193,22 @@ resize (BtorIntHashTable *t)
   }
 
   BTOR_DELETEN (t->mm, old_keys, old_size);
-  BTOR_DELETEN (t->mm, old_hop_info, old_size);
+  BTOR_DELETEN (t->mm, old_ctrl, old_size);
   if (old_data) BTOR_DELETEN (t->mm, old_data, old_size);
   assert (old_count == t->count);
 }
 
+/* Make room for at least one more key.  If the table is mostly filled with
+ * deleted slots, it is rehashed without growing. */
+static void
+grow (BtorIntHashTable *t)
+{
+  if (t->count + 1 > max_used (t->size) / 2)
+    resize (t, t->size * 2);
+  else
+    resize (t, t->size);
+}
+
 /*------------------------------------------------------------------------*/
 
 BtorIntHashTable *
@@ -227,9 +218,10 @@ btor_hashint_table_new (BtorMemMgr *mm)
 
   BTOR_CNEW (mm, res);
   res->mm   = mm;
-  res->size = initsize (HOP_RANGE);
+  res->size = INIT_SIZE;
   BTOR_CNEWN (mm, res->keys, res->size);
-  BTOR_CNEWN (mm, res->hop_info, res->size);
+  BTOR_NEWN (mm, res->ctrl, res->size);
+  memset (res->ctrl, CTRL_EMPTY, res->size);
   return res;
 }
 
@@ -238,7 +230,7 @@ btor_hashint_table_delete (BtorIntHashTable *t)
 {
   assert (!t->data);
   BTOR_DELETEN (t->mm, t->keys, t->size);
-  BTOR_DELETEN (t->mm, t->hop_info, t->size);
+  BTOR_DELETEN (t->mm, t->ctrl, t->size);
   BTOR_DELETE (t->mm, t);
 }
 
@@ -246,7 +238,7 @@ size_t
 btor_hashint_table_size (BtorIntHashTable *t)
 {
   return sizeof (BtorIntHashTable)
-         + t->size * (sizeof (*t->keys) + sizeof (*t->hop_info));
+         + t->size * (sizeof (*t->keys) + sizeof (*t->ctrl));
 }
 
 size_t
@@ -256,18 +248,32 @@ btor_hashint_table_add (BtorIntHashTable *t, int32_t key)
 
   size_t pos;
 
-  //  print_density (t, key);
   pos = add (t, key);
   /* 'add(...)' returns 't->size' if 'key' could not be added to 't'. hence,
    * we need to resize 't'. */
-  while (pos == t->size)  // TODO: loop may be obsolete
+  if (pos == t->size)
   {
-    resize (t);
+    grow (t);
     pos = add (t, key);
   }
+  assert (pos < t->size);
   return pos;
 }
 
+void
+btor_hashint_table_add_many (BtorIntHashTable *t,
+                             const int32_t *keys,
+                             size_t nkeys)
+{
+  size_t i, size;
+
+  size = t->size;
+  while (max_used (size) < t->count + t->deleted + nkeys) size *= 2;
+  if (size > t->size) resize (t, size);
+
+  for (i = 0; i < nkeys; i++) btor_hashint_table_add (t, keys[i]);
+}
+
 bool
 btor_hashint_table_contains (BtorIntHashTable *t, int32_t key)
 {
@@ -284,8 +290,16 @@ btor_hashint_table_remove (BtorIntHashTable *t, int32_t key)
   if (pos == t->size) return pos;
 
   assert (t->keys[pos] == key);
-  t->keys[pos]     = 0;
-  t->hop_info[pos] = 0;
+  t->keys[pos] = 0;
+  /* A group with an empty slot was never full, hence no probe sequence
+   * passed through it and the slot can be marked as empty again. */
+  if (match_group (t->ctrl + (pos & ~((size_t) GROUP_SIZE - 1)), CTRL_EMPTY))
+    t->ctrl[pos] = CTRL_EMPTY;
+  else
+  {
+    t->ctrl[pos] = CTRL_DELETED;
+    t->deleted += 1;
+  }
   t->count -= 1;
   return pos;
 }
@@ -293,23 +307,7 @@ btor_hashint_table_remove (BtorIntHashTable *t, int32_t key)
 size_t
 btor_hashint_table_get_pos (BtorIntHashTable *t, int32_t key)
 {
-  size_t i, size, end;
-  uint32_t h;
-  int32_t *keys;
-
-  keys = t->keys;
-  size = t->size;
-  h    = hash (key);
-  i    = h & (pow2size (size) - 1);
-  end  = i + HOP_RANGE;
-  //  assert (end < size);
-  if (end > size) end = size;
-
-  for (; i < end; i++)
-  {
-    if (keys[i] == key) return i;
-  }
-  return size;
+  return find (t, key, 0);
 }
 
 BtorIntHashTable *
@@ -322,12 +320,12 @@ btor_hashint_table_clone (BtorMemMgr *mm, BtorIntHashTable *table)
   if (!table) return NULL;
 
   res = btor_hashint_table_new (mm);
-  while (res->size < table->size) resize (res);
+  if (res->size < table->size) resize (res, table->size);
   assert (res->size == table->size);
   memcpy (res->keys, table->keys, table->size * sizeof (*table->keys));
-  memcpy (
-      res->hop_info, table->hop_info, table->size * sizeof (*table->hop_info));
-  res->count = table->count;
+  memcpy (res->ctrl, table->ctrl, table->size * sizeof (*table->ctrl));
+  res->count   = table->count;
+  res->deleted = table->deleted;
   return res;
 }
 
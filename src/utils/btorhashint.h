@@ -20,9 +20,10 @@ struct BtorIntHashTable
 {
   BtorMemMgr *mm;
   size_t count;
+  size_t deleted; /* number of deleted slots */
   size_t size;
-  int32_t *keys;
-  uint8_t *hop_info; /* displacement information */
+  int32_t *keys;  /* 0 if slot is empty or deleted */
+  uint8_t *ctrl;  /* control bytes (empty, deleted or hash bits) */
   BtorHashTableData *data;
 };
 
@@ -45,6 +46,12 @@ size_t btor_hashint_table_size (BtorIntHashTable *);
  * stored in the keys array. */
 size_t btor_hashint_table_add (BtorIntHashTable *, int32_t key);
 
+/* Add all keys in 'keys' to the hash table.  The table is resized at most
+ * once before adding the keys. */
+void btor_hashint_table_add_many (BtorIntHashTable *,
+                                  const int32_t *keys,
+                                  size_t nkeys);
+
 /* Check whether 'key' is in the hash table. */
 bool btor_hashint_table_contains (BtorIntHashTable *, int32_t key);
 
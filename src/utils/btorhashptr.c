@@ -20,35 +20,83 @@ btor_compare_ptr (const void *p, const void *q)
   return ((uintptr_t) p) != ((uintptr_t) q);
 }
 
+struct BtorPtrHashChunk
+{
+  BtorPtrHashChunk *next;
+  uint32_t size;
+  BtorPtrHashBucket buckets[];
+};
+
+/* Maximum number of elements for a table with 'size' slots (load factor of
+ * 3/4). Note that this ensures that there is always at least one empty slot,
+ * which terminates every probe sequence. */
+#define BTOR_PTR_HASH_TABLE_CAPACITY(size) ((size) / 2 + (size) / 4)
+
+static size_t
+btor_chunk_bytes_ptr_hash_table (uint32_t size)
+{
+  return sizeof (BtorPtrHashChunk) + size * sizeof (BtorPtrHashBucket);
+}
+
+static void
+btor_add_chunk_ptr_hash_table (BtorPtrHashTable *p2iht, uint32_t size)
+{
+  BtorPtrHashChunk *chunk;
+  BtorPtrHashBucket *b;
+  uint32_t i;
+
+  chunk = btor_mem_malloc (p2iht->mm, btor_chunk_bytes_ptr_hash_table (size));
+  chunk->next   = p2iht->chunks;
+  chunk->size   = size;
+  p2iht->chunks = chunk;
+
+  /* push in reverse order such that buckets are used in ascending order */
+  for (i = size; i > 0; i--)
+  {
+    b             = chunk->buckets + i - 1;
+    b->next       = p2iht->unused;
+    p2iht->unused = b;
+  }
+  p2iht->capacity += size;
+}
+
+/* Resize table to 'new_size' slots.  For every doubling of the size a chunk
+ * of buckets is added, hence the chunks of a table only depend on its size
+ * (which is required for cloning). */
 static void
-btor_enlarge_ptr_hash_table (BtorPtrHashTable *p2iht)
+btor_enlarge_ptr_hash_table (BtorPtrHashTable *p2iht, uint32_t new_size)
 {
-  BtorPtrHashBucket *p, *chain, **old_table, **new_table;
-  uint32_t old_size, new_size, i, h;
-  BtorHashPtr hash;
+  BtorPtrHashSlot *old_table, *new_table;
+  uint32_t old_size, i, h, mask, s;
 
   old_size  = p2iht->size;
   old_table = p2iht->table;
 
-  new_size = old_size ? 2 * old_size : 1;
-  BTOR_CNEWN (p2iht->mm, new_table, new_size);
+  assert (new_size > old_size);
+  assert (!(new_size & (new_size - 1)));
 
-  hash = p2iht->hash;
+  BTOR_CNEWN (p2iht->mm, new_table, new_size);
 
+  mask = new_size - 1;
   for (i = 0; i < old_size; i++)
-    for (p = old_table[i]; p; p = chain)
-    {
-      chain = p->chain;
-      h     = hash (p->key);
-      h &= new_size - 1;
-      p->chain     = new_table[h];
-      new_table[h] = p;
-    }
+  {
+    if (!old_table[i].bucket) continue;
+    for (h = old_table[i].hash & mask; new_table[h].bucket; h = (h + 1) & mask)
+      ;
+    new_table[h] = old_table[i];
+  }
 
   BTOR_DELETEN (p2iht->mm, old_table, old_size);
 
   p2iht->size  = new_size;
   p2iht->table = new_table;
+
+  for (s = old_size ? 2 * old_size : 1; s <= new_size; s *= 2)
+  {
+    i = BTOR_PTR_HASH_TABLE_CAPACITY (s) - BTOR_PTR_HASH_TABLE_CAPACITY (s / 2);
+    if (i) btor_add_chunk_ptr_hash_table (p2iht, i);
+  }
+  assert (p2iht->capacity == BTOR_PTR_HASH_TABLE_CAPACITY (new_size));
 }
 
 BtorPtrHashTable *
@@ -63,7 +111,7 @@ btor_hashptr_table_new (BtorMemMgr *mm, BtorHashPtr hash, BtorCmpPtr cmp)
   res->hash = hash ? hash : btor_hash_ptr;
   res->cmp  = cmp ? cmp : btor_compare_ptr;
 
-  btor_enlarge_ptr_hash_table (res);
+  btor_enlarge_ptr_hash_table (res, 1);
 
   return res;
 }
@@ -87,7 +135,7 @@ btor_hashptr_table_clone (BtorMemMgr *mm,
   if (!table) return NULL;
 
   res = btor_hashptr_table_new (mm, table->hash, table->cmp);
-  while (res->size < table->size) btor_enlarge_ptr_hash_table (res);
+  if (res->size < table->size) btor_enlarge_ptr_hash_table (res, table->size);
   assert (res->size == table->size);
 
   btor_iter_hashptr_init (&it, table);
@@ -113,72 +161,61 @@ btor_hashptr_table_clone (BtorMemMgr *mm,
 void
 btor_hashptr_table_delete (BtorPtrHashTable *p2iht)
 {
-  BtorPtrHashBucket *p, *next;
+  BtorPtrHashChunk *c, *next;
 
-  for (p = p2iht->first; p; p = next)
+  for (c = p2iht->chunks; c; c = next)
   {
-    next = p->next;
-    BTOR_DELETE (p2iht->mm, p);
+    next = c->next;
+    btor_mem_free (p2iht->mm, c, btor_chunk_bytes_ptr_hash_table (c->size));
   }
 
   BTOR_DELETEN (p2iht->mm, p2iht->table, p2iht->size);
   BTOR_DELETE (p2iht->mm, p2iht);
 }
 
-BtorPtrHashBucket *
-btor_hashptr_table_get (BtorPtrHashTable *p2iht, const void *key)
+/* Returns the slot of 'key' or the empty slot at which 'key' is inserted. */
+static BtorPtrHashSlot *
+btor_findpos_in_ptr_hash_table_pos (BtorPtrHashTable *p2iht,
+                                    const void *key,
+                                    uint32_t h)
 {
-  BtorPtrHashBucket *res, **p, *b;
-  uint32_t i, h;
+  BtorPtrHashSlot *s;
+  uint32_t i, mask;
 
   assert (p2iht->size > 0);
 
-  res = 0;
-  h   = p2iht->hash (key);
-  h &= p2iht->size - 1;
+  mask = p2iht->size - 1;
+  for (i = h & mask; (s = p2iht->table + i)->bucket; i = (i + 1) & mask)
+    if (s->hash == h && !p2iht->cmp (s->bucket->key, key)) break;
 
-  for (i = 0, p = p2iht->table + h; i < p2iht->count; i++, p = &b->chain)
-  {
-    if (!(b = *p)) break;
-    if (!p2iht->cmp (b->key, key))
-    {
-      res = b;
-      break;
-    }
-  }
-
-  return res;
+  return s;
 }
 
-static BtorPtrHashBucket **
-btor_findpos_in_ptr_hash_table_pos (BtorPtrHashTable *p2iht, void *key)
+BtorPtrHashBucket *
+btor_hashptr_table_get (BtorPtrHashTable *p2iht, const void *key)
 {
-  BtorPtrHashBucket **p, *b;
-  uint32_t h;
-
-  if (p2iht->count == p2iht->size) btor_enlarge_ptr_hash_table (p2iht);
-
-  assert (p2iht->size > 0);
-
-  h = p2iht->hash (key);
-  h &= p2iht->size - 1;
-
-  for (p = p2iht->table + h; (b = *p) && p2iht->cmp (b->key, key);
-       p = &b->chain)
-    ;
-
-  return p;
+  return btor_findpos_in_ptr_hash_table_pos (p2iht, key, p2iht->hash (key))
+      ->bucket;
 }
 
-BtorPtrHashBucket *
-btor_hashptr_table_add (BtorPtrHashTable *p2iht, void *key)
+static BtorPtrHashBucket *
+btor_insert_ptr_hash_table (BtorPtrHashTable *p2iht,
+                            BtorPtrHashSlot *s,
+                            uint32_t h,
+                            void *key)
 {
-  BtorPtrHashBucket **p, *res;
-  p = btor_findpos_in_ptr_hash_table_pos (p2iht, key);
-  assert (!*p);
-  BTOR_CNEW (p2iht->mm, res);
-  res->key = key;
-  *p       = res;
+  BtorPtrHashBucket *res;
+
+  assert (!s->bucket);
+  assert (p2iht->count < p2iht->capacity);
+  assert (p2iht->unused);
+
+  res           = p2iht->unused;
+  p2iht->unused = res->next;
+  BTOR_CLR (res);
+  res->key  = key;
+  s->hash   = h;
+  s->bucket = res;
   p2iht->count++;
 
   res->prev = p2iht->last;
@@ -193,6 +230,42 @@ btor_hashptr_table_add (BtorPtrHashTable *p2iht, void *key)
   return res;
 }
 
+BtorPtrHashBucket *
+btor_hashptr_table_add (BtorPtrHashTable *p2iht, void *key)
+{
+  uint32_t h;
+
+  if (p2iht->count == p2iht->capacity)
+    btor_enlarge_ptr_hash_table (p2iht, 2 * p2iht->size);
+
+  h = p2iht->hash (key);
+  return btor_insert_ptr_hash_table (
+      p2iht, btor_findpos_in_ptr_hash_table_pos (p2iht, key, h), h, key);
+}
+
+void
+btor_hashptr_table_add_many (BtorPtrHashTable *table,
+                             void **keys,
+                             uint32_t nkeys)
+{
+  BtorPtrHashSlot *s;
+  uint32_t i, h, size;
+
+  size = table->size;
+  while (BTOR_PTR_HASH_TABLE_CAPACITY ((uint64_t) size)
+         < (uint64_t) table->count + nkeys)
+    size *= 2;
+  if (size > table->size) btor_enlarge_ptr_hash_table (table, size);
+
+  for (i = 0; i < nkeys; i++)
+  {
+    h = table->hash (keys[i]);
+    s = btor_findpos_in_ptr_hash_table_pos (table, keys[i], h);
+    if (s->bucket) continue;
+    btor_insert_ptr_hash_table (table, s, h, keys[i]);
+  }
+}
+
 /*
  * Uses djb2 string hash function from [1].
  *
@@ -218,13 +291,27 @@ btor_hashptr_table_remove (BtorPtrHashTable *table,
                            void **stored_key_ptr,
                            BtorHashTableData *stored_data_ptr)
 {
-  BtorPtrHashBucket **p, *bucket;
+  BtorPtrHashSlot *s;
+  BtorPtrHashBucket *bucket;
+  uint32_t i, j, k, mask;
 
-  p      = btor_findpos_in_ptr_hash_table_pos (table, key);
-  bucket = *p;
+  s      = btor_findpos_in_ptr_hash_table_pos (table, key, table->hash (key));
+  bucket = s->bucket;
 
   assert (bucket);
-  *p = bucket->chain;
+
+  /* Fill the gap with subsequent slots of the same cluster that would not be
+   * reachable otherwise (backward shift deletion, no tombstones). */
+  mask = table->size - 1;
+  i    = s - table->table;
+  for (j = (i + 1) & mask; table->table[j].bucket; j = (j + 1) & mask)
+  {
+    k = table->table[j].hash & mask;
+    if (((j - k) & mask) < ((j - i) & mask)) continue;
+    table->table[i] = table->table[j];
+    i               = j;
+  }
+  table->table[i].bucket = 0;
 
   if (bucket->prev)
     bucket->prev->next = bucket->next;
@@ -243,7 +330,31 @@ btor_hashptr_table_remove (BtorPtrHashTable *table,
 
   if (stored_data_ptr) *stored_data_ptr = bucket->data;
 
-  BTOR_DELETE (table->mm, bucket);
+  bucket->next  = table->unused;
+  table->unused = bucket;
+}
+
+void
+btor_hashptr_table_remove_many (BtorPtrHashTable *table,
+                                void **keys,
+                                uint32_t nkeys)
+{
+  uint32_t i;
+
+  for (i = 0; i < nkeys; i++)
+    btor_hashptr_table_remove (table, keys[i], 0, 0);
+}
+
+size_t
+btor_hashptr_table_size (const BtorPtrHashTable *table)
+{
+  BtorPtrHashChunk *c;
+  size_t res;
+
+  res = sizeof (BtorPtrHashTable) + table->size * sizeof (BtorPtrHashSlot);
+  for (c = table->chunks; c; c = c->next)
+    res += btor_chunk_bytes_ptr_hash_table (c->size);
+  return res;
 }
 
 /*------------------------------------------------------------------------*/
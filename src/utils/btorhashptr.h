@@ -20,6 +20,8 @@
 
 typedef struct BtorPtrHashTable BtorPtrHashTable;
 typedef struct BtorPtrHashBucket BtorPtrHashBucket;
+typedef struct BtorPtrHashSlot BtorPtrHashSlot;
+typedef struct BtorPtrHashChunk BtorPtrHashChunk;
 
 typedef void *(*BtorCloneKeyPtr) (BtorMemMgr *mm,
                                   const void *map,
@@ -39,25 +41,39 @@ struct BtorPtrHashBucket
 
   BtorPtrHashBucket *next; /* chronologically */
   BtorPtrHashBucket *prev; /* chronologically */
+};
 
-  /* private:
-   */
-  BtorPtrHashBucket *chain; /* collision chain */
+/* Open addressing (linear probing) slot.  The hash of the key is stored
+ * inline, such that probing only has to access the bucket on a hash match. */
+struct BtorPtrHashSlot
+{
+  uint32_t hash;
+  BtorPtrHashBucket *bucket; /* 0 if slot is empty */
 };
 
+/* Buckets are not allocated individually but taken from chunks that are
+ * allocated whenever the table is enlarged.  Buckets of subsequently added
+ * keys are thus stored densely in insertion order.  Bucket addresses are
+ * stable until the bucket is removed. */
 struct BtorPtrHashTable
 {
   BtorMemMgr *mm;
 
-  uint32_t size;
-  uint32_t count;
-  BtorPtrHashBucket **table;
+  uint32_t size;  /* number of slots (power of two) */
+  uint32_t count; /* number of elements */
+  BtorPtrHashSlot *table;
 
   BtorHashPtr hash;
   BtorCmpPtr cmp;
 
   BtorPtrHashBucket *first; /* chronologically */
   BtorPtrHashBucket *last;  /* chronologically */
+
+  /* private:
+   */
+  uint32_t capacity;         /* number of buckets in all chunks */
+  BtorPtrHashBucket *unused; /* unused buckets, linked via 'next' */
+  BtorPtrHashChunk *chunks;  /* bucket storage */
 };
 
 /*------------------------------------------------------------------------*/
@@ -96,6 +112,22 @@ void btor_hashptr_table_remove (BtorPtrHashTable *,
                                 void **stored_key_ptr,
                                 BtorHashTableData *stored_data_ptr);
 
+/* Add all keys in 'keys' that are not yet contained in the hash table.  The
+ * table is enlarged at most once, hence this is preferable over adding a
+ * large number of keys one by one. */
+void btor_hashptr_table_add_many (BtorPtrHashTable *table,
+                                  void **keys,
+                                  uint32_t nkeys);
+
+/* Remove all keys in 'keys' from the hash table.  All keys have to be
+ * elements of the hash table. */
+void btor_hashptr_table_remove_many (BtorPtrHashTable *table,
+                                     void **keys,
+                                     uint32_t nkeys);
+
+/* Returns the size of the BtorPtrHashTable in Byte. */
+size_t btor_hashptr_table_size (const BtorPtrHashTable *table);
+
 uint32_t btor_hash_str (const void *str);
 
 #define btor_compare_str ((BtorCmpPtr) strcmp)
@@ -207,41 +207,48 @@ btor_has_next_param_iterator (BtorNodeIterator * it)
 
 /*------------------------------------------------------------------------*/
 
-#if 0
+/* Iterates over the slots of the unique table first, then over the old slots
+ * if the table is currently resized. */
 static void
-find_next_unique_node (BtorNodeIterator * it)
+find_next_unique_node (BtorNodeIterator *it)
 {
-  while (!it->cur && it->pos < it->btor->nodes_unique_table.size)
-    it->cur = it->btor->nodes_unique_table.chains[it->pos++];
-  assert (it->cur
-	  || it->num_elements == it->btor->nodes_unique_table.num_elements);
+  const BtorNodeUniqueTable *table = &it->btor->nodes_unique_table;
+
+  it->cur = 0;
+  while (!it->cur && it->pos < table->size + table->old_size)
+  {
+    if (it->pos < table->size)
+      it->cur = table->slots[it->pos].exp;
+    else
+      it->cur = table->old_slots[it->pos - table->size].exp;
+    it->pos++;
+  }
+  assert (it->cur || it->num_elements == table->num_elements);
 }
 
 void
-btor_iter_unique_table_init (BtorNodeIterator * it, const Btor * btor)
+btor_iter_unique_table_init (BtorNodeIterator *it, const Btor *btor)
 {
   assert (btor);
   assert (it);
 
   it->btor = btor;
-  it->pos = 0;
+  it->pos  = 0;
 #ifndef NDEBUG
   it->num_elements = 0;
 #endif
-  it->cur = 0;
   find_next_unique_node (it);
 }
 
 bool
-btor_iter_unique_table_has_next (const BtorNodeIterator * it)
+btor_iter_unique_table_has_next (const BtorNodeIterator *it)
 {
   assert (it);
-  assert (it->cur || it->pos >= it->btor->nodes_unique_table.size);
   return it->cur != 0;
 }
 
 BtorNode *
-btor_iter_unique_table_next (BtorNodeIterator * it)
+btor_iter_unique_table_next (BtorNodeIterator *it)
 {
   assert (it);
   assert (it->cur);
@@ -252,11 +259,7 @@ btor_iter_unique_table_next (BtorNodeIterator * it)
 #ifndef NDEBUG
   it->num_elements++;
   assert (it->num_elements <= it->btor->nodes_unique_table.num_elements);
-  assert (result);
 #endif
-  it->cur = it->cur->next;
-  if (!it->cur)
-    find_next_unique_node (it);
+  find_next_unique_node (it);
   return result;
 }
-#endif
@@ -51,12 +51,12 @@ BtorNode *btor_iter_binder_next (BtorNodeIterator *it);
 void btor_iter_param_init (BtorNodeIterator * it, BtorNode * exp);
 bool btor_iter_param_has_next (const BtorNodeIterator * it);
 BtorNode * btor_iter_param_next (BtorNodeIterator * it);
-
-void btor_iter_unique_table_init (BtorNodeIterator * it, const Btor * exp);
-bool btor_iter_unique_table_has_next (const BtorNodeIterator * it);
-BtorNode * btor_iter_unique_table_next (BtorNodeIterator * it);
 #endif
 
+void btor_iter_unique_table_init (BtorNodeIterator *it, const Btor *btor);
+bool btor_iter_unique_table_has_next (const BtorNodeIterator *it);
+BtorNode *btor_iter_unique_table_next (BtorNodeIterator *it);
+
 /*------------------------------------------------------------------------*/
 
 typedef struct BtorArgsIterator
@@ -19,7 +19,7 @@ btor_nodemap_new (Btor *btor)
 
   assert (btor);
 
-  BTOR_NEW (btor->mm, res);
+  BTOR_CNEW (btor->mm, res);
   res->btor  = btor;
   res->table = btor_hashptr_table_new (btor->mm,
                                        (BtorHashPtr) btor_node_hash_by_id,
@@ -27,6 +27,20 @@ btor_nodemap_new (Btor *btor)
   return res;
 }
 
+BtorNodeMap *
+btor_nodemap_new_by_id (Btor *btor, Btor *id_btor)
+{
+  BtorNodeMap *res;
+
+  assert (btor);
+  assert (id_btor);
+
+  BTOR_CNEW (btor->mm, res);
+  res->btor    = btor;
+  res->id_btor = id_btor;
+  return res;
+}
+
 void
 btor_nodemap_delete (BtorNodeMap *map)
 {
@@ -36,6 +50,12 @@ btor_nodemap_delete (BtorNodeMap *map)
   BtorNode *src;
   BtorNode *dst;
 
+  if (map->id_btor)
+  {
+    BTOR_DELETE (map->btor->mm, map);
+    return;
+  }
+
   btor_iter_hashptr_init (&it, map->table);
   while (btor_iter_hashptr_has_next (&it))
   {
@@ -52,14 +72,25 @@ BtorNode *
 btor_nodemap_mapped (BtorNodeMap *map, const BtorNode *node)
 {
   BtorPtrHashBucket *bucket;
+  BtorNodePtrStack *id_table;
   BtorNode *real_node;
   BtorNode *res;
 
   real_node = btor_node_real_addr (node);
-  bucket    = btor_hashptr_table_get (map->table, real_node);
-  if (!bucket) return 0;
-  assert (bucket->key == real_node);
-  res = bucket->data.as_ptr;
+  if (map->id_btor)
+  {
+    id_table = &map->id_btor->nodes_id_table;
+    if ((size_t) real_node->id >= BTOR_COUNT_STACK (*id_table)) return 0;
+    res = BTOR_PEEK_STACK (*id_table, real_node->id);
+    if (!res) return 0;
+  }
+  else
+  {
+    bucket = btor_hashptr_table_get (map->table, real_node);
+    if (!bucket) return 0;
+    assert (bucket->key == real_node);
+    res = bucket->data.as_ptr;
+  }
   if (btor_node_is_inverted (node)) res = btor_node_invert (res);
   return res;
 }
@@ -70,6 +101,7 @@ btor_nodemap_map (BtorNodeMap *map, BtorNode *src, BtorNode *dst)
   BtorPtrHashBucket *bucket;
 
   assert (map);
+  assert (!map->id_btor);
   assert (src);
   assert (dst);
 
@@ -95,6 +127,7 @@ void
 btor_iter_nodemap_init (BtorNodeMapIterator *it, const BtorNodeMap *map)
 {
   assert (map);
+  assert (!map->id_btor);
   btor_iter_hashptr_init (&it->it, map->table);
 }
 
@@ -103,6 +136,7 @@ btor_iter_nodemap_init_reversed (BtorNodeMapIterator *it,
                                  const BtorNodeMap *map)
 {
   assert (map);
+  assert (!map->id_btor);
   btor_iter_hashptr_init_reversed (&it->it, map->table);
 }
 
@@ -116,6 +150,7 @@ void
 btor_iter_nodemap_queue (BtorNodeMapIterator *it, const BtorNodeMap *map)
 {
   assert (map);
+  assert (!map->id_btor);
   btor_iter_hashptr_queue (&it->it, map->table);
 }
 
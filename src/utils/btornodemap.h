@@ -24,6 +24,8 @@ struct BtorNodeMap
                // Otherwise src and dst can have different
                // Boolector instances (even != 'btor')!!!
   BtorPtrHashTable *table;
+  Btor *id_btor;  // If non-zero, nodes are implicitly mapped to the nodes
+                  // with the same id in 'id_btor' (no table, no references)
 };
 
 typedef struct BtorNodeMap BtorNodeMap;
@@ -31,6 +33,10 @@ typedef struct BtorNodeMap BtorNodeMap;
 /*------------------------------------------------------------------------*/
 
 BtorNodeMap *btor_nodemap_new (Btor *btor);
+/* Create a map that maps every node to the node with the same id in 'id_btor'
+ * (e.g., a clone of the Boolector instance of the mapped nodes).  Nodes can
+ * not be added to and iterated over in such a map. */
+BtorNodeMap *btor_nodemap_new_by_id (Btor *btor, Btor *id_btor);
 BtorNode *btor_nodemap_mapped (BtorNodeMap *map, const BtorNode *node);
 void btor_nodemap_map (BtorNodeMap *map, BtorNode *src, BtorNode *dst);
 void btor_nodemap_delete (BtorNodeMap *map);
@@ -169,6 +169,8 @@ BTOR_DECLARE_STACK (BtorInt, int32_t);
 
 BTOR_DECLARE_STACK (BtorUInt, uint32_t);
 
+BTOR_DECLARE_STACK (BtorUInt64, uint64_t);
+
 BTOR_DECLARE_STACK (BtorChar, char);
 
 BTOR_DECLARE_STACK (BtorCharPtr, char *);
@@ -2029,6 +2029,48 @@ TEST_F (TestBv, consth)
   btor_bv_free (d_mm, bv);
 }
 
+TEST_F (TestBv, dec_to_bv)
+{
+  BtorBitVector *bv, *exp;
+
+  bv = btor_bv_dec_to_bv (d_mm, "0", 1);
+  assert (btor_bv_to_uint64 (bv) == 0);
+  btor_bv_free (d_mm, bv);
+
+  bv = btor_bv_dec_to_bv (d_mm, "3", 2);
+  assert (btor_bv_to_uint64 (bv) == 3);
+  btor_bv_free (d_mm, bv);
+
+  bv = btor_bv_dec_to_bv (d_mm, "4", 2);
+  assert (!bv);
+
+  bv = btor_bv_dec_to_bv (d_mm, "1234567890123", 41);
+  assert (btor_bv_to_uint64 (bv) == 1234567890123);
+  btor_bv_free (d_mm, bv);
+
+  bv = btor_bv_dec_to_bv (d_mm, "18446744073709551615", 64);
+  assert (btor_bv_to_uint64 (bv) == UINT64_MAX);
+  btor_bv_free (d_mm, bv);
+
+  bv = btor_bv_dec_to_bv (d_mm, "18446744073709551616", 64);
+  assert (!bv);
+
+  bv  = btor_bv_dec_to_bv (d_mm, "340282366920938463463374607431768211455", 128);
+  exp = btor_bv_consth (d_mm, "ffffffffffffffffffffffffffffffff", 128);
+  assert (!btor_bv_compare (bv, exp));
+  btor_bv_free (d_mm, bv);
+  btor_bv_free (d_mm, exp);
+
+  bv  = btor_bv_dec_to_bv (d_mm, "340282366920938463463374607431768211456", 129);
+  exp = btor_bv_consth (d_mm, "100000000000000000000000000000000", 129);
+  assert (!btor_bv_compare (bv, exp));
+  btor_bv_free (d_mm, bv);
+  btor_bv_free (d_mm, exp);
+
+  bv = btor_bv_dec_to_bv (d_mm, "340282366920938463463374607431768211456", 128);
+  assert (!bv);
+}
+
 TEST_F (TestBv, set_get_flip_bit)
 {
   int32_t i;
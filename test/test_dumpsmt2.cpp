@@ -0,0 +1,82 @@
+/*  Boolector: Satisfiability Modulo Theories (SMT) solver.
+ *
+ *  Copyright (C) 2007-2021 by the authors listed in the AUTHORS file.
+ *
+ *  This file is part of Boolector.
+ *  See COPYING for more information on using this software.
+ */
+
+#include "test.h"
+
+extern "C" {
+#include "boolector.h"
+#include "btoropt.h"
+}
+
+#include <string>
+
+class TestDumpSmt2 : public TestBoolector
+{
+ protected:
+  std::string dump ()
+  {
+    std::string res;
+    FILE *file;
+    char buf[4096];
+    size_t n;
+
+    file = tmpfile ();
+    boolector_dump_smt2 (d_btor, file);
+    rewind (file);
+    while ((n = fread (buf, 1, sizeof (buf), file)) > 0) res.append (buf, n);
+    fclose (file);
+    return res;
+  }
+};
+
+/* Reference counts of formulas with at least 2^15 expressions are computed
+ * by several threads, which must yield the same dump as a single thread. */
+TEST_F (TestDumpSmt2, large_n_threads)
+{
+  uint32_t i;
+  std::string expected;
+  BoolectorSort s;
+  BoolectorNode *x, *y, *e, *m, *c, *t;
+
+  boolector_set_opt (d_btor, BTOR_OPT_REWRITE_LEVEL, 0);
+
+  s = boolector_bitvec_sort (d_btor, 16);
+  x = boolector_var (d_btor, s, "x");
+  y = boolector_var (d_btor, s, "y");
+  e = boolector_copy (d_btor, x);
+  for (i = 0; i < 12000; i++)
+  {
+    /* 'e' is referenced twice, hence dumped via define-fun */
+    m = boolector_mul (d_btor, e, y);
+    c = boolector_unsigned_int (d_btor, i, s);
+    t = boolector_add (d_btor, m, c);
+    boolector_release (d_btor, m);
+    boolector_release (d_btor, c);
+    m = boolector_xor (d_btor, t, e);
+    boolector_release (d_btor, t);
+    boolector_release (d_btor, e);
+    e = m;
+  }
+  t = boolector_eq (d_btor, e, x);
+  boolector_assert (d_btor, t);
+  boolector_release (d_btor, t);
+  boolector_release (d_btor, e);
+
+  boolector_set_opt (d_btor, BTOR_OPT_DUMP_N_THREADS, 1);
+  expected = dump ();
+  ASSERT_NE (expected.find ("(define-fun"), std::string::npos);
+  for (i = 2; i <= 4; i++)
+  {
+    boolector_set_opt (d_btor, BTOR_OPT_DUMP_N_THREADS, i);
+    ASSERT_EQ (dump (), expected);
+  }
+
+  boolector_release (d_btor, x);
+  boolector_release (d_btor, y);
+  boolector_release_sort (d_btor, s);
+}
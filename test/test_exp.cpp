@@ -9,8 +9,11 @@
 #include "test.h"
 
 extern "C" {
+#include "btorclone.h"
 #include "btorcore.h"
 #include "btorexp.h"
+#include "btorparse.h"
+#include "dumper/btordumpbin.h"
 #include "dumper/btordumpbtor.h"
 }
 
@@ -933,3 +936,110 @@ TEST_F (TestExp, dec)
   btor_node_release (d_btor, exp2);
   btor_node_release (d_btor, exp3);
 }
+
+TEST_F (TestExp, dump_binary)
+{
+  BtorNode *a, *i, *j, *x, *w, *l, *r, *e[2];
+  BtorSortId sort4, sort8, sorta;
+  Btor *btor;
+  FILE *file;
+  char *emsg;
+  int32_t status;
+  bool parsed_smt2;
+
+  sort4 = btor_sort_bv (d_btor, 4);
+  sort8 = btor_sort_bv (d_btor, 8);
+  sorta = btor_sort_array (d_btor, sort4, sort8);
+
+  a = btor_exp_array (d_btor, sorta, "a");
+  i = btor_exp_var (d_btor, sort4, "i");
+  j = btor_exp_var (d_btor, sort4, "j");
+  x = btor_exp_var (d_btor, sort8, "x");
+  w = btor_exp_write (d_btor, a, i, x);
+  l = btor_exp_lambda_write (d_btor, w, j, btor_node_invert (x));
+  r = btor_exp_read (d_btor, l, i);
+
+  e[0] = btor_exp_eq (d_btor, r, x);
+  e[1] = btor_exp_bv_ult (d_btor, i, j);
+  btor_assert_exp (d_btor, e[0]);
+  btor_assert_exp (d_btor, e[1]);
+
+  file = tmpfile ();
+  btor_dumpbin_dump (d_btor, file);
+  rewind (file);
+
+  btor = btor_new ();
+  ASSERT_EQ (
+      btor_parse (btor, file, "dump", stdout, &emsg, &status, &parsed_smt2),
+      BOOLECTOR_PARSE_UNKNOWN);
+  ASSERT_EQ (emsg, nullptr);
+  ASSERT_NE (btor_node_get_by_symbol (btor, "a"), nullptr);
+  ASSERT_NE (btor_node_get_by_symbol (btor, "i"), nullptr);
+  ASSERT_NE (btor_node_get_by_symbol (btor, "j"), nullptr);
+  ASSERT_NE (btor_node_get_by_symbol (btor, "x"), nullptr);
+  ASSERT_TRUE (btor_node_get_by_symbol (btor, "a")->is_array);
+  ASSERT_EQ (btor_check_sat (btor, -1, -1), BTOR_RESULT_SAT);
+  btor_delete (btor);
+  fclose (file);
+
+  btor_node_release (d_btor, e[0]);
+  btor_node_release (d_btor, e[1]);
+  btor_node_release (d_btor, r);
+  btor_node_release (d_btor, l);
+  btor_node_release (d_btor, w);
+  btor_node_release (d_btor, x);
+  btor_node_release (d_btor, j);
+  btor_node_release (d_btor, i);
+  btor_node_release (d_btor, a);
+  btor_sort_release (d_btor, sorta);
+  btor_sort_release (d_btor, sort8);
+  btor_sort_release (d_btor, sort4);
+}
+
+TEST_F (TestExp, clone_cone)
+{
+  BtorSortId sort, sorta;
+  BtorNode *a, *i, *x, *y, *r, *add, *eq, *mul, *c;
+  BtorNodeMap *map;
+  Btor *clone;
+
+  sort  = btor_sort_bv (d_btor, 8);
+  sorta = btor_sort_array (d_btor, sort, sort);
+  a     = btor_exp_array (d_btor, sorta, "a");
+  i     = btor_exp_var (d_btor, sort, "i");
+  x     = btor_exp_var (d_btor, sort, "x");
+  y     = btor_exp_var (d_btor, sort, "y");
+  r     = btor_exp_read (d_btor, a, i);
+  add   = btor_exp_bv_add (d_btor, r, x);
+  eq    = btor_exp_eq (d_btor, add, i);
+  mul   = btor_exp_bv_mul (d_btor, x, y);
+
+  clone = btor_clone_cone (d_btor, &eq, 1, &map);
+  c     = btor_nodemap_mapped (map, eq);
+  ASSERT_NE (c, nullptr);
+  ASSERT_EQ (c->btor, clone);
+  ASSERT_EQ (btor_node_real_addr (c)->kind, BTOR_BV_EQ_NODE);
+  ASSERT_NE (btor_nodemap_mapped (map, x), nullptr);
+  ASSERT_EQ (btor_nodemap_mapped (map, y), nullptr);
+  ASSERT_EQ (btor_nodemap_mapped (map, mul), nullptr);
+  ASSERT_EQ (clone->bv_vars->count, 2u);
+  ASSERT_EQ (clone->ufs->count, 1u);
+  ASSERT_NE (btor_node_get_by_symbol (clone, "a"), nullptr);
+  ASSERT_TRUE (btor_node_get_by_symbol (clone, "a")->is_array);
+  ASSERT_EQ (btor_node_get_by_symbol (clone, "y"), nullptr);
+  btor_assert_exp (clone, c);
+  btor_nodemap_delete (map);
+  ASSERT_EQ (btor_check_sat (clone, -1, -1), BTOR_RESULT_SAT);
+  btor_delete (clone);
+
+  btor_node_release (d_btor, mul);
+  btor_node_release (d_btor, eq);
+  btor_node_release (d_btor, add);
+  btor_node_release (d_btor, r);
+  btor_node_release (d_btor, y);
+  btor_node_release (d_btor, x);
+  btor_node_release (d_btor, i);
+  btor_node_release (d_btor, a);
+  btor_sort_release (d_btor, sorta);
+  btor_sort_release (d_btor, sort);
+}
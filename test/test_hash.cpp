@@ -128,3 +128,48 @@ TEST_F (TestHash, str2str)
 
   btor_hashptr_table_delete (ht);
 }
+
+TEST_F (TestHash, add_remove_many)
+{
+  BtorPtrHashTable *ht;
+  BtorPtrHashBucket *p;
+  size_t allocated;
+  int32_t i, keys[100];
+  void *ptrs[100];
+
+  allocated = d_mm->allocated;
+  ht        = btor_hashptr_table_new (d_mm, 0, 0);
+
+  for (i = 0; i < 100; i++) ptrs[i] = &keys[i];
+
+  btor_hashptr_table_add (ht, ptrs[42]);
+  btor_hashptr_table_add_many (ht, ptrs, 100);
+  ASSERT_EQ (ht->count, 100u);
+  ASSERT_EQ (d_mm->allocated - allocated, btor_hashptr_table_size (ht));
+
+  /* insertion order, keys already contained are skipped */
+  ASSERT_EQ (ht->first->key, ptrs[42]);
+  for (i = 0, p = ht->first->next; p; p = p->next, i++)
+  {
+    if (i == 42) i++;
+    ASSERT_EQ (p->key, ptrs[i]);
+  }
+
+  btor_hashptr_table_remove_many (ht, ptrs, 50);
+  ASSERT_EQ (ht->count, 50u);
+  for (i = 0; i < 100; i++)
+    ASSERT_EQ (btor_hashptr_table_get (ht, ptrs[i]) != nullptr, i >= 50);
+  for (i = 50, p = ht->first; p; p = p->next, i++) ASSERT_EQ (p->key, ptrs[i]);
+  for (i = 99, p = ht->last; p; p = p->prev, i--) ASSERT_EQ (p->key, ptrs[i]);
+
+  /* removed buckets are reused */
+  btor_hashptr_table_add_many (ht, ptrs, 50);
+  ASSERT_EQ (ht->count, 100u);
+  ASSERT_EQ (d_mm->allocated - allocated, btor_hashptr_table_size (ht));
+  for (i = 0; i < 100; i++)
+    ASSERT_NE (btor_hashptr_table_get (ht, ptrs[i]), nullptr);
+  ASSERT_EQ (ht->last->key, ptrs[49]);
+
+  btor_hashptr_table_delete (ht);
+  ASSERT_EQ (allocated, d_mm->allocated);
+}
@@ -9,7 +9,9 @@
 #include "test.h"
 
 extern "C" {
+#include "btorcore.h"
 #include "btoropt.h"
+#include "btorslvfun.h"
 }
 
 class TestInc : public TestBoolector
@@ -130,6 +132,54 @@ class TestInc : public TestBoolector
 
     boolector_release (d_btor, prev);
   }
+
+  /* Assert that the reads of an array at 'n' indices are pairwise distinct
+   * and check sat under different assumptions, which requires several
+   * refinement iterations each time. */
+  void test_inc_fun_dual_prop (bool dual_prop,
+                               int32_t *results,
+                               uint32_t *iterations)
+  {
+    static constexpr uint32_t n = 6;
+
+    BoolectorNode *array, *idx[n], *read[n], *val, *eq;
+    BoolectorSort s, as;
+    uint32_t i;
+
+    boolector_set_opt (d_btor, BTOR_OPT_INCREMENTAL, 1);
+    boolector_set_opt (d_btor, BTOR_OPT_FUN_DUAL_PROP, dual_prop);
+    s     = boolector_bitvec_sort (d_btor, 8);
+    as    = boolector_array_sort (d_btor, s, s);
+    array = boolector_array (d_btor, as, "array");
+    for (i = 0; i < n; i++)
+    {
+      idx[i]  = boolector_var (d_btor, s, 0);
+      read[i] = boolector_read (d_btor, array, idx[i]);
+      val     = boolector_unsigned_int (d_btor, i, s);
+      eq      = boolector_eq (d_btor, read[i], val);
+      boolector_assert (d_btor, eq);
+      boolector_release (d_btor, val);
+      boolector_release (d_btor, eq);
+    }
+    results[0] = boolector_sat (d_btor);
+    eq         = boolector_eq (d_btor, idx[0], idx[n - 1]);
+    boolector_assume (d_btor, eq);
+    results[1] = boolector_sat (d_btor);
+    boolector_release (d_btor, eq);
+    eq = boolector_ult (d_btor, idx[1], idx[2]);
+    boolector_assume (d_btor, eq);
+    results[2] = boolector_sat (d_btor);
+    boolector_release (d_btor, eq);
+    *iterations = BTOR_FUN_SOLVER (d_btor)->stats.refinement_iterations;
+    for (i = 0; i < n; i++)
+    {
+      boolector_release (d_btor, idx[i]);
+      boolector_release (d_btor, read[i]);
+    }
+    boolector_release (d_btor, array);
+    boolector_release_sort (d_btor, s);
+    boolector_release_sort (d_btor, as);
+  }
 };
 
 TEST_F (TestInc, true_false)
@@ -255,3 +305,580 @@ TEST_F (TestInc, lemmas_on_demand1)
   boolector_release_sort (d_btor, s);
   boolector_release_sort (d_btor, as);
 }
+
+TEST_F (TestInc, fun_pre_concurrent)
+{
+  uint32_t i;
+  uint64_t prod;
+  int32_t sat_result;
+  BoolectorNode *x[8], *mul, *c, *one, *two, *ugt, *ult, *eq;
+  BoolectorSort s;
+
+  boolector_set_opt (d_btor, BTOR_OPT_INCREMENTAL, 1);
+  boolector_set_opt (d_btor, BTOR_OPT_MODEL_GEN, 1);
+  boolector_set_opt (d_btor, BTOR_OPT_FUN_PREPROP, 1);
+  boolector_set_opt (d_btor, BTOR_OPT_FUN_PRE_CONCURRENT, 1);
+  s   = boolector_bitvec_sort (d_btor, 64);
+  c   = boolector_consth (d_btor, s, "90abcdef1234567f");
+  one = boolector_one (d_btor, s);
+  two = boolector_unsigned_int (d_btor, 2, s);
+  /* a product of 8 factors > 1 is found by the prop engine almost instantly,
+   * while bit-blasting and solving it takes much longer */
+  for (i = 0; i < 8; i++)
+  {
+    x[i] = boolector_var (d_btor, s, 0);
+    ugt  = boolector_ugt (d_btor, x[i], one);
+    boolector_assert (d_btor, ugt);
+    boolector_release (d_btor, ugt);
+  }
+  mul = boolector_copy (d_btor, x[0]);
+  for (i = 1; i < 8; i++)
+  {
+    eq = boolector_mul (d_btor, mul, x[i]);
+    boolector_release (d_btor, mul);
+    mul = eq;
+  }
+  eq = boolector_eq (d_btor, mul, c);
+  boolector_assert (d_btor, eq);
+
+  sat_result = boolector_sat (d_btor);
+  ASSERT_EQ (sat_result, BOOLECTOR_SAT);
+  ASSERT_EQ (BTOR_FUN_SOLVER (d_btor)->stats.presolver_sat, 1u);
+  for (i = 0, prod = 1; i < 8; i++)
+    prod *= boolector_bv_assignment_u64 (d_btor, x[i]);
+  ASSERT_EQ (prod, 0x90abcdef1234567full);
+
+  /* the prop engine does not determine unsat */
+  ult = boolector_ult (d_btor, x[0], two);
+  boolector_assume (d_btor, ult);
+  sat_result = boolector_sat (d_btor);
+  ASSERT_EQ (sat_result, BOOLECTOR_UNSAT);
+  ASSERT_TRUE (boolector_failed (d_btor, ult));
+  ASSERT_EQ (BTOR_FUN_SOLVER (d_btor)->stats.presolver_sat, 1u);
+
+  sat_result = boolector_sat (d_btor);
+  ASSERT_EQ (sat_result, BOOLECTOR_SAT);
+  ASSERT_GT (boolector_bv_assignment_u64 (d_btor, x[0]), 1u);
+
+  for (i = 0; i < 8; i++) boolector_release (d_btor, x[i]);
+  boolector_release (d_btor, mul);
+  boolector_release (d_btor, c);
+  boolector_release (d_btor, one);
+  boolector_release (d_btor, two);
+  boolector_release (d_btor, eq);
+  boolector_release (d_btor, ult);
+  boolector_release_sort (d_btor, s);
+}
+
+TEST_F (TestInc, fun_reuse_beta_results)
+{
+  int32_t sat_result;
+  uint32_t i;
+  BoolectorNode *a, *b, *x, *p, *ult, *ra, *rb, *ite, *f, *idx[4], *app[4];
+  BoolectorNode *val, *eq;
+  BoolectorSort s, as;
+
+  boolector_set_opt (d_btor, BTOR_OPT_INCREMENTAL, 1);
+  boolector_set_opt (d_btor, BTOR_OPT_MODEL_GEN, 1);
+  s   = boolector_bitvec_sort (d_btor, 8);
+  as  = boolector_array_sort (d_btor, s, s);
+  a   = boolector_array (d_btor, as, "a");
+  b   = boolector_array (d_btor, as, "b");
+  x   = boolector_var (d_btor, s, "x");
+  p   = boolector_param (d_btor, s, "p");
+  ult = boolector_ult (d_btor, p, x);
+  ra  = boolector_read (d_btor, a, p);
+  rb  = boolector_read (d_btor, b, p);
+  ite = boolector_cond (d_btor, ult, ra, rb);
+  f   = boolector_fun (d_btor, &p, 1, ite);
+  for (i = 0; i < 4; i++)
+  {
+    idx[i] = boolector_var (d_btor, s, 0);
+    app[i] = boolector_apply (d_btor, &idx[i], 1, f);
+    val    = boolector_unsigned_int (d_btor, i, s);
+    eq     = boolector_eq (d_btor, app[i], val);
+    boolector_assert (d_btor, eq);
+    boolector_release (d_btor, val);
+    boolector_release (d_btor, eq);
+  }
+  /* applications of 'f' with changed arguments are propagated again, and
+   * their beta reduction is reused while the conditions evaluate the same */
+  sat_result = boolector_sat (d_btor);
+  ASSERT_EQ (sat_result, BOOLECTOR_SAT);
+  ASSERT_GT (BTOR_FUN_SOLVER (d_btor)->stats.lod_refinements, 1u);
+  ASSERT_GT (BTOR_FUN_SOLVER (d_btor)->stats.propagations_reused, 0u);
+  for (i = 1; i < 4; i++)
+    ASSERT_NE (boolector_bv_assignment_u64 (d_btor, idx[0]),
+               boolector_bv_assignment_u64 (d_btor, idx[i]));
+  eq = boolector_eq (d_btor, idx[0], idx[1]);
+  boolector_assume (d_btor, eq);
+  sat_result = boolector_sat (d_btor);
+  ASSERT_EQ (sat_result, BOOLECTOR_UNSAT);
+  sat_result = boolector_sat (d_btor);
+  ASSERT_EQ (sat_result, BOOLECTOR_SAT);
+  for (i = 0; i < 4; i++)
+  {
+    boolector_release (d_btor, idx[i]);
+    boolector_release (d_btor, app[i]);
+  }
+  boolector_release (d_btor, a);
+  boolector_release (d_btor, b);
+  boolector_release (d_btor, x);
+  boolector_release (d_btor, p);
+  boolector_release (d_btor, ult);
+  boolector_release (d_btor, ra);
+  boolector_release (d_btor, rb);
+  boolector_release (d_btor, ite);
+  boolector_release (d_btor, f);
+  boolector_release (d_btor, eq);
+  boolector_release_sort (d_btor, s);
+  boolector_release_sort (d_btor, as);
+}
+
+TEST_F (TestInc, fun_skip_unchanged_applies)
+{
+  int32_t sat_result;
+  uint32_t i;
+  BoolectorNode *u, *x, *y, *c, *val, *app[10], *eq, *ne;
+  BoolectorSort s, fs;
+
+  boolector_set_opt (d_btor, BTOR_OPT_INCREMENTAL, 1);
+  boolector_set_opt (d_btor, BTOR_OPT_MODEL_GEN, 1);
+  s  = boolector_bitvec_sort (d_btor, 8);
+  fs = boolector_fun_sort (d_btor, &s, 1, s);
+  u  = boolector_uf (d_btor, fs, "u");
+  for (i = 0; i < 8; i++)
+  {
+    c      = boolector_unsigned_int (d_btor, i, s);
+    val    = boolector_unsigned_int (d_btor, i + 1, s);
+    app[i] = boolector_apply (d_btor, &c, 1, u);
+    eq     = boolector_eq (d_btor, app[i], val);
+    boolector_assert (d_btor, eq);
+    boolector_release (d_btor, c);
+    boolector_release (d_btor, val);
+    boolector_release (d_btor, eq);
+  }
+  x      = boolector_var (d_btor, s, "x");
+  y      = boolector_var (d_btor, s, "y");
+  app[8] = boolector_apply (d_btor, &x, 1, u);
+  app[9] = boolector_apply (d_btor, &y, 1, u);
+  ne     = boolector_ne (d_btor, app[8], app[9]);
+  boolector_assert (d_btor, ne);
+  /* the applications of 'u' to constants are only propagated in the first
+   * refinement round since their assignments do not change */
+  sat_result = boolector_sat (d_btor);
+  ASSERT_EQ (sat_result, BOOLECTOR_SAT);
+  ASSERT_GT (BTOR_FUN_SOLVER (d_btor)->stats.lod_refinements, 0u);
+  ASSERT_GE (BTOR_FUN_SOLVER (d_btor)->stats.propagations_skipped, 8u);
+  ASSERT_NE (boolector_bv_assignment_u64 (d_btor, x),
+             boolector_bv_assignment_u64 (d_btor, y));
+  for (i = 0; i < 10; i++) boolector_release (d_btor, app[i]);
+  boolector_release (d_btor, u);
+  boolector_release (d_btor, x);
+  boolector_release (d_btor, y);
+  boolector_release (d_btor, ne);
+  boolector_release_sort (d_btor, s);
+  boolector_release_sort (d_btor, fs);
+}
+
+TEST_F (TestInc, fun_max_lemmas)
+{
+  int32_t sat_result;
+  uint32_t i;
+  BoolectorNode *array, *idx[4], *read[4], *val, *eq;
+  BoolectorSort s, as;
+
+  boolector_set_opt (d_btor, BTOR_OPT_INCREMENTAL, 1);
+  boolector_set_opt (d_btor, BTOR_OPT_MODEL_GEN, 1);
+  boolector_set_opt (
+      d_btor, BTOR_OPT_FUN_EAGER_LEMMAS, BTOR_FUN_EAGER_LEMMAS_ALL);
+  boolector_set_opt (d_btor, BTOR_OPT_FUN_MAX_LEMMAS, 1);
+  s     = boolector_bitvec_sort (d_btor, 8);
+  as    = boolector_array_sort (d_btor, s, s);
+  array = boolector_array (d_btor, as, "array");
+  for (i = 0; i < 4; i++)
+  {
+    idx[i]  = boolector_var (d_btor, s, 0);
+    read[i] = boolector_read (d_btor, array, idx[i]);
+    val     = boolector_unsigned_int (d_btor, i, s);
+    eq      = boolector_eq (d_btor, read[i], val);
+    boolector_assert (d_btor, eq);
+    boolector_release (d_btor, val);
+    boolector_release (d_btor, eq);
+  }
+  sat_result = boolector_sat (d_btor);
+  ASSERT_EQ (sat_result, BOOLECTOR_SAT);
+  /* several conflicts per round, only one lemma is added each time */
+  ASSERT_GT (BTOR_FUN_SOLVER (d_btor)->stats.deferred_lemmas, 0u);
+  for (i = 1; i < 4; i++)
+    ASSERT_NE (boolector_bv_assignment_u64 (d_btor, idx[0]),
+               boolector_bv_assignment_u64 (d_btor, idx[i]));
+  eq = boolector_eq (d_btor, idx[0], idx[3]);
+  boolector_assume (d_btor, eq);
+  sat_result = boolector_sat (d_btor);
+  ASSERT_EQ (sat_result, BOOLECTOR_UNSAT);
+  sat_result = boolector_sat (d_btor);
+  ASSERT_EQ (sat_result, BOOLECTOR_SAT);
+  for (i = 0; i < 4; i++)
+  {
+    boolector_release (d_btor, idx[i]);
+    boolector_release (d_btor, read[i]);
+  }
+  boolector_release (d_btor, array);
+  boolector_release (d_btor, eq);
+  boolector_release_sort (d_btor, s);
+  boolector_release_sort (d_btor, as);
+}
+
+TEST_F (TestInc, fun_eager_updates)
+{
+  int32_t sat_result;
+  BoolectorNode *array, *i, *j, *v, *write, *read, *eq, *ne;
+  BoolectorSort s, as;
+
+  boolector_set_opt (d_btor, BTOR_OPT_INCREMENTAL, 1);
+  boolector_set_opt (d_btor, BTOR_OPT_MODEL_GEN, 1);
+  boolector_set_opt (d_btor, BTOR_OPT_FUN_EAGER_UPDATES, 1);
+  s     = boolector_bitvec_sort (d_btor, 8);
+  as    = boolector_array_sort (d_btor, s, s);
+  array = boolector_array (d_btor, as, "array");
+  i     = boolector_var (d_btor, s, "i");
+  j     = boolector_var (d_btor, s, "j");
+  v     = boolector_var (d_btor, s, "v");
+  write = boolector_write (d_btor, array, j, v);
+  read  = boolector_read (d_btor, write, i);
+  ne    = boolector_ne (d_btor, read, v);
+  boolector_assert (d_btor, ne);
+  sat_result = boolector_sat (d_btor);
+  ASSERT_EQ (sat_result, BOOLECTOR_SAT);
+  /* the read over the write is resolved by the eager axioms */
+  ASSERT_GT (BTOR_FUN_SOLVER (d_btor)->stats.update_axioms, 0u);
+  ASSERT_EQ (BTOR_FUN_SOLVER (d_btor)->stats.lod_refinements, 0u);
+  ASSERT_NE (boolector_bv_assignment_u64 (d_btor, i),
+             boolector_bv_assignment_u64 (d_btor, j));
+  eq = boolector_eq (d_btor, i, j);
+  boolector_assume (d_btor, eq);
+  sat_result = boolector_sat (d_btor);
+  ASSERT_EQ (sat_result, BOOLECTOR_UNSAT);
+  ASSERT_TRUE (boolector_failed (d_btor, eq));
+  sat_result = boolector_sat (d_btor);
+  ASSERT_EQ (sat_result, BOOLECTOR_SAT);
+  boolector_release (d_btor, array);
+  boolector_release (d_btor, i);
+  boolector_release (d_btor, j);
+  boolector_release (d_btor, v);
+  boolector_release (d_btor, write);
+  boolector_release (d_btor, read);
+  boolector_release (d_btor, eq);
+  boolector_release (d_btor, ne);
+  boolector_release_sort (d_btor, s);
+  boolector_release_sort (d_btor, as);
+}
+
+TEST_F (TestInc, fun_dual_prop)
+{
+  int32_t results[3], dp_results[3];
+  uint32_t i, iterations;
+
+  test_inc_fun_dual_prop (false, results, &iterations);
+  boolector_delete (d_btor);
+  d_btor = boolector_new ();
+  test_inc_fun_dual_prop (true, dp_results, &iterations);
+  ASSERT_GT (iterations, 1u);
+  ASSERT_EQ (results[0], BOOLECTOR_SAT);
+  ASSERT_EQ (results[1], BOOLECTOR_UNSAT);
+  ASSERT_EQ (results[2], BOOLECTOR_SAT);
+  for (i = 0; i < 3; i++) ASSERT_EQ (dp_results[i], results[i]);
+}
+
+TEST_F (TestInc, push_pop_scopes)
+{
+  int32_t sat_result;
+  uint32_t k;
+  BoolectorNode *array, *x, *y, *rx, *ry, *c, *eqc, *eq, *ne;
+  BoolectorSort s, as;
+
+  boolector_set_opt (d_btor, BTOR_OPT_INCREMENTAL, 1);
+  boolector_set_opt (d_btor, BTOR_OPT_MODEL_GEN, 1);
+  s     = boolector_bitvec_sort (d_btor, 8);
+  as    = boolector_array_sort (d_btor, s, s);
+  array = boolector_array (d_btor, as, "array");
+  x     = boolector_var (d_btor, s, "x");
+  y     = boolector_var (d_btor, s, "y");
+  rx    = boolector_read (d_btor, array, x);
+  ry    = boolector_read (d_btor, array, y);
+  ne    = boolector_ne (d_btor, rx, ry);
+  eq    = boolector_eq (d_btor, x, y);
+  for (k = 0; k < 8; k++)
+  {
+    boolector_push (d_btor, 1);
+    c   = boolector_unsigned_int (d_btor, k, s);
+    eqc = boolector_eq (d_btor, x, c);
+    boolector_assert (d_btor, eqc);
+    boolector_release (d_btor, c);
+    boolector_release (d_btor, eqc);
+    sat_result = boolector_sat (d_btor);
+    ASSERT_EQ (sat_result, BOOLECTOR_SAT);
+    ASSERT_EQ (boolector_bv_assignment_u64 (d_btor, x), k);
+    boolector_push (d_btor, 1);
+    boolector_assert (d_btor, ne);
+    boolector_assert (d_btor, eq);
+    sat_result = boolector_sat (d_btor);
+    ASSERT_EQ (sat_result, BOOLECTOR_UNSAT);
+    boolector_pop (d_btor, 1);
+    boolector_assume (d_btor, ne);
+    sat_result = boolector_sat (d_btor);
+    ASSERT_EQ (sat_result, BOOLECTOR_SAT);
+    ASSERT_NE (boolector_bv_assignment_u64 (d_btor, y), k);
+    boolector_assume (d_btor, eq);
+    boolector_assume (d_btor, ne);
+    sat_result = boolector_sat (d_btor);
+    ASSERT_EQ (sat_result, BOOLECTOR_UNSAT);
+    boolector_pop (d_btor, 1);
+    ASSERT_TRUE (boolector_failed (d_btor, ne));
+  }
+  boolector_assert (d_btor, eq);
+  sat_result = boolector_sat (d_btor);
+  ASSERT_EQ (sat_result, BOOLECTOR_SAT);
+  ASSERT_EQ (boolector_bv_assignment_u64 (d_btor, x),
+             boolector_bv_assignment_u64 (d_btor, y));
+  boolector_release (d_btor, array);
+  boolector_release (d_btor, x);
+  boolector_release (d_btor, y);
+  boolector_release (d_btor, rx);
+  boolector_release (d_btor, ry);
+  boolector_release (d_btor, eq);
+  boolector_release (d_btor, ne);
+  boolector_release_sort (d_btor, s);
+  boolector_release_sort (d_btor, as);
+}
+
+TEST_F (TestInc, push_pop_scopes_args)
+{
+  int32_t sat_result;
+  BoolectorNode *array, *i, *j, *k, *ij, *rij, *rk, *one, *five, *zero;
+  BoolectorNode *eq, *ne, *eqik, *eqj, *eqk;
+  BoolectorSort s, as;
+
+  boolector_set_opt (d_btor, BTOR_OPT_INCREMENTAL, 1);
+  boolector_set_opt (d_btor, BTOR_OPT_REWRITE_LEVEL, 0);
+  s     = boolector_bitvec_sort (d_btor, 8);
+  as    = boolector_array_sort (d_btor, s, s);
+  array = boolector_array (d_btor, as, "array");
+  i     = boolector_var (d_btor, s, "i");
+  j     = boolector_var (d_btor, s, "j");
+  k     = boolector_var (d_btor, s, "k");
+  ij    = boolector_add (d_btor, i, j);
+  rij   = boolector_read (d_btor, array, ij);
+  rk    = boolector_read (d_btor, array, k);
+  one   = boolector_one (d_btor, s);
+  five  = boolector_unsigned_int (d_btor, 5, s);
+  zero  = boolector_zero (d_btor, s);
+  eq    = boolector_eq (d_btor, rij, one);
+  ne    = boolector_ne (d_btor, rij, rk);
+  eqik  = boolector_eq (d_btor, i, k);
+  eqj   = boolector_eq (d_btor, j, zero);
+  eqk   = boolector_eq (d_btor, k, five);
+  /* 'ij' is encoded within the scope only */
+  boolector_push (d_btor, 1);
+  boolector_assert (d_btor, eq);
+  sat_result = boolector_sat (d_btor);
+  ASSERT_EQ (sat_result, BOOLECTOR_SAT);
+  boolector_pop (d_btor, 1);
+  boolector_assume (d_btor, ne);
+  boolector_assume (d_btor, eqik);
+  boolector_assume (d_btor, eqj);
+  boolector_assume (d_btor, eqk);
+  sat_result = boolector_sat (d_btor);
+  ASSERT_EQ (sat_result, BOOLECTOR_UNSAT);
+  boolector_release (d_btor, array);
+  boolector_release (d_btor, i);
+  boolector_release (d_btor, j);
+  boolector_release (d_btor, k);
+  boolector_release (d_btor, ij);
+  boolector_release (d_btor, rij);
+  boolector_release (d_btor, rk);
+  boolector_release (d_btor, one);
+  boolector_release (d_btor, five);
+  boolector_release (d_btor, zero);
+  boolector_release (d_btor, eq);
+  boolector_release (d_btor, ne);
+  boolector_release (d_btor, eqik);
+  boolector_release (d_btor, eqj);
+  boolector_release (d_btor, eqk);
+  boolector_release_sort (d_btor, s);
+  boolector_release_sort (d_btor, as);
+}
+
+TEST_F (TestInc, garbage_collection)
+{
+  int32_t sat_result;
+  uint32_t i, c, vx, vy;
+  const char *ax, *ay;
+  BoolectorNode *x, *y, *cst, *add, *mul, *eq;
+  BoolectorSort s;
+
+  boolector_set_opt (d_btor, BTOR_OPT_INCREMENTAL, 1);
+  boolector_set_opt (d_btor, BTOR_OPT_MODEL_GEN, 1);
+  s = boolector_bitvec_sort (d_btor, 32);
+  x = boolector_var (d_btor, s, "x");
+  y = boolector_var (d_btor, s, "y");
+  /* every iteration creates and deletes the AIGs of a multiplier */
+  for (i = 0; i < 32; i++)
+  {
+    c   = 1000 + 2 * i;
+    cst = boolector_unsigned_int (d_btor, c, s);
+    add = boolector_add (d_btor, x, cst);
+    mul = boolector_mul (d_btor, add, y);
+    eq  = boolector_eq (d_btor, mul, cst);
+    boolector_assume (d_btor, eq);
+    sat_result = boolector_sat (d_btor);
+    ASSERT_EQ (sat_result, BOOLECTOR_SAT);
+    ax = boolector_bv_assignment (d_btor, x);
+    ay = boolector_bv_assignment (d_btor, y);
+    vx = strtoul (ax, 0, 2);
+    vy = strtoul (ay, 0, 2);
+    ASSERT_EQ ((vx + c) * vy, c);
+    boolector_free_bv_assignment (d_btor, ax);
+    boolector_free_bv_assignment (d_btor, ay);
+    boolector_release (d_btor, eq);
+    boolector_release (d_btor, mul);
+    boolector_release (d_btor, add);
+    boolector_release (d_btor, cst);
+  }
+  ASSERT_GT (btor_get_aig_mgr (d_btor)->num_aig_id_gcs, 0u);
+  boolector_release (d_btor, x);
+  boolector_release (d_btor, y);
+  boolector_release_sort (d_btor, s);
+}
+
+TEST_F (TestInc, garbage_collection_scopes)
+{
+  int32_t sat_result;
+  uint32_t i;
+  BoolectorNode *x[2], *y[2], *mul, *eq;
+  BoolectorSort s[2];
+  BtorAIGMgr *amgr;
+
+  boolector_set_opt (d_btor, BTOR_OPT_INCREMENTAL, 1);
+  amgr = btor_get_aig_mgr (d_btor);
+  /* the encoding of the outer scope is larger than the encoding of the inner
+   * scope, hence popping the inner scope does not trigger garbage collection */
+  for (i = 0; i < 2; i++)
+  {
+    s[i] = boolector_bitvec_sort (d_btor, i == 0 ? 32 : 8);
+    x[i] = boolector_var (d_btor, s[i], 0);
+    y[i] = boolector_var (d_btor, s[i], 0);
+    boolector_push (d_btor, 1);
+    mul = boolector_mul (d_btor, x[i], y[i]);
+    eq  = boolector_eq (d_btor, mul, x[i]);
+    boolector_assert (d_btor, eq);
+    boolector_release (d_btor, mul);
+    boolector_release (d_btor, eq);
+    sat_result = boolector_sat (d_btor);
+    ASSERT_EQ (sat_result, BOOLECTOR_SAT);
+  }
+  boolector_pop (d_btor, 1);
+  sat_result = boolector_sat (d_btor);
+  ASSERT_EQ (sat_result, BOOLECTOR_SAT);
+  ASSERT_EQ (amgr->num_cnf_gcs, 0u);
+  /* the CNF indices of the inner scope have been counted already */
+  boolector_pop (d_btor, 1);
+  btor_aig_mgr_release_popped_scopes (amgr);
+  ASSERT_GT (amgr->num_dead_cnf_ids, 0);
+  ASSERT_LE (amgr->num_dead_cnf_ids, amgr->smgr->maxvar);
+  sat_result = boolector_sat (d_btor);
+  ASSERT_EQ (sat_result, BOOLECTOR_SAT);
+  for (i = 0; i < 2; i++)
+  {
+    boolector_release (d_btor, x[i]);
+    boolector_release (d_btor, y[i]);
+    boolector_release_sort (d_btor, s[i]);
+  }
+}
+
+TEST_F (TestInc, sat_parallel)
+{
+  int32_t results[17], expected[17];
+  uint32_t i, j, k, sizes[17];
+  const char *ax;
+  BoolectorNode *x, *y, *cst, *mul, *eq, *gt, *ne, *assumptions[18];
+  BoolectorSort s;
+
+  boolector_set_opt (d_btor, BTOR_OPT_INCREMENTAL, 1);
+  boolector_set_opt (d_btor, BTOR_OPT_MODEL_GEN, 1);
+  s   = boolector_bitvec_sort (d_btor, 8);
+  x   = boolector_var (d_btor, s, "x");
+  y   = boolector_var (d_btor, s, "y");
+  cst = boolector_unsigned_int (d_btor, 15, s);
+  mul = boolector_mul (d_btor, x, y);
+  eq  = boolector_eq (d_btor, mul, cst);
+  boolector_assert (d_btor, eq);
+  boolector_release (d_btor, cst);
+  cst = boolector_unsigned_int (d_btor, 2, s);
+  gt  = boolector_ugt (d_btor, y, cst);
+  boolector_assert (d_btor, gt);
+  boolector_release (d_btor, cst);
+  cst = boolector_unsigned_int (d_btor, 3, s);
+  ne  = boolector_ne (d_btor, y, cst);
+  boolector_release (d_btor, cst);
+
+  for (i = 0; i < 16; i++)
+  {
+    cst            = boolector_unsigned_int (d_btor, i, s);
+    assumptions[i] = boolector_eq (d_btor, x, cst);
+    sizes[i]       = 1;
+    boolector_release (d_btor, cst);
+  }
+  assumptions[16] = boolector_copy (d_btor, assumptions[3]);
+  assumptions[17] = boolector_copy (d_btor, assumptions[5]);
+  sizes[16]       = 2;
+
+  for (i = 0, k = 0; i < 17; i++)
+  {
+    for (j = 0; j < sizes[i]; j++, k++)
+      boolector_assume (d_btor, assumptions[k]);
+    expected[i] = boolector_sat (d_btor);
+  }
+  ASSERT_EQ (expected[0], BOOLECTOR_UNSAT);
+  ASSERT_EQ (expected[2], BOOLECTOR_UNSAT);
+  ASSERT_EQ (expected[5], BOOLECTOR_SAT);
+  ASSERT_EQ (expected[16], BOOLECTOR_UNSAT);
+  boolector_sat_parallel (d_btor, assumptions, sizes, 17, 4, results);
+  for (i = 0; i < 17; i++) ASSERT_EQ (results[i], expected[i]);
+#ifdef BTOR_HAVE_PTHREADS
+  ASSERT_EQ (d_btor->stats.parallel_checks, 1u);
+#endif
+
+  /* assumptions made before are added to every set */
+  for (i = 0, k = 0; i < 17; i++)
+  {
+    boolector_assume (d_btor, ne);
+    for (j = 0; j < sizes[i]; j++, k++)
+      boolector_assume (d_btor, assumptions[k]);
+    expected[i] = boolector_sat (d_btor);
+  }
+  ASSERT_EQ (expected[5], BOOLECTOR_UNSAT);
+  boolector_assume (d_btor, ne);
+  boolector_sat_parallel (d_btor, assumptions, sizes, 17, 4, results);
+  for (i = 0; i < 17; i++) ASSERT_EQ (results[i], expected[i]);
+#ifdef BTOR_HAVE_PTHREADS
+  ASSERT_EQ (d_btor->stats.parallel_checks, 2u);
+#endif
+
+  /* the formula can still be checked afterwards */
+  boolector_assume (d_btor, assumptions[5]);
+  ASSERT_EQ (boolector_sat (d_btor), BOOLECTOR_SAT);
+  ax = boolector_bv_assignment (d_btor, x);
+  ASSERT_STREQ (ax, "00000101");
+  boolector_free_bv_assignment (d_btor, ax);
+
+  for (i = 0; i < 18; i++) boolector_release (d_btor, assumptions[i]);
+  boolector_release (d_btor, ne);
+  boolector_release (d_btor, gt);
+  boolector_release (d_btor, eq);
+  boolector_release (d_btor, mul);
+  boolector_release (d_btor, x);
+  boolector_release (d_btor, y);
+  boolector_release_sort (d_btor, s);
+}
@@ -72,3 +72,32 @@ TEST_F (TestIntHash, add)
     ASSERT_EQ (btor_hashint_table_get_pos (d_htable, items[i]), d_htable->size);
   }
 }
+
+TEST_F (TestIntHash, add_many_remove)
+{
+  int32_t i, keys[1000];
+
+  for (i = 0; i < 1000; i++) keys[i] = i + 1;
+
+  btor_hashint_table_add_many (d_htable, keys, 1000);
+  ASSERT_EQ (d_htable->count, 1000u);
+  for (i = 0; i < 1000; i++)
+    ASSERT_TRUE (btor_hashint_table_contains (d_htable, keys[i]));
+
+  /* keys already in the table are not added twice */
+  btor_hashint_table_add_many (d_htable, keys, 500);
+  ASSERT_EQ (d_htable->count, 1000u);
+
+  /* repeatedly remove and add keys such that removed slots are reused */
+  for (i = 0; i < 10000; i++)
+  {
+    btor_hashint_table_remove (d_htable, keys[i % 1000]);
+    ASSERT_FALSE (btor_hashint_table_contains (d_htable, keys[i % 1000]));
+    keys[i % 1000] = -(i + 1);
+    btor_hashint_table_add (d_htable, keys[i % 1000]);
+  }
+  ASSERT_EQ (d_htable->count, 1000u);
+  for (i = 0; i < 1000; i++)
+    ASSERT_TRUE (btor_hashint_table_contains (d_htable, keys[i]));
+  ASSERT_FALSE (btor_hashint_table_contains (d_htable, 1));
+}
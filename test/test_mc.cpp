@@ -10,6 +10,9 @@
 
 extern "C" {
 #include "boolectormc.h"
+#include "btormc.h"
+#include "parser/btoraiger.h"
+#include "utils/btormem.h"
 }
 
 class TestMc : public TestMm
@@ -55,6 +58,17 @@ class TestMc : public TestMm
     boolector_mc_free_assignment (d_mc, val);
   }
 
+  /* Parse AIGER model 'aiger' of size 'size', return parse error or 0. */
+  char *parse_aiger (const char *aiger, size_t size, bool checkall)
+  {
+    FILE *file = tmpfile ();
+    fwrite (aiger, 1, size, file);
+    rewind (file);
+    char *res = btor_parseaiger_mc (d_mc, file, "<tmp>", checkall);
+    fclose (file);
+    return res;
+  }
+
   BtorMC *d_mc = nullptr;
   Btor *d_btor = nullptr;
 };
@@ -447,3 +461,37 @@ TEST_F (TestMc, count2multi)
   ASSERT_EQ (boolector_mc_reached_bad_at_bound (d_mc, 3), 3);
   boolector_release (d_btor, count);
 }
+
+/*------------------------------------------------------------------------*/
+
+TEST_F (TestMc, aiger)
+{
+  /* 2-bit counter, bad if both bits are set, and gates in ASCII format out
+   * of order */
+  const char aag[] =
+      "aag 6 0 2 0 4 1\n2 3\n4 13\n6\n"
+      "12 11 9\n6 4 2\n10 4 3\n8 5 2\nl0 bit0\nl1 bit1\nc\ncomment\n";
+  const char aig[] =
+      "aig 6 0 2 0 4 1\n3\n13\n6\n\x02\x02\x03\x03\x06\x01\x01\x02";
+  const char cyclic[] = "aag 3 1 0 1 2\n2\n6\n6 4 2\n4 6 2\n";
+  char *err;
+  int32_t k;
+
+  for (int32_t mode = 0; mode < 2; mode++)
+  {
+    set_up_iteration ();
+    if (mode)
+      err = parse_aiger (aig, sizeof aig - 1, false);
+    else
+      err = parse_aiger (aag, sizeof aag - 1, false);
+    ASSERT_EQ (err, nullptr);
+    k = boolector_mc_bmc (d_mc, 0, 5);
+    ASSERT_EQ (k, 3);
+  }
+
+  set_up_iteration ();
+  err = parse_aiger (cyclic, sizeof cyclic - 1, false);
+  ASSERT_NE (err, nullptr);
+  ASSERT_NE (strstr (err, "cyclic"), nullptr);
+  btor_mem_freestr (d_mc->mm, err);
+}
@@ -11,6 +11,7 @@
 extern "C" {
 #include "boolector.h"
 #include "btorconfig.h"
+#include "btorcore.h"
 }
 
 class TestModelGen : public TestFile
@@ -183,3 +184,193 @@ TEST_F (TestModelGen, modelgen27)
 {
   run_modelgen_test ("modelgen27", ".btor", 3);
 }
+
+TEST_F (TestModelGen, dump_binary_simplified)
+{
+  BoolectorSort s;
+  BoolectorNode *x, *y, *one, *add, *eq, *ult, *lx, *ly, *lult;
+  Btor *btor;
+  FILE *file;
+  char *emsg;
+  const char *ax, *ay;
+  int32_t status;
+  bool parsed_smt2;
+
+  s   = boolector_bitvec_sort (d_btor, 8);
+  x   = boolector_var (d_btor, s, "x");
+  y   = boolector_var (d_btor, s, "y");
+  one = boolector_one (d_btor, s);
+  add = boolector_add (d_btor, x, one);
+  eq  = boolector_eq (d_btor, y, add);
+  ult = boolector_ult (d_btor, one, x);
+  boolector_assert (d_btor, eq);
+  boolector_assert (d_btor, ult);
+  boolector_simplify (d_btor);
+
+  file = tmpfile ();
+  boolector_dump_binary (d_btor, file);
+  rewind (file);
+
+  /* 'y' is eliminated by simplification but still gets a model */
+  btor = boolector_new ();
+  boolector_set_opt (btor, BTOR_OPT_MODEL_GEN, 1);
+  ASSERT_EQ (
+      boolector_parse (btor, file, "dump", stdout, &emsg, &status, &parsed_smt2),
+      BOOLECTOR_PARSE_UNKNOWN);
+  /* the loaded formula is not simplified again */
+  ASSERT_TRUE (btor->simplified);
+  ASSERT_EQ (boolector_simplify (btor), BOOLECTOR_UNKNOWN);
+  ASSERT_EQ (btor->stats.simplifications_skipped, 1u);
+  ASSERT_EQ (btor->stats.var_substitutions, 0u);
+  ASSERT_EQ (boolector_sat (btor), BOOLECTOR_SAT);
+  ASSERT_EQ (btor->stats.simplifications_skipped, 2u);
+  lx = boolector_match_node_by_symbol (btor, "x");
+  ly = boolector_match_node_by_symbol (btor, "y");
+  ax = boolector_bv_assignment (btor, lx);
+  ay = boolector_bv_assignment (btor, ly);
+  ASSERT_EQ ((strtoul (ax, 0, 2) + 1) % 256, strtoul (ay, 0, 2));
+  ASSERT_GT (strtoul (ax, 0, 2), 1u);
+  boolector_free_bv_assignment (btor, ax);
+  boolector_free_bv_assignment (btor, ay);
+  /* new constraints are simplified */
+  lult = boolector_ult (btor, ly, lx);
+  boolector_assert (btor, lult);
+  ASSERT_FALSE (btor->simplified);
+  ASSERT_EQ (boolector_simplify (btor), BOOLECTOR_UNKNOWN);
+  ASSERT_EQ (btor->stats.simplifications_skipped, 2u);
+  ASSERT_TRUE (btor->simplified);
+  boolector_release (btor, lult);
+  boolector_release (btor, lx);
+  boolector_release (btor, ly);
+  boolector_delete (btor);
+  fclose (file);
+
+  boolector_release (d_btor, x);
+  boolector_release (d_btor, y);
+  boolector_release (d_btor, one);
+  boolector_release (d_btor, add);
+  boolector_release (d_btor, eq);
+  boolector_release (d_btor, ult);
+  boolector_release_sort (d_btor, s);
+}
+
+TEST_F (TestModelGen, bv_assignment_u64)
+{
+  BoolectorSort s8, s64, s100;
+  BoolectorNode *x, *y, *z, *cx, *cy, *cz, *ex, *ey, *ez, *nodes[3];
+  uint64_t values[3], words[3];
+
+  s8   = boolector_bitvec_sort (d_btor, 8);
+  s64  = boolector_bitvec_sort (d_btor, 64);
+  s100 = boolector_bitvec_sort (d_btor, 100);
+  x    = boolector_var (d_btor, s8, "x");
+  y    = boolector_var (d_btor, s64, "y");
+  z    = boolector_var (d_btor, s100, "z");
+  cx   = boolector_consth (d_btor, s8, "a5");
+  cy   = boolector_ones (d_btor, s64);
+  cz   = boolector_consth (d_btor, s100, "80123456789abcdef0");
+  ex   = boolector_eq (d_btor, x, cx);
+  ey   = boolector_eq (d_btor, y, cy);
+  ez   = boolector_eq (d_btor, z, cz);
+  boolector_assert (d_btor, ex);
+  boolector_assert (d_btor, ey);
+  boolector_assert (d_btor, ez);
+
+  boolector_set_opt (d_btor, BTOR_OPT_MODEL_GEN, 1);
+  ASSERT_EQ (boolector_sat (d_btor), BOOLECTOR_SAT);
+
+  ASSERT_EQ (boolector_bv_assignment_u64 (d_btor, x), 0xa5u);
+  ASSERT_EQ (boolector_bv_assignment_u64 (d_btor, y), UINT64_MAX);
+  ASSERT_EQ (boolector_bv_assignment_u64 (d_btor, ex), 1u);
+
+  words[2] = 1;
+  boolector_bv_assignment_words (d_btor, z, words, 3);
+  ASSERT_EQ (words[0], 0x123456789abcdef0ull);
+  ASSERT_EQ (words[1], 0x80u);
+  ASSERT_EQ (words[2], 0u);
+  boolector_bv_assignment_words (d_btor, x, words, 1);
+  ASSERT_EQ (words[0], 0xa5u);
+
+  nodes[0] = x;
+  nodes[1] = y;
+  nodes[2] = boolector_not (d_btor, x);
+  boolector_bv_assignments (d_btor, nodes, 3, values);
+  ASSERT_EQ (values[0], 0xa5u);
+  ASSERT_EQ (values[1], UINT64_MAX);
+  ASSERT_EQ (values[2], 0x5au);
+  boolector_release (d_btor, nodes[2]);
+
+  boolector_release (d_btor, x);
+  boolector_release (d_btor, y);
+  boolector_release (d_btor, z);
+  boolector_release (d_btor, cx);
+  boolector_release (d_btor, cy);
+  boolector_release (d_btor, cz);
+  boolector_release (d_btor, ex);
+  boolector_release (d_btor, ey);
+  boolector_release (d_btor, ez);
+  boolector_release_sort (d_btor, s8);
+  boolector_release_sort (d_btor, s64);
+  boolector_release_sort (d_btor, s100);
+}
+
+TEST_F (TestModelGen, lazy)
+{
+  BoolectorSort s8, as;
+  BoolectorNode *a, *i, *j, *x, *y, *ri, *rj, *e0, *e1, *e2, *c;
+  char **indices, **values;
+  uint32_t size;
+
+  s8 = boolector_bitvec_sort (d_btor, 8);
+  as = boolector_array_sort (d_btor, s8, s8);
+  a  = boolector_array (d_btor, as, "a");
+  i  = boolector_var (d_btor, s8, "i");
+  j  = boolector_var (d_btor, s8, "j");
+  x  = boolector_var (d_btor, s8, "x");
+  y  = boolector_var (d_btor, s8, "y");
+  c  = boolector_int (d_btor, 7, s8);
+  ri = boolector_read (d_btor, a, i);
+  rj = boolector_read (d_btor, a, j);
+  e0 = boolector_eq (d_btor, ri, c);
+  e1 = boolector_ne (d_btor, rj, c);
+  e2 = boolector_ult (d_btor, x, y);
+  boolector_assert (d_btor, e0);
+  boolector_assert (d_btor, e1);
+  boolector_assert (d_btor, e2);
+
+  boolector_set_opt (d_btor, BTOR_OPT_MODEL_GEN, 1);
+  boolector_set_opt (d_btor, BTOR_OPT_MODEL_GEN_LAZY, 1);
+  /* checking the model would generate it up front */
+  boolector_set_opt (d_btor, BTOR_OPT_CHK_MODEL, 0);
+  ASSERT_EQ (boolector_sat (d_btor), BOOLECTOR_SAT);
+  ASSERT_TRUE (d_btor->lazy_model);
+
+  /* bit-vector values are computed on demand without generating the model */
+  ASSERT_EQ (boolector_bv_assignment_u64 (d_btor, ri), 7u);
+  ASSERT_NE (boolector_bv_assignment_u64 (d_btor, rj), 7u);
+  ASSERT_NE (boolector_bv_assignment_u64 (d_btor, i),
+             boolector_bv_assignment_u64 (d_btor, j));
+  ASSERT_LT (boolector_bv_assignment_u64 (d_btor, x),
+             boolector_bv_assignment_u64 (d_btor, y));
+  ASSERT_TRUE (d_btor->lazy_model);
+
+  /* the model of 'a' requires the values of all reads on it */
+  boolector_array_assignment (d_btor, a, &indices, &values, &size);
+  ASSERT_FALSE (d_btor->lazy_model);
+  ASSERT_EQ (size, 2u);
+  boolector_free_array_assignment (d_btor, indices, values, size);
+
+  boolector_release (d_btor, a);
+  boolector_release (d_btor, i);
+  boolector_release (d_btor, j);
+  boolector_release (d_btor, x);
+  boolector_release (d_btor, y);
+  boolector_release (d_btor, c);
+  boolector_release (d_btor, ri);
+  boolector_release (d_btor, rj);
+  boolector_release (d_btor, e0);
+  boolector_release (d_btor, e1);
+  boolector_release (d_btor, e2);
+  boolector_release_sort (d_btor, s8);
+  boolector_release_sort (d_btor, as);
+}
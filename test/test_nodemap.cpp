@@ -9,6 +9,7 @@
 #include "test.h"
 
 extern "C" {
+#include "btorclone.h"
 #include "btorexp.h"
 }
 
@@ -77,3 +78,35 @@ TEST_F (TestMap, map1)
   btor_nodemap_delete (map);
   btor_delete (btor_a);
 }
+
+TEST_F (TestMap, map_by_id)
+{
+  Btor *btor_a, *clone;
+  BtorNode *s, *t, *a, *b, *m;
+  BtorSortId sort;
+  BtorNodeMap *map;
+
+  btor_a = btor_new ();
+  sort   = btor_sort_bv (btor_a, 32);
+  s      = btor_exp_var (btor_a, sort, "0");
+  t      = btor_exp_var (btor_a, sort, "1");
+  a      = btor_exp_bv_and (btor_a, s, t);
+  btor_sort_release (btor_a, sort);
+  clone = btor_clone_formula (btor_a);
+  b     = btor_exp_bv_add (btor_a, s, t);
+  map   = btor_nodemap_new_by_id (d_btor, clone);
+  m     = btor_nodemap_mapped (map, a);
+  ASSERT_EQ (m->btor, clone);
+  ASSERT_EQ (btor_node_get_id (m), btor_node_get_id (a));
+  ASSERT_EQ (btor_nodemap_mapped (map, btor_node_invert (a)),
+             btor_node_invert (m));
+  ASSERT_EQ (btor_nodemap_mapped (map, b), nullptr);
+
+  btor_node_release (btor_a, t);
+  btor_node_release (btor_a, s);
+  btor_node_release (btor_a, a);
+  btor_node_release (btor_a, b);
+  btor_nodemap_delete (map);
+  btor_delete (clone);
+  btor_delete (btor_a);
+}
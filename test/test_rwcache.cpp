@@ -0,0 +1,238 @@
+/*  Boolector: Satisfiability Modulo Theories (SMT) solver.
+ *
+ *  Copyright (C) 2007-2021 by the authors listed in the AUTHORS file.
+ *
+ *  This file is part of Boolector.
+ *  See COPYING for more information on using this software.
+ */
+
+#include "test.h"
+
+extern "C" {
+#include "btorcore.h"
+#include "btorexp.h"
+#include "btorrwcache.h"
+}
+
+class TestRwCache : public TestBtor
+{
+ protected:
+  static constexpr uint32_t s_num_vars = 256;
+
+  void SetUp () override
+  {
+    BtorSortId sort;
+
+    TestBtor::SetUp ();
+    sort = btor_sort_bv (d_btor, 8);
+    for (uint32_t i = 0; i < s_num_vars; i++)
+    {
+      d_vars[i] = btor_exp_var (d_btor, sort, 0);
+    }
+    btor_sort_release (d_btor, sort);
+  }
+
+  void TearDown () override
+  {
+    for (uint32_t i = 0; i < s_num_vars; i++)
+    {
+      btor_node_release (d_btor, d_vars[i]);
+    }
+    TestBtor::TearDown ();
+  }
+
+  int32_t id (uint32_t i) { return d_vars[i]->id; }
+
+  BtorNode *d_vars[s_num_vars];
+};
+
+TEST_F (TestRwCache, add_get)
+{
+  BtorRwCache rwc;
+
+  btor_rw_cache_init (&rwc, d_btor);
+  ASSERT_EQ (btor_rw_cache_get (&rwc, BTOR_BV_AND_NODE, id (0), id (1), 0), 0);
+  btor_rw_cache_add (&rwc, BTOR_BV_AND_NODE, id (0), id (1), 0, id (2));
+  ASSERT_EQ (btor_rw_cache_get (&rwc, BTOR_BV_AND_NODE, id (0), id (1), 0),
+             id (2));
+  ASSERT_EQ (btor_rw_cache_get (&rwc, BTOR_BV_ADD_NODE, id (0), id (1), 0), 0);
+  ASSERT_EQ (btor_rw_cache_get (&rwc, BTOR_BV_AND_NODE, id (1), id (0), 0), 0);
+  ASSERT_EQ (rwc.num_add, 1u);
+  ASSERT_EQ (rwc.num_get, 4u);
+  ASSERT_EQ (rwc.num_hits, 1u);
+  btor_rw_cache_delete (&rwc);
+}
+
+TEST_F (TestRwCache, evict)
+{
+  uint32_t i, j, max_size, hits;
+  BtorRwCache rwc;
+
+  /* 1 MB holds 32768 entries, which is less than the 65536 added below */
+  btor_opt_set (d_btor, BTOR_OPT_RW_CACHE_SIZE, 1);
+  btor_rw_cache_init (&rwc, d_btor);
+
+  /* the cache is enlarged while a set is full */
+  btor_rw_cache_add (&rwc, BTOR_BV_ADD_NODE, id (0), id (0), 0, id (0));
+  for (i = 0; i < s_num_vars; i++)
+  {
+    for (j = 0; j < s_num_vars; j++)
+    {
+      btor_rw_cache_add (&rwc, BTOR_BV_AND_NODE, id (i), id (j), 0, id (i));
+      /* a referenced entry gets a second chance each time the CLOCK hand
+       * passes it, hence it is never evicted if it is used in between */
+      ASSERT_EQ (
+          btor_rw_cache_get (&rwc, BTOR_BV_ADD_NODE, id (0), id (0), 0),
+          id (0));
+    }
+  }
+  max_size = rwc.size;
+  ASSERT_LE (max_size * sizeof (BtorRwCacheTuple), 1u << 20);
+  ASSERT_GT (2 * max_size * sizeof (BtorRwCacheTuple), 1u << 20);
+  ASSERT_GT (rwc.num_evict, 0u);
+  ASSERT_LE (rwc.count, rwc.size);
+  ASSERT_EQ (rwc.count + rwc.num_evict, rwc.num_add);
+
+  /* the most recently added entry was not evicted, and all entries that are
+   * still counted can be found */
+  ASSERT_EQ (btor_rw_cache_get (&rwc,
+                                BTOR_BV_AND_NODE,
+                                id (s_num_vars - 1),
+                                id (s_num_vars - 1),
+                                0),
+             id (s_num_vars - 1));
+  for (i = 0, hits = 0; i < s_num_vars; i++)
+  {
+    for (j = 0; j < s_num_vars; j++)
+    {
+      if (btor_rw_cache_get (&rwc, BTOR_BV_AND_NODE, id (i), id (j), 0))
+      {
+        hits++;
+      }
+    }
+  }
+  ASSERT_EQ (hits + 1, rwc.count);
+
+  /* evicting does not enlarge the cache beyond the limit */
+  btor_rw_cache_add (&rwc, BTOR_BV_ADD_NODE, id (1), id (1), 0, id (1));
+  ASSERT_EQ (rwc.size, max_size);
+  btor_rw_cache_delete (&rwc);
+}
+
+TEST_F (TestRwCache, max_size)
+{
+  uint32_t i, j;
+  BtorRwCache *rwc;
+
+  rwc = d_btor->rw_cache;
+  btor_opt_set (d_btor, BTOR_OPT_RW_CACHE_SIZE, 2);
+  ASSERT_LE (rwc->max_size * sizeof (BtorRwCacheTuple), 2u << 20);
+  ASSERT_GT (2 * rwc->max_size * sizeof (BtorRwCacheTuple), 2u << 20);
+  for (i = 0; i < s_num_vars; i++)
+  {
+    for (j = 0; j < s_num_vars; j++)
+    {
+      btor_rw_cache_add (rwc, BTOR_BV_AND_NODE, id (i), id (j), 0, id (i));
+    }
+  }
+  ASSERT_GT (rwc->size * sizeof (BtorRwCacheTuple), 1u << 20);
+
+  /* lowering the limit drops the cache, raising it keeps the entries */
+  btor_opt_set (d_btor, BTOR_OPT_RW_CACHE_SIZE, 1);
+  ASSERT_LE (rwc->max_size * sizeof (BtorRwCacheTuple), 1u << 20);
+  ASSERT_EQ (rwc->count, 0u);
+  btor_rw_cache_add (rwc, BTOR_BV_AND_NODE, id (0), id (1), 0, id (0));
+  btor_opt_set (d_btor, BTOR_OPT_RW_CACHE_SIZE, 4);
+  ASSERT_EQ (btor_rw_cache_get (rwc, BTOR_BV_AND_NODE, id (0), id (1), 0),
+             id (0));
+}
+
+TEST_F (TestRwCache, shared)
+{
+  uint32_t i;
+  Btor *btor[3];
+  BtorSortId sort;
+  BtorNode *x[3], *y[3], *res;
+
+  for (i = 0; i < 3; i++)
+  {
+    btor[i] = btor_new ();
+    btor_opt_set (btor[i], BTOR_OPT_RW_CACHE_SHARED, 1);
+    sort = btor_sort_bv (btor[i], i < 2 ? 8 : 16);
+    /* create the variables in different order to get different ids */
+    if (i == 1) y[i] = btor_exp_var (btor[i], sort, "rwcache_shared_y");
+    x[i] = btor_exp_var (btor[i], sort, "rwcache_shared_x");
+    if (i != 1) y[i] = btor_exp_var (btor[i], sort, "rwcache_shared_y");
+    btor_sort_release (btor[i], sort);
+  }
+  ASSERT_NE (x[0]->id, x[1]->id);
+
+  btor_rw_cache_add (
+      btor[0]->rw_cache, BTOR_BV_AND_NODE, x[0]->id, y[0]->id, 0, x[0]->id);
+
+  /* same structure in another instance */
+  res = btor_rw_cache_get_shared (
+      btor[1]->rw_cache, BTOR_BV_AND_NODE, x[1]->id, y[1]->id, 0);
+  ASSERT_EQ (res, x[1]);
+  ASSERT_EQ (btor[1]->rw_cache->num_shared_hits, 1u);
+  btor_node_release (btor[1], res);
+
+  /* different kind, children or widths */
+  ASSERT_EQ (btor_rw_cache_get_shared (
+                 btor[1]->rw_cache, BTOR_BV_ADD_NODE, x[1]->id, y[1]->id, 0),
+             nullptr);
+  ASSERT_EQ (btor_rw_cache_get_shared (
+                 btor[1]->rw_cache, BTOR_BV_AND_NODE, y[1]->id, x[1]->id, 0),
+             nullptr);
+  ASSERT_EQ (btor_rw_cache_get_shared (
+                 btor[2]->rw_cache, BTOR_BV_AND_NODE, x[2]->id, y[2]->id, 0),
+             nullptr);
+  ASSERT_EQ (btor[1]->rw_cache->num_shared_hits, 1u);
+
+  for (i = 0; i < 3; i++)
+  {
+    btor_node_release (btor[i], x[i]);
+    btor_node_release (btor[i], y[i]);
+    btor_delete (btor[i]);
+  }
+}
+
+TEST_F (TestRwCache, shared_max_nodes)
+{
+  uint32_t i, j;
+  char sym[32];
+  Btor *btor[2];
+  BtorSortId sort;
+  BtorNode *v, *c[2], *tmp;
+
+  /* entries for children with too many nodes are not shared */
+  for (i = 0; i < 2; i++)
+  {
+    btor[i] = btor_new ();
+    btor_opt_set (btor[i], BTOR_OPT_RW_CACHE_SHARED, 1);
+    sort = btor_sort_bv (btor[i], 8);
+    c[i] = btor_exp_var (btor[i], sort, "rwcache_shared_max_c");
+    for (j = 0; j < 40; j++)
+    {
+      sprintf (sym, "rwcache_shared_max_v%u", j);
+      v   = btor_exp_var (btor[i], sort, sym);
+      tmp = btor_exp_bv_and (btor[i], c[i], v);
+      btor_node_release (btor[i], c[i]);
+      btor_node_release (btor[i], v);
+      c[i] = tmp;
+    }
+    btor_sort_release (btor[i], sort);
+  }
+
+  btor_rw_cache_add (
+      btor[0]->rw_cache, BTOR_BV_AND_NODE, c[0]->id, c[0]->id, 0, c[0]->id);
+  ASSERT_EQ (btor_rw_cache_get_shared (
+                 btor[1]->rw_cache, BTOR_BV_AND_NODE, c[1]->id, c[1]->id, 0),
+             nullptr);
+
+  for (i = 0; i < 2; i++)
+  {
+    btor_node_release (btor[i], c[i]);
+    btor_delete (btor[i]);
+  }
+}